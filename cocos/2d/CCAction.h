@@ -248,6 +248,10 @@ protected:
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
+    /** Slot of the action in the ActionBatch that steps it, -1 when it is stepped on its own. */
+    int _batchIndex;
+
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
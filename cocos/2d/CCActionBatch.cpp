@@ -0,0 +1,544 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCActionBatch.h"
+#include <typeinfo>
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
+#include "2d/CCNode.h"
+#include "base/CCScriptSupport.h"
+
+NS_CC_BEGIN
+
+enum
+{
+    TWEEN_FIRST_TICK = 1 << 0,
+    TWEEN_PAUSED = 1 << 1,
+    // stepped by stepAction() in this frame
+    TWEEN_STEPPED = 1 << 2,
+};
+
+// the easing of EaseIn, EaseOut and EaseInOut, which have no tweenfunc::TweenType
+enum
+{
+    EASING_RATE_IN = tweenfunc::TWEEN_EASING_MAX + 1,
+    EASING_RATE_OUT,
+    EASING_RATE_IN_OUT,
+};
+
+enum
+{
+    ROTATE_SKEW,
+    ROTATE_UNIFORM,
+    ROTATE_3D,
+};
+
+static inline float easeTime(float time, int easing, float easingParam)
+{
+    switch (easing)
+    {
+        case tweenfunc::Linear:
+            return time;
+        case EASING_RATE_IN:
+            return tweenfunc::easeIn(time, easingParam);
+        case EASING_RATE_OUT:
+            return tweenfunc::easeOut(time, easingParam);
+        case EASING_RATE_IN_OUT:
+            return tweenfunc::easeInOut(time, easingParam);
+        default:
+            return tweenfunc::tweenTo(time, (tweenfunc::TweenType)easing, &easingParam);
+    }
+}
+
+template <typename T>
+static inline void moveTo(std::vector<T>& values, size_t from, size_t to)
+{
+    values[to] = values[from];
+}
+
+ActionBatch::ActionBatch()
+: _needsCompact(false)
+{
+}
+
+ActionBatch::~ActionBatch()
+{
+    for (auto action : _tweens.actions)
+    {
+        if (action)
+        {
+            action->_batchIndex = -1;
+        }
+    }
+}
+
+ActionBatch::Kind ActionBatch::getKind(const Action *action)
+{
+    // exact types only: subclasses may override update()
+    const std::type_info& type = typeid(*action);
+    if (type == typeid(MoveTo) || type == typeid(MoveBy))
+        return KIND_MOVE;
+    if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+        return KIND_SCALE;
+    if (type == typeid(RotateTo))
+        return KIND_ROTATE;
+    if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+        return KIND_OPACITY;
+    if (type == typeid(TintTo))
+        return KIND_COLOR;
+    return KIND_COUNT;
+}
+
+ActionInterval* ActionBatch::getTweenAction(Action *action, int *easing, float *easingParam)
+{
+    *easing = tweenfunc::Linear;
+    *easingParam = 0;
+
+    if (getKind(action) != KIND_COUNT)
+    {
+        return static_cast<ActionInterval*>(action);
+    }
+
+    static const struct
+    {
+        const std::type_info* type;
+        int easing;
+    } easeActions[] = {
+        { &typeid(EaseIn), EASING_RATE_IN },
+        { &typeid(EaseOut), EASING_RATE_OUT },
+        { &typeid(EaseInOut), EASING_RATE_IN_OUT },
+        { &typeid(EaseExponentialIn), tweenfunc::Expo_EaseIn },
+        { &typeid(EaseExponentialOut), tweenfunc::Expo_EaseOut },
+        { &typeid(EaseExponentialInOut), tweenfunc::Expo_EaseInOut },
+        { &typeid(EaseSineIn), tweenfunc::Sine_EaseIn },
+        { &typeid(EaseSineOut), tweenfunc::Sine_EaseOut },
+        { &typeid(EaseSineInOut), tweenfunc::Sine_EaseInOut },
+        { &typeid(EaseElasticIn), tweenfunc::Elastic_EaseIn },
+        { &typeid(EaseElasticOut), tweenfunc::Elastic_EaseOut },
+        { &typeid(EaseElasticInOut), tweenfunc::Elastic_EaseInOut },
+        { &typeid(EaseBounceIn), tweenfunc::Bounce_EaseIn },
+        { &typeid(EaseBounceOut), tweenfunc::Bounce_EaseOut },
+        { &typeid(EaseBounceInOut), tweenfunc::Bounce_EaseInOut },
+        { &typeid(EaseBackIn), tweenfunc::Back_EaseIn },
+        { &typeid(EaseBackOut), tweenfunc::Back_EaseOut },
+        { &typeid(EaseBackInOut), tweenfunc::Back_EaseInOut },
+        { &typeid(EaseQuadraticActionIn), tweenfunc::Quad_EaseIn },
+        { &typeid(EaseQuadraticActionOut), tweenfunc::Quad_EaseOut },
+        { &typeid(EaseQuadraticActionInOut), tweenfunc::Quad_EaseInOut },
+        { &typeid(EaseQuarticActionIn), tweenfunc::Quart_EaseIn },
+        { &typeid(EaseQuarticActionOut), tweenfunc::Quart_EaseOut },
+        { &typeid(EaseQuarticActionInOut), tweenfunc::Quart_EaseInOut },
+        { &typeid(EaseQuinticActionIn), tweenfunc::Quint_EaseIn },
+        { &typeid(EaseQuinticActionOut), tweenfunc::Quint_EaseOut },
+        { &typeid(EaseQuinticActionInOut), tweenfunc::Quint_EaseInOut },
+        { &typeid(EaseCircleActionIn), tweenfunc::Circ_EaseIn },
+        { &typeid(EaseCircleActionOut), tweenfunc::Circ_EaseOut },
+        { &typeid(EaseCircleActionInOut), tweenfunc::Circ_EaseInOut },
+        { &typeid(EaseCubicActionIn), tweenfunc::Cubic_EaseIn },
+        { &typeid(EaseCubicActionOut), tweenfunc::Cubic_EaseOut },
+        { &typeid(EaseCubicActionInOut), tweenfunc::Cubic_EaseInOut },
+    };
+
+    const std::type_info& type = typeid(*action);
+    for (const auto& easeAction : easeActions)
+    {
+        if (type != *easeAction.type)
+            continue;
+
+        ActionEase* ease = static_cast<ActionEase*>(action);
+        ActionInterval* inner = ease->getInnerAction();
+        if (inner == nullptr || getKind(inner) == KIND_COUNT)
+            return nullptr;
+
+        *easing = easeAction.easing;
+        if (easeAction.easing == EASING_RATE_IN || easeAction.easing == EASING_RATE_OUT || easeAction.easing == EASING_RATE_IN_OUT)
+        {
+            *easingParam = static_cast<EaseRateAction*>(action)->getRate();
+        }
+        else if (easeAction.easing == tweenfunc::Elastic_EaseIn || easeAction.easing == tweenfunc::Elastic_EaseOut || easeAction.easing == tweenfunc::Elastic_EaseInOut)
+        {
+            *easingParam = static_cast<EaseElastic*>(action)->getPeriod();
+        }
+        return inner;
+    }
+
+    return nullptr;
+}
+
+bool ActionBatch::add(Action *action, bool paused)
+{
+#if CC_ENABLE_SCRIPT_BINDING
+    // javascript actions may handle the update themselves
+    if (action->_scriptType == kScriptTypeJavascript)
+    {
+        return false;
+    }
+#endif
+    // an action run on two nodes at the same time is left to the regular path
+    if (action->_batchIndex >= 0 || action->getTarget() == nullptr)
+    {
+        return false;
+    }
+
+    int easing;
+    float easingParam;
+    ActionInterval* tweenAction = getTweenAction(action, &easing, &easingParam);
+    if (tweenAction == nullptr)
+    {
+        return false;
+    }
+
+    Tweens& tweens = _tweens;
+    ActionInterval* interval = static_cast<ActionInterval*>(action);
+    size_t index = tweens.actions.size();
+
+    // appended, so that the actions of a node stay in the order they were added
+    tweens.actions.push_back(action);
+    tweens.targets.push_back(action->getTarget());
+    tweens.kind.push_back((unsigned char)getKind(tweenAction));
+    tweens.elapsed.push_back(interval->_elapsed);
+    tweens.duration.push_back(interval->getDuration());
+    tweens.flags.push_back((interval->_firstTick ? TWEEN_FIRST_TICK : 0) | (paused ? TWEEN_PAUSED : 0));
+    tweens.easing.push_back(easing);
+    tweens.easingParam.push_back(easingParam);
+    tweens.start.push_back(Vec3::ZERO);
+    tweens.delta.push_back(Vec3::ZERO);
+    tweens.previous.push_back(Vec3::ZERO);
+    tweens.mode.push_back(0);
+    readState(index, tweenAction);
+
+    action->_batchIndex = (int)index;
+    return true;
+}
+
+bool ActionBatch::contains(const Action *action) const
+{
+    if (action->_batchIndex < 0)
+    {
+        return false;
+    }
+
+    size_t index = (size_t)action->_batchIndex;
+    return index < _tweens.actions.size() && _tweens.actions[index] == action;
+}
+
+void ActionBatch::remove(Action *action)
+{
+    if (!contains(action))
+    {
+        return;
+    }
+
+    size_t index = (size_t)action->_batchIndex;
+    Tweens& tweens = _tweens;
+
+    ActionInterval* interval = static_cast<ActionInterval*>(action);
+    interval->_elapsed = tweens.elapsed[index];
+    interval->_firstTick = (tweens.flags[index] & TWEEN_FIRST_TICK) != 0;
+
+    int easing;
+    float easingParam;
+    ActionInterval* tweenAction = getTweenAction(action, &easing, &easingParam);
+    if (tweenAction)
+    {
+        writeState(index, tweenAction);
+    }
+
+    // the slot may be stepped right now, the arrays are compacted by the next step()
+    action->_batchIndex = -1;
+    tweens.actions[index] = nullptr;
+    tweens.targets[index] = nullptr;
+    _needsCompact = true;
+}
+
+void ActionBatch::setPaused(Action *action, bool paused)
+{
+    if (!contains(action))
+    {
+        return;
+    }
+
+    unsigned char& flags = _tweens.flags[(size_t)action->_batchIndex];
+    flags = paused ? (flags | TWEEN_PAUSED) : (flags & ~TWEEN_PAUSED);
+}
+
+void ActionBatch::readState(size_t index, ActionInterval *tweenAction)
+{
+    Tweens& tweens = _tweens;
+    switch (tweens.kind[index])
+    {
+        case KIND_MOVE:
+        {
+            MoveBy* move = static_cast<MoveBy*>(tweenAction);
+            tweens.start[index] = move->_startPosition;
+            tweens.delta[index] = move->_positionDelta;
+            tweens.previous[index] = move->_previousPosition;
+            break;
+        }
+        case KIND_SCALE:
+        {
+            ScaleTo* scale = static_cast<ScaleTo*>(tweenAction);
+            tweens.start[index].set(scale->_startScaleX, scale->_startScaleY, scale->_startScaleZ);
+            tweens.delta[index].set(scale->_deltaX, scale->_deltaY, scale->_deltaZ);
+            break;
+        }
+        case KIND_ROTATE:
+        {
+            RotateTo* rotate = static_cast<RotateTo*>(tweenAction);
+            tweens.start[index] = rotate->_startAngle;
+            tweens.delta[index] = rotate->_diffAngle;
+            if (rotate->_is3D)
+            {
+                tweens.mode[index] = ROTATE_3D;
+            }
+            else
+            {
+#if CC_USE_PHYSICS
+                bool uniform = rotate->_startAngle.x == rotate->_startAngle.y && rotate->_diffAngle.x == rotate->_diffAngle.y;
+                tweens.mode[index] = uniform ? ROTATE_UNIFORM : ROTATE_SKEW;
+#else
+                tweens.mode[index] = ROTATE_SKEW;
+#endif // CC_USE_PHYSICS
+            }
+            break;
+        }
+        case KIND_OPACITY:
+        {
+            FadeTo* fade = static_cast<FadeTo*>(tweenAction);
+            tweens.start[index].x = fade->_fromOpacity;
+            tweens.delta[index].x = (float)(fade->_toOpacity - fade->_fromOpacity);
+            break;
+        }
+        case KIND_COLOR:
+        {
+            TintTo* tint = static_cast<TintTo*>(tweenAction);
+            tweens.start[index].set(tint->_from.r, tint->_from.g, tint->_from.b);
+            tweens.delta[index].set((float)(tint->_to.r - tint->_from.r),
+                                    (float)(tint->_to.g - tint->_from.g),
+                                    (float)(tint->_to.b - tint->_from.b));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void ActionBatch::writeState(size_t index, ActionInterval *tweenAction)
+{
+    // only stacked moves change their state while running
+    if (_tweens.kind[index] == KIND_MOVE)
+    {
+        MoveBy* move = static_cast<MoveBy*>(tweenAction);
+        move->_startPosition = _tweens.start[index];
+        move->_previousPosition = _tweens.previous[index];
+    }
+}
+
+void ActionBatch::compact()
+{
+    // the removed slots are squeezed out without changing the order of the others
+    Tweens& tweens = _tweens;
+    size_t count = 0;
+    for (size_t i = 0, size = tweens.actions.size(); i < size; ++i)
+    {
+        if (tweens.actions[i] == nullptr)
+            continue;
+
+        if (count != i)
+        {
+            moveTo(tweens.actions, i, count);
+            moveTo(tweens.targets, i, count);
+            moveTo(tweens.kind, i, count);
+            moveTo(tweens.elapsed, i, count);
+            moveTo(tweens.duration, i, count);
+            moveTo(tweens.flags, i, count);
+            moveTo(tweens.easing, i, count);
+            moveTo(tweens.easingParam, i, count);
+            moveTo(tweens.start, i, count);
+            moveTo(tweens.delta, i, count);
+            moveTo(tweens.previous, i, count);
+            moveTo(tweens.mode, i, count);
+            tweens.actions[count]->_batchIndex = (int)count;
+        }
+        ++count;
+    }
+
+    tweens.actions.resize(count);
+    tweens.targets.resize(count);
+    tweens.kind.resize(count);
+    tweens.elapsed.resize(count);
+    tweens.duration.resize(count);
+    tweens.flags.resize(count);
+    tweens.easing.resize(count);
+    tweens.easingParam.resize(count);
+    tweens.start.resize(count);
+    tweens.delta.resize(count);
+    tweens.previous.resize(count);
+    tweens.mode.resize(count);
+    _needsCompact = false;
+}
+
+bool ActionBatch::advance(size_t index, float dt, float *time)
+{
+    Tweens& tweens = _tweens;
+    unsigned char& flags = tweens.flags[index];
+    if (tweens.actions[index] == nullptr || (flags & TWEEN_PAUSED))
+    {
+        return false;
+    }
+
+    // same as ActionInterval::step(), the elapsed time is kept in the action for getElapsed() and isDone()
+    ActionInterval* interval = static_cast<ActionInterval*>(tweens.actions[index]);
+    float& elapsed = tweens.elapsed[index];
+    if (flags & TWEEN_FIRST_TICK)
+    {
+        flags &= ~TWEEN_FIRST_TICK;
+        elapsed = 0;
+        interval->_firstTick = false;
+    }
+    else
+    {
+        elapsed += dt;
+    }
+    interval->_elapsed = elapsed;
+
+    float t = MAX(0, MIN(1, elapsed / MAX(tweens.duration[index], FLT_EPSILON)));
+    *time = easeTime(t, tweens.easing[index], tweens.easingParam[index]);
+    return true;
+}
+
+void ActionBatch::apply(size_t index, float time)
+{
+    Tweens& tweens = _tweens;
+    Node* target = tweens.targets[index];
+    // copies: a setter may add an action, which grows the arrays
+    const Vec3 start = tweens.start[index];
+    const Vec3 delta = tweens.delta[index];
+
+    switch (tweens.kind[index])
+    {
+        case KIND_MOVE:
+        {
+#if CC_ENABLE_STACKABLE_ACTIONS
+            Vec3 currentPos = target->getPosition3D();
+            Vec3 diff = currentPos - tweens.previous[index];
+            tweens.start[index] = start + diff;
+            Vec3 newPos = tweens.start[index] + (delta * time);
+            target->setPosition3D(newPos);
+            tweens.previous[index] = newPos;
+#else
+            target->setPosition3D(start + delta * time);
+#endif // CC_ENABLE_STACKABLE_ACTIONS
+            break;
+        }
+        case KIND_SCALE:
+            target->setScaleX(start.x + delta.x * time);
+            target->setScaleY(start.y + delta.y * time);
+            target->setScaleZ(start.z + delta.z * time);
+            break;
+        case KIND_ROTATE:
+            switch (tweens.mode[index])
+            {
+                case ROTATE_3D:
+                    target->setRotation3D(Vec3(start.x + delta.x * time,
+                                               start.y + delta.y * time,
+                                               start.z + delta.z * time));
+                    break;
+                case ROTATE_UNIFORM:
+                    target->setRotation(start.x + delta.x * time);
+                    break;
+                default:
+                    target->setRotationSkewX(start.x + delta.x * time);
+                    target->setRotationSkewY(start.y + delta.y * time);
+                    break;
+            }
+            break;
+        case KIND_OPACITY:
+            target->setOpacity((GLubyte)(start.x + delta.x * time));
+            break;
+        case KIND_COLOR:
+            target->setColor(Color3B((GLubyte)(start.x + delta.x * time),
+                                     (GLubyte)(start.y + delta.y * time),
+                                     (GLubyte)(start.z + delta.z * time)));
+            break;
+        default:
+            break;
+    }
+}
+
+void ActionBatch::stepAction(Action *action, float dt)
+{
+    if (!contains(action))
+    {
+        return;
+    }
+
+    // the ActionManager checks isDone() and removes the action, like the others of the node
+    size_t index = (size_t)action->_batchIndex;
+    _tweens.flags[index] |= TWEEN_STEPPED;
+    float time;
+    if (advance(index, dt, &time))
+    {
+        apply(index, time);
+    }
+}
+
+const std::vector<Action*>& ActionBatch::step(float dt)
+{
+    _doneActions.clear();
+
+    if (_needsCompact)
+    {
+        compact();
+    }
+
+    // the actions added or removed by the setters are at the end of the arrays, or emptied
+    Tweens& tweens = _tweens;
+    for (size_t i = 0, count = tweens.actions.size(); i < count; ++i)
+    {
+        unsigned char& flags = tweens.flags[i];
+        if (flags & TWEEN_STEPPED)
+        {
+            flags &= ~TWEEN_STEPPED;
+            continue;
+        }
+
+        float time;
+        if (!advance(i, dt, &time))
+            continue;
+
+        apply(i, time);
+
+        // a setter may have removed the action
+        if (tweens.actions[i] && tweens.elapsed[i] >= tweens.duration[i])
+        {
+            tweens.actions[i]->retain();
+            _doneActions.push_back(tweens.actions[i]);
+        }
+    }
+    return _doneActions;
+}
+
+NS_CC_END
@@ -0,0 +1,152 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __ACTION_CCACTION_BATCH_H__
+#define __ACTION_CCACTION_BATCH_H__
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+#include "math/CCMath.h"
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+class Action;
+class ActionInterval;
+class Node;
+
+/** @class ActionBatch
+ * @brief @~english Steps the most common interval actions of an ActionManager in tight loops.
+ *
+ * MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, FadeTo, FadeIn, FadeOut and TintTo, either alone or wrapped in one
+ * of the easing actions of CCActionEase.h (except EaseBezierAction), are handled here when they are run directly
+ * on a node. Their state is copied into contiguous arrays, kept in the order the actions were added, which are
+ * updated without virtual calls, using the functions of CCTweenFunction.h for the easing, and the results are
+ * written to the nodes. The Action objects stay in the ActionManager, so that tags, flags and the removal
+ * functions keep working; their elapsed time is kept up to date, and the rest of their state is copied back
+ * when they leave the batch. Subclasses of these actions are never batched.
+ *
+ * The actions of a node are stepped in the order they were added: the ActionManager steps the batched actions
+ * of a node that also runs other actions with stepAction(), in turn with the others, and step() steps the rest.
+ * @~chinese 在紧凑的循环中更新ActionManager中最常用的持续动作。
+ *
+ * 直接在节点上运行的MoveBy、MoveTo、ScaleTo、ScaleBy、RotateTo、FadeTo、FadeIn、FadeOut和TintTo，
+ * 以及用CCActionEase.h中的缓动动作（EaseBezierAction除外）包装的这些动作，都由这个类处理。
+ * 它们的状态被拷贝到连续的数组中，按动作加入的顺序排列，更新时没有虚函数调用，缓动使用CCTweenFunction.h中的函数，
+ * 结果再写回节点。动作对象仍然保存在ActionManager中，因此标签、标记和删除函数都能正常工作；
+ * 动作的已运行时间会保持最新，其余状态在离开批处理时拷贝回动作对象。这些动作的子类不会被批处理。
+ *
+ * 一个节点的动作按加入的顺序更新：如果节点同时运行其他动作，ActionManager通过stepAction()与其他动作依次更新它的被批处理的动作，
+ * step()更新其余的动作。
+ */
+class CC_DLL ActionBatch
+{
+public:
+    ActionBatch();
+    ~ActionBatch();
+
+    /** @~english Takes over an action that was just started, if it is one of the batched kinds.
+     * @~chinese 如果动作是可以批处理的类型，接管这个刚启动的动作。
+     * @return @~english True if the action is now stepped by the batch.
+     * @~chinese 如果动作现在由批处理更新，返回true。
+     */
+    bool add(Action *action, bool paused);
+
+    /** @~english Gives a batched action back, copying its state into it.
+     * @~chinese 归还一个被批处理的动作，并把状态拷贝回动作对象。
+     */
+    void remove(Action *action);
+
+    /** @~english Pauses or resumes a batched action.
+     * @~chinese 暂停或恢复一个被批处理的动作。
+     */
+    void setPaused(Action *action, bool paused);
+
+    /** @~english Whether the action is stepped by the batch.
+     * @~chinese 动作是否由批处理更新。
+     */
+    bool contains(const Action *action) const;
+
+    /** @~english Steps one batched action, in turn with the other actions of its node.
+     * step() skips it until the next frame.
+     * @~chinese 与节点的其他动作依次更新一个被批处理的动作。step()在下一帧之前跳过它。
+     */
+    void stepAction(Action *action, float dt);
+
+    /** @~english Steps the batched actions that are not paused, and weren't stepped by stepAction() in this frame.
+     * @~chinese 更新没有暂停，并且在这一帧中没有被stepAction()更新的被批处理的动作。
+     * @return @~english The actions that are done, retained. The caller stops, removes and releases them.
+     * @~chinese 已经完成的动作，它们被retain了。调用者负责停止、删除和release它们。
+     */
+    const std::vector<Action*>& step(float dt);
+
+protected:
+    enum Kind
+    {
+        KIND_MOVE,
+        KIND_SCALE,
+        KIND_ROTATE,
+        KIND_OPACITY,
+        KIND_COLOR,
+
+        KIND_COUNT
+    };
+
+    // structure of arrays for the batched actions, in the order they were added
+    struct Tweens
+    {
+        std::vector<Action*> actions;       // the action run on the node, it may be an easing action, nullptr once removed
+        std::vector<Node*> targets;
+        std::vector<unsigned char> kind;
+        std::vector<float> elapsed;
+        std::vector<float> duration;
+        std::vector<unsigned char> flags;
+        std::vector<int> easing;
+        std::vector<float> easingParam;
+        std::vector<Vec3> start;
+        std::vector<Vec3> delta;
+        std::vector<Vec3> previous;         // stacked moves: last position written by the action
+        std::vector<unsigned char> mode;    // rotations: how the angles are applied
+    };
+
+    static ActionInterval* getTweenAction(Action *action, int *easing, float *easingParam);
+    static Kind getKind(const Action *action);
+
+    void readState(size_t index, ActionInterval *tweenAction);
+    void writeState(size_t index, ActionInterval *tweenAction);
+    void compact();
+    bool advance(size_t index, float dt, float *time);
+    void apply(size_t index, float time);
+
+    Tweens _tweens;
+    std::vector<Action*> _doneActions;
+    bool _needsCompact;
+};
+
+NS_CC_END
+
+/// @endcond
+
+#endif // __ACTION_CCACTION_BATCH_H__
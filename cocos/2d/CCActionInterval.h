@@ -137,6 +137,8 @@ protected:
     float _elapsed;
     bool _firstTick;
 
+    friend class ActionBatch;
+
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
 };
@@ -638,6 +640,7 @@ protected:
     Vec3 _startAngle;
     Vec3 _diffAngle;
 
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
 };
@@ -810,6 +813,7 @@ protected:
     Vec3 _startPosition;
     Vec3 _previousPosition;
 
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
 };
@@ -1302,6 +1306,7 @@ protected:
     float _deltaY;
     float _deltaZ;
 
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
 };
@@ -1482,6 +1487,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -1630,6 +1636,7 @@ protected:
     Color3B _to;
     Color3B _from;
 
+    friend class ActionBatch;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintTo);
 };
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionBatch.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
@@ -43,6 +44,7 @@ typedef struct _hashElement
     struct _ccArray     *actions;
     Node                *target;
     int                 actionIndex;
+    int                 batchedActions; // actions stepped by the ActionBatch
     Action              *currentAction;
     bool                currentActionSalvaged;
     bool                paused;
@@ -54,7 +56,7 @@ ActionManager::ActionManager()
   _currentTarget(nullptr),
   _currentTargetSalvaged(false)
 {
-
+    _batch = new (std::nothrow) ActionBatch();
 }
 
 ActionManager::~ActionManager()
@@ -62,6 +64,7 @@ ActionManager::~ActionManager()
     CCLOGINFO("deallocing ActionManager: %p", this);
 
     removeAllActions();
+    CC_SAFE_DELETE(_batch);
 }
 
 // private
@@ -92,6 +95,12 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
 {
     Action *action = (Action*)element->actions->arr[index];
 
+    if (_batch->contains(action))
+    {
+        _batch->remove(action);
+        element->batchedActions--;
+    }
+
     if (action == element->currentAction && (! element->currentActionSalvaged))
     {
         element->currentAction->retain();
@@ -119,6 +128,17 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
     }
 }
 
+void ActionManager::setBatchedActionsPaused(tHashElement *element, bool paused)
+{
+    if (element->batchedActions > 0)
+    {
+        for (int i = 0; i < element->actions->num; ++i)
+        {
+            _batch->setPaused((Action*)element->actions->arr[i], paused);
+        }
+    }
+}
+
 // pause / resume
 
 void ActionManager::pauseTarget(Node *target)
@@ -128,6 +148,7 @@ void ActionManager::pauseTarget(Node *target)
     if (element)
     {
         element->paused = true;
+        setBatchedActionsPaused(element, true);
     }
 }
 
@@ -138,6 +159,7 @@ void ActionManager::resumeTarget(Node *target)
     if (element)
     {
         element->paused = false;
+        setBatchedActionsPaused(element, false);
     }
 }
 
@@ -150,6 +172,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            setBatchedActionsPaused(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -190,6 +213,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      ccArrayAppendObject(element->actions, action);
  
      action->startWithTarget(target);
+
+     if (_batch->add(action, element->paused))
+     {
+         element->batchedActions++;
+     }
 }
 
 // remove
@@ -222,6 +250,15 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
             element->currentActionSalvaged = true;
         }
 
+        if (element->batchedActions > 0)
+        {
+            for (int i = 0; i < element->actions->num; ++i)
+            {
+                _batch->remove((Action*)element->actions->arr[i]);
+            }
+            element->batchedActions = 0;
+        }
+
         ccArrayRemoveAllObjects(element->actions);
         if (_currentTarget == element)
         {
@@ -404,7 +441,8 @@ void ActionManager::update(float dt)
         _currentTarget = elt;
         _currentTargetSalvaged = false;
 
-        if (! _currentTarget->paused)
+        // the targets whose actions are all batched are stepped by the batch, in the order of their actions
+        if (! _currentTarget->paused && _currentTarget->batchedActions < _currentTarget->actions->num)
         {
             // The 'actions' MutableArray may change while inside this loop.
             for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
@@ -418,7 +456,15 @@ void ActionManager::update(float dt)
 
                 _currentTarget->currentActionSalvaged = false;
 
-                _currentTarget->currentAction->step(dt);
+                // the batched actions of the target are stepped in turn with the others, the batch skips them
+                if (_batch->contains(_currentTarget->currentAction))
+                {
+                    _batch->stepAction(_currentTarget->currentAction, dt);
+                }
+                else
+                {
+                    _currentTarget->currentAction->step(dt);
+                }
 
                 if (_currentTarget->currentActionSalvaged)
                 {
@@ -454,6 +500,19 @@ void ActionManager::update(float dt)
 
     // issue #635
     _currentTarget = nullptr;
+
+    // the batched actions, removed like the others when they are done
+    const auto& doneActions = _batch->step(dt);
+    for (auto action : doneActions)
+    {
+        // an action stopped before may have removed this one
+        if (_batch->contains(action))
+        {
+            action->stop();
+            removeAction(action);
+        }
+        action->release();
+    }
 }
 
 NS_CC_END
@@ -36,6 +36,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
+class ActionBatch;
 
 struct _hashElement;
 
@@ -60,6 +61,12 @@ struct _hashElement;
  * - 当你想要运行一个动作，但目标不是节点类型。
  * - 当你想要暂停/恢复动作。
  * 
+ * @~english MoveTo, MoveBy, ScaleTo, RotateTo, FadeTo, TintTo and their easing wrappers run directly on a node
+ * are stepped together in tight loops, see ActionBatch. The actions of a node are still stepped in the order they
+ * were added.
+ * @~chinese 直接在节点上运行的MoveTo、MoveBy、ScaleTo、RotateTo、FadeTo、TintTo以及它们的缓动包装动作
+ * 会在紧凑的循环中一起更新，参见ActionBatch。一个节点的动作仍然按加入的顺序更新。
+ * 
  @since v0.8
  */
 class CC_DLL ActionManager : public Ref
@@ -238,11 +245,13 @@ protected:
     void removeActionAtIndex(ssize_t index, struct _hashElement *element);
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
+    void setBatchedActionsPaused(struct _hashElement *element, bool paused);
 
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    ActionBatch     *_batch;
 };
 
 // end of actions group
@@ -455,6 +455,8 @@ public:
     
     // Overrides
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    // the primitives aren't bounded by the content size
+    virtual bool getCullingBounds(AABB* bounds) const override { return false; }
     
     void setLineWidth(int lineWidth);
 
@@ -105,6 +105,9 @@ bool TMXLayer::initWithTilesetInfo(TMXTilesetInfo *tilesetInfo, TMXLayerInfo *la
     _useAutomaticVertexZ = false;
     _vertexZvalue = 0;
 
+    // the quads of one buffer are indexed with 16 bit indices
+    _chunkingEnabled = _layerSize.width * _layerSize.height > 16384;
+
     return true;
 }
 
@@ -123,6 +126,11 @@ TMXLayer::TMXLayer()
 , _vertexBuffer(nullptr)
 , _vData(nullptr)
 , _indexBuffer(nullptr)
+, _chunkingEnabled(false)
+, _chunkSize(32)
+, _chunkPadding(256.0f)
+, _chunkColumns(0)
+, _chunkIndexBuffer(nullptr)
 {
 }
 
@@ -134,12 +142,16 @@ TMXLayer::~TMXLayer()
     CC_SAFE_RELEASE(_vData);
     CC_SAFE_RELEASE(_vertexBuffer);
     CC_SAFE_RELEASE(_indexBuffer);
-    
+    releaseChunks();
+    CC_SAFE_RELEASE(_chunkIndexBuffer);
 }
 
 void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
 {
-    updateTotalQuads();
+    if (_chunkingEnabled)
+        setupChunks();
+    else
+        updateTotalQuads();
 
     bool isViewProjectionUpdated = true;
     auto visitingCamera = Camera::getVisitingCamera();
@@ -160,11 +172,24 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
         inv.inverse();
         rect = RectApplyTransform(rect, inv);
         
-        updateTiles(rect);
-        updateIndexBuffer();
-        updatePrimitives();
+        if (_chunkingEnabled)
+        {
+            updateChunks(rect);
+        }
+        else
+        {
+            updateTiles(rect);
+            updateIndexBuffer();
+            updatePrimitives();
+        }
         _dirty = false;
     }
+
+    if (_chunkingEnabled)
+    {
+        drawChunks(renderer, flags);
+        return;
+    }
     
     if(_renderCommands.size() < static_cast<size_t>(_primitives.size()))
     {
@@ -195,7 +220,7 @@ void TMXLayer::onDraw(Primitive *primitive)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, primitive->getCount() * 4);
 }
 
-void TMXLayer::updateTiles(const Rect& culledRect)
+void TMXLayer::getTileRange(const Rect& culledRect, int* xBegin, int* xEnd, int* yBegin, int* yEnd)
 {
     Rect visibleTiles = culledRect;
     Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
@@ -241,6 +266,17 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         //CCASSERT(0, "TMX invalid value");
     }
     
+    *yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
+    *yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
+    *xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
+    *xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
+}
+
+void TMXLayer::updateTiles(const Rect& culledRect)
+{
+    int xBegin, xEnd, yBegin, yEnd;
+    getTileRange(culledRect, &xBegin, &xEnd, &yBegin, &yEnd);
+
     _indicesVertexZNumber.clear();
     
     for(const auto& iter : _indicesVertexZOffsets)
@@ -248,11 +284,6 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         _indicesVertexZNumber[iter.first] = iter.second;
     }
     
-    int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
-    int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
-    int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
-    int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
-    
     for (int y =  yBegin; y < yEnd; ++y)
     {
         for (int x = xBegin; x < xEnd; ++x)
@@ -435,12 +466,95 @@ void TMXLayer::updatePrimitives()
     }
 }
 
+void TMXLayer::setupQuadForTile(int x, int y, uint32_t tileGID, float z, V3F_C4B_T2F_Quad* quad)
+{
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
+
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
+    
+    float left, right, top, bottom;
+
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
+    
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
+    
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad->bl.vertices.x = left;
+        quad->bl.vertices.y = bottom;
+        quad->bl.vertices.z = z;
+        quad->br.vertices.x = left;
+        quad->br.vertices.y = top;
+        quad->br.vertices.z = z;
+        quad->tl.vertices.x = right;
+        quad->tl.vertices.y = bottom;
+        quad->tl.vertices.z = z;
+        quad->tr.vertices.x = right;
+        quad->tr.vertices.y = top;
+        quad->tr.vertices.z = z;
+    }
+    else
+    {
+        quad->bl.vertices.x = left;
+        quad->bl.vertices.y = bottom;
+        quad->bl.vertices.z = z;
+        quad->br.vertices.x = right;
+        quad->br.vertices.y = bottom;
+        quad->br.vertices.z = z;
+        quad->tl.vertices.x = left;
+        quad->tl.vertices.y = top;
+        quad->tl.vertices.z = z;
+        quad->tr.vertices.x = right;
+        quad->tr.vertices.y = top;
+        quad->tr.vertices.z = z;
+    }
+    
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+    
+    quad->bl.texCoords.u = left;
+    quad->bl.texCoords.v = bottom;
+    quad->br.texCoords.u = right;
+    quad->br.texCoords.v = bottom;
+    quad->tl.texCoords.u = left;
+    quad->tl.texCoords.v = top;
+    quad->tr.texCoords.u = right;
+    quad->tr.texCoords.v = top;
+    
+    quad->bl.colors = Color4B::WHITE;
+    quad->br.colors = Color4B::WHITE;
+    quad->tl.colors = Color4B::WHITE;
+    quad->tr.colors = Color4B::WHITE;
+}
+
 void TMXLayer::updateTotalQuads()
 {
     if(_quadsDirty)
     {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
         _tileToQuadIndex.clear();
         _totalQuads.resize(int(_layerSize.width * _layerSize.height));
         _indices.resize(6 * int(_layerSize.width * _layerSize.height));
@@ -459,14 +573,7 @@ void TMXLayer::updateTotalQuads()
                 
                 _tileToQuadIndex[tileIndex] = quadIndex;
                 
-                auto& quad = _totalQuads[quadIndex];
-                
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-                
-                float left, right, top, bottom, z;
-                
-                z = getVertexZForPos(Vec2(x, y));
+                int z = getVertexZForPos(Vec2(x, y));
                 auto iter = _indicesVertexZOffsets.find(z);
                 if(iter == _indicesVertexZOffsets.end())
                 {
@@ -476,79 +583,8 @@ void TMXLayer::updateTotalQuads()
                 {
                     iter->second++;
                 }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-                
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-                
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-                
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-                
-                quad.bl.colors = Color4B::WHITE;
-                quad.br.colors = Color4B::WHITE;
-                quad.tl.colors = Color4B::WHITE;
-                quad.tr.colors = Color4B::WHITE;
+
+                setupQuadForTile(x, y, tileGID, z, &_totalQuads[quadIndex]);
                 
                 ++quadIndex;
             }
@@ -566,6 +602,253 @@ void TMXLayer::updateTotalQuads()
     }
 }
 
+// FastTMXLayer - chunks
+void TMXLayer::setChunkingEnabled(bool enabled)
+{
+    if (_chunkingEnabled == enabled)
+        return;
+
+    _chunkingEnabled = enabled;
+    releaseChunks();
+    _chunks.clear();
+
+    // the buffers of the whole layer are rebuilt from scratch when chunking is disabled again
+    std::vector<V3F_C4B_T2F_Quad>().swap(_totalQuads);
+    std::vector<GLushort>().swap(_indices);
+    std::vector<int>().swap(_tileToQuadIndex);
+    _indicesVertexZOffsets.clear();
+    _indicesVertexZNumber.clear();
+    _primitives.clear();
+    CC_SAFE_RELEASE_NULL(_vData);
+    CC_SAFE_RELEASE_NULL(_vertexBuffer);
+    CC_SAFE_RELEASE_NULL(_indexBuffer);
+
+    _quadsDirty = true;
+    _dirty = true;
+}
+
+void TMXLayer::setChunkSize(int chunkSize)
+{
+    chunkSize = std::max(1, std::min(chunkSize, (int)MAX_CHUNK_SIZE));
+    if (_chunkSize == chunkSize)
+        return;
+
+    _chunkSize = chunkSize;
+    releaseChunks();
+    CC_SAFE_RELEASE_NULL(_chunkIndexBuffer);
+    _quadsDirty = true;
+    _dirty = true;
+}
+
+void TMXLayer::setupChunks()
+{
+    if (!_quadsDirty)
+        return;
+
+    releaseChunks();
+    _chunkColumns = ((int)_layerSize.width + _chunkSize - 1) / _chunkSize;
+    int chunkRows = ((int)_layerSize.height + _chunkSize - 1) / _chunkSize;
+    Chunk chunk = { nullptr, nullptr, {}, false, false };
+    _chunks.assign(_chunkColumns * chunkRows, chunk);
+
+    // every chunk draws its quads in order, so they all share the same indices
+    if (nullptr == _chunkIndexBuffer)
+    {
+        int quadCount = _chunkSize * _chunkSize;
+        std::vector<GLushort> indices(quadCount * 6);
+        for (int i = 0; i < quadCount; ++i)
+        {
+            indices[i * 6 + 0] = i * 4 + 0;
+            indices[i * 6 + 1] = i * 4 + 1;
+            indices[i * 6 + 2] = i * 4 + 2;
+            indices[i * 6 + 3] = i * 4 + 3;
+            indices[i * 6 + 4] = i * 4 + 2;
+            indices[i * 6 + 5] = i * 4 + 1;
+        }
+        _chunkIndexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)indices.size());
+        CC_SAFE_RETAIN(_chunkIndexBuffer);
+        _chunkIndexBuffer->updateIndices(&indices[0], (int)indices.size(), 0);
+    }
+
+    _quadsDirty = false;
+    _dirty = true;
+}
+
+void TMXLayer::updateChunks(const Rect& culledRect)
+{
+    auto chunkRange = [this](const Rect& rect, int* cxBegin, int* cxEnd, int* cyBegin, int* cyEnd) {
+        int xBegin, xEnd, yBegin, yEnd;
+        getTileRange(rect, &xBegin, &xEnd, &yBegin, &yEnd);
+        *cxBegin = xBegin / _chunkSize;
+        *cyBegin = yBegin / _chunkSize;
+        // an empty range gives an empty chunk range
+        *cxEnd = xEnd > xBegin ? (xEnd - 1) / _chunkSize + 1 : *cxBegin;
+        *cyEnd = yEnd > yBegin ? (yEnd - 1) / _chunkSize + 1 : *cyBegin;
+    };
+
+    int cxBegin, cxEnd, cyBegin, cyEnd;
+
+    // release the chunks beyond twice the padding first, so that their buffers are freed before new ones are created
+    float keepPadding = _chunkPadding * 2;
+    chunkRange(Rect(culledRect.origin.x - keepPadding, culledRect.origin.y - keepPadding,
+                    culledRect.size.width + keepPadding * 2, culledRect.size.height + keepPadding * 2),
+               &cxBegin, &cxEnd, &cyBegin, &cyEnd);
+    size_t kept = 0;
+    for (size_t i = 0; i < _residentChunks.size(); ++i)
+    {
+        int chunkIndex = _residentChunks[i];
+        int cx = chunkIndex % _chunkColumns;
+        int cy = chunkIndex / _chunkColumns;
+        if (cx >= cxBegin && cx < cxEnd && cy >= cyBegin && cy < cyEnd)
+            _residentChunks[kept++] = chunkIndex;
+        else
+            releaseChunk(chunkIndex);
+    }
+    _residentChunks.resize(kept);
+
+    // build the chunks within the padding
+    chunkRange(Rect(culledRect.origin.x - _chunkPadding, culledRect.origin.y - _chunkPadding,
+                    culledRect.size.width + _chunkPadding * 2, culledRect.size.height + _chunkPadding * 2),
+               &cxBegin, &cxEnd, &cyBegin, &cyEnd);
+    for (int cy = cyBegin; cy < cyEnd; ++cy)
+    {
+        for (int cx = cxBegin; cx < cxEnd; ++cx)
+        {
+            int chunkIndex = cx + cy * _chunkColumns;
+            auto& chunk = _chunks[chunkIndex];
+            if (!chunk.resident)
+                _residentChunks.push_back(chunkIndex);
+            if (!chunk.resident || chunk.dirty)
+                buildChunk(chunkIndex);
+        }
+    }
+
+    // draw the visible ones, in the order of their tiles
+    chunkRange(culledRect, &cxBegin, &cxEnd, &cyBegin, &cyEnd);
+    _visibleChunks.clear();
+    for (int cy = cyBegin; cy < cyEnd; ++cy)
+    {
+        for (int cx = cxBegin; cx < cxEnd; ++cx)
+        {
+            int chunkIndex = cx + cy * _chunkColumns;
+            if (!_chunks[chunkIndex].primitives.empty())
+                _visibleChunks.push_back(chunkIndex);
+        }
+    }
+}
+
+void TMXLayer::buildChunk(int chunkIndex)
+{
+    releaseChunk(chunkIndex);
+
+    auto& chunk = _chunks[chunkIndex];
+    chunk.resident = true;
+
+    int xBegin = (chunkIndex % _chunkColumns) * _chunkSize;
+    int yBegin = (chunkIndex / _chunkColumns) * _chunkSize;
+    int xEnd = std::min(xBegin + _chunkSize, (int)_layerSize.width);
+    int yEnd = std::min(yBegin + _chunkSize, (int)_layerSize.height);
+
+    // count the quads of each vertex Z, then store them grouped by vertex Z
+    std::map<int/*vertexZ*/, int/*offset by quads*/> vertexZOffsets;
+    int quadCount = 0;
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            if (_tiles[getTileIndexByPos(x, y)] == 0) continue;
+            ++vertexZOffsets[getVertexZForPos(Vec2(x, y))];
+            ++quadCount;
+        }
+    }
+    if (quadCount == 0)
+        return;
+
+    int offset = 0;
+    for (auto& iter : vertexZOffsets)
+    {
+        int count = iter.second;
+        iter.second = offset;
+        offset += count;
+    }
+
+    _chunkQuads.resize(quadCount);
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            uint32_t tileGID = _tiles[getTileIndexByPos(x, y)];
+            if (tileGID == 0) continue;
+            int z = getVertexZForPos(Vec2(x, y));
+            setupQuadForTile(x, y, tileGID, z, &_chunkQuads[vertexZOffsets[z]++]);
+        }
+    }
+
+    GL::bindVAO(0);
+    chunk.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), quadCount * 4);
+    chunk.vertexBuffer->retain();
+    chunk.vertexBuffer->updateVertices(&_chunkQuads[0], quadCount * 4, 0);
+    chunk.vertexData = VertexData::create();
+    chunk.vertexData->retain();
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+    chunk.vertexData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+
+    // the offsets now point at the end of each vertex Z
+    int start = 0;
+    for (const auto& iter : vertexZOffsets)
+    {
+        auto primitive = Primitive::create(chunk.vertexData, _chunkIndexBuffer, GL_TRIANGLES);
+        primitive->retain();
+        primitive->setStart(start * 6);
+        primitive->setCount((iter.second - start) * 6);
+        chunk.primitives.push_back(std::make_pair(iter.first, primitive));
+        start = iter.second;
+    }
+}
+
+void TMXLayer::releaseChunk(int chunkIndex)
+{
+    auto& chunk = _chunks[chunkIndex];
+    for (auto& iter : chunk.primitives)
+        iter.second->release();
+    chunk.primitives.clear();
+    CC_SAFE_RELEASE_NULL(chunk.vertexData);
+    CC_SAFE_RELEASE_NULL(chunk.vertexBuffer);
+    chunk.resident = false;
+    chunk.dirty = false;
+}
+
+void TMXLayer::releaseChunks()
+{
+    for (int chunkIndex : _residentChunks)
+        releaseChunk(chunkIndex);
+    _residentChunks.clear();
+    _visibleChunks.clear();
+}
+
+void TMXLayer::drawChunks(Renderer* renderer, uint32_t flags)
+{
+    size_t commandCount = 0;
+    for (int chunkIndex : _visibleChunks)
+        commandCount += _chunks[chunkIndex].primitives.size();
+    if (_renderCommands.size() < commandCount)
+    {
+        _renderCommands.resize(commandCount);
+    }
+
+    int index = 0;
+    for (int chunkIndex : _visibleChunks)
+    {
+        for (const auto& iter : _chunks[chunkIndex].primitives)
+        {
+            auto& cmd = _renderCommands[index++];
+            cmd.init(iter.first, _texture->getName(), getGLProgramState(), BlendFunc::ALPHA_NON_PREMULTIPLIED, iter.second, _modelViewTransform, flags);
+            renderer->addCommand(&cmd);
+        }
+    }
+}
+
 // removing / getting tiles
 Sprite* TMXLayer::getTileAt(const Vec2& tileCoordinate)
 {
@@ -696,7 +979,17 @@ void TMXLayer::setFlaggedTileGIDByIndex(int index, int gid)
 {
     if(gid == _tiles[index]) return;
     _tiles[index] = gid;
-    _quadsDirty = true;
+    // in chunked mode only the chunk of the tile is rebuilt
+    if (_chunkingEnabled && !_quadsDirty && !_chunks.empty())
+    {
+        int x = index % (int)_layerSize.width;
+        int y = index / (int)_layerSize.width;
+        _chunks[x / _chunkSize + (y / _chunkSize) * _chunkColumns].dirty = true;
+    }
+    else
+    {
+        _quadsDirty = true;
+    }
     _dirty = true;
 }
 
@@ -374,6 +374,52 @@ public:
      */
     void setupTileSprite(Sprite* sprite, Vec2 pos, int gid);
 
+    /** @~english Sets whether the tiles are drawn from fixed-size chunks.
+     * A chunk of chunkSize x chunkSize tiles has its own static vertex buffer, built the first time the chunk
+     * enters the visible rectangle enlarged by the chunk padding, rebuilt when one of its tiles changes, and released
+     * when the chunk is more than twice the padding away from the visible rectangle. The layer then never holds the
+     * vertices of all its tiles, which is what large maps need.
+     * Layers of more than 16384 tiles, which can't be indexed with 16 bit indices in one buffer, are chunked by default.
+     *
+     * @~chinese 设置是否使用固定大小的块绘制瓦片。
+     * 一个chunkSize x chunkSize个瓦片的块拥有自己的静态顶点缓冲区，在块第一次进入按块边距放大的可见矩形时创建，
+     * 在块中的瓦片变化时重新创建，在块与可见矩形的距离超过边距的两倍时释放。这样层不需要保存所有瓦片的顶点，适用于大型地图。
+     * 超过16384个瓦片的层无法在一个缓冲区中使用16位索引，默认使用块绘制。
+     *
+     * @param enabled @~english true to draw the tiles from chunks. @~chinese true 使用块绘制瓦片。
+     */
+    void setChunkingEnabled(bool enabled);
+
+    /** @~english Whether the tiles are drawn from fixed-size chunks.
+     * @~chinese 是否使用固定大小的块绘制瓦片。
+     */
+    bool isChunkingEnabled() const { return _chunkingEnabled; }
+
+    /** @~english Sets the number of tiles of the side of a chunk, from 1 to MAX_CHUNK_SIZE, 32 by default.
+     * @~chinese 设置块的边长包含的瓦片数，从1到MAX_CHUNK_SIZE，默认为32。
+     */
+    void setChunkSize(int chunkSize);
+
+    /** @~english The number of tiles of the side of a chunk.
+     * @~chinese 块的边长包含的瓦片数。
+     */
+    int getChunkSize() const { return _chunkSize; }
+
+    /** @~english Sets how far, in points, around the visible rectangle the chunks are built ahead of time, 256 by default.
+     * @~chinese 设置在可见矩形周围多远的距离内提前创建块，以点为单位，默认为256。
+     */
+    void setChunkPadding(float padding) { _chunkPadding = padding; _dirty = true; }
+
+    /** @~english How far, in points, around the visible rectangle the chunks are built ahead of time.
+     * @~chinese 在可见矩形周围多远的距离内提前创建块，以点为单位。
+     */
+    float getChunkPadding() const { return _chunkPadding; }
+
+    /** @~english The number of chunks whose vertices are built.
+     * @~chinese 已创建顶点的块的数量。
+     */
+    int getResidentChunkCount() const { return (int)_residentChunks.size(); }
+
     //
     // Override
     //
@@ -407,6 +453,25 @@ protected:
     void updateVertexBuffer();
     void updateIndexBuffer();
     void updatePrimitives();
+
+    void getTileRange(const Rect& culledRect, int* xBegin, int* xEnd, int* yBegin, int* yEnd);
+    void setupQuadForTile(int x, int y, uint32_t tileGID, float z, V3F_C4B_T2F_Quad* quad);
+
+    // chunked mode
+    struct Chunk
+    {
+        VertexBuffer* vertexBuffer;
+        VertexData* vertexData;
+        std::vector<std::pair<int/*vertexZ*/, Primitive*>> primitives;
+        bool resident;
+        bool dirty;
+    };
+    void setupChunks();
+    void updateChunks(const Rect& culledRect);
+    void buildChunk(int chunkIndex);
+    void releaseChunk(int chunkIndex);
+    void releaseChunks();
+    void drawChunks(Renderer* renderer, uint32_t flags);
 protected:
     
     //! name of the layer
@@ -458,8 +523,21 @@ protected:
     IndexBuffer* _indexBuffer;
     
     Map<int , Primitive*> _primitives;
+
+    bool _chunkingEnabled;
+    int _chunkSize;
+    float _chunkPadding;
+    int _chunkColumns;
+    std::vector<Chunk> _chunks;
+    std::vector<int> _residentChunks;
+    std::vector<int> _visibleChunks;
+    /** @~english indices of chunkSize x chunkSize quads, shared by all the chunks  @~chinese 所有块共享的chunkSize x chunkSize个四边形的索引*/
+    IndexBuffer* _chunkIndexBuffer;
+    std::vector<V3F_C4B_T2F_Quad> _chunkQuads;
     
 public:
+    /** @~english The largest chunk size, whose vertices can still be indexed with 16 bit indices  @~chinese 最大的块大小，其顶点仍然可以使用16位索引*/
+    static const int MAX_CHUNK_SIZE = 128;
     /** @~english Possible orientations of the TMX map  @~chinese TMX的可能方向地图*/
     static const int FAST_TMX_ORIENTATION_ORTHO;
     static const int FAST_TMX_ORIENTATION_HEX;
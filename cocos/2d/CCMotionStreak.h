@@ -170,6 +170,8 @@ public:
     virtual Vec3 getPosition3D() const override;
     
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    // the streak is drawn where the node has been
+    virtual bool getCullingBounds(AABB* bounds) const override { return false; }
     virtual void update(float delta) override;
     virtual Texture2D* getTexture() const override;
     virtual void setTexture(Texture2D *texture) override;
@@ -37,13 +37,17 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCThreadPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "2d/CCSpatialIndex.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
+#include "3d/CCFrustum.h"
 #include "math/TransformUtils.h"
 #include "deprecated/CCString.h"
 
@@ -104,6 +108,10 @@ Node::Node()
 , _orderOfArrival(0)
 , _running(false)
 , _visible(true)
+, _parallelVisitRoot(false)
+, _spatialIndex(nullptr)
+, _spatialProxy(-1)
+, _missedParentFlags(0)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
 , _isTransitionFinished(false)
@@ -173,7 +181,9 @@ Node::~Node()
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->_spatialProxy = -1;
     }
+    CC_SAFE_DELETE(_spatialIndex);
 
     removeAllComponents();
     
@@ -1075,9 +1085,12 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
         }
         // set parent nil at the end
         child->setParent(nullptr);
+        child->_spatialProxy = -1;
     }
     
     _children.clear();
+    if (_spatialIndex)
+        _spatialIndex->clear();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1101,6 +1114,10 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
     // set parent nil at the end
     child->setParent(nullptr);
 
+    if (_spatialIndex && child->_spatialProxy >= 0)
+        _spatialIndex->remove(child->_spatialProxy);
+    child->_spatialProxy = -1;
+
     _children.erase(childIndex);
 }
 
@@ -1112,6 +1129,9 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_localZOrder = z;
+
+    if (_spatialIndex)
+        child->_spatialProxy = _spatialIndex->add(child);
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -1152,6 +1172,10 @@ void Node::visit()
 
 uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
 {
+    // the changes the parent propagated while this node was culled still apply
+    parentFlags |= _missedParentFlags;
+    _missedParentFlags = 0;
+
     if(_usingNormalizedPosition)
     {
         CCASSERT(_parent, "setNormalizedPosition() doesn't work with orphan nodes");
@@ -1205,8 +1229,13 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
     // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // The stack is shared, so the subtrees visited on worker threads don't use it
+    bool useMatrixStack = !renderer->isParallelRecording();
+    if (useMatrixStack)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
@@ -1215,13 +1244,29 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     if(!_children.empty())
     {
         sortAllChildren();
+        cullChildren();
+
+        // a child visited serially may record its own roots before the lists of these ones are merged,
+        // so the lists of this node start at firstList
+        size_t firstList = 0;
+        bool parallelVisit = useMatrixStack && _director->isParallelVisitEnabled() && visitParallelRoots(renderer, flags, firstList);
+        size_t recordedList = firstList;
+        auto visitChild = [&](Node* child) {
+            if (isCulledChild(child))
+                child->_missedParentFlags |= flags & FLAGS_DIRTY_MASK;
+            else if (parallelVisit && child->_parallelVisitRoot && child->_visible)
+                renderer->mergeRecordedCommands(recordedList++);
+            else
+                child->visit(renderer, _modelViewTransform, flags);
+        };
+
         // draw children zOrder < 0
         for( ; i < _children.size(); i++ )
         {
             auto node = _children.at(i);
 
             if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
+                visitChild(node);
             else
                 break;
         }
@@ -1230,14 +1275,20 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
             this->draw(renderer, _modelViewTransform, flags);
 
         for(auto it=_children.cbegin()+i; it != _children.cend(); ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+            visitChild(*it);
+
+        if (parallelVisit)
+            renderer->releaseRecordedLists(firstList);
     }
     else if (visibleByCamera)
     {
         this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+    {
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1245,6 +1296,85 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+bool Node::visitParallelRoots(Renderer* renderer, uint32_t flags, size_t& firstList)
+{
+    // children are already sorted, so the roots are recorded in the order a serial visit would use
+    _parallelVisitRoots.clear();
+    for (const auto& child : _children)
+    {
+        if (child->_parallelVisitRoot && child->_visible && !isCulledChild(child))
+            _parallelVisitRoots.push_back(child);
+    }
+
+    if (_parallelVisitRoots.size() < 2)
+        return false;
+
+    firstList = renderer->beginParallelRecording(_parallelVisitRoots.size());
+    ThreadPool::getInstance()->parallelFor(_parallelVisitRoots.size(), [this, renderer, flags, firstList](size_t index) {
+        renderer->setRecordingList(firstList + index);
+        _parallelVisitRoots[index]->visit(renderer, _modelViewTransform, flags);
+    });
+    renderer->endParallelRecording();
+    return true;
+}
+
+void Node::cullChildren()
+{
+    if (!_spatialIndex)
+        return;
+
+    _spatialIndex->update();
+
+    // planes in the coordinates of this node, so the bounds of the children are tested without transforming them.
+    // The scene loads the view projection of the visiting camera into the projection stack, which also holds the
+    // projection of a RenderTexture between begin() and end(), so the stack is what the children are drawn with.
+    if (Camera::getVisitingCamera())
+    {
+        Frustum frustum;
+        frustum.initFrustum(_director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _modelViewTransform);
+        _spatialIndex->cull(frustum);
+    }
+    else
+    {
+        _spatialIndex->disableCulling();
+    }
+}
+
+bool Node::isCulledChild(const Node* child) const
+{
+    return _spatialIndex && child->_spatialProxy >= 0 && _spatialIndex->isCulled(child->_spatialProxy);
+}
+
+void Node::setSpatialIndexEnabled(bool enabled, float margin)
+{
+    CC_SAFE_DELETE(_spatialIndex);
+    for (const auto& child : _children)
+        child->_spatialProxy = -1;
+
+    if (enabled)
+    {
+        _spatialIndex = new (std::nothrow) SpatialIndex(margin);
+        for (const auto& child : _children)
+            child->_spatialProxy = _spatialIndex->add(child);
+    }
+}
+
+void Node::invalidateSpatialBounds(Node* child)
+{
+    CCASSERT(child && child->_parent == this, "child must be a child of this node");
+    if (_spatialIndex && child->_spatialProxy >= 0)
+        _spatialIndex->invalidate(child->_spatialProxy);
+}
+
+bool Node::getCullingBounds(AABB* bounds) const
+{
+    if (_contentSize.width == 0 || _contentSize.height == 0)
+        bounds->reset();
+    else
+        bounds->set(Vec3::ZERO, Vec3(_contentSize.width, _contentSize.height, 0));
+    return true;
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -57,6 +57,8 @@ class GLProgramState;
 class Material;
 class Camera;
 class PhysicsBody;
+class SpatialIndex;
+class AABB;
 
 /**
  * @addtogroup _2d
@@ -1457,6 +1459,84 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * @~english Sets whether this node's subtree can be visited on a worker thread.
+     *
+     * When `Director::setParallelVisitEnabled` is on, the parallel roots among the children of a node are visited
+     * concurrently before the node visits its children. Their render commands are recorded in per-thread lists
+     * and merged into the render queues in the same order as a serial visit, so the rendered result does not change.
+     * A typical parallel root is a direct child of the Scene holding thousands of sprites.
+     * The `draw` methods of the nodes in the subtree must only compute their own data and call `Renderer::addCommand`:
+     * they must not push or pop render groups (ClippingNode, RenderTexture...), use the Director matrix stack,
+     * create autoreleased objects or modify other parts of the scene graph.
+     * @~chinese 设置该节点的子树是否可以在工作线程中遍历。
+     *
+     * 当开启`Director::setParallelVisitEnabled`时，一个节点的子节点中的并行根节点会在该节点遍历子节点之前被并发地遍历。
+     * 它们的渲染命令被记录在每个线程独立的列表中，并按照与串行遍历相同的顺序合并到渲染队列中，因此渲染结果不变。
+     * 典型的并行根节点是包含成千上万个精灵的场景直接子节点。
+     * 子树中节点的`draw`方法只能计算自己的数据并调用`Renderer::addCommand`：
+     * 不能入栈或出栈渲染组（ClippingNode、RenderTexture等），不能使用导演的矩阵栈，不能创建autorelease对象，也不能修改场景图的其他部分。
+     *
+     * @param parallelVisitRoot @~english true if the subtree can be visited on a worker thread. @~chinese true 如果子树可以在工作线程中遍历。
+     */
+    void setParallelVisitRoot(bool parallelVisitRoot) { _parallelVisitRoot = parallelVisitRoot; }
+    /**
+     * @~english Whether this node's subtree can be visited on a worker thread.
+     * @~chinese 该节点的子树是否可以在工作线程中遍历。
+     *
+     * @see `setParallelVisitRoot(bool)`
+     */
+    bool isParallelVisitRoot() const { return _parallelVisitRoot; }
+
+    /**
+     * @~english Sets whether the children of this node are culled with a spatial index.
+     *
+     * The bounds of the subtree of each child are kept in a dynamic AABB tree, in the coordinates of this node.
+     * Each frame, the visit walks the tree with the frustum of the current projection, the view projection of the
+     * visiting camera or the projection of a RenderTexture being drawn into, and skips the children whose
+     * subtree is out of sight, before computing any of their transforms. It pays off for a node holding many
+     * children of which most are off-screen, like the layer of a large scrolling world.
+     * The bounds of a child are computed again when its transform, its content size or its number of children
+     * changes. A change deeper in its subtree isn't seen: call `invalidateSpatialBounds` after it, unless it
+     * stays within the margin. A subtree with a node whose `getCullingBounds` returns false is never culled.
+     * @~chinese 设置是否使用空间索引剔除该节点的子节点。
+     *
+     * 每个子节点的子树的包围盒保存在一个动态AABB树中，使用该节点的坐标系。
+     * 每一帧，遍历使用当前投影的视锥体遍历这棵树，即当前摄像机的视图投影或正在绘制的RenderTexture的投影，在计算变换之前跳过子树不可见的子节点。
+     * 适用于拥有大量子节点、其中大部分在屏幕之外的节点，例如一个大型滚动世界的层。
+     * 当子节点的变换、内容大小或子节点数量变化时，它的包围盒会重新计算。它的子树中更深层的变化不会被发现：
+     * 变化之后请调用`invalidateSpatialBounds`，除非变化没有超出边距。子树中有节点的`getCullingBounds`返回false时，该子树永远不会被剔除。
+     *
+     * @param enabled @~english true to cull the children with a spatial index. @~chinese true 使用空间索引剔除子节点。
+     * @param margin @~english How far, in points, the bounds of a child may move before the tree is updated.
+     * @~chinese 子节点的包围盒在更新树之前可以移动的距离，以点为单位。
+     */
+    void setSpatialIndexEnabled(bool enabled, float margin = 8.0f);
+    /**
+     * @~english Whether the children of this node are culled with a spatial index.
+     * @~chinese 是否使用空间索引剔除该节点的子节点。
+     *
+     * @see `setSpatialIndexEnabled(bool, float)`
+     */
+    bool isSpatialIndexEnabled() const { return _spatialIndex != nullptr; }
+    /**
+     * @~english Makes the spatial index compute the bounds of a child again, after a change in its subtree.
+     * @~chinese 在子节点的子树发生变化之后，让空间索引重新计算它的包围盒。
+     *
+     * @param child @~english A child of this node. @~chinese 该节点的一个子节点。
+     */
+    void invalidateSpatialBounds(Node* child);
+    /**
+     * @~english Gets the bounds of what the node draws, in its local coordinates, for spatial culling.
+     * The default is its content rectangle, or an empty box when the content size is zero.
+     * @~chinese 获取节点绘制内容的包围盒，使用节点的本地坐标系，用于空间剔除。默认为节点的内容矩形，内容大小为零时为空的包围盒。
+     *
+     * @param bounds @~english The bounds. @~chinese 包围盒。
+     * @return @~english false if the node can draw outside of any known bounds, it is never culled then.
+     * @~chinese 如果节点可能在任何已知包围盒之外绘制，返回false，这时它永远不会被剔除。
+     */
+    virtual bool getCullingBounds(AABB* bounds) const;
+
 
     /** 
      @~english Returns the Scene that contains the Node.
@@ -2166,6 +2246,12 @@ protected:
 
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
+    // records the parallel roots among the children on worker threads into the lists starting at firstList,
+    // returns false if there is nothing to parallelize
+    bool visitParallelRoots(Renderer* renderer, uint32_t flags, size_t& firstList);
+    // updates the spatial index and culls the children with the current projection
+    void cullChildren();
+    bool isCulledChild(const Node* child) const;
 
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
@@ -2232,6 +2318,7 @@ protected:
     float _globalZOrder;            ///< Global order used to sort the node
 
     Vector<Node*> _children;        ///< array of children nodes
+    std::vector<Node*> _parallelVisitRoots; ///< children visited on worker threads in the current frame, weak references
     Node *_parent;                  ///< weak reference to parent node
     Director* _director;            //cached director pointer to improve rendering performance
     int _tag;                         ///< a tag. Can be any number you assigned just to identify this node
@@ -2256,6 +2343,12 @@ protected:
 
     bool _visible;                  ///< is this node visible
 
+    bool _parallelVisitRoot;        ///< can this node's subtree be visited on a worker thread
+
+    SpatialIndex* _spatialIndex;    ///< culls the children, nullptr when disabled
+    int _spatialProxy;              ///< item of this node in the spatial index of its parent, -1 when none
+    uint32_t _missedParentFlags;    ///< dirty flags of the visits that skipped this node while it was culled
+
     bool _ignoreAnchorPointForPosition; ///< true if the Anchor Vec2 will be (0,0) when you position the Node, false otherwise.
                                           ///< Used by Layer and Scene.
 
@@ -2302,6 +2395,8 @@ public:
 #endif
 
 private:
+    friend class SpatialIndex;
+
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
 
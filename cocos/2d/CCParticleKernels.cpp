@@ -0,0 +1,649 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCParticleKernels.h"
+#include <math.h>
+#include "base/ccTypes.h"
+#include "base/ccMacros.h"
+
+//#define USE_SSE2          : SSE2 code used
+//#define USE_NEON          : neon code used, 4 lanes of 32 bit floats and integers
+//#define USE_NEON64        : neon 64 code used, with the division and the square root instructions
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#elif defined (__arm64__) || defined (__aarch64__)
+#define USE_NEON
+#define USE_NEON64
+#include <arm_neon.h>
+#elif defined (__ARM_NEON__) || defined (__ARM_NEON)
+#define USE_NEON
+#include <arm_neon.h>
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    // the generator of RANDOM_M11: seed = seed * RANDOM_MUL + 1
+    const uint32_t RANDOM_MUL = 134775813u;
+    // four steps at once: seed = seed * RANDOM_MUL4 + RANDOM_INC4
+    const uint32_t RANDOM_MUL4 = RANDOM_MUL * RANDOM_MUL * RANDOM_MUL * RANDOM_MUL;
+    const uint32_t RANDOM_INC4 = RANDOM_MUL * RANDOM_MUL * RANDOM_MUL + RANDOM_MUL * RANDOM_MUL + RANDOM_MUL + 1u;
+
+    const float DEGREES_TO_RADIANS = 0.01745329252f;
+
+    /**
+     A more effect random number getter function, get from ejoy2d.
+     */
+    inline float randomM11(uint32_t *seed)
+    {
+        *seed = *seed * RANDOM_MUL + 1;
+        union {
+            uint32_t d;
+            float f;
+        } u;
+        u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
+        return u.f - 3.0f;
+    }
+
+#if defined (USE_SSE2)
+
+    typedef __m128 float4;
+    typedef __m128 mask4;
+    typedef __m128i int4;
+
+    inline float4 splat(float v) { return _mm_set1_ps(v); }
+    inline float4 load(const float* p) { return _mm_loadu_ps(p); }
+    inline void store(float* p, float4 v) { _mm_storeu_ps(p, v); }
+    inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+    inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+    inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+    inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+    inline float4 invSqrt(float4 a) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(a)); }
+    inline float4 max4(float4 a, float4 b) { return _mm_max_ps(a, b); }
+    inline float4 min4(float4 a, float4 b) { return _mm_min_ps(a, b); }
+    inline mask4 greater(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+    inline mask4 notEqual(float4 a, float4 b) { return _mm_cmpneq_ps(a, b); }
+    inline mask4 both(mask4 a, mask4 b) { return _mm_and_ps(a, b); }
+    inline float4 select(mask4 m, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    inline void deinterleave(float4 a, float4 b, float4* even, float4* odd)
+    {
+        *even = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+        *odd = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+
+    inline int4 splati(int32_t v) { return _mm_set1_epi32(v); }
+    inline int4 loadi(const uint32_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+    inline void storei(void* p, int4 v) { _mm_storeu_si128((__m128i*)p, v); }
+    inline int4 addi(int4 a, int4 b) { return _mm_add_epi32(a, b); }
+    inline int4 subi(int4 a, int4 b) { return _mm_sub_epi32(a, b); }
+    inline int4 andi(int4 a, int4 b) { return _mm_and_si128(a, b); }
+    inline int4 ori(int4 a, int4 b) { return _mm_or_si128(a, b); }
+    inline int4 xori(int4 a, int4 b) { return _mm_xor_si128(a, b); }
+    template <int N> inline int4 shiftLeft(int4 a) { return _mm_slli_epi32(a, N); }
+    inline mask4 equali(int4 a, int4 b) { return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b)); }
+    inline int4 truncate(float4 a) { return _mm_cvttps_epi32(a); }
+    inline float4 toFloat(int4 a) { return _mm_cvtepi32_ps(a); }
+    inline float4 asFloat(int4 a) { return _mm_castsi128_ps(a); }
+    inline int4 asInt(float4 a) { return _mm_castps_si128(a); }
+    inline int4 muli(int4 a, int4 b)
+    {
+        // SSE2 has no 32 bit multiplication keeping the low bits, multiply the even and the odd lanes in 64 bits
+        int4 even = _mm_mul_epu32(a, b);
+        int4 odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+#elif defined (USE_NEON)
+
+    typedef float32x4_t float4;
+    typedef uint32x4_t mask4;
+    typedef int32x4_t int4;
+
+    inline float4 splat(float v) { return vdupq_n_f32(v); }
+    inline float4 load(const float* p) { return vld1q_f32(p); }
+    inline void store(float* p, float4 v) { vst1q_f32(p, v); }
+    inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+    inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+    inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+#if defined (USE_NEON64)
+    inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+    inline float4 invSqrt(float4 a) { return vdivq_f32(vdupq_n_f32(1.0f), vsqrtq_f32(a)); }
+#else
+    inline float4 div4(float4 a, float4 b)
+    {
+        // reciprocal estimate refined by two Newton-Raphson steps
+        float4 r = vrecpeq_f32(b);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        r = vmulq_f32(vrecpsq_f32(b, r), r);
+        return vmulq_f32(a, r);
+    }
+    inline float4 invSqrt(float4 a)
+    {
+        float4 r = vrsqrteq_f32(a);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+        return r;
+    }
+#endif
+    inline float4 max4(float4 a, float4 b) { return vmaxq_f32(a, b); }
+    inline float4 min4(float4 a, float4 b) { return vminq_f32(a, b); }
+    inline mask4 greater(float4 a, float4 b) { return vcgtq_f32(a, b); }
+    inline mask4 notEqual(float4 a, float4 b) { return vmvnq_u32(vceqq_f32(a, b)); }
+    inline mask4 both(mask4 a, mask4 b) { return vandq_u32(a, b); }
+    inline float4 select(mask4 m, float4 a, float4 b) { return vbslq_f32(m, a, b); }
+    inline void deinterleave(float4 a, float4 b, float4* even, float4* odd)
+    {
+        float32x4x2_t t = vuzpq_f32(a, b);
+        *even = t.val[0];
+        *odd = t.val[1];
+    }
+
+    inline int4 splati(int32_t v) { return vdupq_n_s32(v); }
+    inline int4 loadi(const uint32_t* p) { return vld1q_s32((const int32_t*)p); }
+    inline void storei(void* p, int4 v) { vst1q_s32((int32_t*)p, v); }
+    inline int4 addi(int4 a, int4 b) { return vaddq_s32(a, b); }
+    inline int4 subi(int4 a, int4 b) { return vsubq_s32(a, b); }
+    inline int4 andi(int4 a, int4 b) { return vandq_s32(a, b); }
+    inline int4 ori(int4 a, int4 b) { return vorrq_s32(a, b); }
+    inline int4 xori(int4 a, int4 b) { return veorq_s32(a, b); }
+    template <int N> inline int4 shiftLeft(int4 a) { return vshlq_n_s32(a, N); }
+    inline mask4 equali(int4 a, int4 b) { return vceqq_s32(a, b); }
+    inline int4 truncate(float4 a) { return vcvtq_s32_f32(a); }
+    inline float4 toFloat(int4 a) { return vcvtq_f32_s32(a); }
+    inline float4 asFloat(int4 a) { return vreinterpretq_f32_s32(a); }
+    inline int4 asInt(float4 a) { return vreinterpretq_s32_f32(a); }
+    inline int4 muli(int4 a, int4 b) { return vmulq_s32(a, b); }
+
+#endif
+
+#if defined (USE_SSE2) || defined (USE_NEON)
+#define USE_SIMD
+
+    // the seeds RANDOM_M11 uses for the next four numbers, the seed is left at the first of them
+    inline int4 seedLanes(uint32_t* seed)
+    {
+        uint32_t lanes[4];
+        uint32_t s = *seed;
+        for (int k = 0; k < 4; ++k)
+        {
+            s = s * RANDOM_MUL + 1;
+            lanes[k] = s;
+        }
+        return loadi(lanes);
+    }
+
+    inline int4 nextLanes(int4 lanes)
+    {
+        return addi(muli(lanes, splati((int32_t)RANDOM_MUL4)), splati((int32_t)RANDOM_INC4));
+    }
+
+    inline uint32_t lastLane(int4 lanes)
+    {
+        uint32_t values[4];
+        storei(values, lanes);
+        return values[3];
+    }
+
+    inline float4 randomM11(int4 lanes)
+    {
+        int4 bits = ori(shiftLeft<8>(andi(lanes, splati(0x7fff))), splati(0x40000000));
+        return sub4(asFloat(bits), splat(3.0f));
+    }
+
+    inline float4 clamp4(float4 v, float4 minValue, float4 maxValue)
+    {
+        return min4(max4(v, minValue), maxValue);
+    }
+
+    // sine and cosine of four angles in radians, the Cephes polynomials: about 1 ulp from sinf and cosf below 8192
+    inline void sinCos(float4 x, float4* s, float4* c)
+    {
+        int4 bits = asInt(x);
+        int4 sinSign = andi(bits, splati((int32_t)0x80000000));
+        x = asFloat(andi(bits, splati(0x7fffffff)));
+
+        // octant, rounded up to an even one
+        int4 j = truncate(mul4(x, splat(1.27323954473516f)));
+        j = andi(addi(j, splati(1)), splati(~1));
+        float4 y = toFloat(j);
+
+        int4 sinSwap = shiftLeft<29>(andi(j, splati(4)));
+        int4 cosSign = shiftLeft<29>(xori(andi(subi(j, splati(2)), splati(4)), splati(4)));
+        mask4 sinPolynomial = equali(andi(j, splati(2)), splati(0));
+        sinSign = xori(sinSign, sinSwap);
+
+        // x - j * pi / 4, in extended precision
+        x = add4(x, mul4(y, splat(-0.78515625f)));
+        x = add4(x, mul4(y, splat(-2.4187564849853515625e-4f)));
+        x = add4(x, mul4(y, splat(-3.77489497744594108e-8f)));
+        float4 z = mul4(x, x);
+
+        float4 yc = splat(2.443315711809948e-5f);
+        yc = add4(mul4(yc, z), splat(-1.388731625493765e-3f));
+        yc = add4(mul4(yc, z), splat(4.166664568298827e-2f));
+        yc = mul4(mul4(yc, z), z);
+        yc = sub4(yc, mul4(z, splat(0.5f)));
+        yc = add4(yc, splat(1.0f));
+
+        float4 ys = splat(-1.9515295891e-4f);
+        ys = add4(mul4(ys, z), splat(8.3321608736e-3f));
+        ys = add4(mul4(ys, z), splat(-1.6666654611e-1f));
+        ys = add4(mul4(mul4(ys, z), x), x);
+
+        *s = asFloat(xori(asInt(select(sinPolynomial, ys, yc)), sinSign));
+        *c = asFloat(xori(asInt(select(sinPolynomial, yc, ys)), cosSign));
+    }
+
+#endif
+}
+
+bool ParticleKernels::isVectorized()
+{
+#ifdef USE_SIMD
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ParticleKernels::fillRandom(float* values, int count, float base, float variance, uint32_t* seed,
+                                 float minValue, float maxValue)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    if (count >= 4)
+    {
+        const float4 vbase = splat(base);
+        const float4 vvariance = splat(variance);
+        const float4 vmin = splat(minValue);
+        const float4 vmax = splat(maxValue);
+        int4 lanes = seedLanes(seed);
+        for (;;)
+        {
+            store(values + i, clamp4(add4(vbase, mul4(vvariance, randomM11(lanes))), vmin, vmax));
+            i += 4;
+            if (i + 4 > count)
+                break;
+            lanes = nextLanes(lanes);
+        }
+        *seed = lastLane(lanes);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        values[i] = clampf(base + variance * randomM11(seed), minValue, maxValue);
+    }
+}
+
+void ParticleKernels::fillRandomPairs(float* valuesA, float baseA, float varianceA,
+                                      float* valuesB, float baseB, float varianceB, int count, uint32_t* seed)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    if (count >= 4)
+    {
+        const float4 vbaseA = splat(baseA);
+        const float4 vvarianceA = splat(varianceA);
+        const float4 vbaseB = splat(baseB);
+        const float4 vvarianceB = splat(varianceB);
+        int4 lanes = seedLanes(seed);
+        for (;;)
+        {
+            // eight numbers: a0 b0 a1 b1, a2 b2 a3 b3
+            float4 first = randomM11(lanes);
+            lanes = nextLanes(lanes);
+            float4 second = randomM11(lanes);
+            float4 a, b;
+            deinterleave(first, second, &a, &b);
+            store(valuesA + i, add4(vbaseA, mul4(vvarianceA, a)));
+            store(valuesB + i, add4(vbaseB, mul4(vvarianceB, b)));
+            i += 4;
+            if (i + 4 > count)
+                break;
+            lanes = nextLanes(lanes);
+        }
+        *seed = lastLane(lanes);
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        valuesA[i] = baseA + varianceA * randomM11(seed);
+        valuesB[i] = baseB + varianceB * randomM11(seed);
+    }
+}
+
+void ParticleKernels::multiply(float* values, int count, float factor)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 vfactor = splat(factor);
+    for (; i + 4 <= count; i += 4)
+    {
+        store(values + i, mul4(load(values + i), vfactor));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        values[i] *= factor;
+    }
+}
+
+void ParticleKernels::computeDeltas(float* deltas, const float* values, const float* timeToLive, int count)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    for (; i + 4 <= count; i += 4)
+    {
+        store(deltas + i, div4(sub4(load(deltas + i), load(values + i)), load(timeToLive + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        deltas[i] = (deltas[i] - values[i]) / timeToLive[i];
+    }
+}
+
+void ParticleKernels::computeDirections(float* dirX, float* dirY, int count)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 toRadians = splat(DEGREES_TO_RADIANS);
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 s, c;
+        sinCos(mul4(load(dirX + i), toRadians), &s, &c);
+        float4 speed = load(dirY + i);
+        store(dirX + i, mul4(c, speed));
+        store(dirY + i, mul4(s, speed));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float a = dirX[i] * DEGREES_TO_RADIANS;
+        float speed = dirY[i];
+        dirX[i] = cosf(a) * speed;
+        dirY[i] = sinf(a) * speed;
+    }
+}
+
+void ParticleKernels::add(float* values, int count, float value)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 vvalue = splat(value);
+    for (; i + 4 <= count; i += 4)
+    {
+        store(values + i, add4(load(values + i), vvalue));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        values[i] += value;
+    }
+}
+
+void ParticleKernels::integrate(float* values, const float* deltas, int count, float dt, float minValue)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 vdt = splat(dt);
+    const float4 vmin = splat(minValue);
+    for (; i + 4 <= count; i += 4)
+    {
+        store(values + i, max4(add4(load(values + i), mul4(load(deltas + i), vdt)), vmin));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        values[i] = MAX(minValue, values[i] + deltas[i] * dt);
+    }
+}
+
+void ParticleKernels::updateGravityMode(float* posx, float* posy, float* dirX, float* dirY,
+                                        const float* radialAccel, const float* tangentialAccel, int count,
+                                        float dt, float gravityX, float gravityY, float yCoordFlipped)
+{
+    // like the loop of ParticleSystem::update() did, a particle at the origin, or at exactly 1 from it,
+    // gets no radial nor tangential acceleration
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 zero = splat(0.0f);
+    const float4 one = splat(1.0f);
+    const float4 vdt = splat(dt);
+    const float4 gx = splat(gravityX);
+    const float4 gy = splat(gravityY);
+    const float4 flipped = splat(yCoordFlipped);
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 x = load(posx + i);
+        float4 y = load(posy + i);
+        float4 n = add4(mul4(x, x), mul4(y, y));
+        float4 inv = select(both(greater(n, zero), notEqual(n, one)), invSqrt(n), zero);
+        float4 rx = mul4(x, inv);
+        float4 ry = mul4(y, inv);
+
+        float4 radial = load(radialAccel + i);
+        float4 tangential = load(tangentialAccel + i);
+        float4 ax = add4(add4(mul4(rx, radial), mul4(ry, sub4(zero, tangential))), gx);
+        float4 ay = add4(add4(mul4(ry, radial), mul4(rx, tangential)), gy);
+
+        float4 dx = add4(load(dirX + i), mul4(ax, vdt));
+        float4 dy = add4(load(dirY + i), mul4(ay, vdt));
+        store(dirX + i, dx);
+        store(dirY + i, dy);
+        store(posx + i, add4(x, mul4(mul4(dx, vdt), flipped)));
+        store(posy + i, add4(y, mul4(mul4(dy, vdt), flipped)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float x = posx[i];
+        float y = posy[i];
+        float n = x * x + y * y;
+        float rx = 0.0f;
+        float ry = 0.0f;
+        if (n > 0.0f && n != 1.0f)
+        {
+            float inv = 1.0f / sqrtf(n);
+            rx = x * inv;
+            ry = y * inv;
+        }
+
+        float ax = rx * radialAccel[i] + ry * -tangentialAccel[i] + gravityX;
+        float ay = ry * radialAccel[i] + rx * tangentialAccel[i] + gravityY;
+
+        dirX[i] += ax * dt;
+        dirY[i] += ay * dt;
+        posx[i] = x + dirX[i] * dt * yCoordFlipped;
+        posy[i] = y + dirY[i] * dt * yCoordFlipped;
+    }
+}
+
+void ParticleKernels::updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond,
+                                       float* radius, const float* deltaRadius, int count, float dt, float yCoordFlipped)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 zero = splat(0.0f);
+    const float4 vdt = splat(dt);
+    const float4 flipped = splat(yCoordFlipped);
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 a = add4(load(angle + i), mul4(load(degreesPerSecond + i), vdt));
+        float4 r = add4(load(radius + i), mul4(load(deltaRadius + i), vdt));
+        store(angle + i, a);
+        store(radius + i, r);
+
+        float4 s, c;
+        sinCos(a, &s, &c);
+        store(posx + i, mul4(sub4(zero, c), r));
+        store(posy + i, mul4(mul4(sub4(zero, s), r), flipped));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        angle[i] += degreesPerSecond[i] * dt;
+        radius[i] += deltaRadius[i] * dt;
+        posx[i] = - cosf(angle[i]) * radius[i];
+        posy[i] = - sinf(angle[i]) * radius[i] * yCoordFlipped;
+    }
+}
+
+void ParticleKernels::updateQuadVertices(V3F_C4B_T2F_Quad* quads, const float* posx, const float* posy,
+                                         const float* startPosX, const float* startPosY, const float* size,
+                                         const float* rotation, int count, const Offset& offset)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 zero = splat(0.0f);
+    const float4 half = splat(0.5f);
+    const float4 toRadians = splat(DEGREES_TO_RADIANS);
+    const float4 a = splat(offset.a);
+    const float4 b = splat(offset.b);
+    const float4 c = splat(offset.c);
+    const float4 d = splat(offset.d);
+    const float4 tx = splat(offset.tx);
+    const float4 ty = splat(offset.ty);
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 startX = load(startPosX + i);
+        float4 startY = load(startPosY + i);
+        float4 x = add4(load(posx + i), add4(add4(tx, mul4(a, startX)), mul4(c, startY)));
+        float4 y = add4(load(posy + i), add4(add4(ty, mul4(b, startX)), mul4(d, startY)));
+
+        float4 sr, cr;
+        sinCos(sub4(zero, mul4(load(rotation + i), toRadians)), &sr, &cr);
+        float4 size_2 = mul4(load(size + i), half);
+        float4 hc = mul4(size_2, cr);
+        float4 hs = mul4(size_2, sr);
+
+        // corners: a is bottom-left, b bottom-right, c top-right and d top-left
+        float corners[8][4];
+        store(corners[0], add4(sub4(x, hc), hs));
+        store(corners[1], sub4(sub4(y, hs), hc));
+        store(corners[2], add4(add4(x, hc), hs));
+        store(corners[3], sub4(add4(y, hs), hc));
+        store(corners[4], sub4(add4(x, hc), hs));
+        store(corners[5], add4(add4(y, hs), hc));
+        store(corners[6], sub4(sub4(x, hc), hs));
+        store(corners[7], add4(sub4(y, hs), hc));
+        for (int k = 0; k < 4; ++k)
+        {
+            V3F_C4B_T2F_Quad* quad = quads + i + k;
+            quad->bl.vertices.x = corners[0][k];
+            quad->bl.vertices.y = corners[1][k];
+            quad->br.vertices.x = corners[2][k];
+            quad->br.vertices.y = corners[3][k];
+            quad->tr.vertices.x = corners[4][k];
+            quad->tr.vertices.y = corners[5][k];
+            quad->tl.vertices.x = corners[6][k];
+            quad->tl.vertices.y = corners[7][k];
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float x = posx[i] + (offset.tx + offset.a * startPosX[i] + offset.c * startPosY[i]);
+        float y = posy[i] + (offset.ty + offset.b * startPosX[i] + offset.d * startPosY[i]);
+
+        float r = -rotation[i] * DEGREES_TO_RADIANS;
+        float size_2 = size[i] * 0.5f;
+        float hc = size_2 * cosf(r);
+        float hs = size_2 * sinf(r);
+
+        V3F_C4B_T2F_Quad* quad = quads + i;
+        quad->bl.vertices.x = x - hc + hs;
+        quad->bl.vertices.y = y - hs - hc;
+        quad->br.vertices.x = x + hc + hs;
+        quad->br.vertices.y = y + hs - hc;
+        quad->tr.vertices.x = x + hc - hs;
+        quad->tr.vertices.y = y + hs + hc;
+        quad->tl.vertices.x = x - hc - hs;
+        quad->tl.vertices.y = y - hs + hc;
+    }
+}
+
+void ParticleKernels::updateQuadColors(V3F_C4B_T2F_Quad* quads, const float* r, const float* g, const float* b,
+                                       const float* a, int count, bool premultiply)
+{
+    int i = 0;
+#ifdef USE_SIMD
+    const float4 zero = splat(0.0f);
+    const float4 one = splat(1.0f);
+    const float4 scale = splat(255.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        float4 alpha = clamp4(load(a + i), zero, one);
+        float4 red = clamp4(load(r + i), zero, one);
+        float4 green = clamp4(load(g + i), zero, one);
+        float4 blue = clamp4(load(b + i), zero, one);
+        if (premultiply)
+        {
+            red = mul4(red, alpha);
+            green = mul4(green, alpha);
+            blue = mul4(blue, alpha);
+        }
+
+        int32_t components[4][4];
+        storei(components[0], truncate(mul4(red, scale)));
+        storei(components[1], truncate(mul4(green, scale)));
+        storei(components[2], truncate(mul4(blue, scale)));
+        storei(components[3], truncate(mul4(alpha, scale)));
+        for (int k = 0; k < 4; ++k)
+        {
+            Color4B color((GLubyte)components[0][k], (GLubyte)components[1][k], (GLubyte)components[2][k], (GLubyte)components[3][k]);
+            V3F_C4B_T2F_Quad* quad = quads + i + k;
+            quad->bl.colors = color;
+            quad->br.colors = color;
+            quad->tl.colors = color;
+            quad->tr.colors = color;
+        }
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        float alpha = clampf(a[i], 0.0f, 1.0f);
+        float red = clampf(r[i], 0.0f, 1.0f);
+        float green = clampf(g[i], 0.0f, 1.0f);
+        float blue = clampf(b[i], 0.0f, 1.0f);
+        if (premultiply)
+        {
+            red *= alpha;
+            green *= alpha;
+            blue *= alpha;
+        }
+
+        Color4B color((GLubyte)(red * 255), (GLubyte)(green * 255), (GLubyte)(blue * 255), (GLubyte)(alpha * 255));
+        V3F_C4B_T2F_Quad* quad = quads + i;
+        quad->bl.colors = color;
+        quad->br.colors = color;
+        quad->tl.colors = color;
+        quad->tr.colors = color;
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,136 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCPARTICLE_KERNELS_H__
+#define __CCPARTICLE_KERNELS_H__
+
+/// @cond DO_NOT_SHOW
+
+#include <stdint.h>
+#include <float.h>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+struct V3F_C4B_T2F_Quad;
+
+/** @class ParticleKernels
+ * @brief @~english The loops of ParticleSystem and ParticleSystemQuad, working on the arrays of ParticleData.
+ *
+ * Every kernel processes four particles at a time with SSE2 or NEON when the compiler targets them,
+ * and the remaining particles (or all of them on other CPUs) with the equivalent scalar code.
+ * The random numbers are the ones RANDOM_M11 gave before: the vector code jumps the generator four steps ahead
+ * in each lane, so that emitting a particle consumes the same numbers, in the same order, on every CPU.
+ * @~chinese ParticleSystem和ParticleSystemQuad中的循环，处理ParticleData的数组。
+ *
+ * 如果编译器的目标支持SSE2或NEON，每个函数一次处理四个粒子，剩下的粒子（或者在其他CPU上的全部粒子）用等价的标量代码处理。
+ * 随机数与之前RANDOM_M11生成的相同：向量代码在每个通道中让生成器一次前进四步，因此在所有CPU上，发射粒子时按相同的顺序使用相同的随机数。
+ */
+class CC_DLL ParticleKernels
+{
+public:
+    /** @~english How updateQuadVertices() moves the particles: x += tx + a * startX + c * startY, y += ty + b * startX + d * startY.
+     * @~chinese updateQuadVertices()如何移动粒子：x += tx + a * startX + c * startY, y += ty + b * startX + d * startY。
+     */
+    struct Offset
+    {
+        float a, b, c, d;
+        float tx, ty;
+    };
+
+    /** @~english Whether the kernels use SSE2 or NEON in this build.
+     * @~chinese 这次编译中这些函数是否使用了SSE2或NEON。
+     */
+    static bool isVectorized();
+
+    /** @~english Fills values with base + variance * RANDOM_M11(seed), clamped to [minValue, maxValue].
+     * @~chinese 用base + variance * RANDOM_M11(seed)填充数组，并限制在[minValue, maxValue]之内。
+     */
+    static void fillRandom(float* values, int count, float base, float variance, uint32_t* seed,
+                           float minValue = -FLT_MAX, float maxValue = FLT_MAX);
+
+    /** @~english Like fillRandom(), drawing the value of valuesA, then the value of valuesB, for each particle.
+     * @~chinese 与fillRandom()相同，但每个粒子先生成valuesA的值，再生成valuesB的值。
+     */
+    static void fillRandomPairs(float* valuesA, float baseA, float varianceA,
+                                float* valuesB, float baseB, float varianceB, int count, uint32_t* seed);
+
+    /** @~english values *= factor.
+     * @~chinese values *= factor。
+     */
+    static void multiply(float* values, int count, float factor);
+
+    /** @~english Turns the end values stored in deltas into per second deltas: deltas = (deltas - values) / timeToLive.
+     * @~chinese 把deltas中保存的结束值转换成每秒的变化量：deltas = (deltas - values) / timeToLive。
+     */
+    static void computeDeltas(float* deltas, const float* values, const float* timeToLive, int count);
+
+    /** @~english Turns angles in degrees (dirX) and speeds (dirY) into directions.
+     * @~chinese 把角度（dirX，单位为度）和速度（dirY）转换成方向。
+     */
+    static void computeDirections(float* dirX, float* dirY, int count);
+
+    /** @~english values += value.
+     * @~chinese values += value。
+     */
+    static void add(float* values, int count, float value);
+
+    /** @~english values = max(values + deltas * dt, minValue).
+     * @~chinese values = max(values + deltas * dt, minValue)。
+     */
+    static void integrate(float* values, const float* deltas, int count, float dt, float minValue = -FLT_MAX);
+
+    /** @~english Moves the particles of a ParticleSystem in gravity mode.
+     * @~chinese 移动重力模式的粒子。
+     */
+    static void updateGravityMode(float* posx, float* posy, float* dirX, float* dirY,
+                                  const float* radialAccel, const float* tangentialAccel, int count,
+                                  float dt, float gravityX, float gravityY, float yCoordFlipped);
+
+    /** @~english Moves the particles of a ParticleSystem in radius mode.
+     * @~chinese 移动半径模式的粒子。
+     */
+    static void updateRadiusMode(float* posx, float* posy, float* angle, const float* degreesPerSecond,
+                                 float* radius, const float* deltaRadius, int count, float dt, float yCoordFlipped);
+
+    /** @~english Writes the positions of the corners of the quads of rotated particles.
+     * @~chinese 写入旋转后的粒子四边形的顶点位置。
+     */
+    static void updateQuadVertices(V3F_C4B_T2F_Quad* quads, const float* posx, const float* posy,
+                                   const float* startPosX, const float* startPosY, const float* size,
+                                   const float* rotation, int count, const Offset& offset);
+
+    /** @~english Writes the colors of the quads, with the alpha premultiplied when premultiply is true.
+     * The components are clamped to [0, 1].
+     * @~chinese 写入四边形的颜色，premultiply为true时预乘alpha。颜色分量被限制在[0, 1]之内。
+     */
+    static void updateQuadColors(V3F_C4B_T2F_Quad* quads, const float* r, const float* g, const float* b,
+                                 const float* a, int count, bool premultiply);
+};
+
+NS_CC_END
+
+/// @endcond
+
+#endif // __CCPARTICLE_KERNELS_H__
@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include <string>
 
 #include "2d/CCParticleBatchNode.h"
+#include "2d/CCParticleKernels.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
@@ -77,36 +78,6 @@ NS_CC_BEGIN
 //
 
 
-inline void nomalize_point(float x, float y, particle_point* out)
-{
-    float n = x * x + y * y;
-    // Already normalized.
-    if (n == 1.0f)
-        return;
-    
-    n = sqrt(n);
-    // Too close to zero.
-    if (n < MATH_TOLERANCE)
-        return;
-    
-    n = 1.0f / n;
-    out->x = x * n;
-    out->y = y * n;
-}
-
-/**
- A more effect random number getter function, get from ejoy2d.
- */
-inline static float RANDOM_M11(unsigned int *seed) {
-    *seed = *seed * 134775813 + 1;
-    union {
-        uint32_t d;                                     
-        float f;
-    } u;
-    u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
-    return u.f - 3.0f;
-}
-
 ParticleData::ParticleData()
 {
     memset(this, 0, sizeof(ParticleData));
@@ -218,6 +189,12 @@ ParticleSystem::ParticleSystem()
 , _opacityModifyRGB(false)
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
+, _randomSeed(0)
+, _randomState(1)
+, _frameJobPending(false)
+, _frameJobDelta(0)
+, _frameJobTransformsCached(false)
+, _pendingAutoRemove(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -233,6 +210,8 @@ ParticleSystem::ParticleSystem()
     modeB.endRadiusVar = 0;            
     modeB.rotatePerSecond = 0;
     modeB.rotatePerSecondVar = 0;
+
+    setRandomSeed(rand());
 }
 // implementation ParticleSystem
 
@@ -587,35 +566,25 @@ ParticleSystem::~ParticleSystem()
 
 void ParticleSystem::addParticles(int count)
 {
-    uint32_t RANDSEED = rand();
+    // xorshift32 of the emitter gives the seed of the RANDOM_M11 sequence of this emission
+    _randomState ^= _randomState << 13;
+    _randomState ^= _randomState >> 17;
+    _randomState ^= _randomState << 5;
+    uint32_t RANDSEED = _randomState;
 
     int start = _particleCount;
     _particleCount += count;
     
     //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
+    ParticleKernels::fillRandom(_particleData.timeToLive + start, count, _life, _lifeVar, &RANDSEED, 0);
     
     //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-    
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
+    ParticleKernels::fillRandom(_particleData.posx + start, count, _sourcePosition.x, _posVar.x, &RANDSEED);
+    ParticleKernels::fillRandom(_particleData.posy + start, count, _sourcePosition.y, _posVar.y, &RANDSEED);
     
     //color
 #define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
+ParticleKernels::fillRandom(c + start, count, b, v, &RANDSEED, 0, 1);
     
     SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
     SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
@@ -628,10 +597,7 @@ c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
     SET_COLOR(_particleData.deltaColorA, _endColor.a, _endColorVar.a);
     
 #define SET_DELTA_COLOR(c, dc)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
-}
+ParticleKernels::computeDeltas(dc + start, c + start, _particleData.timeToLive + start, count);
     
     SET_DELTA_COLOR(_particleData.colorR, _particleData.deltaColorR);
     SET_DELTA_COLOR(_particleData.colorG, _particleData.deltaColorG);
@@ -639,20 +605,12 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
     
     //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
+    ParticleKernels::fillRandom(_particleData.size + start, count, _startSize, _startSizeVar, &RANDSEED, 0);
     
     if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
     {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
-        }
+        ParticleKernels::fillRandom(_particleData.deltaSize + start, count, _endSize, _endSizeVar, &RANDSEED, 0);
+        ParticleKernels::computeDeltas(_particleData.deltaSize + start, _particleData.size + start, _particleData.timeToLive + start, count);
     }
     else
     {
@@ -663,21 +621,15 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     }
     
     // rotation
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
-    }
+    ParticleKernels::fillRandom(_particleData.rotation + start, count, _startSpin, _startSpinVar, &RANDSEED);
+    ParticleKernels::fillRandom(_particleData.deltaRotation + start, count, _endSpin, _endSpinVar, &RANDSEED);
+    ParticleKernels::computeDeltas(_particleData.deltaRotation + start, _particleData.rotation + start, _particleData.timeToLive + start, count);
     
     // position
     Vec2 pos;
     if (_positionType == PositionType::FREE)
     {
-        pos = this->convertToWorldSpace(Vec2::ZERO);
+        pos = getEmitterWorldPosition();
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -697,43 +649,25 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         
         // radial accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::fillRandom(_particleData.modeA.radialAccel + start, count, modeA.radialAccel, modeA.radialAccelVar, &RANDSEED);
         
         // tangential accel
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::fillRandom(_particleData.modeA.tangentialAccel + start, count, modeA.tangentialAccel, modeA.tangentialAccelVar, &RANDSEED);
+        
+        // direction: the angle in degrees and the speed, then the vector
+        ParticleKernels::fillRandomPairs(_particleData.modeA.dirX + start, _angle, _angleVar,
+                                         _particleData.modeA.dirY + start, modeA.speed, modeA.speedVar, count, &RANDSEED);
+        ParticleKernels::computeDirections(_particleData.modeA.dirX + start, _particleData.modeA.dirY + start, count);
         
         // rotation is dir
         if( modeA.rotationIsDir )
         {
             for (int i = start; i < _particleCount; ++i)
             {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
+                Vec2 dir(_particleData.modeA.dirX[i], _particleData.modeA.dirY[i]);
                 _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(dir.getAngle());
             }
         }
-        else
-        {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
-            }
-        }
         
     }
     
@@ -742,20 +676,13 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         //Need to check by Jacky
         // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
-        }
+        ParticleKernels::fillRandom(_particleData.modeB.radius + start, count, modeB.startRadius, modeB.startRadiusVar, &RANDSEED);
 
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED));
-        }
+        ParticleKernels::fillRandom(_particleData.modeB.angle + start, count, _angle, _angleVar, &RANDSEED);
+        ParticleKernels::multiply(_particleData.modeB.angle + start, count, CC_DEGREES_TO_RADIANS(1.0f));
         
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * RANDOM_M11(&RANDSEED));
-        }
+        ParticleKernels::fillRandom(_particleData.modeB.degreesPerSecond + start, count, modeB.rotatePerSecond, modeB.rotatePerSecondVar, &RANDSEED);
+        ParticleKernels::multiply(_particleData.modeB.degreesPerSecond + start, count, CC_DEGREES_TO_RADIANS(1.0f));
         
         if(modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
         {
@@ -766,11 +693,8 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
         }
         else
         {
-            for (int i = start; i < _particleCount; ++i)
-            {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
-            }
+            ParticleKernels::fillRandom(_particleData.modeB.deltaRadius + start, count, modeB.endRadius, modeB.endRadiusVar, &RANDSEED);
+            ParticleKernels::computeDeltas(_particleData.modeB.deltaRadius + start, _particleData.modeB.radius + start, _particleData.timeToLive + start, count);
         }
     }
 }
@@ -827,11 +751,99 @@ bool ParticleSystem::isFull()
     return (_particleCount == _totalParticles);
 }
 
+void ParticleSystem::setRandomSeed(unsigned int seed)
+{
+    _randomSeed = seed;
+    // xorshift32 never leaves 0
+    _randomState = seed ? seed : 0x9e3779b9;
+}
+
+Vec2 ParticleSystem::getEmitterWorldPosition()
+{
+    return _frameJobTransformsCached ? _frameJobWorldPosition : convertToWorldSpace(Vec2::ZERO);
+}
+
+Mat4 ParticleSystem::getEmitterWorldToNodeTransform()
+{
+    return _frameJobTransformsCached ? _frameJobWorldToNodeTransform : getWorldToNodeTransform();
+}
+
 // ParticleSystem - MainLoop
 void ParticleSystem::update(float dt)
 {
+    auto frameJobQueue = FrameJobQueue::getInstance();
+    if (_director->isParallelParticlesEnabled() && !frameJobQueue->isRunning())
+    {
+        // simulated on a worker thread once the scheduler is done, several updates in a frame are merged
+        if (_frameJobPending)
+        {
+            _frameJobDelta += dt;
+        }
+        else
+        {
+            _frameJobPending = true;
+            _frameJobDelta = dt;
+            // released by finishFrameJob()
+            this->retain();
+            frameJobQueue->push(this);
+        }
+        return;
+    }
+
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    simulate(dt);
+    finishSimulation();
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::prepareFrameJob()
+{
+    // the worker threads must not compute the transforms of the nodes shared with other emitters
+    if (_positionType == PositionType::FREE)
+    {
+        _frameJobWorldPosition = convertToWorldSpace(Vec2::ZERO);
+        _frameJobWorldToNodeTransform = getWorldToNodeTransform();
+        _frameJobTransformsCached = true;
+    }
+}
+
+void ParticleSystem::runFrameJob()
+{
+    simulate(_frameJobDelta);
+}
+
+void ParticleSystem::finishFrameJob()
+{
+    _frameJobPending = false;
+    _frameJobTransformsCached = false;
+    finishSimulation();
+    this->release();
+}
+
+void ParticleSystem::finishSimulation()
+{
+    if (_pendingAutoRemove)
+    {
+        _pendingAutoRemove = false;
+        this->unscheduleUpdate();
+        if (_parent)
+        {
+            _parent->removeChild(this, true);
+        }
+        return;
+    }
+
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+}
+
+void ParticleSystem::simulate(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -857,10 +869,7 @@ void ParticleSystem::update(float dt)
     }
     
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
+        ParticleKernels::add(_particleData.timeToLive, _particleCount, -dt);
         
         for (int i = 0; i < _particleCount; ++i)
         {
@@ -884,8 +893,8 @@ void ParticleSystem::update(float dt)
                 --_particleCount;
                 if( _particleCount == 0 && _isAutoRemoveOnFinish )
                 {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
+                    // removed by finishSimulation() on the main thread
+                    _pendingAutoRemove = true;
                     return;
                 }
             }
@@ -893,113 +902,39 @@ void ParticleSystem::update(float dt)
         
         if (_emitterMode == Mode::GRAVITY)
         {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    nomalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
+            ParticleKernels::updateGravityMode(_particleData.posx, _particleData.posy,
+                                               _particleData.modeA.dirX, _particleData.modeA.dirY,
+                                               _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel,
+                                               _particleCount, dt, modeA.gravity.x, modeA.gravity.y, _yCoordFlipped);
         }
         else
         {
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
+            ParticleKernels::updateRadiusMode(_particleData.posx, _particleData.posy,
+                                              _particleData.modeB.angle, _particleData.modeB.degreesPerSecond,
+                                              _particleData.modeB.radius, _particleData.modeB.deltaRadius,
+                                              _particleCount, dt, _yCoordFlipped);
         }
         
         //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
+        ParticleKernels::integrate(_particleData.colorR, _particleData.deltaColorR, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorG, _particleData.deltaColorG, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorB, _particleData.deltaColorB, _particleCount, dt);
+        ParticleKernels::integrate(_particleData.colorA, _particleData.deltaColorA, _particleCount, dt);
         //size
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
-        }
+        ParticleKernels::integrate(_particleData.size, _particleData.deltaSize, _particleCount, dt, 0);
         //angle
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
-        }
+        ParticleKernels::integrate(_particleData.rotation, _particleData.deltaRotation, _particleCount, dt);
         
         updateParticleQuads();
         _transformSystemDirty = false;
     }
-
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
-    {
-        postStep();
-    }
-
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 }
 
 void ParticleSystem::updateWithNoTime(void)
 {
-    this->update(0.0f);
+    // the batch node needs the quads right away, never defer it
+    simulate(0.0f);
+    finishSimulation();
 }
 
 void ParticleSystem::updateParticleQuads()
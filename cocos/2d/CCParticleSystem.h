@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCProtocols.h"
 #include "2d/CCNode.h"
 #include "base/CCValue.h"
+#include "base/CCFrameJobQueue.h"
 
 NS_CC_BEGIN
 
@@ -235,7 +236,7 @@ It is possible to customize any of the above mentioned properties in runtime. Ex
 #endif
 #endif
 
-class CC_DLL ParticleSystem : public Node, public TextureProtocol
+class CC_DLL ParticleSystem : public Node, public TextureProtocol, public FrameJob
 {
 public:
     /** @~english Mode
@@ -353,6 +354,25 @@ public:
      */
     virtual void updateWithNoTime();
 
+    /** @~english Sets the seed of the random numbers of the emitter. The particles emitted only depend on the settings
+     * of the emitter and on its seed, not on the other emitters nor on Director::setParallelParticlesEnabled().
+     * By default the seed is taken from rand() when the emitter is created.
+     * @~chinese 设置粒子发射器的随机数种子。发射的粒子只取决于发射器的设置和种子，与其他发射器以及
+     * Director::setParallelParticlesEnabled()无关。默认情况下，种子在创建发射器时由rand()生成。
+     *
+     * @param seed @~english The seed.
+     * @~chinese 种子。
+     */
+    void setRandomSeed(unsigned int seed);
+
+    /** @~english Gets the seed of the random numbers of the emitter.
+     * @~chinese 获取粒子发射器的随机数种子。
+     *
+     * @return @~english The seed.
+     * @~chinese 种子。
+     */
+    unsigned int getRandomSeed() const { return _randomSeed; }
+
     /** @~english Whether or not the particle system removed self on finish.
      * @~chinese 获取粒子系统在结束时是否移除自己。
      * 
@@ -1045,6 +1065,11 @@ public:
     virtual void onEnter() override;
     virtual void onExit() override;
     virtual void update(float dt) override;
+    // the particles leave the content size, and with a free position type they don't follow the node
+    virtual bool getCullingBounds(AABB* bounds) const override { return false; }
+    virtual void prepareFrameJob() override;
+    virtual void runFrameJob() override;
+    virtual void finishFrameJob() override;
     virtual Texture2D* getTexture() const override;
     virtual void setTexture(Texture2D *texture) override;    
     virtual void setBlendFunc(const BlendFunc &blendFunc) override;
@@ -1079,6 +1104,20 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    /** Simulates dt seconds: emits, moves and kills the particles, then updates the quads.
+     Only touches the emitter, so that it can run on a worker thread.
+     */
+    virtual void simulate(float dt);
+
+    /** The part of update() that runs on the main thread after simulate(): removes the finished emitter or updates the VBO */
+    virtual void finishSimulation();
+
+    /** convertToWorldSpace(Vec2::ZERO), cached while the emitter is simulated on a worker thread */
+    Vec2 getEmitterWorldPosition();
+
+    /** getWorldToNodeTransform(), cached while the emitter is simulated on a worker thread */
+    Mat4 getEmitterWorldToNodeTransform();
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -1232,6 +1271,20 @@ protected:
      */
     PositionType _positionType;
 
+    /** seed of the random numbers, and state of the generator drawing the seed of each emission */
+    unsigned int _randomSeed;
+    uint32_t _randomState;
+
+    /** the update deferred to FrameJobQueue::run() */
+    bool _frameJobPending;
+    float _frameJobDelta;
+    /** the transforms read by prepareFrameJob() */
+    bool _frameJobTransformsCached;
+    Vec2 _frameJobWorldPosition;
+    Mat4 _frameJobWorldToNodeTransform;
+    /** simulate() found the emitter finished with _isAutoRemoveOnFinish set */
+    bool _pendingAutoRemove;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
@@ -0,0 +1,428 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCRetainedBatchNode.h"
+#include <typeinfo>
+#include "2d/CCSprite.h"
+#include "2d/CCLayer.h"
+#include "base/CCDirector.h"
+#include "base/CCConfiguration.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "deprecated/CCString.h"
+#include "math/MathUtil.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTexture2D.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCGLProgramCache.h"
+#include "platform/CCGL.h"
+
+NS_CC_BEGIN
+
+// the indices are GLushort
+static const size_t MAX_RETAINED_VERTICES = 65536;
+
+RetainedBatchNode* RetainedBatchNode::create()
+{
+    RetainedBatchNode* ret = new (std::nothrow) RetainedBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+RetainedBatchNode::RetainedBatchNode()
+: _spriteGLProgram(nullptr)
+, _frameVertexCount(0)
+, _frameIndexCount(0)
+, _usedRuns(0)
+, _runOpen(false)
+, _emitRuns(false)
+, _worldFlags(0)
+, _bufferSizeChanged(true)
+, _indicesDirty(true)
+, _dirtyVertexStart(0)
+, _dirtyVertexEnd(0)
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+RetainedBatchNode::~RetainedBatchNode()
+{
+    for (auto command : _runCommands)
+    {
+        delete command;
+    }
+    _runCommands.clear();
+
+    if (_buffersVBO[0])
+    {
+        glDeleteBuffers(2, &_buffersVBO[0]);
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+    }
+}
+
+bool RetainedBatchNode::init()
+{
+    // the retained vertices are in the space of this node, so the MV matrix is applied by the shader
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR));
+    // only the sprites using the default shader can be retained
+    _spriteGLProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
+        /** listen the event that renderer was recreated on Android/WP8 */
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+        _bufferSizeChanged = true;
+    });
+
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+std::string RetainedBatchNode::getDescription() const
+{
+    return StringUtils::format("<RetainedBatchNode | Tag = %d, Sprites = %d>", _tag, static_cast<int>(_entries.size()));
+}
+
+void RetainedBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    // quick return if not visible. children won't be drawn.
+    if (!_visible)
+    {
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    bool useMatrixStack = !renderer->isParallelRecording();
+    if (useMatrixStack)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
+
+    _worldFlags = flags;
+    _emitRuns = isVisitableByVisitingCamera();
+    _frameEntries.clear();
+    _frameVertexCount = 0;
+    _frameIndexCount = 0;
+    _usedRuns = 0;
+    _runOpen = false;
+
+    // the descendants are walked with transforms relative to this node:
+    // moving the batch node doesn't dirty them, only their own changes do
+    sortAllChildren();
+    for (auto child : _children)
+    {
+        collectNode(renderer, child, Mat4::IDENTITY);
+    }
+    flushRun(renderer);
+
+    updateBuffers();
+
+    if (useMatrixStack)
+    {
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+}
+
+void RetainedBatchNode::collectNode(Renderer* renderer, Node* node, const Mat4& parentTransform)
+{
+    if (!node->isVisible())
+    {
+        return;
+    }
+
+    auto sprite = dynamic_cast<Sprite*>(node);
+    bool isContainer = typeid(*node) == typeid(Node) || typeid(*node) == typeid(Layer);
+    if (sprite == nullptr && !isContainer)
+    {
+        // anything else draws itself, between the retained runs.
+        // the containers above it may have moved, so its transform is always recomputed
+        flushRun(renderer);
+        node->visit(renderer, _modelViewTransform * parentTransform, _worldFlags | FLAGS_TRANSFORM_DIRTY);
+        return;
+    }
+
+    // the transform and the flags of the node are left alone: they belong to its own visit
+    Mat4 transform = parentTransform * node->getNodeToParentTransform();
+
+    node->sortAllChildren();
+    auto& children = node->getChildren();
+    ssize_t i = 0;
+    for (; i < children.size() && children.at(i)->getLocalZOrder() < 0; ++i)
+    {
+        collectNode(renderer, children.at(i), transform);
+    }
+
+    if (sprite)
+    {
+        collectSprite(renderer, sprite, transform);
+    }
+
+    for (; i < children.size(); ++i)
+    {
+        collectNode(renderer, children.at(i), transform);
+    }
+}
+
+void RetainedBatchNode::collectSprite(Renderer* renderer, Sprite* sprite, const Mat4& transform)
+{
+    const auto& triangles = sprite->getPolygonInfo().triangles;
+    if (triangles.vertCount <= 0 || triangles.indexCount <= 0)
+    {
+        return;
+    }
+
+    if (sprite->getGLProgram() != _spriteGLProgram || _frameVertexCount + triangles.vertCount > MAX_RETAINED_VERTICES)
+    {
+        flushRun(renderer);
+        if (_emitRuns)
+        {
+            sprite->draw(renderer, _modelViewTransform * transform, _worldFlags | FLAGS_TRANSFORM_DIRTY);
+        }
+        return;
+    }
+
+    auto texture = sprite->getTexture();
+    GLuint textureID = texture ? texture->getName() : 0;
+    const BlendFunc& blendFunc = sprite->getBlendFunc();
+
+    if (!_runOpen || _runs[_usedRuns].textureID != textureID || _runs[_usedRuns].blendFunc != blendFunc)
+    {
+        flushRun(renderer);
+        if (_runs.size() <= _usedRuns)
+        {
+            _runs.resize(_usedRuns + 1);
+        }
+        Run& run = _runs[_usedRuns];
+        run.textureID = textureID;
+        run.blendFunc = blendFunc;
+        run.indexStart = _frameIndexCount;
+        run.indexCount = 0;
+        _runOpen = true;
+    }
+
+    Entry entry;
+    entry.sprite = sprite;
+    entry.textureID = textureID;
+    entry.blendFunc = blendFunc;
+    entry.vertexStart = _frameVertexCount;
+    entry.vertexCount = triangles.vertCount;
+    entry.indexStart = _frameIndexCount;
+    entry.indexCount = triangles.indexCount;
+    entry.transform = transform;
+    // the sprite is dirtied by the changes of its color, frame, flip or polygon
+    entry.contentDirty = sprite->isDirty();
+    sprite->setDirty(false);
+    _frameEntries.push_back(entry);
+
+    _frameVertexCount += triangles.vertCount;
+    _frameIndexCount += triangles.indexCount;
+    _runs[_usedRuns].indexCount += triangles.indexCount;
+}
+
+void RetainedBatchNode::flushRun(Renderer* renderer)
+{
+    if (!_runOpen)
+    {
+        return;
+    }
+    _runOpen = false;
+
+    if (!_emitRuns)
+    {
+        return;
+    }
+
+    if (_runCommands.size() <= _usedRuns)
+    {
+        _runCommands.push_back(new (std::nothrow) CustomCommand());
+    }
+    auto command = _runCommands[_usedRuns];
+    command->init(_globalZOrder, _modelViewTransform, _worldFlags);
+    command->func = CC_CALLBACK_0(RetainedBatchNode::onDrawRun, this, _usedRuns, _modelViewTransform);
+    renderer->addCommand(command);
+    ++_usedRuns;
+}
+
+void RetainedBatchNode::updateBuffers()
+{
+    bool layoutChanged = _frameEntries.size() != _entries.size();
+    for (size_t i = 0, count = _frameEntries.size(); i < count && !layoutChanged; ++i)
+    {
+        const Entry& last = _entries[i];
+        const Entry& current = _frameEntries[i];
+        // the offsets only depend on the counts of the previous entries
+        layoutChanged = last.sprite != current.sprite
+            || last.textureID != current.textureID
+            || last.blendFunc != current.blendFunc
+            || last.vertexCount != current.vertexCount
+            || last.indexCount != current.indexCount;
+    }
+
+    if (layoutChanged)
+    {
+        _entries.swap(_frameEntries);
+        _vertices.resize(_frameVertexCount);
+        _indices.resize(_frameIndexCount);
+
+        for (const auto& entry : _entries)
+        {
+            const auto& triangles = entry.sprite->getPolygonInfo().triangles;
+            MathUtil::transformVertices(&_vertices[entry.vertexStart], triangles.verts, entry.vertexCount, entry.transform);
+            MathUtil::transformIndices(&_indices[entry.indexStart], triangles.indices, entry.indexCount, (unsigned short)entry.vertexStart);
+        }
+
+        _bufferSizeChanged = true;
+        _indicesDirty = true;
+        _dirtyVertexStart = 0;
+        _dirtyVertexEnd = _vertices.size();
+        return;
+    }
+
+    // same sprites in the same order: only patch the ones that moved or whose content changed
+    for (size_t i = 0, count = _frameEntries.size(); i < count; ++i)
+    {
+        const Entry& entry = _frameEntries[i];
+        bool transformDirty = memcmp(entry.transform.m, _entries[i].transform.m, sizeof(entry.transform.m)) != 0;
+        if (!transformDirty && !entry.contentDirty)
+        {
+            continue;
+        }
+
+        const auto& triangles = entry.sprite->getPolygonInfo().triangles;
+        MathUtil::transformVertices(&_vertices[entry.vertexStart], triangles.verts, entry.vertexCount, entry.transform);
+        markVerticesDirty(entry);
+
+        if (entry.contentDirty)
+        {
+            MathUtil::transformIndices(&_indices[entry.indexStart], triangles.indices, entry.indexCount, (unsigned short)entry.vertexStart);
+            _indicesDirty = true;
+        }
+    }
+    _entries.swap(_frameEntries);
+}
+
+void RetainedBatchNode::markVerticesDirty(const Entry& entry)
+{
+    if (_dirtyVertexStart == _dirtyVertexEnd)
+    {
+        _dirtyVertexStart = entry.vertexStart;
+        _dirtyVertexEnd = entry.vertexStart + entry.vertexCount;
+    }
+    else
+    {
+        _dirtyVertexStart = std::min(_dirtyVertexStart, entry.vertexStart);
+        _dirtyVertexEnd = std::max(_dirtyVertexEnd, entry.vertexStart + entry.vertexCount);
+    }
+}
+
+void RetainedBatchNode::setupBuffers()
+{
+    if (_buffersVBO[0] == 0)
+    {
+        glGenBuffers(2, &_buffersVBO[0]);
+        _bufferSizeChanged = true;
+    }
+
+    if (_bufferSizeChanged)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        if (_dirtyVertexStart != _dirtyVertexEnd)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * _dirtyVertexStart,
+                            sizeof(V3F_C4B_T2F) * (_dirtyVertexEnd - _dirtyVertexStart), &_vertices[_dirtyVertexStart]);
+        }
+        if (_indicesDirty)
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+            glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(GLushort) * _indices.size(), _indices.data());
+        }
+    }
+
+    _bufferSizeChanged = false;
+    _indicesDirty = false;
+    _dirtyVertexStart = _dirtyVertexEnd = 0;
+}
+
+void RetainedBatchNode::onDrawRun(size_t runIndex, const Mat4& transform)
+{
+    const Run& run = _runs[runIndex];
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+
+    // the first run of the frame uploads what changed since the last one
+    if (runIndex == 0)
+    {
+        setupBuffers();
+    }
+
+    auto glProgram = getGLProgram();
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(transform);
+
+    GL::bindTexture2D(run.textureID);
+    GL::blendFunc(run.blendFunc.src, run.blendFunc.dst);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    // vertex
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, vertices));
+    // color
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, colors));
+    // texcood
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid *)offsetof(V3F_C4B_T2F, texCoords));
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)run.indexCount, GL_UNSIGNED_SHORT, (GLvoid *)(run.indexStart * sizeof(GLushort)));
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, run.indexCount);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
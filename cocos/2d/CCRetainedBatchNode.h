@@ -0,0 +1,152 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCRETAINED_BATCH_NODE_H__
+#define __CCRETAINED_BATCH_NODE_H__
+
+#include <vector>
+#include "2d/CCNode.h"
+#include "base/ccTypes.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class Sprite;
+class GLProgram;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class RetainedBatchNode
+ * @brief @~english A node that keeps the geometry of the sprites in its subtree in persistent vertex buffers.
+ *
+ * Sprites are usually transformed and copied into the renderer's buffers, then uploaded to the GPU, every frame.
+ * The sprites added to a RetainedBatchNode, directly or through plain Node/Layer containers, are transformed
+ * into the space of the RetainedBatchNode once and kept in a vertex buffer object that is only patched for
+ * the sprites whose transform, color or frame changed. Moving the RetainedBatchNode itself does not touch the buffer.
+ * It is meant for large static backgrounds and tile layers.
+ *
+ * Consecutive sprites sharing a texture and a blend function are drawn with one draw call.
+ * Sprites using a custom shader and all the other node types in the subtree are drawn as usual, in the right order.
+ * The global Z order and the camera mask of the retained sprites are the ones of the RetainedBatchNode.
+ * Sprite subclasses that override draw() should not be added to a RetainedBatchNode.
+ * @~chinese 一个把子树中精灵的几何数据保存在持久顶点缓冲区中的节点。
+ *
+ * 通常精灵每帧都会被变换并拷贝到渲染器的缓冲区中，再上传到GPU。
+ * 直接或通过普通的Node/Layer容器加入RetainedBatchNode的精灵，只会被变换到RetainedBatchNode的坐标空间一次，
+ * 并保存在顶点缓冲对象中，只有变换、颜色或帧发生变化的精灵才会更新缓冲区。移动RetainedBatchNode本身不会修改缓冲区。
+ * 适用于大型静态背景和瓦片层。
+ *
+ * 相邻的使用相同纹理和混合函数的精灵会用一次绘制调用完成绘制。
+ * 使用自定义着色器的精灵和子树中其他类型的节点会按正确的顺序正常绘制。
+ * 被保留的精灵使用RetainedBatchNode的全局Z顺序和摄像机掩码。
+ * 重写了draw()的Sprite子类不应该加入RetainedBatchNode。
+ */
+class CC_DLL RetainedBatchNode : public Node
+{
+public:
+    /** @~english Creates a RetainedBatchNode.
+     * @~chinese 创建一个RetainedBatchNode。
+     * @return @~english An autoreleased RetainedBatchNode object.
+     * @~chinese 一个自动释放的RetainedBatchNode对象。
+     */
+    static RetainedBatchNode* create();
+
+    // Overrides
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    RetainedBatchNode();
+    virtual ~RetainedBatchNode();
+    virtual bool init() override;
+
+protected:
+    struct Entry
+    {
+        Sprite* sprite;
+        GLuint textureID;
+        BlendFunc blendFunc;
+        size_t vertexStart;
+        size_t vertexCount;
+        size_t indexStart;
+        size_t indexCount;
+        // the transform of the sprite in the space of this node
+        Mat4 transform;
+        bool contentDirty;
+    };
+
+    struct Run
+    {
+        GLuint textureID;
+        BlendFunc blendFunc;
+        size_t indexStart;
+        size_t indexCount;
+    };
+
+    void collectNode(Renderer* renderer, Node* node, const Mat4& parentTransform);
+    void collectSprite(Renderer* renderer, Sprite* sprite, const Mat4& transform);
+    void markVerticesDirty(const Entry& entry);
+    void flushRun(Renderer* renderer);
+    void updateBuffers();
+    void setupBuffers();
+    void onDrawRun(size_t runIndex, const Mat4& transform);
+
+    GLProgram* _spriteGLProgram;
+
+    // sprites drawn from the buffers, in the order of the last visit and of the current one
+    std::vector<Entry> _entries;
+    std::vector<Entry> _frameEntries;
+    size_t _frameVertexCount;
+    size_t _frameIndexCount;
+
+    std::vector<Run> _runs;
+    std::vector<CustomCommand*> _runCommands;
+    size_t _usedRuns;
+    bool _runOpen;
+    bool _emitRuns;
+    uint32_t _worldFlags;
+
+    // vertices in the space of this node
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::vector<GLushort> _indices;
+
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    bool _bufferSizeChanged;
+    bool _indicesDirty;
+    size_t _dirtyVertexStart;
+    size_t _dirtyVertexEnd;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(RetainedBatchNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCRETAINED_BATCH_NODE_H__
@@ -0,0 +1,531 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCSpatialIndex.h"
+#include <string.h>
+#include <algorithm>
+#include "2d/CCNode.h"
+#include "3d/CCFrustum.h"
+
+NS_CC_BEGIN
+
+// the cost of a box when choosing where to insert a leaf: the sum of its extents works for flat 2D boxes too
+static inline float boxCost(const AABB& box)
+{
+    return (box._max.x - box._min.x) + (box._max.y - box._min.y) + (box._max.z - box._min.z);
+}
+
+static inline AABB mergeBoxes(const AABB& a, const AABB& b)
+{
+    AABB box(a);
+    box.merge(b);
+    return box;
+}
+
+static inline bool containsBox(const AABB& outer, const AABB& inner)
+{
+    return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z
+        && inner._max.x <= outer._max.x && inner._max.y <= outer._max.y && inner._max.z <= outer._max.z;
+}
+
+static bool mergeSubtreeBounds(Node* node, const Mat4& parentToIndex, AABB* bounds, bool* hasBounds)
+{
+    Mat4 nodeToIndex = parentToIndex * node->getNodeToParentTransform();
+
+    AABB box;
+    if (!node->getCullingBounds(&box))
+        return false;
+
+    if (!box.isEmpty())
+    {
+        box.transform(nodeToIndex);
+        if (*hasBounds)
+            bounds->merge(box);
+        else
+            *bounds = box;
+        *hasBounds = true;
+    }
+
+    for (const auto& child : node->getChildren())
+    {
+        if (!mergeSubtreeBounds(child, nodeToIndex, bounds, hasBounds))
+            return false;
+    }
+    return true;
+}
+
+bool SpatialIndex::computeSubtreeBounds(Node* node, AABB* bounds)
+{
+    bool hasBounds = false;
+    return mergeSubtreeBounds(node, Mat4::IDENTITY, bounds, &hasBounds) && hasBounds;
+}
+
+SpatialIndex::SpatialIndex(float margin)
+: _root(NULL_NODE)
+, _freeNode(NULL_NODE)
+, _margin(margin)
+, _stamp(0)
+, _culling(false)
+{
+}
+
+SpatialIndex::~SpatialIndex()
+{
+}
+
+int SpatialIndex::add(Node* node)
+{
+    int item;
+    if (_freeItems.empty())
+    {
+        item = (int)_items.size();
+        _items.push_back(Item());
+    }
+    else
+    {
+        item = _freeItems.back();
+        _freeItems.pop_back();
+    }
+
+    auto& entry = _items[item];
+    entry.node = node;
+    entry.leaf = NULL_NODE;
+    entry.childrenCount = 0;
+    entry.stamp = _stamp - 1;
+    entry.dirty = true;
+    return item;
+}
+
+void SpatialIndex::remove(int item)
+{
+    auto& entry = _items[item];
+    if (entry.leaf != NULL_NODE)
+    {
+        removeLeaf(entry.leaf);
+        freeNode(entry.leaf);
+        entry.leaf = NULL_NODE;
+    }
+    entry.node = nullptr;
+    _freeItems.push_back(item);
+}
+
+void SpatialIndex::clear()
+{
+    _nodes.clear();
+    _root = NULL_NODE;
+    _freeNode = NULL_NODE;
+    _items.clear();
+    _freeItems.clear();
+}
+
+void SpatialIndex::invalidate(int item)
+{
+    _items[item].dirty = true;
+}
+
+void SpatialIndex::update()
+{
+    for (int i = 0, count = (int)_items.size(); i < count; ++i)
+    {
+        auto& entry = _items[i];
+        auto node = entry.node;
+        if (!node)
+            continue;
+
+        // _transformUpdated stays set until the node is visited, the transform tells whether it really moved
+        bool changed = entry.dirty
+            || node->_normalizedPositionDirty
+            || !entry.contentSize.equals(node->_contentSize)
+            || entry.childrenCount != node->_children.size();
+        if (!changed && node->_transformUpdated)
+            changed = memcmp(entry.transform.m, node->getNodeToParentTransform().m, sizeof(entry.transform.m)) != 0;
+
+        if (changed)
+            updateItem(i);
+    }
+}
+
+void SpatialIndex::updateItem(int item)
+{
+    auto& entry = _items[item];
+    auto node = entry.node;
+    entry.transform = node->getNodeToParentTransform();
+    entry.contentSize = node->_contentSize;
+    entry.childrenCount = node->_children.size();
+    entry.dirty = false;
+
+    // the position of a node using a normalized position is only known once it is visited
+    AABB bounds;
+    if (node->_usingNormalizedPosition || !computeSubtreeBounds(node, &bounds))
+    {
+        // never culled
+        if (entry.leaf != NULL_NODE)
+        {
+            removeLeaf(entry.leaf);
+            freeNode(entry.leaf);
+            entry.leaf = NULL_NODE;
+        }
+        return;
+    }
+
+    Vec3 margin(_margin, _margin, _margin);
+    if (entry.leaf != NULL_NODE)
+    {
+        // keep the leaf while it holds the bounds and isn't much larger than them
+        const auto& fatBox = _nodes[entry.leaf].box;
+        if (containsBox(fatBox, bounds) && containsBox(AABB(bounds._min - margin * 4, bounds._max + margin * 4), fatBox))
+            return;
+        removeLeaf(entry.leaf);
+    }
+    else
+    {
+        entry.leaf = allocateNode();
+        _nodes[entry.leaf].item = item;
+    }
+
+    _nodes[entry.leaf].box.set(bounds._min - margin, bounds._max + margin);
+    insertLeaf(entry.leaf);
+}
+
+int SpatialIndex::cull(const Frustum& frustum)
+{
+    _culling = true;
+    ++_stamp;
+
+    int marked = 0;
+    if (_root == NULL_NODE)
+        return marked;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        int index = _stack.back();
+        _stack.pop_back();
+
+        const auto& treeNode = _nodes[index];
+        if (frustum.isOutOfFrustum(treeNode.box))
+            continue;
+
+        if (treeNode.child1 == NULL_NODE)
+        {
+            _items[treeNode.item].stamp = _stamp;
+            ++marked;
+        }
+        else
+        {
+            _stack.push_back(treeNode.child1);
+            _stack.push_back(treeNode.child2);
+        }
+    }
+    return marked;
+}
+
+void SpatialIndex::query(const AABB& box, std::vector<Node*>* nodes) const
+{
+    if (_root == NULL_NODE)
+        return;
+
+    _stack.clear();
+    _stack.push_back(_root);
+    while (!_stack.empty())
+    {
+        int index = _stack.back();
+        _stack.pop_back();
+
+        const auto& treeNode = _nodes[index];
+        if (!treeNode.box.intersects(box))
+            continue;
+
+        if (treeNode.child1 == NULL_NODE)
+        {
+            nodes->push_back(_items[treeNode.item].node);
+        }
+        else
+        {
+            _stack.push_back(treeNode.child1);
+            _stack.push_back(treeNode.child2);
+        }
+    }
+}
+
+int SpatialIndex::allocateNode()
+{
+    int node;
+    if (_freeNode == NULL_NODE)
+    {
+        node = (int)_nodes.size();
+        _nodes.push_back(TreeNode());
+    }
+    else
+    {
+        node = _freeNode;
+        _freeNode = _nodes[node].parent;
+    }
+
+    auto& treeNode = _nodes[node];
+    treeNode.parent = NULL_NODE;
+    treeNode.child1 = NULL_NODE;
+    treeNode.child2 = NULL_NODE;
+    treeNode.height = 0;
+    treeNode.item = -1;
+    return node;
+}
+
+void SpatialIndex::freeNode(int node)
+{
+    _nodes[node].parent = _freeNode;
+    _nodes[node].height = -1;
+    _freeNode = node;
+}
+
+void SpatialIndex::insertLeaf(int leaf)
+{
+    if (_root == NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[_root].parent = NULL_NODE;
+        return;
+    }
+
+    // find the best sibling: descend while creating a parent here costs more than pushing the leaf down
+    const AABB leafBox = _nodes[leaf].box;
+    int index = _root;
+    while (_nodes[index].child1 != NULL_NODE)
+    {
+        const auto& treeNode = _nodes[index];
+        int child1 = treeNode.child1;
+        int child2 = treeNode.child2;
+
+        float area = boxCost(treeNode.box);
+        float combinedArea = boxCost(mergeBoxes(treeNode.box, leafBox));
+
+        // cost of creating a new parent for this node and the new leaf
+        float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float cost1 = boxCost(mergeBoxes(leafBox, _nodes[child1].box));
+        if (_nodes[child1].child1 != NULL_NODE)
+            cost1 -= boxCost(_nodes[child1].box);
+        cost1 += inheritanceCost;
+
+        float cost2 = boxCost(mergeBoxes(leafBox, _nodes[child2].box));
+        if (_nodes[child2].child1 != NULL_NODE)
+            cost2 -= boxCost(_nodes[child2].box);
+        cost2 += inheritanceCost;
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].box = mergeBoxes(leafBox, _nodes[sibling].box);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_NODE)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+
+    // refit the ancestors, keeping the tree balanced
+    index = _nodes[leaf].parent;
+    while (index != NULL_NODE)
+    {
+        index = balance(index);
+
+        int child1 = _nodes[index].child1;
+        int child2 = _nodes[index].child2;
+        _nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+        _nodes[index].box = mergeBoxes(_nodes[child1].box, _nodes[child2].box);
+
+        index = _nodes[index].parent;
+    }
+}
+
+void SpatialIndex::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_NODE)
+    {
+        // the sibling takes the place of the parent
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index != NULL_NODE)
+        {
+            index = balance(index);
+
+            int child1 = _nodes[index].child1;
+            int child2 = _nodes[index].child2;
+            _nodes[index].box = mergeBoxes(_nodes[child1].box, _nodes[child2].box);
+            _nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+
+            index = _nodes[index].parent;
+        }
+    }
+    else
+    {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+// rotates the subtree of a when one of its children is more than one level taller than the other, returns its new root
+int SpatialIndex::balance(int a)
+{
+    auto& nodeA = _nodes[a];
+    if (nodeA.child1 == NULL_NODE || nodeA.height < 2)
+        return a;
+
+    int b = nodeA.child1;
+    int c = nodeA.child2;
+    int balanceFactor = _nodes[c].height - _nodes[b].height;
+
+    // rotate c up
+    if (balanceFactor > 1)
+    {
+        int f = _nodes[c].child1;
+        int g = _nodes[c].child2;
+
+        _nodes[c].child1 = a;
+        _nodes[c].parent = nodeA.parent;
+        nodeA.parent = c;
+
+        if (_nodes[c].parent != NULL_NODE)
+        {
+            if (_nodes[_nodes[c].parent].child1 == a)
+                _nodes[_nodes[c].parent].child1 = c;
+            else
+                _nodes[_nodes[c].parent].child2 = c;
+        }
+        else
+        {
+            _root = c;
+        }
+
+        // the taller grandchild stays under c
+        if (_nodes[f].height > _nodes[g].height)
+        {
+            _nodes[c].child2 = f;
+            nodeA.child2 = g;
+            _nodes[g].parent = a;
+            nodeA.box = mergeBoxes(_nodes[b].box, _nodes[g].box);
+            _nodes[c].box = mergeBoxes(nodeA.box, _nodes[f].box);
+            nodeA.height = 1 + std::max(_nodes[b].height, _nodes[g].height);
+            _nodes[c].height = 1 + std::max(nodeA.height, _nodes[f].height);
+        }
+        else
+        {
+            _nodes[c].child2 = g;
+            nodeA.child2 = f;
+            _nodes[f].parent = a;
+            nodeA.box = mergeBoxes(_nodes[b].box, _nodes[f].box);
+            _nodes[c].box = mergeBoxes(nodeA.box, _nodes[g].box);
+            nodeA.height = 1 + std::max(_nodes[b].height, _nodes[f].height);
+            _nodes[c].height = 1 + std::max(nodeA.height, _nodes[g].height);
+        }
+        return c;
+    }
+
+    // rotate b up
+    if (balanceFactor < -1)
+    {
+        int d = _nodes[b].child1;
+        int e = _nodes[b].child2;
+
+        _nodes[b].child1 = a;
+        _nodes[b].parent = nodeA.parent;
+        nodeA.parent = b;
+
+        if (_nodes[b].parent != NULL_NODE)
+        {
+            if (_nodes[_nodes[b].parent].child1 == a)
+                _nodes[_nodes[b].parent].child1 = b;
+            else
+                _nodes[_nodes[b].parent].child2 = b;
+        }
+        else
+        {
+            _root = b;
+        }
+
+        if (_nodes[d].height > _nodes[e].height)
+        {
+            _nodes[b].child2 = d;
+            nodeA.child1 = e;
+            _nodes[e].parent = a;
+            nodeA.box = mergeBoxes(_nodes[c].box, _nodes[e].box);
+            _nodes[b].box = mergeBoxes(nodeA.box, _nodes[d].box);
+            nodeA.height = 1 + std::max(_nodes[c].height, _nodes[e].height);
+            _nodes[b].height = 1 + std::max(nodeA.height, _nodes[d].height);
+        }
+        else
+        {
+            _nodes[b].child2 = e;
+            nodeA.child1 = d;
+            _nodes[d].parent = a;
+            nodeA.box = mergeBoxes(_nodes[c].box, _nodes[d].box);
+            _nodes[b].box = mergeBoxes(nodeA.box, _nodes[e].box);
+            nodeA.height = 1 + std::max(_nodes[c].height, _nodes[d].height);
+            _nodes[b].height = 1 + std::max(nodeA.height, _nodes[e].height);
+        }
+        return b;
+    }
+
+    return a;
+}
+
+NS_CC_END
@@ -0,0 +1,172 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCSPATIAL_INDEX_H__
+#define __CCSPATIAL_INDEX_H__
+
+/// @cond DO_NOT_SHOW
+
+#include <vector>
+#include "math/CCMath.h"
+#include "math/CCGeometry.h"
+#include "3d/CCAABB.h"
+
+NS_CC_BEGIN
+
+class Node;
+class Frustum;
+
+/** @class SpatialIndex
+ * @brief @~english The bounds of the children of a node, in a dynamic AABB tree, see Node::setSpatialIndexEnabled().
+ *
+ * Each child is an item whose bounds cover its whole subtree, in the coordinates of the node owning the index.
+ * The tree stores the bounds enlarged by a margin, so that small moves don't change the tree. update() only
+ * computes the bounds of the items that were added, invalidated, moved, resized, or whose number of children
+ * changed. cull() walks the tree with the frustum of the camera, marking the items it may see; whole branches
+ * outside the frustum are skipped with one test. Items without bounds (see Node::getCullingBounds()) are never culled.
+ * @~chinese 一个节点的子节点的包围盒，保存在动态AABB树中，参考Node::setSpatialIndexEnabled()。
+ *
+ * 每个子节点是一个条目，它的包围盒覆盖整个子树，使用拥有索引的节点的坐标系。
+ * 树中保存的包围盒按边距放大，因此小的移动不会改变树。update()只计算新加入的、被标记为无效的、移动过的、改变过大小的
+ * 或者子节点数量变化的条目的包围盒。cull()用摄像机的视锥体遍历树，标记可能看到的条目；视锥体之外的整个分支只需一次测试就被跳过。
+ * 没有包围盒的条目（参考Node::getCullingBounds()）永远不会被剔除。
+ */
+class CC_DLL SpatialIndex
+{
+public:
+    explicit SpatialIndex(float margin);
+    ~SpatialIndex();
+
+    /** @~english Adds a node, its bounds are computed by the next update().
+     * @~chinese 加入一个节点，它的包围盒在下一次update()时计算。
+     * @return @~english The item of the node. @~chinese 节点对应的条目。
+     */
+    int add(Node* node);
+
+    /** @~english Removes an item.
+     * @~chinese 删除一个条目。
+     */
+    void remove(int item);
+
+    /** @~english Removes all the items.
+     * @~chinese 删除所有的条目。
+     */
+    void clear();
+
+    /** @~english Makes the next update() compute the bounds of an item, after a change that update() can't see.
+     * @~chinese 让下一次update()重新计算条目的包围盒，用于update()无法发现的变化。
+     */
+    void invalidate(int item);
+
+    /** @~english Computes the bounds of the items that changed since the last update.
+     * @~chinese 计算上次更新以来发生变化的条目的包围盒。
+     */
+    void update();
+
+    /** @~english Marks the items whose bounds may be inside a frustum, given in the coordinates of the index.
+     * Until the next call, isCulled() returns true for the other items.
+     * @~chinese 标记包围盒可能在视锥体之内的条目，视锥体使用索引的坐标系。在下一次调用之前，其他条目的isCulled()返回true。
+     * @return @~english The number of items marked. @~chinese 被标记的条目数量。
+     */
+    int cull(const Frustum& frustum);
+
+    /** @~english Makes isCulled() return false for all the items, until the next cull().
+     * @~chinese 在下一次cull()之前，让所有条目的isCulled()返回false。
+     */
+    void disableCulling() { _culling = false; }
+
+    /** @~english Whether the last cull() found the item outside the frustum.
+     * @~chinese 上一次cull()是否发现条目在视锥体之外。
+     */
+    bool isCulled(int item) const
+    {
+        return _culling && _items[item].leaf != NULL_NODE && _items[item].stamp != _stamp;
+    }
+
+    /** @~english Appends the nodes whose enlarged bounds intersect a box to nodes, items without bounds excluded.
+     * @~chinese 把放大后的包围盒与box相交的节点加入nodes中，没有包围盒的条目除外。
+     */
+    void query(const AABB& box, std::vector<Node*>* nodes) const;
+
+    /** @~english The height of the tree, 0 when it has one leaf or none.
+     * @~chinese 树的高度，只有一个叶子或没有叶子时为0。
+     */
+    int getHeight() const { return _root == NULL_NODE ? 0 : _nodes[_root].height; }
+
+    /** @~english Computes the bounds of a subtree, in the coordinates of the parent of node.
+     * @~chinese 计算一个子树的包围盒，使用node的父节点的坐标系。
+     * @return @~english False if a node of the subtree has no bounds, or if no node draws anything.
+     * @~chinese 如果子树中有节点没有包围盒，或者没有节点绘制任何内容，返回false。
+     */
+    static bool computeSubtreeBounds(Node* node, AABB* bounds);
+
+protected:
+    static const int NULL_NODE = -1;
+
+    struct TreeNode
+    {
+        AABB box;
+        int parent;         // next free node when the node is free
+        int child1;         // NULL_NODE for a leaf
+        int child2;
+        int height;         // 0 for a leaf, -1 when the node is free
+        int item;           // the item of a leaf
+    };
+
+    struct Item
+    {
+        Node* node;         // nullptr when the item is free
+        int leaf;           // NULL_NODE when the item has no bounds yet, or none at all
+        Mat4 transform;     // node to parent transform when the bounds were computed
+        Size contentSize;
+        ssize_t childrenCount;
+        unsigned int stamp;
+        bool dirty;
+    };
+
+    void updateItem(int item);
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+
+    std::vector<TreeNode> _nodes;
+    int _root;
+    int _freeNode;
+
+    std::vector<Item> _items;
+    std::vector<int> _freeItems;
+
+    mutable std::vector<int> _stack;
+    float _margin;
+    unsigned int _stamp;
+    bool _culling;
+};
+
+NS_CC_END
+
+/// @endcond
+
+#endif // __CCSPATIAL_INDEX_H__
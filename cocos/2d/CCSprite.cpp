@@ -438,6 +438,9 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
         _quad.br.vertices.set(x2, y1, 0.0f);
         _quad.tl.vertices.set(x1, y2, 0.0f);
         _quad.tr.vertices.set(x2, y2, 0.0f);
+
+        // seen by the RetainedBatchNode the sprite might be in
+        setDirty(true);
     }
     
     _polyInfo.setQuad(&_quad);
@@ -924,9 +927,7 @@ void Sprite::setFlippedX(bool flippedX)
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.x = _contentSize.width -v.x;
         }
-        if (_textureAtlas) {
-            setDirty(true);
-        }
+        setDirty(true);
     }
 }
 
@@ -944,9 +945,7 @@ void Sprite::setFlippedY(bool flippedY)
             auto& v = _polyInfo.triangles.verts[i].vertices;
             v.y = _contentSize.height -v.y;
         }
-        if (_textureAtlas) {
-            setDirty(true);
-        }
+        setDirty(true);
     }
 }
 
@@ -989,9 +988,11 @@ void Sprite::updateColor(void)
             setDirty(true);
         }
     }
-
-    // self render
-    // do nothing
+    else
+    {
+        // self render: seen by the RetainedBatchNode the sprite might be in
+        setDirty(true);
+    }
 }
 
 void Sprite::setOpacityModifyRGB(bool modify)
@@ -1156,6 +1157,7 @@ PolygonInfo& Sprite::getPolygonInfo()
 void Sprite::setPolygonInfo(const PolygonInfo& info)
 {
     _polyInfo = info;
+    setDirty(true);
 }
 
 NS_CC_END
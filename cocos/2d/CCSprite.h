@@ -408,9 +408,12 @@ public:
 
     /**@~english
      * Whether or not the Sprite needs to be updated in the Atlas.
+     * Sprites that are not in a SpriteBatchNode are also marked dirty when their quad or polygon changes,
+     * which is how a RetainedBatchNode sees the changes of their color or frame.
      *
      * @~chinese 
      * Sprite是否需要在atlas里面更新。
+     * 不在SpriteBatchNode中的精灵在其四边形或多边形改变时也会被标记，RetainedBatchNode据此得知其颜色或帧的变化。
      * 
      * @return @~english True if the sprite needs to be updated in the Atlas, false otherwise.
      * @~chinese 如果需要更新，返回 true；否则返回 false
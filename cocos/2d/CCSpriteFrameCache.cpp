@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrameCache.h"
 
 #include <vector>
+#include <algorithm>
+#include <stdint.h>
 
 
 #include "2d/CCSprite.h"
@@ -44,6 +46,16 @@ THE SOFTWARE.
 
 #include "deprecated/CCString.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+#define CC_SHEET_USE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#define CC_SHEET_USE_MMAP 0
+#endif
+
 
 using namespace std;
 
@@ -108,13 +120,25 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
                                              const std::vector<int> &triangleIndices,
                                              PolygonInfo &info)
 {
-    size_t vertexCount = vertices.size();
-    size_t indexCount = triangleIndices.size();
-    
+    std::vector<unsigned short> indices(triangleIndices.begin(), triangleIndices.end());
+    // the plist lists x,y pairs, vertCount is the number of vertices like for AutoPolygon, not the number of ints
+    initializePolygonInfo(textureSize, spriteSize, vertices.data(), verticesUV.data(), vertices.size() / 2,
+                          indices.data(), indices.size(), info);
+}
+
+void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
+                                             const Size &spriteSize,
+                                             const int *vertices,
+                                             const int *verticesUV,
+                                             size_t vertexCount,
+                                             const unsigned short *triangleIndices,
+                                             size_t indexCount,
+                                             PolygonInfo &info)
+{
     float scaleFactor = CC_CONTENT_SCALE_FACTOR();
 
     V3F_C4B_T2F *vertexData = new V3F_C4B_T2F[vertexCount];
-    for (size_t i = 0; i < vertexCount/2; i++)
+    for (size_t i = 0; i < vertexCount; i++)
     {
         vertexData[i].colors = Color4B::WHITE;
         vertexData[i].vertices = Vec3(vertices[i*2] / scaleFactor,
@@ -125,14 +149,11 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
     }
 
     unsigned short *indexData = new unsigned short[indexCount];
-    for (size_t i = 0; i < indexCount; i++)
-    {
-        indexData[i] = static_cast<unsigned short>(triangleIndices[i]);
-    }
+    memcpy(indexData, triangleIndices, indexCount * sizeof(unsigned short));
 
-    info.triangles.vertCount = vertexCount;
+    info.triangles.vertCount = static_cast<int>(vertexCount);
     info.triangles.verts = vertexData;
-    info.triangles.indexCount = indexCount;
+    info.triangles.indexCount = static_cast<int>(indexCount);
     info.triangles.indices = indexData;
     info.rect = Rect(0, 0, spriteSize.width, spriteSize.height);
 }
@@ -294,12 +315,317 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     CC_SAFE_DELETE(image);
 }
 
+/*
+ Binary sprite sheets (.ccsheet), written by tools/spritesheet/convert_plist_to_ccsheet.py.
+ All values are little endian and 4 byte aligned, offsets are in bytes from the start of the file:
+ - a SheetHeader
+ - frameCount SheetFrame, with the values passed to SpriteFrame::createWithTexture whatever the format of the plist was
+ - aliasCount SheetAlias
+ - the polygons: for each polygon frame, vertexCount pairs of int positions and vertexCount pairs of int texture
+   coordinates at SheetFrame::vertices, and indexCount unsigned short triangle indices at SheetFrame::indices
+ - the strings, NUL terminated, a string is an offset from SheetHeader::strings
+ */
+struct SheetHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    float textureWidth;
+    float textureHeight;
+    uint32_t textureFileName;
+    uint32_t frames;
+    uint32_t aliases;
+    uint32_t strings;
+    uint32_t stringsSize;
+};
+
+struct SheetFrame
+{
+    enum
+    {
+        ROTATED = 1,
+        POLYGON = 2,
+    };
+
+    uint32_t name;
+    float rect[4];
+    float offset[2];
+    float sourceSize[2];
+    uint32_t flags;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t vertices;
+    uint32_t indices;
+};
+
+struct SheetAlias
+{
+    uint32_t name;
+    uint32_t frame;
+};
+
+static_assert(sizeof(SheetHeader) == 44 && sizeof(SheetFrame) == 56 && sizeof(SheetAlias) == 8, "unexpected padding in the .ccsheet structures");
+
+static bool isBinarySheet(const std::string& path)
+{
+    static const std::string extension(".ccsheet");
+    return path.size() > extension.size() && path.compare(path.size() - extension.size(), extension.size(), extension) == 0;
+}
+
+// the content of a .ccsheet file, mapped in memory when possible
+class SheetFile
+{
+public:
+    SheetFile()
+    : _bytes(nullptr)
+    , _size(0)
+    , _mapped(false)
+    {
+    }
+
+    ~SheetFile()
+    {
+#if CC_SHEET_USE_MMAP
+        if (_mapped)
+        {
+            munmap(const_cast<unsigned char*>(_bytes), _size);
+        }
+#endif
+    }
+
+    bool open(const std::string& fullPath)
+    {
+#if CC_SHEET_USE_MMAP
+        // the files inside the apk on Android have relative paths, and are read by FileUtils
+        if (!fullPath.empty() && fullPath[0] == '/')
+        {
+            int fd = ::open(fullPath.c_str(), O_RDONLY);
+            if (fd >= 0)
+            {
+                struct stat st;
+                if (fstat(fd, &st) == 0 && st.st_size > 0)
+                {
+                    void* bytes = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (bytes != MAP_FAILED)
+                    {
+                        _bytes = static_cast<const unsigned char*>(bytes);
+                        _size = st.st_size;
+                        _mapped = true;
+                    }
+                }
+                ::close(fd);
+                if (_mapped)
+                {
+                    return true;
+                }
+            }
+        }
+#endif
+        _data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        _bytes = _data.getBytes();
+        _size = _data.getSize();
+        return !_data.isNull();
+    }
+
+    // returns the header if the blocks it points to are in the file
+    const SheetHeader* getHeader() const
+    {
+        auto header = reinterpret_cast<const SheetHeader*>(_bytes);
+        if (_size < sizeof(SheetHeader) || memcmp(header->magic, "CCSS", 4) != 0 || header->version != 1)
+        {
+            return nullptr;
+        }
+        if (!contains(header->frames, header->frameCount, sizeof(SheetFrame)) ||
+            !contains(header->aliases, header->aliasCount, sizeof(SheetAlias)) ||
+            !contains(header->strings, header->stringsSize, 1) ||
+            header->stringsSize == 0 || _bytes[header->strings + header->stringsSize - 1] != '\0' ||
+            header->textureFileName >= header->stringsSize)
+        {
+            return nullptr;
+        }
+        return header;
+    }
+
+    bool contains(uint32_t offset, uint32_t count, size_t size) const
+    {
+        return offset % 4 == 0 && offset <= _size && count <= (_size - offset) / size;
+    }
+
+    const unsigned char* getBytes() const { return _bytes; }
+
+private:
+    Data _data;
+    const unsigned char* _bytes;
+    size_t _size;
+    bool _mapped;
+};
+
+bool SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& sheet, Texture2D *texture, bool reload)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(sheet);
+    SheetFile file;
+    const SheetHeader* header = nullptr;
+    if (fullPath.empty() || !file.open(fullPath) || !(header = file.getHeader()))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: can not read %s", sheet.c_str());
+        return false;
+    }
+
+    auto bytes = file.getBytes();
+    auto strings = reinterpret_cast<const char*>(bytes + header->strings);
+
+    if (texture == nullptr)
+    {
+        std::string texturePath(strings + header->textureFileName);
+        if (!texturePath.empty())
+        {
+            // build texture path relative to the sheet file
+            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, sheet);
+        }
+        else
+        {
+            // build texture path by replacing file extension
+            texturePath = sheet.substr(0, sheet.find_last_of(".")) + ".png";
+            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+        }
+
+        auto textureCache = Director::getInstance()->getTextureCache();
+        if (!reload)
+            texture = textureCache->addImage(texturePath);
+        else if (textureCache->reloadTexture(texturePath))
+            texture = textureCache->getTextureForKey(texturePath);
+
+        if (texture == nullptr)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            return false;
+        }
+    }
+
+    Size textureSize(header->textureWidth, header->textureHeight);
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    auto frames = reinterpret_cast<const SheetFrame*>(bytes + header->frames);
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        const SheetFrame& frame = frames[i];
+        if (frame.name >= header->stringsSize)
+        {
+            continue;
+        }
+
+        std::string spriteFrameName(strings + frame.name);
+        if (reload)
+        {
+            _spriteFrames.erase(spriteFrameName);
+        }
+        else if (_spriteFrames.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(frame.rect[0], frame.rect[1], frame.rect[2], frame.rect[3]),
+                                                                  (frame.flags & SheetFrame::ROTATED) != 0,
+                                                                  Vec2(frame.offset[0], frame.offset[1]),
+                                                                  Size(frame.sourceSize[0], frame.sourceSize[1]));
+
+        if ((frame.flags & SheetFrame::POLYGON) &&
+            file.contains(frame.vertices, frame.vertexCount, 4 * sizeof(int)) &&
+            file.contains(frame.indices, (frame.indexCount + 1) / 2, 2 * sizeof(unsigned short)))
+        {
+            // the triangles are drawn from the vertices without any check, a bad index would read past them
+            auto indices = reinterpret_cast<const unsigned short*>(bytes + frame.indices);
+            if (std::any_of(indices, indices + frame.indexCount, [&frame](unsigned short index) { return index >= frame.vertexCount; }))
+            {
+                CCLOG("cocos2d: SpriteFrameCache: invalid triangle index in frame %s of %s", spriteFrameName.c_str(), sheet.c_str());
+                continue;
+            }
+
+            auto vertices = reinterpret_cast<const int*>(bytes + frame.vertices);
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, Size(frame.sourceSize[0], frame.sourceSize[1]),
+                                  vertices, vertices + frame.vertexCount * 2, frame.vertexCount,
+                                  indices, frame.indexCount,
+                                  info);
+            spriteFrame->setPolygonInfo(info);
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+        // add sprite frame
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+    }
+    CC_SAFE_DELETE(image);
+
+    auto aliases = reinterpret_cast<const SheetAlias*>(bytes + header->aliases);
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        const SheetAlias& alias = aliases[i];
+        if (alias.name >= header->stringsSize || alias.frame >= header->frameCount || frames[alias.frame].name >= header->stringsSize)
+        {
+            continue;
+        }
+
+        std::string oneAlias(strings + alias.name);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+        _spriteFramesAliases[oneAlias] = Value(strings + frames[alias.frame].name);
+    }
+
+    _loadedFileNames->insert(sheet);
+    return true;
+}
+
+void SpriteFrameCache::removeSpriteFramesFromBinaryFile(const std::string& sheet)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(sheet);
+    SheetFile file;
+    const SheetHeader* header = nullptr;
+    if (fullPath.empty() || !file.open(fullPath) || !(header = file.getHeader()))
+    {
+        CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: can not read %s.", sheet.c_str());
+        return;
+    }
+
+    auto strings = reinterpret_cast<const char*>(file.getBytes() + header->strings);
+    auto frames = reinterpret_cast<const SheetFrame*>(file.getBytes() + header->frames);
+    std::vector<std::string> keysToRemove;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        if (frames[i].name < header->stringsSize)
+        {
+            keysToRemove.push_back(strings + frames[i].name);
+        }
+    }
+    _spriteFrames.erase(keysToRemove);
+
+    _loadedFileNames->erase(sheet);
+}
+
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
     if (_loadedFileNames->find(plist) != _loadedFileNames->end())
     {
         return; // We already added it
     }
+
+    if (isBinarySheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, texture, false);
+        return;
+    }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
@@ -343,7 +669,12 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
-        
+        if (isBinarySheet(plist))
+        {
+            addSpriteFramesWithBinaryFile(plist, nullptr, false);
+            return;
+        }
+
         ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
         string texturePath("");
@@ -465,6 +796,12 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
+    if (isBinarySheet(plist))
+    {
+        removeSpriteFramesFromBinaryFile(plist);
+        return;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
     if (dict.empty())
@@ -673,6 +1010,12 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
         return false;
     }
 
+    if (isBinarySheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(plist, nullptr, true);
+        return true;
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
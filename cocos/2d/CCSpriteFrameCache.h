@@ -86,8 +86,14 @@ class PolygonInfo;
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
+
+ The .plist files can be converted to binary .ccsheet files with tools/spritesheet/convert_plist_to_ccsheet.py.
+ The functions that take a file name load a .ccsheet file in place of a .plist file. The file is memory mapped when
+ the platform allows it, and nothing has to be parsed, so it loads much faster than the .plist file.
  
  * @~chinese 用于加载 SpriteFrame 的单例，缓存所有的 SpriteFrame。
+ * .plist 文件可以用 tools/spritesheet/convert_plist_to_ccsheet.py 转换为二进制的 .ccsheet 文件。
+ * 以文件名为参数的函数可以用 .ccsheet 文件代替 .plist 文件。平台允许时文件会被映射到内存，且无需任何解析，因此加载比 .plist 文件快得多。
  @since v0.9
  @js cc.spriteFrameCache
  */
@@ -329,7 +335,8 @@ protected:
     /** Parses list of space-separated integers */
     void parseIntegerList(const std::string &string, std::vector<int> &res);
     
-    /** Configures PolygonInfo class with the passed sizes + triangles */
+    /** Configures PolygonInfo class with the passed sizes + triangles.
+     * vertices and verticesUV hold x,y pairs, so the triangles get vertices.size() / 2 vertices. */
     void initializePolygonInfo(const Size &textureSize,
                                const Size &spriteSize,
                                const std::vector<int> &vertices,
@@ -337,6 +344,24 @@ protected:
                                const std::vector<int> &triangleIndices,
                                PolygonInfo &polygonInfo);
 
+    /** Configures PolygonInfo class with the passed sizes + vertexCount vertices + indexCount triangle indices.
+     * vertices and verticesUV hold vertexCount x,y pairs each, and triangles.vertCount is set to vertexCount. */
+    void initializePolygonInfo(const Size &textureSize,
+                               const Size &spriteSize,
+                               const int *vertices,
+                               const int *verticesUV,
+                               size_t vertexCount,
+                               const unsigned short *triangleIndices,
+                               size_t indexCount,
+                               PolygonInfo &polygonInfo);
+
+    /** Adds, or replaces when reloading, the frames of a binary .ccsheet file. Without a texture,
+     * the texture named in the file is added, or reloaded, to the texture cache. */
+    bool addSpriteFramesWithBinaryFile(const std::string& sheet, Texture2D *texture, bool reload);
+
+    /** Removes the frames of a binary .ccsheet file */
+    void removeSpriteFramesFromBinaryFile(const std::string& sheet);
+
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture);
 
     Map<std::string, SpriteFrame*> _spriteFrames;
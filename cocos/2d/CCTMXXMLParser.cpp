@@ -634,9 +634,11 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
             
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
             
-            std::string currentString = tmxMapInfo->getCurrentString();
+            const std::string& currentString = tmxMapInfo->getCurrentString();
             unsigned char *buffer;
             auto len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
+            // the text of a large layer is as big as its tiles, free it rather than keep its capacity
+            std::string().swap(_currentString);
             if (!buffer)
             {
                 CCLOG("cocos2d: TiledMap: decode data error");
@@ -668,8 +670,6 @@ void TMXMapInfo::endElement(void *ctx, const char *name)
             {
                 layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
             }
-            
-            tmxMapInfo->setCurrentString("");
         }
         else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribNone)
         {
@@ -706,13 +706,11 @@ void TMXMapInfo::textHandler(void *ctx, const char *ch, int len)
 {
     CC_UNUSED_PARAM(ctx);
     TMXMapInfo *tmxMapInfo = this;
-    std::string text(ch, 0, len);
 
+    // the text of a layer comes in many pieces, append them in place
     if (tmxMapInfo->isStoringCharacters())
     {
-        std::string currentString = tmxMapInfo->getCurrentString();
-        currentString += text;
-        tmxMapInfo->setCurrentString(currentString.c_str());
+        _currentString.append(ch, len);
     }
 }
 
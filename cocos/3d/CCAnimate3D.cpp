@@ -151,74 +151,43 @@ void Animate3D::startWithTarget(Node *target)
     
     if (needReMap)
     {
-        _boneCurves.clear();
-        _nodeCurves.clear();
+        _boneTracks.clear();
+        _nodeTracks.clear();
         
         bool hasCurve = false;
         Sprite3D* sprite = dynamic_cast<Sprite3D*>(target);
         
-        if(sprite)
+        if (_animation)
         {
-            if (_animation)
+            _cursors.assign(_animation->getChannelCount(), 0);
+            auto skin = sprite ? sprite->getSkeleton() : nullptr;
+            const auto& tracks = _animation->getTracks();
+            for (int i = 0; i < (int)tracks.size(); ++i)
             {
-                const std::unordered_map<std::string, Animation3D::Curve*>& boneCurves = _animation->getBoneCurves();
-                for (const auto& iter: boneCurves)
+                const std::string& boneName = tracks[i].name;
+                if (sprite && !skin)
+                    continue;
+
+                auto bone = skin ? skin->getBoneByName(boneName) : nullptr;
+                if (bone)
                 {
-                    const std::string& boneName = iter.first;
-                    auto skin = sprite->getSkeleton();
-                    if(skin)
-                    {
-                        auto bone = skin->getBoneByName(boneName);
-                        if (bone)
-                        {
-                            auto curve = _animation->getBoneCurveByName(boneName);
-                            _boneCurves[bone] = curve;
-                            hasCurve = true;
-                        }
-                        else
-                        {
-                            Node* node = nullptr;
-                            if (target->getName() == boneName)
-                                node = target;
-                            else
-                                node = findChildByNameRecursively(target, boneName);
-                            
-                            if (node)
-                            {
-                                auto curve = _animation->getBoneCurveByName(boneName);
-                                if (curve)
-                                {
-                                    _nodeCurves[node] = curve;
-                                    hasCurve = true;
-                                }
-                            }
-                        }
-                    }
+                    _boneTracks.push_back(std::make_pair(bone, i));
+                    hasCurve = true;
                 }
-            }
-        }
-        else
-        {
-            const std::unordered_map<std::string, Animation3D::Curve*>& boneCurves = _animation->getBoneCurves();
-            for (const auto& iter: boneCurves)
-            {
-                const std::string& boneName = iter.first;
-                Node* node = nullptr;
-                if (target->getName() == boneName)
-                    node = target;
                 else
-                    node = findChildByNameRecursively(target, boneName);
-                
-                if (node)
                 {
-                    auto curve = _animation->getBoneCurveByName(boneName);
-                    if (curve)
+                    Node* node = nullptr;
+                    if (target->getName() == boneName)
+                        node = target;
+                    else
+                        node = findChildByNameRecursively(target, boneName);
+                    
+                    if (node)
                     {
-                        _nodeCurves[node] = curve;
+                        _nodeTracks.push_back(std::make_pair(node, i));
                         hasCurve = true;
                     }
                 }
-                
             }
         }
         
@@ -334,7 +303,6 @@ void Animate3D::update(float t)
             if (_weight > 0.0f)
             {
                 float transDst[3], rotDst[4], scaleDst[3];
-                float* trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse){
                     t = 1 - t;
                     lastTime = 1.0 - lastTime;
@@ -343,46 +311,49 @@ void Animate3D::update(float t)
                 t = _start + t * _last;
                 lastTime = _start + lastTime * _last;
                 
-                for (const auto& it : _boneCurves) {
+                const auto& tracks = _animation->getTracks();
+                unsigned int* cursors = _cursors.data();
+                for (const auto& it : _boneTracks) {
                     auto bone = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
+                    const auto& track = tracks[it.second];
+                    float* trans = nullptr, *rot = nullptr, *scale = nullptr;
+                    if (track.translation >= 0)
                     {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
+                        _animation->sampleVec3(track.translation, t, &cursors[track.translation], _translateEvaluate, transDst);
                         trans = &transDst[0];
                     }
-                    if (curve->rotCurve)
+                    if (track.rotation >= 0)
                     {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
+                        _animation->sampleQuat(track.rotation, t, &cursors[track.rotation], _roteEvaluate, rotDst);
                         rot = &rotDst[0];
                     }
-                    if (curve->scaleCurve)
+                    if (track.scale >= 0)
                     {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
+                        _animation->sampleVec3(track.scale, t, &cursors[track.scale], _scaleEvaluate, scaleDst);
                         scale = &scaleDst[0];
                     }
                     bone->setAnimationValue(trans, rot, scale, this, _weight);
                 }
                 
-                for (const auto& it : _nodeCurves)
+                for (const auto& it : _nodeTracks)
                 {
                     auto node = it.first;
-                    auto curve = it.second;
+                    const auto& track = tracks[it.second];
                     Mat4 transform;
-                    if (curve->translateCurve)
+                    if (track.translation >= 0)
                     {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
+                        _animation->sampleVec3(track.translation, t, &cursors[track.translation], _translateEvaluate, transDst);
                         transform.translate(transDst[0], transDst[1], transDst[2]);
                     }
-                    if (curve->rotCurve)
+                    if (track.rotation >= 0)
                     {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
+                        _animation->sampleQuat(track.rotation, t, &cursors[track.rotation], _roteEvaluate, rotDst);
                         Quaternion qua(rotDst[0], rotDst[1], rotDst[2], rotDst[3]);
                         transform.rotate(qua);
                     }
-                    if (curve->scaleCurve)
+                    if (track.scale >= 0)
                     {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
+                        _animation->sampleVec3(track.scale, t, &cursors[track.scale], _scaleEvaluate, scaleDst);
                         transform.scale(scaleDst[0], scaleDst[1], scaleDst[2]);
                     }
                     node->setAdditionalTransform(&transform);
@@ -310,8 +310,9 @@ protected:
     EvaluateType _scaleEvaluate;
     Animate3DQuality _quality;
     
-    std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves; //weak ref
-    std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
+    std::vector<std::pair<Bone3D*, int>> _boneTracks; //weak ref, bone and index of its track in _animation
+    std::vector<std::pair<Node*, int>> _nodeTracks;
+    std::vector<unsigned int> _cursors; // last key found in each channel of _animation
     
     std::unordered_map<int, ValueMap> _keyFrameUserInfos;
     std::unordered_map<int, EventCustom*> _keyFrameEvent;
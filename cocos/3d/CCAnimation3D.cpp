@@ -23,11 +23,124 @@
  ****************************************************************************/
 
 #include "3d/CCAnimation3D.h"
+#include <algorithm>
+#include <cmath>
 #include "3d/CCBundle3D.h"
 #include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
 
+namespace
+{
+    // keys closer than this to the interpolation of their neighbours are dropped
+    const float VEC3_TOLERANCE = 0.0001f;  // relative to the largest component of the channel
+    const float QUAT_TOLERANCE = 0.0002f;
+
+    const float QUAT_COMPONENT_RANGE = 0.70710678f; // the three smallest components are in [-sqrt(0.5), sqrt(0.5)]
+    const float QUAT_COMPONENT_STEPS = 32767.0f;
+
+    // "smallest three" quaternion: the three smallest components on 15 bits each, the index of the largest one
+    // in the top bits of the first two shorts, the largest component being made positive and computed back
+    void packQuaternion(const Quaternion& quat, unsigned short* dst)
+    {
+        Quaternion q(quat);
+        q.normalize();
+        float c[4] = { q.x, q.y, q.z, q.w };
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (std::fabs(c[i]) > std::fabs(c[largest]))
+                largest = i;
+        }
+        float sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+        int k = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            float v = (c[i] * sign / QUAT_COMPONENT_RANGE) * 0.5f + 0.5f;
+            v = std::min(std::max(v, 0.0f), 1.0f);
+            dst[k++] = (unsigned short)(v * QUAT_COMPONENT_STEPS + 0.5f);
+        }
+        dst[0] |= (unsigned short)((largest & 1) << 15);
+        dst[1] |= (unsigned short)((largest >> 1) << 15);
+    }
+
+    void unpackQuaternion(const unsigned short* src, float* dst)
+    {
+        int largest = (src[0] >> 15) | ((src[1] >> 15) << 1);
+        float sum = 0.0f;
+        int k = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            float v = ((src[k++] & 0x7fff) / QUAT_COMPONENT_STEPS * 2.0f - 1.0f) * QUAT_COMPONENT_RANGE;
+            dst[i] = v;
+            sum += v * v;
+        }
+        dst[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+    }
+
+    float vec3Error(const Vec3& a, const Vec3& b)
+    {
+        return std::max(std::max(std::fabs(a.x - b.x), std::fabs(a.y - b.y)), std::fabs(a.z - b.z));
+    }
+
+    float quatError(const Quaternion& a, const Quaternion& b)
+    {
+        // q and -q are the same rotation
+        float sign = (a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w) < 0.0f ? -1.0f : 1.0f;
+        return std::max(std::max(std::fabs(a.x - b.x * sign), std::fabs(a.y - b.y * sign)),
+                        std::max(std::fabs(a.z - b.z * sign), std::fabs(a.w - b.w * sign)));
+    }
+
+    Vec3 interpolate(const Animation3DData::Vec3Key& from, const Animation3DData::Vec3Key& to, float t)
+    {
+        return from._key + (to._key - from._key) * t;
+    }
+
+    Quaternion interpolate(const Animation3DData::QuatKey& from, const Animation3DData::QuatKey& to, float t)
+    {
+        Quaternion quat;
+        Quaternion::slerp(from._key, to._key, t, &quat);
+        return quat;
+    }
+
+    // Drops the keys reproduced by the interpolation of the keys kept around them, a constant channel keeps one key.
+    template <typename Key, typename Error>
+    std::vector<Key> reduceKeys(const std::vector<Key>& keys, float tolerance, Error error)
+    {
+        std::vector<Key> reduced;
+        reduced.push_back(keys[0]);
+        size_t last = 0;
+        for (size_t i = 1; i + 1 < keys.size(); ++i)
+        {
+            // keep keys[i] if dropping it moves one of the keys since the last kept one
+            const Key& next = keys[i + 1];
+            float span = next._time - keys[last]._time;
+            bool keep = false;
+            for (size_t j = last + 1; j <= i && !keep; ++j)
+            {
+                float t = span > 0.0f ? (keys[j]._time - keys[last]._time) / span : 0.0f;
+                keep = error(interpolate(keys[last], next, t), keys[j]._key) > tolerance;
+            }
+            if (keep)
+            {
+                reduced.push_back(keys[i]);
+                last = i;
+            }
+        }
+        if (keys.size() > 1)
+            reduced.push_back(keys.back());
+
+        if (reduced.size() == 2 && error(reduced[0]._key, reduced[1]._key) <= tolerance)
+            reduced.pop_back();
+        return reduced;
+    }
+}
+
 Animation3D* Animation3D::create(const std::string& fileName, const std::string& animationName)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
@@ -71,6 +184,7 @@ bool Animation3D::initWithFile(const std::string& filename, const std::string& a
 
 Animation3D::Curve* Animation3D::getBoneCurveByName(const std::string& name) const
 {
+    createCurves();
     auto it = _boneCurves.find(name);
     if (it != _boneCurves.end())
         return it->second;
@@ -79,7 +193,8 @@ Animation3D::Curve* Animation3D::getBoneCurveByName(const std::string& name) con
 }
 
 Animation3D::Animation3D()
-: _duration(0)
+: _curvesCreated(false)
+, _duration(0)
 {
     
 }
@@ -109,80 +224,225 @@ bool Animation3D::init(const Animation3DData &data)
 {
     _duration = data._totalTime;
 
-    for(const auto& iter : data._translationKeys)
+    // one track per animated bone, in the order of the names
+    std::map<std::string, Track> tracks;
+    for (const auto& iter : data._translationKeys)
+        tracks[iter.first];
+    for (const auto& iter : data._rotationKeys)
+        tracks[iter.first];
+    for (const auto& iter : data._scaleKeys)
+        tracks[iter.first];
+
+    _tracks.clear();
+    _tracks.reserve(tracks.size());
+    for (const auto& iter : tracks)
     {
-        Curve* curve = _boneCurves[iter.first];
-        if( curve == nullptr)
-        {
-            curve = new (std::nothrow) Curve();
-            _boneCurves[iter.first] = curve;
-        }
-        
-        if(iter.second.size() == 0) continue;
-        std::vector<float> keys;
-        std::vector<float> values;
-        for(const auto& keyIter : iter.second)
-        {
-            keys.push_back(keyIter._time);
-            values.push_back(keyIter._key.x);
-            values.push_back(keyIter._key.y);
-            values.push_back(keyIter._key.z);
-        }
-        
-        curve->translateCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0], (int)keys.size());
-        if(curve->translateCurve) curve->translateCurve->retain();
+        Track track;
+        track.name = iter.first;
+
+        auto translation = data._translationKeys.find(iter.first);
+        track.translation = translation != data._translationKeys.end() ? addVec3Channel(translation->second) : -1;
+        auto rotation = data._rotationKeys.find(iter.first);
+        track.rotation = rotation != data._rotationKeys.end() ? addQuatChannel(rotation->second) : -1;
+        auto scale = data._scaleKeys.find(iter.first);
+        track.scale = scale != data._scaleKeys.end() ? addVec3Channel(scale->second) : -1;
+
+        _tracks.push_back(track);
     }
-    
-    for(const auto& iter : data._rotationKeys)
+
+    _keyTimes.shrink_to_fit();
+    _vec3Values.shrink_to_fit();
+    _quatValues.shrink_to_fit();
+    return true;
+}
+
+int Animation3D::addVec3Channel(const std::vector<Animation3DData::Vec3Key>& keys)
+{
+    if (keys.empty())
+        return -1;
+
+    float largest = 1.0f;
+    for (const auto& key : keys)
+        largest = std::max(largest, std::max(std::max(std::fabs(key._key.x), std::fabs(key._key.y)), std::fabs(key._key.z)));
+    auto reduced = reduceKeys(keys, VEC3_TOLERANCE * largest, vec3Error);
+
+    Channel channel = { (unsigned int)_keyTimes.size(), (unsigned int)_vec3Values.size(), (unsigned int)reduced.size() };
+    for (const auto& key : reduced)
     {
-        Curve* curve = _boneCurves[iter.first];
-        if( curve == nullptr)
+        _keyTimes.push_back(key._time);
+        _vec3Values.push_back(key._key.x);
+        _vec3Values.push_back(key._key.y);
+        _vec3Values.push_back(key._key.z);
+    }
+    _channels.push_back(channel);
+    return (int)_channels.size() - 1;
+}
+
+int Animation3D::addQuatChannel(const std::vector<Animation3DData::QuatKey>& keys)
+{
+    if (keys.empty())
+        return -1;
+
+    auto reduced = reduceKeys(keys, QUAT_TOLERANCE, quatError);
+
+    Channel channel = { (unsigned int)_keyTimes.size(), (unsigned int)_quatValues.size(), (unsigned int)reduced.size() };
+    for (const auto& key : reduced)
+    {
+        _keyTimes.push_back(key._time);
+        _quatValues.resize(_quatValues.size() + 3);
+        packQuaternion(key._key, &_quatValues[_quatValues.size() - 3]);
+    }
+    _channels.push_back(channel);
+    return (int)_channels.size() - 1;
+}
+
+unsigned int Animation3D::findKey(const Channel& channel, float time, unsigned int* cursor) const
+{
+    const float* times = &_keyTimes[channel.firstKey];
+    unsigned int count = channel.keyCount;
+    unsigned int index = *cursor;
+    if (index + 1 >= count)
+        index = 0;
+
+    if (time < times[index] || time >= times[index + 1])
+    {
+        if (time >= times[index + 1] && index + 2 < count && time < times[index + 2])
         {
-            curve = new (std::nothrow) Curve();
-            _boneCurves[iter.first] = curve;
+            // the next key, when playing forward
+            ++index;
         }
-        
-        if(iter.second.size() == 0) continue;
-        std::vector<float> keys;
-        std::vector<float> values;
-        for(const auto& keyIter : iter.second)
+        else
         {
-            keys.push_back(keyIter._time);
-            values.push_back(keyIter._key.x);
-            values.push_back(keyIter._key.y);
-            values.push_back(keyIter._key.z);
-            values.push_back(keyIter._key.w);
+            index = (unsigned int)(std::upper_bound(times + 1, times + count - 1, time) - times) - 1;
         }
-        
-        curve->rotCurve = Curve::AnimationCurveQuat::create(&keys[0], &values[0], (int)keys.size());
-        if(curve->rotCurve) curve->rotCurve->retain();
     }
-    
-    for(const auto& iter : data._scaleKeys)
+
+    *cursor = index;
+    return index;
+}
+
+void Animation3D::sampleVec3(int channelIndex, float time, unsigned int* cursor, EvaluateType type, float* dst) const
+{
+    const Channel& channel = _channels[channelIndex];
+    const float* times = &_keyTimes[channel.firstKey];
+    const float* values = &_vec3Values[channel.firstValue];
+    if (channel.keyCount == 1 || time <= times[0])
+    {
+        dst[0] = values[0], dst[1] = values[1], dst[2] = values[2];
+        return;
+    }
+    if (time >= times[channel.keyCount - 1])
     {
-        Curve* curve = _boneCurves[iter.first];
-        if( curve == nullptr)
+        values += (channel.keyCount - 1) * 3;
+        dst[0] = values[0], dst[1] = values[1], dst[2] = values[2];
+        return;
+    }
+
+    unsigned int index = findKey(channel, time, cursor);
+    float span = times[index + 1] - times[index];
+    float t = span > 0.0f ? (time - times[index]) / span : 0.0f;
+    const float* from = values + index * 3;
+    const float* to = from + 3;
+
+    // the keys INT_NEAR picked may have been dropped, every quality interpolates
+    CC_UNUSED_PARAM(type);
+    for (int i = 0; i < 3; ++i)
+        dst[i] = from[i] + (to[i] - from[i]) * t;
+}
+
+void Animation3D::sampleQuat(int channelIndex, float time, unsigned int* cursor, EvaluateType type, float* dst) const
+{
+    const Channel& channel = _channels[channelIndex];
+    const float* times = &_keyTimes[channel.firstKey];
+    const unsigned short* values = &_quatValues[channel.firstValue];
+    if (channel.keyCount == 1 || time <= times[0])
+    {
+        unpackQuaternion(values, dst);
+        return;
+    }
+    if (time >= times[channel.keyCount - 1])
+    {
+        unpackQuaternion(values + (channel.keyCount - 1) * 3, dst);
+        return;
+    }
+
+    unsigned int index = findKey(channel, time, cursor);
+    float span = times[index + 1] - times[index];
+    float t = span > 0.0f ? (time - times[index]) / span : 0.0f;
+    float from[4], to[4];
+    unpackQuaternion(values + index * 3, from);
+    unpackQuaternion(values + index * 3 + 3, to);
+
+    if (type == EvaluateType::INT_QUAT_SLERP)
+    {
+        Quaternion quat;
+        Quaternion::slerp(Quaternion(from), Quaternion(to), t, &quat);
+        dst[0] = quat.x, dst[1] = quat.y, dst[2] = quat.z, dst[3] = quat.w;
+    }
+    else
+    {
+        // normalized linear interpolation, along the shortest path like slerp
+        float sign = (from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3]) < 0.0f ? -1.0f : 1.0f;
+        float length = 0.0f;
+        for (int i = 0; i < 4; ++i)
         {
-            curve = new (std::nothrow) Curve();
-            _boneCurves[iter.first] = curve;
+            dst[i] = from[i] + (to[i] * sign - from[i]) * t;
+            length += dst[i] * dst[i];
         }
-        
-        if(iter.second.size() == 0) continue;
-        std::vector<float> keys;
-        std::vector<float> values;
-        for(const auto& keyIter : iter.second)
+        float invLength = length > 0.0f ? 1.0f / std::sqrt(length) : 1.0f;
+        for (int i = 0; i < 4; ++i)
+            dst[i] *= invLength;
+    }
+}
+
+void Animation3D::createCurves() const
+{
+    if (_curvesCreated)
+        return;
+    _curvesCreated = true;
+
+    for (const auto& track : _tracks)
+    {
+        Curve* curve = new (std::nothrow) Curve();
+        _boneCurves[track.name] = curve;
+
+        int channels[3] = { track.translation, track.rotation, track.scale };
+        for (int c = 0; c < 3; ++c)
         {
-            keys.push_back(keyIter._time);
-            values.push_back(keyIter._key.x);
-            values.push_back(keyIter._key.y);
-            values.push_back(keyIter._key.z);
+            if (channels[c] < 0)
+                continue;
+
+            const Channel& channel = _channels[channels[c]];
+            std::vector<float> values;
+            if (c == 1)
+            {
+                values.resize(channel.keyCount * 4);
+                for (unsigned int i = 0; i < channel.keyCount; ++i)
+                    unpackQuaternion(&_quatValues[channel.firstValue + i * 3], &values[i * 4]);
+            }
+            else
+            {
+                values.assign(_vec3Values.begin() + channel.firstValue, _vec3Values.begin() + channel.firstValue + channel.keyCount * 3);
+            }
+            float* keys = const_cast<float*>(&_keyTimes[channel.firstKey]);
+
+            if (c == 0)
+            {
+                curve->translateCurve = Curve::AnimationCurveVec3::create(keys, &values[0], (int)channel.keyCount);
+                if(curve->translateCurve) curve->translateCurve->retain();
+            }
+            else if (c == 1)
+            {
+                curve->rotCurve = Curve::AnimationCurveQuat::create(keys, &values[0], (int)channel.keyCount);
+                if(curve->rotCurve) curve->rotCurve->retain();
+            }
+            else
+            {
+                curve->scaleCurve = Curve::AnimationCurveVec3::create(keys, &values[0], (int)channel.keyCount);
+                if(curve->scaleCurve) curve->scaleCurve->retain();
+            }
         }
-        
-        curve->scaleCurve = Curve::AnimationCurveVec3::create(&keys[0], &values[0], (int)keys.size());
-        if(curve->scaleCurve) curve->scaleCurve->retain();
     }
-    
-    return true;
 }
 
 ////////////////////////////////////////////////////////////////
@@ -111,7 +111,52 @@ public:
      * @return @~english The bone curves set.
      * @~chinese 骨骼曲线的集合
      */
-    const std::unordered_map<std::string, Curve*>& getBoneCurves() const {return _boneCurves;}
+    const std::unordered_map<std::string, Curve*>& getBoneCurves() const { createCurves(); return _boneCurves; }
+
+    /// @cond DO_NOT_SHOW
+
+    /**
+     * @~english A bone, or a node, animated by the animation. The channels are the indices of its translation,
+     * rotation and scale keys for the sample functions, -1 when they are not animated.
+     * @~chinese 被动画驱动的骨骼或节点。通道是平移、旋转和缩放关键帧在采样函数中的索引，没有动画时为-1。
+     */
+    struct Track
+    {
+        std::string name;
+        int translation;
+        int rotation;
+        int scale;
+    };
+
+    /**
+     * @~english Get the bones and nodes animated by the animation.
+     * @~chinese 获取被动画驱动的骨骼和节点。
+     */
+    const std::vector<Track>& getTracks() const { return _tracks; }
+
+    /**
+     * @~english Get the number of channels of all the tracks.
+     * @~chinese 获取所有轨道的通道数。
+     */
+    ssize_t getChannelCount() const { return _channels.size(); }
+
+    /**
+     * @~english Sample a translation or scale channel at time (0 - 1).
+     * @~chinese 在时间time (0 - 1)采样一个平移或缩放通道。
+     * @param cursor @~english The key found by the last sample of this channel, updated, 0 at first.
+     * @~chinese 上次采样这个通道时找到的关键帧，会被更新，初始为0。
+     */
+    void sampleVec3(int channel, float time, unsigned int* cursor, EvaluateType type, float* dst) const;
+
+    /**
+     * @~english Sample a rotation channel at time (0 - 1).
+     * @~chinese 在时间time (0 - 1)采样一个旋转通道。
+     * @param cursor @~english The key found by the last sample of this channel, updated, 0 at first.
+     * @~chinese 上次采样这个通道时找到的关键帧，会被更新，初始为0。
+     */
+    void sampleQuat(int channel, float time, unsigned int* cursor, EvaluateType type, float* dst) const;
+
+    /// @endcond
     
 CC_CONSTRUCTOR_ACCESS:
     /**
@@ -147,7 +192,30 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithFile(const std::string& filename, const std::string& animationName);
     
 protected:
-    std::unordered_map<std::string, Curve*> _boneCurves;//bone curves map, key bone name, value AnimationCurve
+    // keys of a channel in the packed arrays
+    struct Channel
+    {
+        unsigned int firstKey;   // in _keyTimes
+        unsigned int firstValue; // in _vec3Values, or in _quatValues
+        unsigned int keyCount;
+    };
+
+    int addVec3Channel(const std::vector<Animation3DData::Vec3Key>& keys);
+    int addQuatChannel(const std::vector<Animation3DData::QuatKey>& keys);
+    // index of the key before time, time being strictly between the first key and the last one
+    unsigned int findKey(const Channel& channel, float time, unsigned int* cursor) const;
+    // creates the curves from the packed keys, for getBoneCurves() and getBoneCurveByName()
+    void createCurves() const;
+
+    mutable std::unordered_map<std::string, Curve*> _boneCurves;//bone curves map, key bone name, value AnimationCurve
+    mutable bool _curvesCreated;
+
+    // the keys of all the tracks, the channels of a track next to each other
+    std::vector<Track> _tracks;
+    std::vector<Channel> _channels;
+    std::vector<float> _keyTimes;
+    std::vector<float> _vec3Values;             // 3 floats per key
+    std::vector<unsigned short> _quatValues;    // 3 shorts per key, see packQuaternion() in CCAnimation3D.cpp
 
     float _duration; //animation duration
 };
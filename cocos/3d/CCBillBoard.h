@@ -135,6 +135,9 @@ public:
     
     /** update billboard's transform and turn it towards camera */
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+
+    /** the billboard is turned towards the camera, so its node to parent transform doesn't bound it */
+    virtual bool getCullingBounds(AABB* bounds) const override { return false; }
     
     /** 
      * draw BillBoard object.
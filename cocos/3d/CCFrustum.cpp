@@ -30,9 +30,17 @@ NS_CC_BEGIN
 bool Frustum::initFrustum(const Camera* camera)
 {
     _initialized = true;
-    createPlane(camera);
+    createPlane(camera->getViewProjectionMatrix());
     return true;
 }
+
+bool Frustum::initFrustum(const Mat4& viewProjection)
+{
+    _initialized = true;
+    createPlane(viewProjection);
+    return true;
+}
+
 bool Frustum::isOutOfFrustum(const AABB& aabb) const
 {
     if (_initialized)
@@ -79,9 +87,8 @@ bool Frustum::isOutOfFrustum(const OBB& obb) const
     return  false;
 }
 
-void Frustum::createPlane(const Camera* camera)
+void Frustum::createPlane(const Mat4& mat)
 {
-    const Mat4& mat = camera->getViewProjectionMatrix();
     //ref http://www.lighthouse3d.com/tutorials/view-frustum-culling/clip-space-approach-extracting-the-planes/
     //extract frustum plane
     _plane[0].initPlane(-Vec3(mat.m[3] + mat.m[0], mat.m[7] + mat.m[4], mat.m[11] + mat.m[8]), (mat.m[15] + mat.m[12]));//left
@@ -72,6 +72,17 @@ public:
      */
     bool initFrustum(const Camera* camera);
 
+    /**
+     * @~english Init frustum from a view projection matrix. With the view projection matrix of a camera multiplied by
+     * the model view transform of a node, the planes are in the coordinates of the node.
+     * @~chinese 通过视图投影矩阵来初始化平截头体。使用相机的视图投影矩阵乘以节点的模型视图变换时，平面使用节点的坐标系。
+     * @param viewProjection @~english The specified view projection matrix.
+     * @~chinese 指定的视图投影矩阵
+     * @return @~english Return true if success, otherwise return false.
+     * @~chinese 创建成功返回true，反之返回false
+     */
+    bool initFrustum(const Mat4& viewProjection);
+
     /**
      * @~english Check an AABB whether out of frustum or not.
      * @~chinese 检查一个AABB包围盒是否在平截头体之外
@@ -110,7 +121,7 @@ protected:
     /**
      * create clip plane
      */
-    void createPlane(const Camera* camera);
+    void createPlane(const Mat4& mat);
 
     Plane _plane[6];             // clip plane, left, right, top, bottom, near, far
     bool _clipZ;                // use near and far clip plane
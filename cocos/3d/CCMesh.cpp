@@ -132,6 +132,7 @@ Mesh::Mesh()
 , _visibleChanged(nullptr)
 , _blendDirty(true)
 , _force2DQueue(false)
+, _instancingEnabled(false)
 , _texFile("")
 {
     
@@ -382,6 +383,18 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
     if (isTransparent)
         flags |= Node::FLAGS_RENDER_AS_3D;
 
+    // opaque meshes sharing their mesh and their program may be drawn together
+    const auto scene = Director::getInstance()->getRunningScene();
+    bool isLit = scene && scene->getLights().size() > 0 && hasVertexAttrib(GLProgram::VERTEX_ATTRIB_NORMAL);
+    if (_instancingEnabled && !isTransparent && !_skin && !_force2DQueue && !isLit
+        && _material->getTechnique()->getPassCount() == 1)
+    {
+        _material->getStateBlock()->setDepthWrite(true);
+        _material->getStateBlock()->setBlend(false);
+        if (renderer->addMeshInstance(globalZ, _material, _meshIndexData, transform, color, flags))
+            return;
+    }
+
     _meshCommand.init(globalZ,
                       _material,
                       getVertexBuffer(),
@@ -406,7 +419,6 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
 
     // set default uniforms for Mesh
     // 'u_color' and others
-    const auto scene = Director::getInstance()->getRunningScene();
     auto technique = _material->_currentTechnique;
     for(const auto pass : technique->_passes)
     {
@@ -383,6 +383,23 @@ public:
      */
     void setForce2DQueue(bool force2D) { _force2DQueue = force2D; }
 
+    /**
+     * @brief @~english Draws the mesh as an instance through Renderer::addMeshInstance(), together with the other
+     * instances of its mesh and its program, when it is opaque, not skinned, not lit by the lights of the scene and
+     * its material has one pass. The instances share the render state and the uniforms of the first one, except
+     * the matrices and u_color.
+     * @~chinese 当网格不透明、没有蒙皮、不受场景中灯光影响并且材质只有一个pass时，通过Renderer::addMeshInstance()
+     * 把网格作为实例，与使用相同网格和着色器程序的其他实例一起绘制。实例共享第一个实例的渲染状态和uniform，矩阵和u_color除外。
+     * @param enabled @~english Whether instancing is enabled, false by default. @~chinese 是否启用实例化，默认为false。
+     */
+    void setInstancingEnabled(bool enabled) { _instancingEnabled = enabled; }
+
+    /**
+     * @brief @~english Whether the mesh may be drawn as an instance.
+     * @~chinese 网格是否可以作为实例绘制。
+     */
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
     /**
      * @brief @~english Return texture file name.
      * @~chinese 返回素材图片文件名。
@@ -405,6 +422,7 @@ protected:
     bool                _visible; // is the submesh visible
     bool                _isTransparent; // is this mesh transparent, it is a property of material in fact
     bool                _force2DQueue; // add this mesh to 2D render queue
+    bool                _instancingEnabled; // draw this mesh through Renderer::addMeshInstance when possible
     
     std::string         _name;
     MeshCommand         _meshCommand;
@@ -27,14 +27,63 @@
 #include "3d/CCBundle3D.h"
 #include "3d/CCSkeleton3D.h"
 
+//#define USE_SSE2          : SSE2 code used
+//#define USE_NEON          : neon code used
+
+#if defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USE_SSE2
+#include <emmintrin.h>
+#elif defined (__arm64__) || defined (__aarch64__) || defined (__ARM_NEON__) || defined (__ARM_NEON)
+#define USE_NEON
+#include <arm_neon.h>
+#endif
+
 NS_CC_BEGIN
 
 static int PALETTE_ROWS = 3;
 
+// Writes the first three rows of world * invBindPose, the rows of invBindPose being given.
+// Row r of the product is the sum over k of world[r][k] * invBindPose row k.
+static inline void computePaletteRows(const float* world, const Vec4* invBindPoseRows, Vec4* palette)
+{
+#if defined (USE_SSE2)
+    __m128 row0 = _mm_loadu_ps(&invBindPoseRows[0].x);
+    __m128 row1 = _mm_loadu_ps(&invBindPoseRows[1].x);
+    __m128 row2 = _mm_loadu_ps(&invBindPoseRows[2].x);
+    __m128 row3 = _mm_loadu_ps(&invBindPoseRows[3].x);
+    for (int r = 0; r < 3; ++r)
+    {
+        __m128 a = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(world[r]), row0), _mm_mul_ps(_mm_set1_ps(world[4 + r]), row1));
+        __m128 b = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(world[8 + r]), row2), _mm_mul_ps(_mm_set1_ps(world[12 + r]), row3));
+        _mm_storeu_ps(&palette[r].x, _mm_add_ps(a, b));
+    }
+#elif defined (USE_NEON)
+    float32x4_t row0 = vld1q_f32(&invBindPoseRows[0].x);
+    float32x4_t row1 = vld1q_f32(&invBindPoseRows[1].x);
+    float32x4_t row2 = vld1q_f32(&invBindPoseRows[2].x);
+    float32x4_t row3 = vld1q_f32(&invBindPoseRows[3].x);
+    for (int r = 0; r < 3; ++r)
+    {
+        float32x4_t v = vmulq_n_f32(row0, world[r]);
+        v = vmlaq_n_f32(v, row1, world[4 + r]);
+        v = vmlaq_n_f32(v, row2, world[8 + r]);
+        v = vmlaq_n_f32(v, row3, world[12 + r]);
+        vst1q_f32(&palette[r].x, v);
+    }
+#else
+    for (int r = 0; r < 3; ++r)
+    {
+        palette[r] = invBindPoseRows[0] * world[r] + invBindPoseRows[1] * world[4 + r]
+                   + invBindPoseRows[2] * world[8 + r] + invBindPoseRows[3] * world[12 + r];
+    }
+#endif
+}
+
 MeshSkin::MeshSkin()
 : _rootBone(nullptr)
 , _skeleton(nullptr)
 , _matrixPalette(nullptr)
+, _paletteVersion(0)
 {
     
 }
@@ -102,16 +151,32 @@ Vec4* MeshSkin::getMatrixPalette()
     if (_matrixPalette == nullptr)
     {
         _matrixPalette = new (std::nothrow) Vec4[_skinBones.size() * PALETTE_ROWS];
+        _paletteVersion = 0;
+    }
+
+    // the skeleton did not evaluate a new pose since the palette was computed
+    unsigned int poseVersion = _skeleton->getPoseVersion();
+    if (_paletteVersion != 0 && _paletteVersion == poseVersion)
+        return _matrixPalette;
+
+    if (_invBindPoseRows.size() != _invBindPoses.size() * 4)
+    {
+        _invBindPoseRows.resize(_invBindPoses.size() * 4);
+        for (size_t i = 0; i < _invBindPoses.size(); ++i)
+        {
+            const float* m = _invBindPoses[i].m;
+            for (int k = 0; k < 4; ++k)
+                _invBindPoseRows[i * 4 + k].set(m[k], m[4 + k], m[8 + k], m[12 + k]);
+        }
     }
-    int i = 0, paletteIndex = 0;
-    static Mat4 t;
+
+    int i = 0;
     for (auto it : _skinBones )
     {
-        Mat4::multiply(it->getWorldMat(), _invBindPoses[i++], &t);
-        _matrixPalette[paletteIndex++].set(t.m[0], t.m[4], t.m[8], t.m[12]);
-        _matrixPalette[paletteIndex++].set(t.m[1], t.m[5], t.m[9], t.m[13]);
-        _matrixPalette[paletteIndex++].set(t.m[2], t.m[6], t.m[10], t.m[14]);
+        computePaletteRows(it->getWorldMat().m, &_invBindPoseRows[i * 4], &_matrixPalette[i * PALETTE_ROWS]);
+        ++i;
     }
+    _paletteVersion = poseVersion;
     
     return _matrixPalette;
 }
@@ -125,12 +190,14 @@ void MeshSkin::removeAllBones()
 {
     _skinBones.clear();
     CC_SAFE_DELETE_ARRAY(_matrixPalette);
+    _paletteVersion = 0;
     CC_SAFE_RELEASE(_rootBone);
 }
 
 void MeshSkin::addSkinBone(Bone3D* bone)
 {
     _skinBones.pushBack(bone);
+    CC_SAFE_DELETE_ARRAY(_matrixPalette);
 }
 
 Bone3D* MeshSkin::getRootBone() const
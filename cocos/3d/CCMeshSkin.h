@@ -114,7 +114,9 @@ public:
     
     /**
      * @~english Compute matrix palette used by gpu skin. The matrix palette is array of matrix which contatin
+     * It is only computed again when the pose version of the skeleton changed.
      * @~chinese 创建一个矩阵组(matrix palette)用以进行GPU蒙皮
+     * 只有骨架的姿态版本改变时才会重新计算。
      * @return @~english The matrix palette.
      * @~chinese 骨骼变换矩阵组
      */
@@ -181,6 +183,10 @@ protected:
     // Each 4x3 row-wise matrix is represented as 3 Vec4's.
     // The number of Vec4's is (_skinBones.size() * 3).
     Vec4* _matrixPalette;
+    // pose version of the skeleton _matrixPalette was computed from, 0 when it has to be computed
+    unsigned int _paletteVersion;
+    // rows of the inverse bind poses, 4 Vec4's per bone
+    std::vector<Vec4> _invBindPoseRows;
 };
 
 // end of 3d group
@@ -50,6 +50,7 @@ void Bone3D::setOriPose(const Mat4& m)
 void Bone3D::resetPose()
 {
     _local =_oriPose;
+    _localDirty = true;
     
     for (auto it : _children) {
         it->resetPose();
@@ -93,6 +94,7 @@ const Mat4& Bone3D::getWorldMat()
 
 void Bone3D::setAnimationValue(float* trans, float* rot, float* scale, void* tag, float weight)
 {
+    _localDirty = true;
     for (auto& it : _blendStates) {
         if (it.tag == tag)
         {
@@ -184,6 +186,7 @@ Bone3D::Bone3D(const std::string& id)
 : _name(id)
 , _parent(nullptr)
 , _worldDirty(true)
+, _localDirty(true)
 {
     
 }
@@ -246,6 +249,10 @@ void Bone3D::updateLocalMat()
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 Skeleton3D::Skeleton3D()
+: _evaluationOrderDirty(true)
+, _poseSource(nullptr)
+, _poseVersion(0)
+, _sourcePoseVersion(0)
 {
     
 }
@@ -253,6 +260,7 @@ Skeleton3D::Skeleton3D()
 Skeleton3D::~Skeleton3D()
 {
     removeAllBones();
+    CC_SAFE_RELEASE(_poseSource);
 }
 
 Skeleton3D* Skeleton3D::create(const std::vector<NodeData*>& skeletondata)
@@ -315,21 +323,96 @@ int Skeleton3D::getBoneIndex(Bone3D* bone) const
 //refresh bone world matrix
 void Skeleton3D::updateBoneMatrix()
 {
-    for (const auto& it : _rootBones) {
-        it->setWorldMatDirty(true);
-        it->updateWorldMat();
+    if (_poseSource)
+    {
+        _poseSource->updateBoneMatrix();
+        if (_sourcePoseVersion != _poseSource->_poseVersion)
+        {
+            ssize_t count = _bones.size();
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                auto bone = _bones.at(i);
+                bone->_world = _poseSource->_bones.at(i)->_world;
+                bone->_worldDirty = false;
+            }
+            _sourcePoseVersion = _poseSource->_poseVersion;
+            ++_poseVersion;
+        }
+        return;
+    }
+
+    bool dirty = _evaluationOrderDirty;
+    if (_evaluationOrderDirty)
+    {
+        _evaluationOrder.clear();
+        _evaluationOrder.reserve(_bones.size());
+        for (const auto& it : _rootBones) {
+            _evaluationOrder.push_back(it);
+        }
+        // breadth first, so that the parents come before their children
+        for (size_t i = 0; i < _evaluationOrder.size(); ++i) {
+            for (const auto& child : _evaluationOrder[i]->_children) {
+                _evaluationOrder.push_back(child);
+            }
+        }
+        _evaluationOrderDirty = false;
+    }
+
+    for (size_t i = 0; i < _evaluationOrder.size() && !dirty; ++i) {
+        dirty = _evaluationOrder[i]->_localDirty;
+    }
+    if (!dirty)
+        return;
+
+    for (auto bone : _evaluationOrder) {
+        bone->updateLocalMat();
+        bone->_localDirty = false;
+        if (bone->_parent)
+            Mat4::multiply(bone->_parent->_world, bone->_local, &bone->_world);
+        else
+            bone->_world = bone->_local;
+        bone->_worldDirty = false;
+    }
+    ++_poseVersion;
+}
+
+void Skeleton3D::setPoseSource(Skeleton3D* source)
+{
+    if (source == _poseSource)
+        return;
+
+    if (source)
+    {
+        CCASSERT(source->getBoneCount() == getBoneCount(), "the source skeleton should have the same bones");
+        for (auto it = source; it; it = it->_poseSource) {
+            CCASSERT(it != this, "the skeleton can't follow itself");
+            if (it == this)
+                return;
+        }
+        if (source->getBoneCount() != getBoneCount())
+            return;
     }
+
+    CC_SAFE_RETAIN(source);
+    CC_SAFE_RELEASE(_poseSource);
+    _poseSource = source;
+    _sourcePoseVersion = 0;
+    // evaluate the own pose again when the source is removed
+    _evaluationOrderDirty = true;
 }
 
 void Skeleton3D::removeAllBones()
 {
     _bones.clear();
     _rootBones.clear();
+    _evaluationOrder.clear();
+    _evaluationOrderDirty = true;
 }
 
 void Skeleton3D::addBone(Bone3D* bone)
 {
     _bones.pushBack(bone);
+    _evaluationOrderDirty = true;
 }
 
 Bone3D* Skeleton3D::createBone3D(const NodeData& nodedata)
@@ -249,6 +249,7 @@ protected:
     Vector<Bone3D*> _children;
     
     bool          _worldDirty;
+    bool          _localDirty; // _local changed since the skeleton last evaluated its pose
     Mat4          _world;
     Mat4          _local;
     
@@ -332,9 +333,42 @@ public:
     
     /**
      * @~english Refresh all bones world matrix.
+     * The bones are only evaluated again when an animation or resetPose() changed them since the last call,
+     * so that the skeleton of several meshes, or drawn by several cameras, is evaluated once per frame.
      * @~chinese 重新更新所有骨骼的世界坐标变换矩阵
+     * 只有在上次调用之后动画或resetPose()改变了骨骼时才会重新计算，因此被多个网格共享、或被多个摄像机绘制的骨架每帧只计算一次。
      */
     void updateBoneMatrix();
+
+    /**
+     * @~english Make this skeleton show the pose of another skeleton with the same bones, for example the one of
+     * another Sprite3D created from the same file. The pose is evaluated once by the source, and its world matrices
+     * are copied to the bones of this skeleton, so that a crowd of identical characters can share a few animated poses.
+     * The animations run on this skeleton are ignored while it has a source.
+     * @~chinese 让这个骨架显示另一个具有相同骨骼的骨架的姿态，例如用同一个文件创建的另一个Sprite3D的骨架。
+     * 姿态只由源骨架计算一次，其世界矩阵被拷贝到这个骨架的骨骼中，因此一群相同的角色可以共享少数几个动画姿态。
+     * 有源骨架时，在这个骨架上运行的动画被忽略。
+     * @param source @~english The skeleton to follow, nullptr to evaluate the pose of this skeleton again.
+     * @~chinese 要跟随的骨架，nullptr表示重新计算这个骨架自己的姿态。
+     */
+    void setPoseSource(Skeleton3D* source);
+
+    /**
+     * @~english Get the skeleton whose pose this skeleton shows.
+     * @~chinese 获取这个骨架显示其姿态的骨架。
+     * @return @~english The source skeleton, nullptr if none.
+     * @~chinese 源骨架，没有时为nullptr。
+     */
+    Skeleton3D* getPoseSource() const { return _poseSource; }
+
+    /**
+     * @~english Get the number of times the world matrices of the bones changed, starting at 0.
+     * The matrix palettes of the skins are rebuilt only when it changes.
+     * @~chinese 获取骨骼世界矩阵改变的次数，从0开始。蒙皮的矩阵组只在它改变时才重新计算。
+     * @return @~english The pose version.
+     * @~chinese 姿态版本。
+     */
+    unsigned int getPoseVersion() const { return _poseVersion; }
     
 CC_CONSTRUCTOR_ACCESS:
     
@@ -369,6 +403,14 @@ protected:
     Vector<Bone3D*> _bones; // bones
 
     Vector<Bone3D*> _rootBones;
+
+    // the bones reachable from the roots, parents before children
+    std::vector<Bone3D*> _evaluationOrder;
+    bool _evaluationOrderDirty;
+
+    Skeleton3D* _poseSource;
+    unsigned int _poseVersion;
+    unsigned int _sourcePoseVersion; // pose version of the source copied last
 };
 
 // end of 3d group
@@ -867,6 +867,16 @@ Action* Sprite3D::runAction(Action *action)
     return Node::runAction(action);
 }
 
+bool Sprite3D::getCullingBounds(AABB* bounds) const
+{
+    bounds->reset();
+    for (const auto& it : _meshes) {
+        if (it->isVisible())
+            bounds->merge(it->getAABB());
+    }
+    return true;
+}
+
 Rect Sprite3D::getBoundingBox() const
 {
     AABB aabb = getAABB();
@@ -932,6 +942,13 @@ void Sprite3D::setForce2DQueue(bool force2D)
     }
 }
 
+void Sprite3D::setInstancingEnabled(bool enabled)
+{
+    for (const auto &mesh : _meshes) {
+        mesh->setInstancingEnabled(enabled);
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 Sprite3DCache* Sprite3DCache::_cacheInstance = nullptr;
 Sprite3DCache* Sprite3DCache::getInstance()
@@ -260,6 +260,11 @@ public:
     */
     virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
 
+    /** @~english The bounds of the visible meshes, in the local coordinates of the sprite, for spatial culling.
+        @~chinese 可见网格的包围盒，使用精灵的本地坐标系，用于空间剔除。
+    */
+    virtual bool getCullingBounds(AABB* bounds) const override;
+
     /** @~english Adds a new material to the sprite.
         The Material will be applied to all the meshes that belong to the sprite.
         Internally it will call `setMaterial(material,-1)`
@@ -291,6 +296,14 @@ public:
     */
     void setForce2DQueue(bool force2D);
 
+    /**
+    * @brief @~english Lets the meshes of this Sprite3D be drawn as instances, together with the meshes of the other
+    * Sprite3Ds created from the same file, see Mesh::setInstancingEnabled().
+    * @~chinese 允许这个Sprite3D的网格作为实例，与从同一个文件创建的其他Sprite3D的网格一起绘制，参考Mesh::setInstancingEnabled()。
+    * @param enabled @~english Whether instancing is enabled, false by default. @~chinese 是否启用实例化，默认为false。
+    */
+    void setInstancingEnabled(bool enabled);
+
     /**
     * @brief @~english Get meshes used in sprite 3d.
     * @~chinese 返回3d精灵中使用的网格材质。
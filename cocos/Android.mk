@@ -19,6 +19,7 @@ endif
 LOCAL_SRC_FILES := \
 cocos2d.cpp \
 2d/CCAction.cpp \
+2d/CCActionBatch.cpp \
 2d/CCActionCamera.cpp \
 2d/CCActionCatmullRom.cpp \
 2d/CCActionEase.cpp \
@@ -68,12 +69,15 @@ cocos2d.cpp \
 2d/CCParallaxNode.cpp \
 2d/CCParticleBatchNode.cpp \
 2d/CCParticleExamples.cpp \
+2d/CCParticleKernels.cpp \
 2d/CCParticleSystem.cpp \
 2d/CCParticleSystemQuad.cpp \
 2d/CCProgressTimer.cpp \
 2d/CCProtectedNode.cpp \
 2d/CCRenderTexture.cpp \
+2d/CCRetainedBatchNode.cpp \
 2d/CCScene.cpp \
+2d/CCSpatialIndex.cpp \
 2d/CCSprite.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
@@ -141,6 +145,8 @@ base/CCProperties.cpp \
 base/CCRef.cpp \
 base/CCScheduler.cpp \
 base/CCScriptSupport.cpp \
+base/CCFrameJobQueue.cpp \
+base/CCThreadPool.cpp \
 base/CCTouch.cpp \
 base/CCUserDefault-android.cpp \
 base/CCUserDefault.cpp \
@@ -169,6 +175,7 @@ renderer/CCGLProgramCache.cpp \
 renderer/CCGLProgramState.cpp \
 renderer/CCGLProgramStateCache.cpp \
 renderer/CCGroupCommand.cpp \
+renderer/CCInstancedMeshCommand.cpp \
 renderer/CCMaterial.cpp \
 renderer/CCMeshCommand.cpp \
 renderer/CCPass.cpp \
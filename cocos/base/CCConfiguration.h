@@ -202,6 +202,15 @@ public:
      * @since v2.0.0
      */
 	bool supportsShareableVAO() const;
+
+    /** @~english Whether or not instanced arrays (GL_ARB_instanced_arrays or GL_EXT_instanced_arrays) are supported.
+     *
+     * @~chinese 是否支持实例化数组（GL_ARB_instanced_arrays或GL_EXT_instanced_arrays）。
+     *
+     * @return @~english Is true if supports instanced arrays.
+     * @~chinese 如果支持实例化数组返回真。
+     */
+    bool supportsInstancing() const;
     
 
     /** @~english Max support directional light in shader, for Sprite3D.
@@ -334,6 +343,7 @@ protected:
     bool            _supportsBGRA8888;
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
+    bool            _supportsInstancing;
     GLint           _maxSamplesAllowed;
     GLint           _maxTextureUnits;
     char *          _glExtensions;
@@ -56,10 +56,13 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
+#include "base/CCEventType.h"
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCThreadPool.h"
+#include "base/CCFrameJobQueue.h"
 #include "platform/CCApplication.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -128,10 +131,16 @@ bool Director::init(void)
     _totalFrames = 0;
     _lastUpdate = new struct timeval;
     _secondsPerFrame = 1.0f;
+    _fixedDeltaTime = 0.0f;
+    _measuredDeltaTime = 0.0f;
 
     // paused ?
     _paused = false;
 
+    // visit the parallel roots on worker threads ?
+    _parallelVisitEnabled = false;
+    _parallelParticlesEnabled = false;
+
     // purge ?
     _purgeDirectorInNextLoop = false;
     
@@ -271,6 +280,8 @@ void Director::drawScene()
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
+        // the updates deferred to worker threads, they are done before visiting the scene
+        FrameJobQueue::getInstance()->run();
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
     }
 
@@ -341,21 +352,27 @@ void Director::calculateDeltaTime()
         return;
     }
 
+    _measuredDeltaTime = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
+    _measuredDeltaTime = MAX(0, _measuredDeltaTime);
+
     // new delta time. Re-fixed issue #1277
     if (_nextDeltaTimeZero)
     {
         _deltaTime = 0;
         _nextDeltaTimeZero = false;
     }
+    else if (_fixedDeltaTime > 0)
+    {
+        _deltaTime = _fixedDeltaTime;
+    }
     else
     {
-        _deltaTime = (now.tv_sec - _lastUpdate->tv_sec) + (now.tv_usec - _lastUpdate->tv_usec) / 1000000.0f;
-        _deltaTime = MAX(0, _deltaTime);
+        _deltaTime = _measuredDeltaTime;
     }
 
 #if COCOS2D_DEBUG
     // If we are debugging our code, prevent big delta time
-    if (_deltaTime > 0.2f)
+    if (_deltaTime > 0.2f && _fixedDeltaTime <= 0)
     {
         _deltaTime = 1 / 60.0f;
     }
@@ -649,6 +666,9 @@ void Director::setProjection(Projection projection)
 
 void Director::purgeCachedData(void)
 {
+    // the caches outside of the engine may hold textures, release them before the unused textures are removed
+    _eventDispatcher->dispatchCustomEvent(EVENT_PURGE_CACHED_DATA);
+
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
 
@@ -978,6 +998,8 @@ void Director::reset()
     GLProgramStateCache::destroyInstance();
     FileUtils::destroyInstance();
     AsyncTaskPool::destoryInstance();
+    FrameJobQueue::destroyInstance();
+    ThreadPool::destroyInstance();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -1110,13 +1132,15 @@ void Director::showStats()
     static float prevDeltaTime  = 0.016f; // 60FPS
     static const float FPS_FILTER = 0.10f;
 
-    _accumDt += _deltaTime;
+    // with a fixed delta time, the FPS must still reflect the real speed
+    float frameTime = _fixedDeltaTime > 0 ? _measuredDeltaTime : _deltaTime;
+    _accumDt += frameTime;
     
     if (_displayStats && _FPSLabel && _drawnBatchesLabel && _drawnVerticesLabel)
     {
         char buffer[30];
 
-        float dt = _deltaTime * FPS_FILTER + (1-FPS_FILTER) * prevDeltaTime;
+        float dt = frameTime * FPS_FILTER + (1-FPS_FILTER) * prevDeltaTime;
         prevDeltaTime = dt;
         _frameRate = 1/dt;
 
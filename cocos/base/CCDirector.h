@@ -181,6 +181,16 @@ public:
     /** @~english Get seconds per frame.  @~chinese 获取每帧间隔几秒。*/
     inline float getSecondsPerFrame() { return _secondsPerFrame; }
 
+    /** @~english Whether or not the subtrees flagged with Node::setParallelVisitRoot are visited on worker threads.  @~chinese 是否在工作线程中遍历通过Node::setParallelVisitRoot标记的子树。*/
+    inline bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+    /** @~english Enables or disables visiting the subtrees flagged with Node::setParallelVisitRoot on worker threads. Disabled by default.  @~chinese 设置是否在工作线程中遍历通过Node::setParallelVisitRoot标记的子树。默认不启用。*/
+    inline void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+
+    /** @~english Whether or not the particle systems are simulated on worker threads, after the scheduler update.  @~chinese 是否在调度器更新之后，在工作线程中模拟粒子系统。*/
+    inline bool isParallelParticlesEnabled() const { return _parallelParticlesEnabled; }
+    /** @~english Enables or disables simulating the ParticleSystem and ParticleSystem3D instances on worker threads. Their updates are then deferred to FrameJobQueue::run(), which runs once the scheduler is updated, before the scene is visited. Disabled by default.  @~chinese 设置是否在工作线程中模拟ParticleSystem和ParticleSystem3D。启用后它们的更新被推迟到FrameJobQueue::run()中，它在调度器更新之后、遍历场景之前执行。默认不启用。*/
+    inline void setParallelParticlesEnabled(bool enabled) { _parallelParticlesEnabled = enabled; }
+
     /** @~english
      * Get the GLView.
      * @~chinese 
@@ -547,6 +557,22 @@ public:
 
     /* @~english Gets delta time since last tick to main loop.  @~chinese 获取mainloop距上一个tick的时间间隔。*/
     float getDeltaTime() const;
+
+    /** @~english
+     * Sets a delta time used for every frame instead of the measured one, so that the simulation doesn't depend on the speed of the machine.
+     * The FPS statistics still use the measured time. On Linux the main loop doesn't wait between frames in this mode.
+     * Pass 0 to use the measured time again, which is the default.
+     * @~chinese
+     * 设置每帧使用的固定时间间隔，代替测量到的时间间隔，使模拟结果与机器速度无关。
+     * FPS统计仍然使用测量到的时间。在Linux上，这种模式下主循环不会在帧之间等待。
+     * 传入0则重新使用测量到的时间，这是默认行为。
+     * @param fixedDeltaTime @~english The delta time in seconds, or 0.
+     * @~chinese 以秒为单位的时间间隔，或0。
+     */
+    void setFixedDeltaTime(float fixedDeltaTime) { _fixedDeltaTime = fixedDeltaTime; }
+
+    /** @~english Gets the fixed delta time, 0 if the measured time is used.  @~chinese 获取固定的时间间隔，如果使用测量的时间则返回0。*/
+    float getFixedDeltaTime() const { return _fixedDeltaTime; }
     
     /**@~english
      *  Gets Frame Rate.
@@ -670,6 +696,11 @@ protected:
         
     /* @~english delta time since last tick to main loop  @~chinese 三角洲自去年蜱虫主循环*/
 	float _deltaTime;
+
+    // fixed delta time, 0 to use the measured one
+    float _fixedDeltaTime;
+    // measured delta time, used by the FPS statistics
+    float _measuredDeltaTime;
     
     /* @~english The _openGLView, where everything is rendered, GLView is a abstract class,cocos2d-x provide GLViewImpl
      * @~chinese _openGLView,一切呈现,GLView是一个抽象类,cocos2d-x提供GLViewImpl
@@ -686,6 +717,8 @@ protected:
     bool _landscape;
     
     bool _displayStats;
+    bool _parallelVisitEnabled;
+    bool _parallelParticlesEnabled;
     float _accumDt;
     float _frameRate;
     
@@ -44,5 +44,13 @@
 // This message is posted in cocos/platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxRenderer.cpp and cocos\platform\wp8-xaml\cpp\Cocos2dRenderer.cpp.
 #define EVENT_COME_TO_BACKGROUND    "event_come_to_background"
 
+// The cached data should be released, on a memory warning for instance.
+// This message is posted in cocos/base/CCDirector.cpp, by Director::purgeCachedData().
+#define EVENT_PURGE_CACHED_DATA     "event_purge_cached_data"
+
+// The search paths or the search resolutions order of FileUtils changed, the files may have other full paths.
+// This message is posted in cocos/platform/CCFileUtils.cpp.
+#define EVENT_SEARCH_PATHS_CHANGED  "event_search_paths_changed"
+
 /// @endcond
 #endif // __CCEVENT_TYPE_H__
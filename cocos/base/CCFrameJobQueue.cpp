@@ -0,0 +1,94 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFrameJobQueue.h"
+#include "base/CCThreadPool.h"
+#include "base/ccMacros.h"
+
+NS_CC_BEGIN
+
+FrameJobQueue* FrameJobQueue::s_frameJobQueue = nullptr;
+
+FrameJobQueue* FrameJobQueue::getInstance()
+{
+    if (s_frameJobQueue == nullptr)
+    {
+        s_frameJobQueue = new (std::nothrow) FrameJobQueue();
+    }
+    return s_frameJobQueue;
+}
+
+void FrameJobQueue::destroyInstance()
+{
+    CC_SAFE_DELETE(s_frameJobQueue);
+}
+
+FrameJobQueue::FrameJobQueue()
+: _running(false)
+{
+}
+
+FrameJobQueue::~FrameJobQueue()
+{
+    // the jobs release what they retained when they finish
+    run();
+}
+
+void FrameJobQueue::push(FrameJob* job)
+{
+    CCASSERT(!_running, "FrameJobQueue: can't push a job while running the jobs");
+    _jobs.push_back(job);
+}
+
+void FrameJobQueue::run()
+{
+    if (_jobs.empty() || _running)
+        return;
+
+    // jobs pushed by the finish callbacks wait for the next frame
+    _runningJobs.swap(_jobs);
+    _running = true;
+
+    for (auto job : _runningJobs)
+        job->prepareFrameJob();
+
+    if (_runningJobs.size() == 1)
+    {
+        _runningJobs[0]->runFrameJob();
+    }
+    else
+    {
+        auto& jobs = _runningJobs;
+        ThreadPool::getInstance()->parallelFor(jobs.size(), [&jobs](size_t i) {
+            jobs[i]->runFrameJob();
+        });
+    }
+
+    _running = false;
+    for (auto job : _runningJobs)
+        job->finishFrameJob();
+    _runningJobs.clear();
+}
+
+NS_CC_END
@@ -0,0 +1,118 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCFRAME_JOB_QUEUE_H_
+#define __CCFRAME_JOB_QUEUE_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class FrameJob
+ * @brief @~english Work deferred from the update phase to FrameJobQueue::run().
+ * @~chinese 从更新阶段推迟到FrameJobQueue::run()中执行的工作。
+ * @js NA
+ */
+class CC_DLL FrameJob
+{
+public:
+    virtual ~FrameJob() {}
+
+    /** @~english Called on the main thread before any job runs. Read the scene graph (transforms, parents) here.
+     * @~chinese 在所有任务执行之前，在主线程中调用。在这里读取场景图（变换、父节点）。
+     */
+    virtual void prepareFrameJob() {}
+
+    /** @~english Called on a worker thread or on the main thread, concurrently with the other jobs.
+     * It must only touch the data of its own object.
+     * @~chinese 在工作线程或主线程中调用，与其他任务并发执行。只能访问自身对象的数据。
+     */
+    virtual void runFrameJob() = 0;
+
+    /** @~english Called on the main thread once all the jobs ran, in the order the jobs were pushed.
+     * @~chinese 所有任务执行完毕后，按加入的顺序在主线程中调用。
+     */
+    virtual void finishFrameJob() {}
+};
+
+/**
+ * @class FrameJobQueue
+ * @brief @~english Collects the jobs pushed during the update phase, and runs them on the ThreadPool
+ * once the Scheduler is done, before the scene is visited.
+ * @~chinese 收集更新阶段加入的任务，在Scheduler更新完毕之后、遍历场景之前，用ThreadPool执行它们。
+ * @js NA
+ */
+class CC_DLL FrameJobQueue
+{
+public:
+    /** @~english Returns the shared job queue.
+     * @~chinese 返回共享的任务队列。
+     */
+    static FrameJobQueue* getInstance();
+
+    /** @~english Destroys the shared job queue, running the jobs still pending.
+     * @~chinese 销毁共享的任务队列，并执行尚未执行的任务。
+     */
+    static void destroyInstance();
+
+    /** @~english Adds a job to run in the next call of run(). The queue does not retain the job.
+     * @~chinese 加入一个在下次调用run()时执行的任务。队列不会retain任务。
+     */
+    void push(FrameJob* job);
+
+    /** @~english Runs the pending jobs: prepareFrameJob() on the main thread, runFrameJob() in parallel,
+     * then finishFrameJob() on the main thread. Called by the Director after updating the Scheduler.
+     * @~chinese 执行等待中的任务：先在主线程调用prepareFrameJob()，然后并行调用runFrameJob()，
+     * 最后在主线程调用finishFrameJob()。Director在更新Scheduler之后调用这个函数。
+     */
+    void run();
+
+    /** @~english Whether run() is running the jobs, so that the jobs must not be deferred again.
+     * @~chinese run()是否正在执行任务，此时不能再推迟任务。
+     */
+    bool isRunning() const { return _running; }
+
+CC_CONSTRUCTOR_ACCESS:
+    FrameJobQueue();
+    ~FrameJobQueue();
+
+protected:
+    std::vector<FrameJob*> _jobs;
+    std::vector<FrameJob*> _runningJobs;
+    bool _running;
+
+    static FrameJobQueue* s_frameJobQueue;
+};
+
+NS_CC_END
+/**
+ * @}
+ */
+#endif //__CCFRAME_JOB_QUEUE_H_
@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -61,13 +62,27 @@ typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                currentTimerSalvaged;
     bool                paused;
     UT_hash_handle      hh;
 } tHashTimerEntry;
 
+// Where a timer is, regarding the timing wheel
+enum
+{
+    TIMER_DETACHED,     // not scheduled, or a script timer updated every frame
+    TIMER_IN_WHEEL,     // waiting in a slot of the wheel
+    TIMER_EXPIRED,      // taken out of the wheel, will be updated in this frame
+    TIMER_PARKED,       // its target is paused
+};
+
+// Length of a tick of the timing wheel
+static const double TIMER_WHEEL_TICKS_PER_SECOND = 1000.0;
+
+static inline uint64_t timerWheelTick(double time)
+{
+    return time > 0 ? (uint64_t)(time * TIMER_WHEEL_TICKS_PER_SECOND) : 0;
+}
+
 // implementation Timer
 
 Timer::Timer()
@@ -79,6 +94,12 @@ Timer::Timer()
 , _repeat(0)
 , _delay(0.0f)
 , _interval(0.0f)
+, _wheelPrev(nullptr)
+, _wheelNext(nullptr)
+, _wheelSlot(nullptr)
+, _syncTime(0.0)
+, _dueTime(0.0)
+, _wheelState(TIMER_DETACHED)
 {
 }
 
@@ -144,6 +165,25 @@ void Timer::update(float dt)
     }
 }
 
+float Timer::getTimeToNextTrigger() const
+{
+    if (_elapsed == -1)
+    {
+        return 0;
+    }
+
+    float timeLeft = 0;
+    if (_useDelay)
+    {
+        timeLeft = _delay - _elapsed;
+    }
+    else if (_interval > 0)
+    {
+        timeLeft = _interval - _elapsed;
+    }
+    return std::max(timeLeft, 0.0f);
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -250,8 +290,9 @@ Scheduler::Scheduler(void)
 , _updatesPosList(nullptr)
 , _hashForUpdates(nullptr)
 , _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
+, _timerWheelTick(0)
+, _timerWheelCount(0)
+, _timerTime(0.0)
 , _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
@@ -259,6 +300,9 @@ Scheduler::Scheduler(void)
 {
     // I don't expect to have more than 30 functions to all per frame
     _functionsToPerform.reserve(30);
+
+    memset(_timerWheelNear, 0, sizeof(_timerWheelNear));
+    memset(_timerWheelFar, 0, sizeof(_timerWheelFar));
 }
 
 Scheduler::~Scheduler(void)
@@ -273,6 +317,229 @@ void Scheduler::removeHashElement(_hashSelectorEntry *element)
     free(element);
 }
 
+void Scheduler::addTimer(_hashSelectorEntry *element, Timer *timer)
+{
+    ccArrayAppendObject(element->timers, timer);
+
+    // the first update of a timer only starts it, it is done on the next frame
+    timer->_syncTime = _timerTime;
+    if (element->paused)
+    {
+        timer->_syncTime = 0;
+        timer->_wheelState = TIMER_PARKED;
+    }
+    else
+    {
+        insertTimer(timer);
+    }
+}
+
+void Scheduler::removeTimer(Timer *timer)
+{
+    if (timer->_wheelState == TIMER_IN_WHEEL)
+    {
+        unlinkTimer(timer);
+    }
+    // an expired timer is retained by _expiredTimers, it is skipped when its turn comes
+    timer->_wheelState = TIMER_DETACHED;
+}
+
+void Scheduler::pauseTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = (Timer*)element->timers->arr[i];
+        if (timer->_wheelState == TIMER_IN_WHEEL || timer->_wheelState == TIMER_EXPIRED)
+        {
+            if (timer->_wheelState == TIMER_IN_WHEEL)
+            {
+                unlinkTimer(timer);
+            }
+            // keep the time the timer has not been updated with yet
+            timer->_syncTime -= _timerTime;
+            timer->_wheelState = TIMER_PARKED;
+        }
+    }
+}
+
+void Scheduler::resumeTimers(_hashSelectorEntry *element)
+{
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = (Timer*)element->timers->arr[i];
+        if (timer->_wheelState == TIMER_PARKED)
+        {
+            timer->_syncTime += _timerTime;
+            insertTimer(timer);
+        }
+    }
+}
+
+void Scheduler::insertTimer(Timer *timer)
+{
+    timer->_dueTime = timer->_syncTime + timer->getTimeToNextTrigger();
+    linkTimer(timer);
+}
+
+void Scheduler::linkTimer(Timer *timer)
+{
+    uint64_t tick = std::max(timerWheelTick(timer->_dueTime), _timerWheelTick);
+    uint64_t ticksLeft = tick - _timerWheelTick;
+
+    Timer **slot = nullptr;
+    if (ticksLeft < (1 << TIMER_WHEEL_NEAR_BITS))
+    {
+        slot = &_timerWheelNear[tick & ((1 << TIMER_WHEEL_NEAR_BITS) - 1)];
+    }
+    else
+    {
+        int level = 0;
+        uint64_t range = (uint64_t)1 << (TIMER_WHEEL_NEAR_BITS + TIMER_WHEEL_FAR_BITS);
+        while (ticksLeft >= range && level < TIMER_WHEEL_FAR_LEVELS - 1)
+        {
+            ++level;
+            range <<= TIMER_WHEEL_FAR_BITS;
+        }
+        if (ticksLeft >= range)
+        {
+            // beyond the wheel, wait in its last slot and get linked again when it cascades
+            tick = _timerWheelTick + range - 1;
+        }
+        int shift = TIMER_WHEEL_NEAR_BITS + level * TIMER_WHEEL_FAR_BITS;
+        slot = &_timerWheelFar[level][(tick >> shift) & ((1 << TIMER_WHEEL_FAR_BITS) - 1)];
+    }
+
+    timer->_wheelPrev = nullptr;
+    timer->_wheelNext = *slot;
+    if (*slot)
+    {
+        (*slot)->_wheelPrev = timer;
+    }
+    *slot = timer;
+    timer->_wheelSlot = slot;
+    timer->_wheelState = TIMER_IN_WHEEL;
+    ++_timerWheelCount;
+}
+
+void Scheduler::unlinkTimer(Timer *timer)
+{
+    if (timer->_wheelPrev)
+    {
+        timer->_wheelPrev->_wheelNext = timer->_wheelNext;
+    }
+    else
+    {
+        *timer->_wheelSlot = timer->_wheelNext;
+    }
+    if (timer->_wheelNext)
+    {
+        timer->_wheelNext->_wheelPrev = timer->_wheelPrev;
+    }
+    timer->_wheelPrev = nullptr;
+    timer->_wheelNext = nullptr;
+    timer->_wheelSlot = nullptr;
+    timer->_wheelState = TIMER_DETACHED;
+    --_timerWheelCount;
+}
+
+void Scheduler::cascadeTimers(int level, int index)
+{
+    // the timers of this slot are all due within the next turn of the level below
+    Timer *timer = _timerWheelFar[level][index];
+    while (timer)
+    {
+        Timer *next = timer->_wheelNext;
+        unlinkTimer(timer);
+        linkTimer(timer);
+        timer = next;
+    }
+}
+
+void Scheduler::collectExpiredTimers(bool dueOnly)
+{
+    Timer *timer = _timerWheelNear[_timerWheelTick & ((1 << TIMER_WHEEL_NEAR_BITS) - 1)];
+    while (timer)
+    {
+        Timer *next = timer->_wheelNext;
+        // the current tick is not over, some of its timers may be due later in it
+        if (!dueOnly || timer->_dueTime <= _timerTime)
+        {
+            unlinkTimer(timer);
+            timer->_wheelState = TIMER_EXPIRED;
+            timer->retain();
+            _expiredTimers.push_back(timer);
+        }
+        timer = next;
+    }
+}
+
+void Scheduler::updateTimers(float dt)
+{
+    _timerTime += dt;
+    uint64_t tick = std::max(timerWheelTick(_timerTime), _timerWheelTick);
+
+    if (_timerWheelCount == 0)
+    {
+        _timerWheelTick = tick;
+        return;
+    }
+
+    // timers linked while the last frame was processed may wait in the slot of its last tick
+    collectExpiredTimers(_timerWheelTick == tick);
+    while (_timerWheelTick < tick)
+    {
+        if (_timerWheelCount == 0)
+        {
+            _timerWheelTick = tick;
+            break;
+        }
+        ++_timerWheelTick;
+
+        uint64_t index = _timerWheelTick;
+        int shift = TIMER_WHEEL_NEAR_BITS;
+        for (int level = 0; level < TIMER_WHEEL_FAR_LEVELS; ++level)
+        {
+            if ((index & (((uint64_t)1 << shift) - 1)) != 0)
+            {
+                break;
+            }
+            cascadeTimers(level, (index >> shift) & ((1 << TIMER_WHEEL_FAR_BITS) - 1));
+            shift += TIMER_WHEEL_FAR_BITS;
+        }
+
+        collectExpiredTimers(_timerWheelTick == tick);
+    }
+
+    if (_expiredTimers.empty())
+    {
+        return;
+    }
+
+    // fire in the order the timers expired, like they would have been by updating all of them every frame
+    std::stable_sort(_expiredTimers.begin(), _expiredTimers.end(), [](const Timer *a, const Timer *b) {
+        return a->_dueTime < b->_dueTime;
+    });
+
+    for (size_t i = 0; i < _expiredTimers.size(); ++i)
+    {
+        Timer *timer = _expiredTimers[i];
+        // the callbacks fired before may have unscheduled it or paused its target
+        if (timer->_wheelState == TIMER_EXPIRED)
+        {
+            float elapsed = (float)(_timerTime - timer->_syncTime);
+            timer->_syncTime = _timerTime;
+            timer->update(elapsed);
+
+            if (timer->_wheelState == TIMER_EXPIRED)
+            {
+                insertTimer(timer);
+            }
+        }
+        timer->release();
+    }
+    _expiredTimers.clear();
+}
+
 void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
 {
     this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
@@ -315,6 +582,11 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                if (timer->_wheelState == TIMER_IN_WHEEL)
+                {
+                    unlinkTimer(timer);
+                    insertTimer(timer);
+                }
                 return;
             }        
         }
@@ -323,7 +595,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -349,30 +621,13 @@ void Scheduler::unschedule(const std::string &key, void *target)
 
             if (timer && key == timer->getKey())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-
+                // a timer unscheduling itself is still retained by _expiredTimers
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
 
                 return;
@@ -645,22 +900,12 @@ void Scheduler::unscheduleAllForTarget(void *target)
 
     if (element)
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimerSalvaged))
+        for (int i = 0; i < element->timers->num; ++i)
         {
-            element->currentTimer->retain();
-            element->currentTimerSalvaged = true;
+            removeTimer((Timer*)element->timers->arr[i]);
         }
         ccArrayRemoveAllObjects(element->timers);
-
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+        removeHashElement(element);
     }
 
     // update selector
@@ -697,9 +942,10 @@ void Scheduler::resumeTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && element->paused)
     {
         element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
@@ -719,9 +965,10 @@ void Scheduler::pauseTarget(void *target)
     // custom selectors
     tHashTimerEntry *element = nullptr;
     HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    if (element && !element->paused)
     {
         element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
@@ -770,7 +1017,11 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        if (!element->paused)
+        {
+            element->paused = true;
+            pauseTimers(element);
+        }
         idsWithSelectors.insert(element->target);
     }
 
@@ -869,44 +1120,8 @@ void Scheduler::update(float dt)
         }
     }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                elt->currentTimerSalvaged = false;
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimerSalvaged)
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
-
-                elt->currentTimer = nullptr;
-            }
-        }
-
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
-
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
-        {
-            removeHashElement(_currentTarget);
-        }
-    }
+    // Fire the custom selectors that expired
+    updateTimers(dt);
 
     // delete all updates that are marked for deletion
     // updates with priority < 0
@@ -937,7 +1152,6 @@ void Scheduler::update(float dt)
     }
 
     _updateHashLocked = false;
-    _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -1016,6 +1230,11 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                if (timer->_wheelState == TIMER_IN_WHEEL)
+                {
+                    unlinkTimer(timer);
+                    insertTimer(timer);
+                }
                 return;
             }
         }
@@ -1024,7 +1243,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    addTimer(element, timer);
     timer->release();
 }
 
@@ -1090,30 +1309,13 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
             
             if (timer && selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && (! element->currentTimerSalvaged))
-                {
-                    element->currentTimer->retain();
-                    element->currentTimerSalvaged = true;
-                }
-                
+                // a timer unscheduling itself is still retained by _expiredTimers
+                removeTimer(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
                 if (element->timers->num == 0)
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
                 
                 return;
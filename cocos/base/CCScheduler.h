@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <vector>
+#include <stdint.h>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
@@ -64,7 +66,11 @@ public:
     void update(float dt);
     
 protected:
-    
+    friend class Scheduler;
+
+    // time left before update() triggers the timer, 0 if it has to be updated on the next frame
+    float getTimeToNextTrigger() const;
+
     Scheduler* _scheduler; // weak ref
     float _elapsed;
     bool _runForever;
@@ -73,6 +79,14 @@ protected:
     unsigned int _repeat; //0 = once, 1 is 2 x executed
     float _delay;
     float _interval;
+
+    // timing wheel bookkeeping, owned by the scheduler
+    Timer* _wheelPrev;
+    Timer* _wheelNext;
+    Timer** _wheelSlot;
+    double _syncTime;   // scheduler time up to which _elapsed is accumulated, relative while parked
+    double _dueTime;
+    int _wheelState;
 };
 
 
@@ -161,6 +175,9 @@ There are 2 different types of callbacks (selectors):
 
 The 'custom selectors' should be avoided when possible. It is faster, and consumes less memory to use the 'update selector'.
 
+The custom selectors are kept in a hierarchical timing wheel: scheduling and unscheduling them costs O(1),
+and a frame only touches the ones that expire, so a large number of long interval timers is cheap.
+
  * @~chinese
  * Scheduler 是负责触发回调函数的类。
  * 不建议在游戏代码中直接使用系统的定时器，推荐使用这个类来实现定时器功能。
@@ -171,6 +188,9 @@ The 'custom selectors' should be avoided when possible. It is faster, and consum
  * 
  * 应该尽量避免使用自定义定时器。使用 update 定时器更快，而且消耗更少的内存。
  * 
+ * 自定义定时器保存在分层时间轮中：添加和取消定时器的开销是O(1)，每一帧只会处理到期的定时器，
+ * 因此大量长间隔的定时器开销很小。
+ * 
 */
 class CC_DLL Scheduler : public Ref
 {
@@ -635,6 +655,19 @@ protected:
     void removeHashElement(struct _hashSelectorEntry *element);
     void removeUpdateFromHash(struct _listEntry *entry);
 
+    // timing wheel specific
+
+    void addTimer(struct _hashSelectorEntry *element, Timer *timer);
+    void removeTimer(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
+    void insertTimer(Timer *timer);
+    void linkTimer(Timer *timer);
+    void unlinkTimer(Timer *timer);
+    void cascadeTimers(int level, int index);
+    void collectExpiredTimers(bool dueOnly);
+    void updateTimers(float dt);
+
     // update specific
 
     void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
@@ -653,8 +686,21 @@ protected:
 
     // Used for "selectors with interval"
     struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
+
+    // Timing wheel of the "selectors with interval". The near level has one slot per tick,
+    // each far level has slots covering a whole turn of the level below.
+    enum
+    {
+        TIMER_WHEEL_NEAR_BITS = 8,
+        TIMER_WHEEL_FAR_BITS = 6,
+        TIMER_WHEEL_FAR_LEVELS = 4,
+    };
+    Timer *_timerWheelNear[1 << TIMER_WHEEL_NEAR_BITS];
+    Timer *_timerWheelFar[TIMER_WHEEL_FAR_LEVELS][1 << TIMER_WHEEL_FAR_BITS];
+    uint64_t _timerWheelTick;
+    size_t _timerWheelCount;
+    double _timerTime;
+    std::vector<Timer*> _expiredTimers;
     // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
     bool _updateHashLocked;
     
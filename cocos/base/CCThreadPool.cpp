@@ -0,0 +1,171 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCThreadPool.h"
+#include "base/ccMacros.h"
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+NS_CC_BEGIN
+
+ThreadPool* ThreadPool::s_threadPool = nullptr;
+
+// set once by each worker when it starts, so getCurrentThreadIndex() does not search the threads
+static thread_local const ThreadPool* s_poolOfThread = nullptr;
+static thread_local size_t s_indexOfThread = 0;
+
+ThreadPool* ThreadPool::getInstance()
+{
+    if (s_threadPool == nullptr)
+    {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        // the thread that calls parallelFor works too, keep at least one worker for enqueue()
+        size_t threadCount = hardwareThreads > 2 ? hardwareThreads - 1 : 1;
+        s_threadPool = new (std::nothrow) ThreadPool(threadCount);
+    }
+    return s_threadPool;
+}
+
+void ThreadPool::destroyInstance()
+{
+    delete s_threadPool;
+    s_threadPool = nullptr;
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+: _stop(false)
+{
+    std::unique_lock<std::mutex> lock(_queueMutex);
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        _threads.push_back(std::thread(&ThreadPool::workerLoop, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::workerLoop(size_t index)
+{
+    s_poolOfThread = this;
+    s_indexOfThread = index;
+
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _condition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+            if (_stop && _tasks.empty())
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task();
+    }
+}
+
+size_t ThreadPool::getCurrentThreadIndex() const
+{
+    // only the other threads read the thread count, it does not change once the constructor returned
+    return s_poolOfThread == this ? s_indexOfThread : _threads.size();
+}
+
+void ThreadPool::enqueue(const std::function<void()>& task)
+{
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        if (_stop)
+        {
+            CC_ASSERT(0 && "already stop");
+            return;
+        }
+        _tasks.push(task);
+    }
+    _condition.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& job)
+{
+    if (count == 0)
+        return;
+
+    if (count == 1 || _threads.empty())
+    {
+        for (size_t i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    struct ParallelForState
+    {
+        std::atomic<size_t> next;
+        std::atomic<size_t> done;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    // helpers that start after all the jobs were taken only touch the state, so it must outlive this call
+    auto state = std::make_shared<ParallelForState>();
+    state->next = 0;
+    state->done = 0;
+
+    const std::function<void(size_t)>* jobPtr = &job;
+    auto run = [state, jobPtr, count]() {
+        size_t index;
+        while ((index = state->next++) < count)
+        {
+            (*jobPtr)(index);
+            if (++state->done == count)
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    size_t helpers = std::min(_threads.size(), count - 1);
+    for (size_t i = 0; i < helpers; ++i)
+    {
+        enqueue(run);
+    }
+
+    run();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state, count]{ return state->done == count; });
+}
+
+NS_CC_END
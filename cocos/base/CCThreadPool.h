@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTHREAD_POOL_H_
+#define __CCTHREAD_POOL_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class ThreadPool
+ * @brief @~english A pool of worker threads used to split frame work (visit, particles, physics queries) across cores.
+ * Unlike AsyncTaskPool, the caller usually waits for the jobs it submits, and it takes part in running them.
+ * @~chinese 工作线程池，用于把每帧的工作（遍历、粒子、物理查询）分摊到多个核心上。
+ * 与AsyncTaskPool不同，调用者通常会等待提交的任务完成，并且自己也参与执行。
+ * @js NA
+ */
+class CC_DLL ThreadPool
+{
+public:
+    /** @brief
+     * @~english
+     * Returns the shared thread pool, it has one worker less than the number of hardware threads.
+     * @~chinese
+     * 返回共享的线程池，工作线程数比硬件线程数少一个。
+     * @return @~english instance of the thread pool.
+     * @~chinese 线程池实例。
+     */
+    static ThreadPool* getInstance();
+
+    /** @brief
+     * @~english
+     * Destroys the shared thread pool, waiting for the queued tasks to finish.
+     * @~chinese
+     * 销毁共享的线程池，并等待队列中的任务执行完毕。
+     */
+    static void destroyInstance();
+
+    /** @brief
+     * @~english
+     * Gets the number of worker threads.
+     * @~chinese
+     * 获取工作线程的数量。
+     */
+    size_t getThreadCount() const { return _threads.size(); }
+
+    /** @brief
+     * @~english
+     * Gets the index of the calling thread: a value in [0, getThreadCount()) for the worker threads,
+     * and getThreadCount() for any other thread. Useful to pick per-thread scratch data.
+     * @~chinese
+     * 获取调用线程的序号：工作线程返回[0, getThreadCount())之间的值，其他线程返回getThreadCount()。
+     * 可以用来选择每个线程独立的数据。
+     */
+    size_t getCurrentThreadIndex() const;
+
+    /** @brief
+     * @~english
+     * Runs job(i) for every i in [0, count). The jobs are shared between the worker threads and the calling thread,
+     * and the function returns once all of them finished. It is safe to call it from a job.
+     * @~chinese
+     * 对[0, count)中的每一个i执行job(i)。任务由工作线程和调用线程共同执行，全部完成后函数才返回。可以在任务中嵌套调用。
+     *
+     * @param count @~english the number of jobs.
+     * @~chinese 任务数量。
+     * @param job @~english the job, called with the job index.
+     * @~chinese 任务函数，参数为任务序号。
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& job);
+
+    /** @brief
+     * @~english
+     * Runs a task on a worker thread, without waiting for it.
+     * @~chinese
+     * 在工作线程中执行一个任务，不等待其完成。
+     *
+     * @param task @~english the task.
+     * @~chinese 任务。
+     */
+    void enqueue(const std::function<void()>& task);
+
+CC_CONSTRUCTOR_ACCESS:
+    explicit ThreadPool(size_t threadCount);
+    ~ThreadPool();
+
+protected:
+    void workerLoop(size_t index);
+
+    std::vector<std::thread> _threads;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _queueMutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+    static ThreadPool* s_threadPool;
+};
+
+NS_CC_END
+/**
+ * @}
+ */
+#endif //__CCTHREAD_POOL_H_
@@ -28,6 +28,19 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/ccUTF8.h"
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -41,100 +54,254 @@ using namespace std;
 NS_CC_BEGIN
 
 /**
- * define the functions here because we don't want to
- * export xmlNodePtr and other types in "CCUserDefault.h"
+ * The values are parsed from the xml file once, and kept in memory.
+ * Changes are written back by a thread, WRITE_BEHIND_DELAY milliseconds after the first change,
+ * so that a burst of changes is saved with one write. The file is written to a temporary file
+ * first, and then renamed, so that it is never left half written.
+ * It is defined here because we don't want to export tinyxml2 types and threads in "CCUserDefault.h"
  */
+#define WRITE_BEHIND_DELAY 200
+
+class UserDefaultStore
+{
+public:
+    explicit UserDefaultStore(const std::string& filePath);
+    ~UserDefaultStore();
+
+    bool getValue(const char* key, std::string* value);
+    void setValue(const char* key, const char* value);
+    void deleteValue(const char* key);
+    bool save();
+
+private:
+    void load();
+    void writeBehind();
+
+    std::string _filePath;
+    // resolved on the cocos thread, the writer doesn't use FileUtils, which may be destroyed before the store
+    std::string _fopenPath;
+    std::string _fopenTempPath;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    std::u16string _widePath;
+    std::u16string _wideTempPath;
+#endif
+    // sorted, so that the file doesn't change when the values don't
+    std::map<std::string, std::string> _values;
+    bool _dirty;
+    bool _quit;
+    std::thread* _writer;
+    // locks _values, _dirty and _quit
+    std::mutex _mutex;
+    // one save at a time, so that an older snapshot never replaces a newer one
+    std::mutex _saveMutex;
+    std::condition_variable _condition;
+};
+
+static UserDefaultStore* s_store = nullptr;
+
+static UserDefaultStore* getStore()
+{
+    if (nullptr == s_store)
+    {
+        s_store = new (std::nothrow) UserDefaultStore(UserDefault::getXMLFilePath());
+    }
+    return s_store;
+}
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+UserDefaultStore::UserDefaultStore(const std::string& filePath)
+: _filePath(filePath)
+, _dirty(false)
+, _quit(false)
+, _writer(nullptr)
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    std::string tempPath = _filePath + ".tmp";
+    _fopenPath = FileUtils::getInstance()->getSuitableFOpen(_filePath);
+    _fopenTempPath = FileUtils::getInstance()->getSuitableFOpen(tempPath);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    StringUtils::UTF8ToUTF16(_filePath, _widePath);
+    StringUtils::UTF8ToUTF16(tempPath, _wideTempPath);
+#endif
+    load();
+}
 
-    // check the key value
-    if (! pKey)
+UserDefaultStore::~UserDefaultStore()
+{
+    if (_writer)
+    {
+        _mutex.lock();
+        _quit = true;
+        _mutex.unlock();
+        _condition.notify_one();
+        _writer->join();
+        delete _writer;
+    }
+
+    save();
+}
+
+void UserDefaultStore::load()
+{
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(_filePath);
+    if (xmlBuffer.empty())
     {
-        return nullptr;
+        CCLOG("can not read xml file");
+        return;
     }
 
-    do 
+    tinyxml2::XMLDocument doc;
+    doc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+
+    tinyxml2::XMLElement* rootNode = doc.RootElement();
+    if (nullptr == rootNode)
     {
-         tinyxml2::XMLDocument* xmlDoc = new tinyxml2::XMLDocument();
-        *doc = xmlDoc;
+        CCLOG("read root node error");
+        return;
+    }
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+    for (auto node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+    {
+        // the first node with a name wins, as it did when the file was searched for each key
+        const char* value = node->FirstChild() ? node->FirstChild()->Value() : "";
+        _values.insert(std::make_pair(std::string(node->Value()), std::string(value)));
+    }
+}
 
-        if (xmlBuffer.empty())
+bool UserDefaultStore::getValue(const char* key, std::string* value)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _values.find(key);
+    // an empty value is read back as a missing one, like an empty node of the file
+    if (it == _values.end() || it->second.empty())
+    {
+        return false;
+    }
+    *value = it->second;
+    return true;
+}
+
+void UserDefaultStore::setValue(const char* key, const char* value)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _values.find(key);
+        if (it != _values.end())
         {
-            CCLOG("can not read xml file");
-            break;
+            if (it->second == value)
+            {
+                return;
+            }
+            it->second = value;
         }
-        xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+        else
+        {
+            _values.insert(std::make_pair(std::string(key), std::string(value)));
+        }
+        _dirty = true;
+    }
+    writeBehind();
+}
 
-        // get root node
-        *rootNode = xmlDoc->RootElement();
-        if (nullptr == *rootNode)
+void UserDefaultStore::deleteValue(const char* key)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (0 == _values.erase(key))
         {
-            CCLOG("read root node error");
-            break;
+            return;
         }
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
+        _dirty = true;
+    }
+    writeBehind();
+}
+
+void UserDefaultStore::writeBehind()
+{
+    if (_writer)
+    {
+        _condition.notify_one();
+        return;
+    }
+
+    _writer = new std::thread([this]() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (true)
         {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
+            _condition.wait(lock, [this]() { return _quit || _dirty; });
+            if (_quit)
             {
                 break;
             }
 
-            curNode = curNode->NextSiblingElement();
-        }
-    } while (0);
+            // let the other changes of the burst come in
+            if (_condition.wait_for(lock, std::chrono::milliseconds(WRITE_BEHIND_DELAY), [this]() { return _quit; }))
+            {
+                break;
+            }
 
-    return curNode;
+            lock.unlock();
+            save();
+            lock.lock();
+        }
+    });
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+bool UserDefaultStore::save()
 {
-     tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    // check the params
-    if (! pKey || ! pValue)
-    {
-        return;
-    }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+    std::lock_guard<std::mutex> saveLock(_saveMutex);
+
+    tinyxml2::XMLDocument doc;
     {
-        if (node->FirstChild())
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_dirty)
         {
-            node->FirstChild()->SetValue(pValue);
+            return true;
         }
-        else
+        _dirty = false;
+
+        doc.LinkEndChild(doc.NewDeclaration(nullptr));
+        tinyxml2::XMLElement* rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+        doc.LinkEndChild(rootNode);
+        for (const auto& value : _values)
         {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
+            tinyxml2::XMLElement* node = doc.NewElement(value.first.c_str());
+            node->LinkEndChild(doc.NewText(value.second.c_str()));
+            rootNode->LinkEndChild(node);
         }
     }
-    else
+
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+
+    // write a temporary file and rename it, the rename replaces the old file at once
+    bool ret = false;
+    FILE* fp = fopen(_fopenTempPath.c_str(), "wb");
+    if (fp)
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        size_t size = printer.CStrSize() - 1;
+        ret = (fwrite(printer.CStr(), 1, size, fp) == size) && (0 == fflush(fp));
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+        ret = ret && (0 == _commit(_fileno(fp)));
+#else
+        ret = ret && (0 == fsync(fileno(fp)));
+#endif
+        fclose(fp);
     }
-
-    // save file and free doc
-    if (doc)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    // rename() doesn't replace an existing file on Windows
+    ret = ret && (0 != MoveFileExW((const wchar_t*)_wideTempPath.c_str(), (const wchar_t*)_widePath.c_str(),
+                                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH));
+#else
+    ret = ret && (0 == rename(_fopenTempPath.c_str(), _fopenPath.c_str()));
+#endif
+
+    if (!ret)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        CCLOG("can not write xml file %s", _filePath.c_str());
+        // try again with the next change or flush
+        std::lock_guard<std::mutex> lock(_mutex);
+        _dirty = true;
     }
+    return ret;
 }
 
 /**
@@ -147,6 +314,8 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    // save the pending changes
+    CC_SAFE_DELETE(s_store);
 }
 
 UserDefault::UserDefault()
@@ -161,14 +330,10 @@ bool UserDefault::getBoolForKey(const char* pKey)
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
     const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
+    std::string storedValue;
+    if (pKey && getStore()->getValue(pKey, &storedValue))
+    {
+        value = storedValue.c_str();
     }
 
     bool ret = defaultValue;
@@ -178,8 +343,6 @@ bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
         ret = (! strcmp(value, "true"));
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -191,14 +354,10 @@ int UserDefault::getIntegerForKey(const char* pKey)
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
     const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
+    std::string storedValue;
+    if (pKey && getStore()->getValue(pKey, &storedValue))
+    {
+        value = storedValue.c_str();
     }
 
     int ret = defaultValue;
@@ -208,12 +367,6 @@ int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
         ret = atoi(value);
     }
 
-    if(doc)
-    {
-        delete doc;
-    }
-
-
     return ret;
 }
 
@@ -237,14 +390,10 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
     const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
+    std::string storedValue;
+    if (pKey && getStore()->getValue(pKey, &storedValue))
+    {
+        value = storedValue.c_str();
     }
 
     double ret = defaultValue;
@@ -254,8 +403,6 @@ double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
         ret = utils::atof(value);
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -267,14 +414,10 @@ std::string UserDefault::getStringForKey(const char* pKey)
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
     const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
+    std::string storedValue;
+    if (pKey && getStore()->getValue(pKey, &storedValue))
+    {
+        value = storedValue.c_str();
     }
 
     string ret = defaultValue;
@@ -284,8 +427,6 @@ string UserDefault::getStringForKey(const char* pKey, const std::string & defaul
         ret = string(value);
     }
 
-    if (doc) delete doc;
-
     return ret;
 }
 
@@ -297,14 +438,10 @@ Data UserDefault::getDataForKey(const char* pKey)
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
     const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
+    std::string storedValue;
+    if (pKey && getStore()->getValue(pKey, &storedValue))
+    {
+        encodedData = storedValue.c_str();
     }
     
     Data ret = defaultValue;
@@ -319,9 +456,7 @@ Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
         }
     }
     
-    if (doc) delete doc;
-    
-    return ret;    
+    return ret;
 }
 
 
@@ -352,7 +487,7 @@ void UserDefault::setIntegerForKey(const char* pKey, int value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%d", value);
 
-    setValueForKey(pKey, tmp);
+    getStore()->setValue(pKey, tmp);
 }
 
 void UserDefault::setFloatForKey(const char* pKey, float value)
@@ -373,7 +508,7 @@ void UserDefault::setDoubleForKey(const char* pKey, double value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%f", value);
 
-    setValueForKey(pKey, tmp);
+    getStore()->setValue(pKey, tmp);
 }
 
 void UserDefault::setStringForKey(const char* pKey, const std::string & value)
@@ -384,7 +519,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    getStore()->setValue(pKey, value.c_str());
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -398,7 +533,8 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
     
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
         
-    setValueForKey(pKey, encodedData);
+    if (encodedData)
+        getStore()->setValue(pKey, encodedData);
     
     if (encodedData)
         free(encodedData);
@@ -501,14 +637,11 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    getStore()->save();
 }
 
 void UserDefault::deleteValueForKey(const char* key)
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-
     // check the params
     if (!key)
     {
@@ -516,24 +649,7 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
-
-    // if node not exist, don't need to delete
-    if (!node)
-    {
-        return;
-    }
-
-    // save file and free doc
-    if (doc)
-    {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
-    }
-
-    flush();
+    getStore()->deleteValue(key);
 }
 
 NS_CC_END
@@ -284,8 +284,13 @@ public:
     virtual void setDataForKey(const char* key, const Data& value);
     /**@~english
      * You should invoke this function to save values set by setXXXForKey().
+     * On the platforms that use the xml file, the values are kept in memory and the file is written by a
+     * background thread shortly after they change, so that many changes are saved at once. flush() writes
+     * the pending changes before returning, replacing the file atomically.
      * @~chinese 
      * 此方法将 setXXXForKey() 设置的数据保存到文件中。
+     * 在使用 xml 文件的平台上，数据保存在内存中，修改后不久由后台线程写入文件，使多次修改只需写入一次。
+     * flush() 在返回之前写入未保存的修改，并以原子方式替换文件。
      * @js NA
      */
     virtual void flush();
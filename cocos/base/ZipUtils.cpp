@@ -40,6 +40,8 @@
 #include "base/ccMacros.h"
 #include "platform/CCFileUtils.h"
 #include <map>
+#include <algorithm>
+#include <climits>
 
 // FIXME: Other platforms should use upstream minizip like mingw-w64  
 #ifdef MINIZIP_FROM_SYSTEM
@@ -494,6 +496,121 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
     setPvrEncryptionKeyPart(3, keyPart4);
 }
 
+// --------------------- InflateStream ---------------------
+
+InflateStream::InflateStream()
+: _stream(nullptr)
+, _totalOut(0)
+, _finished(false)
+, _failed(false)
+{
+}
+
+InflateStream::~InflateStream()
+{
+    end();
+}
+
+void InflateStream::end()
+{
+    if (_stream)
+    {
+        inflateEnd(_stream);
+        delete _stream;
+        _stream = nullptr;
+    }
+}
+
+bool InflateStream::init(const OutputCallback& output, size_t bufferSize)
+{
+    CCASSERT(bufferSize > 0, "bufferSize can't be 0.");
+    end();
+
+    _output = output;
+    _buffer.resize(bufferSize);
+    _totalOut = 0;
+    _finished = false;
+    _failed = false;
+
+    _stream = new (std::nothrow) z_stream;
+    if (_stream == nullptr)
+    {
+        _failed = true;
+        return false;
+    }
+    memset(_stream, 0, sizeof(z_stream));
+
+    // 15 window bits, +32 to detect the zlib or gzip header
+    if (inflateInit2(_stream, 15 + 32) != Z_OK)
+    {
+        CCLOG("cocos2d: InflateStream: can't initialize zlib");
+        delete _stream;
+        _stream = nullptr;
+        _failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool InflateStream::write(const void* data, size_t size)
+{
+    if (_failed || _stream == nullptr)
+    {
+        return false;
+    }
+
+    const unsigned char* in = static_cast<const unsigned char*>(data);
+    while (size > 0)
+    {
+        // avail_in is 32 bits wide
+        uInt chunk = static_cast<uInt>(std::min<size_t>(size, UINT_MAX));
+        _stream->next_in = const_cast<Bytef*>(in);
+        _stream->avail_in = chunk;
+        in += chunk;
+        size -= chunk;
+
+        do
+        {
+            if (_finished)
+            {
+                if (_stream->avail_in == 0)
+                {
+                    break;
+                }
+                // the next gzip member
+                inflateReset(_stream);
+                _finished = false;
+            }
+
+            _stream->next_out = _buffer.data();
+            _stream->avail_out = static_cast<uInt>(_buffer.size());
+            int err = inflate(_stream, Z_NO_FLUSH);
+            if (err == Z_STREAM_END)
+            {
+                _finished = true;
+            }
+            else if (err != Z_OK && !(err == Z_BUF_ERROR && _stream->avail_in == 0))
+            {
+                CCLOG("cocos2d: InflateStream: incorrect compressed data, error %d", err);
+                _failed = true;
+                return false;
+            }
+
+            size_t produced = _buffer.size() - _stream->avail_out;
+            if (produced > 0)
+            {
+                _totalOut += produced;
+                if (_output && !_output(_buffer.data(), produced))
+                {
+                    _failed = true;
+                    return false;
+                }
+            }
+        } while (_stream->avail_in > 0 || _stream->avail_out == 0);
+    }
+    return true;
+}
+
 // --------------------- ZipFile ---------------------
 // from unzip.cpp
 #define UNZ_MAXFILENAMEINZIP 256
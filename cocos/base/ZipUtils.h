@@ -28,6 +28,8 @@ THE SOFTWARE.
 /// @cond DO_NOT_SHOW
 
 #include <string>
+#include <vector>
+#include <functional>
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCPlatformDefine.h"
@@ -39,6 +41,9 @@ THE SOFTWARE.
 #include "platform/CCStdC.h"
 #endif
 
+// forward declaration of the zlib stream used by InflateStream
+struct z_stream_s;
+
 /**
  * @addtogroup base
  * @{
@@ -217,6 +222,63 @@ typedef struct unz_file_info_s unz_file_info;
         static bool s_bEncryptionKeyIsValid;
     };
 
+    /**
+     * Inflates zlib or gzip deflated data incrementally, as it arrives.
+     *
+     * The format is detected from the first bytes. write() can be called with chunks of any size, the
+     * inflated data is passed to the output callback in blocks of at most the buffer size, so that only
+     * one block is held in memory at a time. Concatenated gzip members are inflated one after the other.
+     *
+     * @since v3.10
+     */
+    class CC_DLL InflateStream
+    {
+    public:
+        /**
+         * Receives a block of inflated data, which is only valid during the call.
+         * Returning false aborts the stream.
+         */
+        typedef std::function<bool(const unsigned char* data, size_t size)> OutputCallback;
+
+        InflateStream();
+        ~InflateStream();
+
+        /**
+         * Starts a new stream, the previous one, if any, is discarded.
+         *
+         * @param output Receives the inflated data.
+         * @param bufferSize The largest block passed to output.
+         * @return false if zlib could not be initialized.
+         */
+        bool init(const OutputCallback& output, size_t bufferSize = 16 * 1024);
+
+        /**
+         * Inflates the next chunk of the deflated data.
+         *
+         * @return false if the data is corrupted, if output aborted the stream or if it failed before.
+         */
+        bool write(const void* data, size_t size);
+
+        /** Whether the end of the deflated data was reached. Streams cut short are never finished. */
+        bool isFinished() const { return _finished; }
+
+        /** Whether write() failed. */
+        bool hasFailed() const { return _failed; }
+
+        /** The number of inflated bytes passed to the output callback. */
+        size_t getTotalOut() const { return _totalOut; }
+
+    private:
+        void end();
+
+        z_stream_s* _stream;
+        std::vector<unsigned char> _buffer;
+        OutputCallback _output;
+        size_t _totalOut;
+        bool _finished;
+        bool _failed;
+    };
+
     // forward declaration
     class ZipFilePrivate;
     struct unz_file_info_s;
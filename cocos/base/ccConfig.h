@@ -418,6 +418,15 @@ THE SOFTWARE.
 #define CC_USE_NAVMESH 1
 #endif
 
+/** @~english Replace the OpenGL entry points by a recording null backend, to run the engine without a GPU (Linux only).
+ * Enabled with the USE_NULL_GL CMake option, see NullGL and GLViewHeadless.
+ * @~chinese 用一个记录调用的空后端替换OpenGL函数，以便在没有GPU的机器上运行引擎（仅限Linux）。
+ * 通过CMake选项USE_NULL_GL启用，参见NullGL和GLViewHeadless。
+ */
+#ifndef CC_USE_NULL_GL
+#define CC_USE_NULL_GL 0
+#endif
+
 /** @~english Use culling or not.  @~chinese 是否使用剔除功能。*/
 #ifndef CC_USE_CULLING
 #define CC_USE_CULLING 1
@@ -39,6 +39,8 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCThreadPool.h"
+#include "base/CCFrameJobQueue.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
@@ -131,6 +133,7 @@ THE SOFTWARE.
 #include "2d/CCProgressTimer.h"
 #include "2d/CCProtectedNode.h"
 #include "2d/CCRenderTexture.h"
+#include "2d/CCRetainedBatchNode.h"
 #include "2d/CCScene.h"
 #include "2d/CCTransition.h"
 #include "2d/CCTransitionPageTurn.h"
@@ -152,6 +155,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCGroupCommand.h"
+#include "renderer/CCInstancedMeshCommand.h"
 #include "renderer/CCMaterial.h"
 #include "renderer/CCPass.h"
 #include "renderer/CCPrimitive.h"
@@ -240,6 +244,8 @@ THE SOFTWARE.
     #include "platform/desktop/CCGLViewImpl-desktop.h"
     #include "platform/linux/CCGL-linux.h"
     #include "platform/linux/CCStdC-linux.h"
+    #include "platform/linux/CCNullGL-linux.h"
+    #include "platform/linux/CCGLViewHeadless-linux.h"
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -0,0 +1,631 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "CCNodePrototypeCache.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "CSLoader.h"
+#include "base/ObjectFactory.h"
+#include "base/CCAsyncTaskPool.h"
+#include "cocostudio/CSParseBinary_generated.h"
+#include "cocostudio/WidgetReader/NodeReaderProtocol.h"
+#include "cocostudio/WidgetReader/ProjectNodeReader/ProjectNodeReader.h"
+#include "cocostudio/WidgetReader/ComAudioReader/ComAudioReader.h"
+
+using namespace cocostudio;
+using namespace flatbuffers;
+
+NS_CC_BEGIN
+
+static const size_t DEFAULT_MEMORY_BUDGET = 32 * 1024 * 1024;
+
+// NodePrototype
+
+NodePrototype::NodePrototype()
+: _memorySize(0)
+{
+}
+
+NodePrototype::~NodePrototype()
+{
+    for (auto& entry : _entries)
+    {
+        CC_SAFE_RELEASE(entry.project);
+    }
+    for (auto& sheet : _sheets)
+    {
+        CC_SAFE_RELEASE(sheet.texture);
+    }
+}
+
+bool NodePrototype::initWithData(const std::string& fileName, const Data& data)
+{
+    if (data.isNull())
+    {
+        return false;
+    }
+
+    _fileName = fileName;
+    _data = data;
+
+    auto csparsebinary = GetCSParseBinary(_data.getBytes());
+    auto csBuildId = csparsebinary->version();
+    if (csBuildId)
+    {
+        const std::string& readerBuildId = CSLoader::getInstance()->_csBuildID;
+        CCASSERT(strcmp(readerBuildId.c_str(), csBuildId->c_str()) == 0,
+                 StringUtils::format("%s%s%s%s%s%s%s%s%s%s",
+                                     "The reader build id of your Cocos exported file(",
+                                     csBuildId->c_str(),
+                                     ") and the reader build id in your Cocos2d-x(",
+                                     readerBuildId.c_str(),
+                                     ") are not match.\n",
+                                     "Please get the correct reader(build id ",
+                                     csBuildId->c_str(),
+                                     ")from ",
+                                     "http://www.cocos2d-x.org/filedown/cocos-reader",
+                                     " and replace it in your Cocos2d-x").c_str());
+    }
+
+    // the file lists a sheet for each resource using it
+    auto textures = csparsebinary->textures();
+    int textureSize = textures ? textures->size() : 0;
+    std::unordered_set<std::string> sheetFiles;
+    for (int i = 0; i < textureSize; ++i)
+    {
+        std::string file = textures->Get(i)->c_str();
+        if (sheetFiles.insert(file).second)
+        {
+            Sheet sheet = { file, nullptr };
+            _sheets.push_back(sheet);
+        }
+    }
+
+    if (csparsebinary->nodeTree())
+    {
+        addEntries(csparsebinary->nodeTree());
+    }
+
+    _memorySize = sizeof(NodePrototype) + _data.getSize() + _entries.capacity() * sizeof(Entry);
+    return true;
+}
+
+void NodePrototype::addEntries(const flatbuffers::NodeTree* nodetree)
+{
+    int index = (int)_entries.size();
+
+    Entry entry;
+    entry.kind = Kind::READER;
+    entry.reader = nullptr;
+    entry.options = nodetree->options()->data();
+    entry.project = nullptr;
+    entry.childCount = 0;
+    entry.subtreeSize = 1;
+
+    std::string classname = nodetree->classname()->c_str();
+    if (classname == "ProjectNode")
+    {
+        entry.kind = Kind::PROJECT_NODE;
+        entry.reader = ProjectNodeReader::getInstance();
+        auto projectNodeOptions = (ProjectNodeOptions*)entry.options;
+        std::string filePath = projectNodeOptions->fileName()->c_str();
+        if (filePath != "" && FileUtils::getInstance()->isFileExist(filePath))
+        {
+            entry.project = NodePrototypeCache::getInstance()->getPrototype(filePath);
+            CC_SAFE_RETAIN(entry.project);
+            entry.projectFile = filePath;
+        }
+    }
+    else if (classname == "SimpleAudio")
+    {
+        entry.kind = Kind::SIMPLE_AUDIO;
+        entry.reader = ComAudioReader::getInstance();
+    }
+    else
+    {
+        std::string customClassName = nodetree->customClassName()->c_str();
+        if (customClassName != "")
+        {
+            classname = customClassName;
+        }
+        std::string readername = CSLoader::getInstance()->getGUIClassName(classname);
+        readername.append("Reader");
+
+        // the readers are singletons, see IMPLEMENT_CLASS_NODE_READER_INFO
+        entry.reader = dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
+    }
+    _entries.push_back(entry);
+
+    auto children = nodetree->children();
+    int size = children->size();
+    for (int i = 0; i < size; ++i)
+    {
+        int childIndex = (int)_entries.size();
+        addEntries(children->Get(i));
+        _entries[index].subtreeSize += _entries[childIndex].subtreeSize;
+    }
+    _entries[index].childCount = size;
+}
+
+std::string NodePrototype::getSheetTexturePath(const std::string& sheetFullPath)
+{
+    // binary sheets name their texture in their own format
+    static const std::string binaryExtension(".ccsheet");
+    if (sheetFullPath.empty() || (sheetFullPath.size() > binaryExtension.size()
+        && sheetFullPath.compare(sheetFullPath.size() - binaryExtension.size(), binaryExtension.size(), binaryExtension) == 0))
+    {
+        return "";
+    }
+
+    Data content = FileUtils::getInstance()->getDataFromFile(sheetFullPath);
+    if (content.isNull())
+    {
+        return "";
+    }
+
+    // the same rules as SpriteFrameCache::addSpriteFramesWithFile()
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromData((const char*)content.getBytes(), (int)content.getSize());
+    std::string texturePath;
+    auto metadata = dict.find("metadata");
+    if (metadata != dict.end() && metadata->second.getType() == Value::Type::MAP)
+    {
+        auto& metadataDict = metadata->second.asValueMap();
+        auto textureFileName = metadataDict.find("textureFileName");
+        if (textureFileName != metadataDict.end())
+        {
+            texturePath = textureFileName->second.asString();
+        }
+    }
+
+    if (!texturePath.empty())
+    {
+        return FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, sheetFullPath);
+    }
+
+    texturePath = sheetFullPath;
+    size_t startPos = texturePath.find_last_of(".");
+    if (startPos != std::string::npos)
+    {
+        texturePath.erase(startPos);
+    }
+    return texturePath.append(".png");
+}
+
+void NodePrototype::retainSheetTextures(const std::vector<std::string>& texturePaths)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (size_t i = 0; i < _sheets.size() && i < texturePaths.size(); ++i)
+    {
+        if (texturePaths[i].empty() || _sheets[i].texture)
+        {
+            continue;
+        }
+
+        Texture2D* texture = textureCache->addImage(texturePaths[i]);
+        if (texture)
+        {
+            texture->retain();
+            _sheets[i].texture = texture;
+            _memorySize += (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+        }
+    }
+
+    resolveSheets();
+}
+
+void NodePrototype::resolveSheets()
+{
+    auto spriteFrameCache = SpriteFrameCache::getInstance();
+    for (auto& sheet : _sheets)
+    {
+        if (spriteFrameCache->isSpriteFramesWithFileLoaded(sheet.file))
+        {
+            continue;
+        }
+
+        if (sheet.texture)
+        {
+            spriteFrameCache->addSpriteFramesWithFile(sheet.file, sheet.texture);
+        }
+        else
+        {
+            spriteFrameCache->addSpriteFramesWithFile(sheet.file);
+        }
+    }
+}
+
+// NodePrototypeCache
+
+static NodePrototypeCache* s_sharedNodePrototypeCache = nullptr;
+// changed when the cache is destroyed, so that the pending asynchronous loads are dropped
+static unsigned int s_cacheGeneration = 0;
+
+struct NodePrototypeCache::AsyncLoad
+{
+    std::string fileName;
+    std::string fullPath;
+    Data data;
+    NodePrototype* prototype;
+    std::vector<std::string> sheetPaths;
+    std::vector<std::string> texturePaths;
+    // the textures that weren't cached, and their images decoded by the loading thread, nullptr if it failed
+    std::vector<std::string> decodePaths;
+    std::vector<Image*> images;
+    unsigned int generation;
+
+    ~AsyncLoad()
+    {
+        CC_SAFE_RELEASE(prototype);
+        for (auto image : images)
+        {
+            CC_SAFE_RELEASE(image);
+        }
+    }
+};
+
+NodePrototypeCache* NodePrototypeCache::getInstance()
+{
+    if (!s_sharedNodePrototypeCache)
+    {
+        s_sharedNodePrototypeCache = new (std::nothrow) NodePrototypeCache();
+    }
+    return s_sharedNodePrototypeCache;
+}
+
+void NodePrototypeCache::destroyInstance()
+{
+    if (s_sharedNodePrototypeCache)
+    {
+        ++s_cacheGeneration;
+        CC_SAFE_DELETE(s_sharedNodePrototypeCache);
+    }
+}
+
+NodePrototypeCache::NodePrototypeCache()
+: _enabled(false)
+, _memoryBudget(DEFAULT_MEMORY_BUDGET)
+, _memoryUsage(0)
+{
+    // the prototypes keep textures alive, and a file may resolve to another one once the search paths change
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    _purgeListener = eventDispatcher->addCustomEventListener(EVENT_PURGE_CACHED_DATA, [this](EventCustom* event) {
+        removeAllPrototypes();
+    });
+    _searchPathsListener = eventDispatcher->addCustomEventListener(EVENT_SEARCH_PATHS_CHANGED, [this](EventCustom* event) {
+        removeAllPrototypes();
+    });
+}
+
+NodePrototypeCache::~NodePrototypeCache()
+{
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    eventDispatcher->removeEventListener(_purgeListener);
+    eventDispatcher->removeEventListener(_searchPathsListener);
+
+    removeAllPrototypes();
+}
+
+void NodePrototypeCache::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+    if (!enabled)
+    {
+        removeAllPrototypes();
+    }
+}
+
+NodePrototype* NodePrototypeCache::getPrototype(const std::string& fileName)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
+
+    auto it = _prototypes.find(fullPath);
+    if (it != _prototypes.end())
+    {
+        _recentFiles.splice(_recentFiles.begin(), _recentFiles, it->second.recent);
+        return it->second.prototype;
+    }
+
+    CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
+
+    Data buf = FileUtils::getInstance()->getDataFromFile(fullPath);
+
+    if (buf.isNull())
+    {
+        CCLOG("NodePrototypeCache::getPrototype - failed read file: %s", fileName.c_str());
+        CC_ASSERT(false);
+        return nullptr;
+    }
+
+    auto prototype = new (std::nothrow) NodePrototype();
+    if (!prototype || !prototype->initWithData(fileName, buf))
+    {
+        CC_SAFE_DELETE(prototype);
+        return nullptr;
+    }
+
+    std::vector<std::string> texturePaths;
+    for (auto& sheet : prototype->_sheets)
+    {
+        texturePaths.push_back(NodePrototype::getSheetTexturePath(FileUtils::getInstance()->fullPathForFilename(sheet.file)));
+    }
+    prototype->retainSheetTextures(texturePaths);
+
+    addPrototype(fullPath, prototype);
+    return prototype;
+}
+
+void NodePrototypeCache::loadPrototypeAsync(const std::string& fileName, const std::function<void(NodePrototype*)>& callback)
+{
+    // the paths are resolved on this thread, FileUtils only reads full paths safely on the others
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
+    if (fullPath.empty())
+    {
+        CCLOG("NodePrototypeCache::loadPrototypeAsync - failed read file: %s", fileName.c_str());
+        if (callback)
+        {
+            callback(nullptr);
+        }
+        return;
+    }
+
+    auto it = _prototypes.find(fullPath);
+    if (it != _prototypes.end())
+    {
+        _recentFiles.splice(_recentFiles.begin(), _recentFiles, it->second.recent);
+        if (callback)
+        {
+            callback(it->second.prototype);
+        }
+        return;
+    }
+
+    // the file is already loading
+    auto pending = _asyncCallbacks.find(fullPath);
+    if (pending != _asyncCallbacks.end())
+    {
+        pending->second.push_back(callback);
+        return;
+    }
+    _asyncCallbacks[fullPath].push_back(callback);
+
+    AsyncLoad* load = new AsyncLoad();
+    load->fileName = fileName;
+    load->fullPath = fullPath;
+    load->prototype = nullptr;
+    load->generation = s_cacheGeneration;
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void* param) {
+        AsyncLoad* load = (AsyncLoad*)param;
+        if (load->generation != s_cacheGeneration)
+        {
+            delete load;
+            return;
+        }
+        s_sharedNodePrototypeCache->onAsyncDataLoaded(load);
+    }, (void*)load, [load]() {
+        load->data = FileUtils::getInstance()->getDataFromFile(load->fullPath);
+    });
+}
+
+void NodePrototypeCache::onAsyncDataLoaded(AsyncLoad* load)
+{
+    auto prototype = new (std::nothrow) NodePrototype();
+    if (!prototype || !prototype->initWithData(load->fileName, load->data))
+    {
+        CCLOG("NodePrototypeCache::loadPrototypeAsync - failed read file: %s", load->fileName.c_str());
+        CC_SAFE_DELETE(prototype);
+        finishAsyncLoad(load, nullptr);
+        return;
+    }
+    load->prototype = prototype;
+    load->data = Data::Null;
+
+    for (auto& sheet : prototype->_sheets)
+    {
+        load->sheetPaths.push_back(FileUtils::getInstance()->fullPathForFilename(sheet.file));
+    }
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void* param) {
+        AsyncLoad* load = (AsyncLoad*)param;
+        if (load->generation != s_cacheGeneration)
+        {
+            delete load;
+            return;
+        }
+        s_sharedNodePrototypeCache->onAsyncSheetsLoaded(load);
+    }, (void*)load, [load]() {
+        for (auto& sheetPath : load->sheetPaths)
+        {
+            load->texturePaths.push_back(NodePrototype::getSheetTexturePath(sheetPath));
+        }
+    });
+}
+
+void NodePrototypeCache::onAsyncSheetsLoaded(AsyncLoad* load)
+{
+    // The textures are decoded here rather than by TextureCache::addImageAsync(), whose callbacks can be dropped by
+    // TextureCache::unbindImageAsync() or unbindAllImageAsync(), which would leave the load pending forever
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (auto& texturePath : load->texturePaths)
+    {
+        if (!texturePath.empty() && !textureCache->getTextureForKey(texturePath)
+            && std::find(load->decodePaths.begin(), load->decodePaths.end(), texturePath) == load->decodePaths.end())
+        {
+            load->decodePaths.push_back(texturePath);
+        }
+    }
+
+    if (load->decodePaths.empty())
+    {
+        onAsyncTexturesLoaded(load);
+        return;
+    }
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void* param) {
+        AsyncLoad* load = (AsyncLoad*)param;
+        if (load->generation != s_cacheGeneration)
+        {
+            delete load;
+            return;
+        }
+        s_sharedNodePrototypeCache->onAsyncTexturesLoaded(load);
+    }, (void*)load, [load]() {
+        for (auto& texturePath : load->decodePaths)
+        {
+            // the path is a full one, so FileUtils doesn't touch its caches
+            Image* image = new (std::nothrow) Image();
+            if (image && !image->initWithImageFile(texturePath))
+            {
+                CC_SAFE_RELEASE_NULL(image);
+            }
+            load->images.push_back(image);
+        }
+    });
+}
+
+void NodePrototypeCache::onAsyncTexturesLoaded(AsyncLoad* load)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    for (size_t i = 0; i < load->images.size(); ++i)
+    {
+        // the texture cache keeps the texture of a file loaded in the meantime, a failed one is loaded again by
+        // retainSheetTextures(), which reports the error
+        if (load->images[i])
+        {
+            textureCache->addImage(load->images[i], load->decodePaths[i]);
+        }
+    }
+
+    NodePrototype* prototype = load->prototype;
+    load->prototype = nullptr;
+    auto it = _prototypes.find(load->fullPath);
+    if (it != _prototypes.end())
+    {
+        // getPrototype() loaded the file in the meantime
+        prototype->release();
+        prototype = it->second.prototype;
+    }
+    else
+    {
+        // the textures are cached now, retaining them doesn't load anything
+        prototype->retainSheetTextures(load->texturePaths);
+        addPrototype(load->fullPath, prototype);
+    }
+    finishAsyncLoad(load, prototype);
+}
+
+void NodePrototypeCache::finishAsyncLoad(AsyncLoad* load, NodePrototype* prototype)
+{
+    auto pending = _asyncCallbacks.find(load->fullPath);
+    if (pending != _asyncCallbacks.end())
+    {
+        auto callbacks = std::move(pending->second);
+        _asyncCallbacks.erase(pending);
+
+        // a callback may remove the prototype
+        CC_SAFE_RETAIN(prototype);
+        for (auto& callback : callbacks)
+        {
+            if (callback)
+            {
+                callback(prototype);
+            }
+        }
+        CC_SAFE_RELEASE(prototype);
+    }
+    delete load;
+}
+
+void NodePrototypeCache::addPrototype(const std::string& fullPath, NodePrototype* prototype)
+{
+    _recentFiles.push_front(fullPath);
+    CachedPrototype cached = { prototype, _recentFiles.begin() };
+    _prototypes[fullPath] = cached;
+    _memoryUsage += prototype->getMemorySize();
+
+    evictPrototypes();
+}
+
+void NodePrototypeCache::removeCachedPrototype(std::unordered_map<std::string, CachedPrototype>::iterator it)
+{
+    NodePrototype* prototype = it->second.prototype;
+    _memoryUsage -= prototype->getMemorySize();
+    _recentFiles.erase(it->second.recent);
+    _prototypes.erase(it);
+    prototype->release();
+}
+
+void NodePrototypeCache::evictPrototypes()
+{
+    // removing a prototype may release the nested prototypes it used, which can be removed by the next pass
+    bool removed = true;
+    while (removed && _memoryUsage > _memoryBudget && _recentFiles.size() > 1)
+    {
+        removed = false;
+        auto recent = _recentFiles.end();
+        --recent;
+        while (_memoryUsage > _memoryBudget && recent != _recentFiles.begin())
+        {
+            auto it = _prototypes.find(*recent);
+            --recent;
+            // skip the prototypes in use, by a node being created or by another prototype
+            if (it->second.prototype->getReferenceCount() == 1)
+            {
+                removeCachedPrototype(it);
+                removed = true;
+            }
+        }
+    }
+}
+
+void NodePrototypeCache::removePrototype(const std::string& fileName)
+{
+    auto it = _prototypes.find(FileUtils::getInstance()->fullPathForFilename(fileName));
+    if (it != _prototypes.end())
+    {
+        removeCachedPrototype(it);
+    }
+}
+
+void NodePrototypeCache::removeAllPrototypes()
+{
+    // the nested prototypes are deleted with the last prototype using them
+    for (auto& cached : _prototypes)
+    {
+        cached.second.prototype->release();
+    }
+    _prototypes.clear();
+    _recentFiles.clear();
+    _memoryUsage = 0;
+}
+
+void NodePrototypeCache::setMemoryBudget(size_t budget)
+{
+    _memoryBudget = budget;
+    evictPrototypes();
+}
+
+NS_CC_END
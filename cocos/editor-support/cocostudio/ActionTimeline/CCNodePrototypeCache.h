@@ -0,0 +1,272 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef __cocos2d_libs__CCNodePrototypeCache__
+#define __cocos2d_libs__CCNodePrototypeCache__
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <functional>
+
+#include "cocostudio/CocosStudioExport.h"
+#include "cocos2d.h"
+
+namespace flatbuffers
+{
+    class Table;
+    struct NodeTree;
+}
+
+namespace cocostudio
+{
+    class NodeReaderProtocol;
+}
+
+NS_CC_BEGIN
+
+/** @class NodePrototype
+ * @brief @~english The instantiation plan of a .csb file, see NodePrototypeCache.
+ *
+ * The node tree of the file is flattened in depth first order, each entry holding the reader of its node and the
+ * options of the node, which point into the content of the file kept by the prototype. The readers and the nested
+ * files of the project nodes are resolved once. The sprite sheets of the file are loaded once, and the prototype
+ * retains their textures, so that instantiating it doesn't read or decode anything.
+ * @~chinese 一个.csb文件的实例化方案，参考NodePrototypeCache。
+ *
+ * 文件的节点树按深度优先的顺序展开，每个条目保存其节点的读取器和节点的选项，选项指向原型保存的文件内容。
+ * 读取器和项目节点嵌套的文件只解析一次。文件的精灵表只加载一次，原型持有它们的纹理，因此实例化原型不需要读取或解码任何内容。
+ */
+class CC_STUDIO_DLL NodePrototype : public Ref
+{
+public:
+    /** @~english What creates the node of an entry.
+     * @~chinese 创建条目节点的方式。
+     */
+    enum class Kind
+    {
+        READER,
+        PROJECT_NODE,
+        SIMPLE_AUDIO,
+    };
+
+    /** @~english A node of the tree, its descendants are the entries following it.
+     * @~chinese 树中的一个节点，它的后代是它后面的条目。
+     */
+    struct Entry
+    {
+        Kind kind;
+        cocostudio::NodeReaderProtocol* reader;     // nullptr when the reader of the class isn't registered
+        const flatbuffers::Table* options;
+        NodePrototype* project;                     // the nested file of a project node, nullptr if it doesn't exist
+        std::string projectFile;
+        int childCount;
+        int subtreeSize;                            // the number of entries of the subtree, this one included
+    };
+
+    virtual ~NodePrototype();
+
+    /** @~english The name of the file of the prototype.
+     * @~chinese 原型对应的文件名。
+     */
+    const std::string& getFileName() const { return _fileName; }
+
+    /** @~english The content of the file of the prototype.
+     * @~chinese 原型对应的文件内容。
+     */
+    const Data& getData() const { return _data; }
+
+    /** @~english The nodes of the tree in depth first order, empty if the file has no node tree.
+     * @~chinese 按深度优先顺序排列的树节点，文件没有节点树时为空。
+     */
+    const std::vector<Entry>& getEntries() const { return _entries; }
+
+    /** @~english The memory used by the prototype, the textures it retains included.
+     * @~chinese 原型使用的内存，包括它持有的纹理。
+     */
+    size_t getMemorySize() const { return _memorySize; }
+
+    /** @~english Adds the sprite frames of the sheets of the file to the SpriteFrameCache again,
+     * if they were removed since the last call, using the textures retained by the prototype.
+     * @~chinese 如果文件的精灵表在上次调用后被移除，使用原型持有的纹理把它们的精灵帧重新加入SpriteFrameCache。
+     */
+    void resolveSheets();
+
+CC_CONSTRUCTOR_ACCESS:
+    NodePrototype();
+
+    bool initWithData(const std::string& fileName, const Data& data);
+
+protected:
+    friend class NodePrototypeCache;
+
+    struct Sheet
+    {
+        std::string file;
+        Texture2D* texture;
+    };
+
+    void addEntries(const flatbuffers::NodeTree* nodetree);
+
+    /* Retains the textures of the sheets, texturePaths has one path per sheet, empty when unknown. */
+    void retainSheetTextures(const std::vector<std::string>& texturePaths);
+
+    /* The texture a sheet uses, empty for a binary sheet. Reads the sheet, with a full path it's safe on any thread. */
+    static std::string getSheetTexturePath(const std::string& sheetFullPath);
+
+    std::string _fileName;
+    Data _data;
+    std::vector<Entry> _entries;
+    std::vector<Sheet> _sheets;
+    size_t _memorySize;
+};
+
+/** @class NodePrototypeCache
+ * @brief @~english Caches the prototypes of the .csb files created by CSLoader::createNode().
+ *
+ * CSLoader::createNode() only uses the cache once it's enabled with setEnabled(). The first creation of a file then
+ * parses it into a NodePrototype, the next ones only run the readers of its nodes.
+ * The prototypes are cached by the full path of their file. When they use more memory than the budget, the least
+ * recently used ones are removed, except the ones in use. The textures of the sheets retained by a cached prototype
+ * are not removed by TextureCache::removeUnusedTextures(), they count toward the budget.
+ * All the prototypes are removed by Director::purgeCachedData() and when the search paths of FileUtils change.
+ * @~chinese 缓存由CSLoader::createNode()创建的.csb文件的原型。
+ *
+ * 只有通过setEnabled()启用缓存后，CSLoader::createNode()才会使用它。此时文件第一次创建时被解析为一个NodePrototype，
+ * 之后的创建只运行其节点的读取器。
+ * 原型以其文件的完整路径缓存。当原型使用的内存超过预算时，最近最少使用的原型被移除，正在使用的除外。
+ * 缓存的原型持有的精灵表纹理不会被TextureCache::removeUnusedTextures()移除，它们计入预算。
+ * Director::purgeCachedData()和FileUtils的搜索路径改变时，所有的原型被移除。
+ */
+class CC_STUDIO_DLL NodePrototypeCache
+{
+public:
+    /** @~english Get singleton.
+     * @~chinese 获取单例。
+     */
+    static NodePrototypeCache* getInstance();
+
+    /** @~english Destroy singleton, the pending asynchronous loads are dropped.
+     * @~chinese 销毁单例，未完成的异步加载被丢弃。
+     */
+    static void destroyInstance();
+
+    /** @~english Sets whether CSLoader::createNode() creates the .csb nodes from the cached prototypes, false by
+     * default. Disabling the cache removes all the prototypes.
+     * @~chinese 设置CSLoader::createNode()是否通过缓存的原型创建.csb节点，默认为false。禁用缓存会移除所有的原型。
+     */
+    void setEnabled(bool enabled);
+
+    /** @~english Whether CSLoader::createNode() creates the .csb nodes from the cached prototypes.
+     * @~chinese CSLoader::createNode()是否通过缓存的原型创建.csb节点。
+     */
+    bool isEnabled() const { return _enabled; }
+
+    /** @~english Gets the prototype of a file, loading it if it isn't cached.
+     * @~chinese 获取一个文件的原型，如果没有缓存则加载它。
+     * @param fileName @~english The .csb file. @~chinese .csb文件。
+     * @return @~english The prototype, owned by the cache, or nullptr if the file can't be read.
+     * @~chinese 原型，由缓存持有，文件无法读取时返回nullptr。
+     */
+    NodePrototype* getPrototype(const std::string& fileName);
+
+    /** @~english Loads the prototype of a file in the background: the file and its sprite sheets are read, and the
+     * textures of the sheets are decoded, on other threads. The callback is called on the cocos thread.
+     * The files of the project nodes nested in the file are not loaded in the background: the ones that aren't cached
+     * are loaded with getPrototype() on the cocos thread, once the file is read. Load them first to avoid it.
+     * @~chinese 在后台加载一个文件的原型：文件和它的精灵表在其他线程中读取，精灵表的纹理在其他线程中解码。回调函数在cocos线程中调用。
+     * 文件中嵌套的项目节点的文件不会在后台加载：文件读取之后，没有缓存的嵌套文件在cocos线程中通过getPrototype()加载。
+     * 可以先加载它们来避免这种情况。
+     * @param fileName @~english The .csb file. @~chinese .csb文件。
+     * @param callback @~english Receives the prototype, or nullptr if the file can't be read, may be nullptr.
+     * @~chinese 接收原型，文件无法读取时接收nullptr，可以为nullptr。
+     */
+    void loadPrototypeAsync(const std::string& fileName, const std::function<void(NodePrototype*)>& callback);
+
+    /** @~english Removes the prototype of a file, the nodes created from it are not changed.
+     * @~chinese 移除一个文件的原型，由它创建的节点不受影响。
+     */
+    void removePrototype(const std::string& fileName);
+
+    /** @~english Removes all the prototypes.
+     * @~chinese 移除所有的原型。
+     */
+    void removeAllPrototypes();
+
+    /** @~english Sets the memory the prototypes may use, in bytes, 32 MB by default. The most recently used prototype
+     * is kept even if it's larger.
+     * @~chinese 设置原型可以使用的内存，以字节为单位，默认为32MB。最近使用的原型即使更大也会被保留。
+     */
+    void setMemoryBudget(size_t budget);
+
+    /** @~english Gets the memory the prototypes may use, in bytes.
+     * @~chinese 获取原型可以使用的内存，以字节为单位。
+     */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** @~english Gets the memory used by the cached prototypes, in bytes.
+     * @~chinese 获取缓存的原型使用的内存，以字节为单位。
+     */
+    size_t getMemoryUsage() const { return _memoryUsage; }
+
+protected:
+    struct CachedPrototype
+    {
+        NodePrototype* prototype;
+        std::list<std::string>::iterator recent;
+    };
+
+    struct AsyncLoad;
+
+    NodePrototypeCache();
+    ~NodePrototypeCache();
+
+    /* Caches a prototype created with a reference count of 1, which the cache takes. */
+    void addPrototype(const std::string& fullPath, NodePrototype* prototype);
+    void removeCachedPrototype(std::unordered_map<std::string, CachedPrototype>::iterator it);
+    void evictPrototypes();
+
+    void onAsyncDataLoaded(AsyncLoad* load);
+    void onAsyncSheetsLoaded(AsyncLoad* load);
+    void onAsyncTexturesLoaded(AsyncLoad* load);
+    void finishAsyncLoad(AsyncLoad* load, NodePrototype* prototype);
+
+    // the prototypes and the pending loads by full path
+    std::unordered_map<std::string, CachedPrototype> _prototypes;
+    // the full paths of the prototypes, the most recently used first
+    std::list<std::string> _recentFiles;
+    std::unordered_map<std::string, std::vector<std::function<void(NodePrototype*)>>> _asyncCallbacks;
+
+    bool _enabled;
+    size_t _memoryBudget;
+    size_t _memoryUsage;
+
+    EventListenerCustom* _purgeListener;
+    EventListenerCustom* _searchPathsListener;
+};
+
+NS_CC_END
+
+#endif /* defined(__cocos2d_libs__CCNodePrototypeCache__) */
@@ -28,6 +28,7 @@
 
 #include "../../cocos/ui/CocosGUI.h"
 #include "CCActionTimelineCache.h"
+#include "CCNodePrototypeCache.h"
 #include "CCActionTimeline.h"
 #include "CCActionTimelineNode.h"
 #include "../CCSGUIReader.h"
@@ -180,6 +181,7 @@ CSLoader* CSLoader::getInstance()
 
 void CSLoader::destroyInstance()
 {
+    NodePrototypeCache::destroyInstance();
     CC_SAFE_DELETE(_sharedCSLoader);
     ActionTimelineCache::destroyInstance();
 }
@@ -908,7 +910,25 @@ Node* CSLoader::createNodeWithFlatBuffersFile(const std::string &filename)
 
 Node* CSLoader::createNodeWithFlatBuffersFile(const std::string &filename, const ccNodeLoadCallback &callback)
 {
-    Node* node = nodeWithFlatBuffersFile(filename, callback);
+    Node* node = nullptr;
+    auto prototypeCache = NodePrototypeCache::getInstance();
+    if (prototypeCache->isEnabled())
+    {
+        // The file is parsed once into a prototype, see NodePrototypeCache
+        NodePrototype* prototype = prototypeCache->getPrototype(filename);
+        if (prototype)
+        {
+            // the callback may remove the prototype from the cache
+            prototype->retain();
+            prototype->resolveSheets();
+            node = nodeWithPrototype(prototype, 0, callback);
+            prototype->release();
+        }
+    }
+    else
+    {
+        node = nodeWithFlatBuffersFile(filename, callback);
+    }
 
     reconstructNestNode(node);
 
@@ -1057,23 +1077,7 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
                 node = reader->createNodeWithFlatBuffers(options->data());
             }
             
-            Widget* widget = dynamic_cast<Widget*>(node);
-            if (widget)
-            {
-                std::string callbackName = widget->getCallbackName();
-                std::string callbackType = widget->getCallbackType();
-                
-                bindCallback(callbackName, callbackType, widget, _rootNode);
-            }
-            
-            /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
-            auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
-            if (callbackHandler)
-            {
-                _callbackHandlers.pushBack(node);
-                _rootNode = _callbackHandlers.back();
-            }
-            /**/
+            bindNodeCallbacks(node);
             //        _loadingNodeParentHierarchy.push_back(node);
         }
         
@@ -1091,33 +1095,7 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
             Node* child = nodeWithFlatBuffers(subNodeTree, callback);
             if (child)
             {
-                PageView* pageView = dynamic_cast<PageView*>(node);
-                ListView* listView = dynamic_cast<ListView*>(node);
-                if (pageView)
-                {
-                    Layout* layout = dynamic_cast<Layout*>(child);
-                    if (layout)
-                    {
-                        pageView->addPage(layout);
-                    }
-                }
-                else if (listView)
-                {
-                    Widget* widget = dynamic_cast<Widget*>(child);
-                    if (widget)
-                    {
-                        listView->pushBackCustomItem(widget);
-                    }
-                }
-                else
-                {
-                    node->addChild(child);
-                }
-                
-                if (callback)
-                {
-                    callback(child);
-                }
+                addLoadedChild(node, child, callback);
             }
         }
         
@@ -1127,6 +1105,137 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const
     }
 }
 
+Node* CSLoader::nodeWithPrototype(NodePrototype* prototype, int index, const ccNodeLoadCallback &callback)
+{
+    auto& entries = prototype->getEntries();
+    if (index >= (int)entries.size())
+        return nullptr;
+    
+    const NodePrototype::Entry& entry = entries[index];
+    Node* node = nullptr;
+    
+    switch (entry.kind)
+    {
+        case NodePrototype::Kind::PROJECT_NODE:
+        {
+            cocostudio::timeline::ActionTimeline* action = nullptr;
+            if (entry.project)
+            {
+                entry.project->resolveSheets();
+                node = nodeWithPrototype(entry.project, 0, callback);
+                reconstructNestNode(node);
+                action = timeline::ActionTimelineCache::getInstance()->loadAnimationWithDataBuffer(entry.project->getData(), entry.projectFile);
+            }
+            if (!node)
+            {
+                node = Node::create();
+            }
+            entry.reader->setPropsWithFlatBuffers(node, entry.options);
+            if (action)
+            {
+                // the cached action can only run on one node
+                action = action->clone();
+                action->setTimeSpeed(((ProjectNodeOptions*)entry.options)->innerActionSpeed());
+                node->runAction(action);
+                action->gotoFrameAndPause(0);
+            }
+        }
+            break;
+        case NodePrototype::Kind::SIMPLE_AUDIO:
+        {
+            node = Node::create();
+            auto reader = static_cast<ComAudioReader*>(entry.reader);
+            Component* component = reader->createComAudioWithFlatBuffers(entry.options);
+            if (component)
+            {
+                node->addComponent(component);
+                reader->setPropsWithFlatBuffers(node, entry.options);
+            }
+        }
+            break;
+        default:
+        {
+            if (entry.reader)
+            {
+                node = entry.reader->createNodeWithFlatBuffers(entry.options);
+            }
+            bindNodeCallbacks(node);
+        }
+            break;
+    }
+    
+    // If node is invalid, there is no necessity to process children of node.
+    if (!node)
+    {
+        return nullptr;
+    }
+    
+    int childIndex = index + 1;
+    for (int i = 0; i < entry.childCount; ++i)
+    {
+        Node* child = nodeWithPrototype(prototype, childIndex, callback);
+        if (child)
+        {
+            addLoadedChild(node, child, callback);
+        }
+        childIndex += entries[childIndex].subtreeSize;
+    }
+    
+    return node;
+}
+
+void CSLoader::bindNodeCallbacks(Node* node)
+{
+    Widget* widget = dynamic_cast<Widget*>(node);
+    if (widget)
+    {
+        std::string callbackName = widget->getCallbackName();
+        std::string callbackType = widget->getCallbackType();
+        
+        bindCallback(callbackName, callbackType, widget, _rootNode);
+    }
+    
+    /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
+    auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
+    if (callbackHandler)
+    {
+        _callbackHandlers.pushBack(node);
+        _rootNode = _callbackHandlers.back();
+    }
+    /**/
+}
+
+void CSLoader::addLoadedChild(Node* node, Node* child, const ccNodeLoadCallback &callback)
+{
+    PageView* pageView = dynamic_cast<PageView*>(node);
+    ListView* listView = dynamic_cast<ListView*>(node);
+    if (pageView)
+    {
+        Layout* layout = dynamic_cast<Layout*>(child);
+        if (layout)
+        {
+            pageView->addPage(layout);
+        }
+    }
+    else if (listView)
+    {
+        Widget* widget = dynamic_cast<Widget*>(child);
+        if (widget)
+        {
+            listView->pushBackCustomItem(widget);
+        }
+    }
+    else
+    {
+        node->addChild(child);
+    }
+    
+    if (callback)
+    {
+        callback(child);
+    }
+}
+
 bool CSLoader::bindCallback(const std::string &callbackName,
                             const std::string &callbackType,
                             cocos2d::ui::Widget *sender,
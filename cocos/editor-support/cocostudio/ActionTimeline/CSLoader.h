@@ -65,6 +65,8 @@ NS_CC_BEGIN
 
 typedef std::function<void(Ref*)> ccNodeLoadCallback;
 
+class NodePrototype;
+
 class CC_STUDIO_DLL CSLoader
 {
 public:
@@ -239,6 +241,9 @@ protected:
     cocos2d::Node* createNodeWithFlatBuffersFile(const std::string& filename, const ccNodeLoadCallback& callback);
     cocos2d::Node* nodeWithFlatBuffersFile(const std::string& fileName, const ccNodeLoadCallback& callback);
     cocos2d::Node* nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const ccNodeLoadCallback& callback);
+    cocos2d::Node* nodeWithPrototype(NodePrototype* prototype, int index, const ccNodeLoadCallback& callback);
+    void bindNodeCallbacks(cocos2d::Node* node);
+    void addLoadedChild(cocos2d::Node* node, cocos2d::Node* child, const ccNodeLoadCallback& callback);
     
     cocos2d::Node* loadNode(const rapidjson::Value& json);
     
@@ -290,6 +295,7 @@ protected:
     
     std::string _csBuildID;
     
+    friend class NodePrototype;
 };
 
 NS_CC_END
@@ -75,6 +75,7 @@ ActionTimeline/CCTimeLine.cpp \
 ActionTimeline/CCActionTimeline.cpp \
 ActionTimeline/CCActionTimelineNode.cpp \
 ActionTimeline/CSLoader.cpp \
+ActionTimeline/CCNodePrototypeCache.cpp \
 ActionTimeline/CCBoneNode.cpp \
 ActionTimeline/CCSkeletonNode.cpp \
 ActionTimeline/CCSkinNode.cpp \
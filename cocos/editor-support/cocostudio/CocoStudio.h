@@ -75,6 +75,7 @@ THE SOFTWARE.
 #include "cocostudio/ActionTimeline/CCSkeletonNode.h"
 #include "cocostudio/CocosStudioExport.h"
 #include "cocostudio/ActionTimeline/CSLoader.h"
+#include "cocostudio/ActionTimeline/CCNodePrototypeCache.h"
 
 #include "cocostudio/CocosStudioExport.h"
 
@@ -19,7 +19,9 @@ This file was modified to fit the cocos2d-x project
 */
 
 #include "MathUtil.h"
+#include "math/Mat4.h"
 #include "base/ccMacros.h"
+#include "base/ccTypes.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include <cpu-features.h>
@@ -275,4 +277,36 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVertices(dst, src, count, transform);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVertices(dst, src, count, transform);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVertices(dst, src, count, transform);
+    else MathUtilC::transformVertices(dst, src, count, transform);
+#elif defined (USE_SSE)
+    transformVertices(transform.col, dst, src, count);
+#else
+    MathUtilC::transformVertices(dst, src, count, transform);
+#endif
+}
+
+void MathUtil::transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformIndices(dst, src, count, offset);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformIndices(dst, src, count, offset);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformIndices(dst, src, count, offset);
+    else MathUtilC::transformIndices(dst, src, count, offset);
+#elif defined (USE_SSE) && defined (__SSE2__)
+    transformIndicesSSE2(dst, src, count, offset);
+#else
+    MathUtilC::transformIndices(dst, src, count, offset);
+#endif
+}
+
 NS_CC_MATH_END
@@ -28,6 +28,10 @@
 
 #include "CCMathBase.h"
 
+NS_CC_BEGIN
+struct V3F_C4B_T2F;
+NS_CC_END
+
 /**
  * @addtogroup base
  * @{
@@ -35,6 +39,8 @@
 
 NS_CC_MATH_BEGIN
 
+class Mat4;
+
 /**
 @class MathUtil
 @brief
@@ -122,6 +128,41 @@ public:
      * @~chinese 差值的结果
      */
     static float lerp(float from, float to, float alpha);
+
+    /**@~english
+     * Transforms the positions of an array of interleaved V3F_C4B_T2F vertices by a matrix,
+     * copying the colors and texture coordinates unchanged. Uses SSE or NEON when available.
+     *
+     * @~chinese 
+     * 使用矩阵批量变换交错存储的V3F_C4B_T2F顶点的位置，颜色和纹理坐标直接拷贝。在支持的平台上使用SSE或NEON加速。
+     * 
+     * @param dst @~english the destination vertices, may be the same as src.
+     * @~chinese 目标顶点数组，可以与src相同。
+     * @param src @~english the source vertices.
+     * @~chinese 源顶点数组。
+     * @param count @~english the number of vertices.
+     * @~chinese 顶点数量。
+     * @param transform @~english the transform matrix.
+     * @~chinese 变换矩阵。
+     */
+    static void transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform);
+
+    /**@~english
+     * Adds an offset to every index of an index array. Uses SSE2 or NEON when available.
+     *
+     * @~chinese 
+     * 为索引数组中的每一个索引加上偏移量。在支持的平台上使用SSE2或NEON加速。
+     * 
+     * @param dst @~english the destination indices, may be the same as src.
+     * @~chinese 目标索引数组，可以与src相同。
+     * @param src @~english the source indices.
+     * @~chinese 源索引数组。
+     * @param count @~english the number of indices.
+     * @~chinese 索引数量。
+     * @param offset @~english the offset added to each index.
+     * @~chinese 每个索引要加上的偏移量。
+     */
+    static void transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -143,6 +184,11 @@ private:
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
         
     static void transformVec4(const __m128 m[4], const __m128& v, __m128& dst);
+
+    static void transformVertices(const __m128 m[4], V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count);
+#endif
+#ifdef __SSE2__
+    static void transformIndicesSSE2(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset);
 #endif
     static void addMatrix(const float* m, float scalar, float* dst);
 
@@ -42,6 +42,10 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform);
+    
+    inline static void transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +219,38 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform)
+{
+    // Work on a local copy of the matrix so the compiler knows it does not alias dst.
+    const Mat4 t = transform;
+    const float* m = t.m;
+    const V3F_C4B_T2F* end = src + count;
+    while (src < end)
+    {
+        float x = src->vertices.x;
+        float y = src->vertices.y;
+        float z = src->vertices.z;
+        
+        dst->vertices.x = x * m[0] + y * m[4] + z * m[8] + m[12];
+        dst->vertices.y = x * m[1] + y * m[5] + z * m[9] + m[13];
+        dst->vertices.z = x * m[2] + y * m[6] + z * m[10] + m[14];
+        dst->colors = src->colors;
+        dst->texCoords = src->texCoords;
+        
+        ++dst;
+        ++src;
+    }
+}
+
+inline void MathUtilC::transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset)
+{
+    const unsigned short* end = src + count;
+    while (src < end)
+    {
+        *dst = *src + offset;
+        ++dst;
+        ++src;
+    }
+}
+
 NS_CC_MATH_END
@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +43,10 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+    
+    inline static void transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform);
+    
+    inline static void transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +274,47 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::transformVertices(V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count, const Mat4& transform)
+{
+    float32x4_t col0 = vld1q_f32(&transform.m[0]);
+    float32x4_t col1 = vld1q_f32(&transform.m[4]);
+    float32x4_t col2 = vld1q_f32(&transform.m[8]);
+    float32x4_t col3 = vld1q_f32(&transform.m[12]);
+    
+    const V3F_C4B_T2F* end = src + count;
+    while (src < end)
+    {
+        // Loads x, y, z and the packed color, the color lane is never used as a multiplier
+        float32x4_t v = vld1q_f32(&src->vertices.x);
+        Color4B colors = src->colors;
+        Tex2F texCoords = src->texCoords;
+        
+        float32x4_t r = vmlaq_lane_f32(col3, col0, vget_low_f32(v), 0);   // DST->V = M[m12-m15] + M[m0-m3] * V[x]
+        r = vmlaq_lane_f32(r, col1, vget_low_f32(v), 1);                   // DST->V += M[m4-m7] * V[y]
+        r = vmlaq_lane_f32(r, col2, vget_high_f32(v), 0);                  // DST->V += M[m8-m11] * V[z]
+        
+        // The fourth lane overwrites the color, which is restored right after
+        vst1q_f32(&dst->vertices.x, r);
+        dst->colors = colors;
+        dst->texCoords = texCoords;
+        
+        ++dst;
+        ++src;
+    }
+}
+
+inline void MathUtilNeon::transformIndices(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset)
+{
+    uint16x8_t o = vdupq_n_u16(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 NS_CC_MATH_END
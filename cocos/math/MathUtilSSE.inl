@@ -1,3 +1,7 @@
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 NS_CC_MATH_BEGIN
 
 #ifdef __SSE__
@@ -151,6 +155,54 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformVertices(const __m128 m[4], V3F_C4B_T2F* dst, const V3F_C4B_T2F* src, size_t count)
+{
+    const V3F_C4B_T2F* end = src + count;
+    while (src < end)
+    {
+        // Loads x, y, z and the packed color, the color lane is ignored by the shuffles below
+        __m128 v = _mm_loadu_ps(&src->vertices.x);
+        Color4B colors = src->colors;
+        Tex2F texCoords = src->texCoords;
+        
+        __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+        
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[1], y)),
+                              _mm_add_ps(_mm_mul_ps(m[2], z), m[3])
+                              );
+        
+        // The fourth lane overwrites the color, which is restored right after
+        _mm_storeu_ps(&dst->vertices.x, r);
+        dst->colors = colors;
+        dst->texCoords = texCoords;
+        
+        ++dst;
+        ++src;
+    }
+}
+
+#endif
+
+#ifdef __SSE2__
+
+void MathUtil::transformIndicesSSE2(unsigned short* dst, const unsigned short* src, size_t count, unsigned short offset)
+{
+    __m128i o = _mm_set1_epi16((short)offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(v, o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 #endif
 
 
@@ -6,6 +6,7 @@ LOCAL_MODULE := cocos_network_static
 LOCAL_MODULE_FILENAME := libnetwork
 
 LOCAL_SRC_FILES := HttpClient-android.cpp \
+HttpResponse.cpp \
 SocketIO.cpp \
 WebSocket.cpp \
 CCDownloader.cpp \
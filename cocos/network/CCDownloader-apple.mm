@@ -404,10 +404,10 @@ namespace cocos2d { namespace network {
             // (for a file download task, callback is called in didFinishDownloadingToURL)
             std::string errorString;
 
-            const int64_t buflen = [wrapper totalBytesReceived];
-            char buf[buflen];
-            [wrapper transferDataToBuffer:buf lengthOfBuffer:buflen];
-            std::vector<unsigned char> data(buf, buf + buflen);
+            // only the data not transferred by the progress callbacks is left
+            const int64_t buflen = [wrapper bytesReceived];
+            std::vector<unsigned char> data((size_t)buflen);
+            data.resize((size_t)[wrapper transferDataToBuffer:data.data() lengthOfBuffer:buflen]);
             
             _outer->onTaskFinish(*[wrapper get],
                                  cocos2d::network::DownloadTask::ERROR_NO_ERROR,
@@ -83,6 +83,17 @@ namespace cocos2d { namespace network {
                                        int64_t totalBytesExpected,
                                        std::function<int64_t(void *buffer, int64_t len)>& transferDataToBuffer)
         {
+            // pass the data received since the last progress to onDataTaskReceive, so that it doesn't accumulate
+            if (onDataTaskReceive && transferDataToBuffer && 0 == task.storagePath.length() && bytesReceived > 0)
+            {
+                _receiveBuffer.resize((size_t)bytesReceived);
+                int64_t size = transferDataToBuffer(_receiveBuffer.data(), bytesReceived);
+                if (size > 0)
+                {
+                    onDataTaskReceive(task, _receiveBuffer.data(), size);
+                }
+            }
+
             if (onTaskProgress)
             {
                 onTaskProgress(task, bytesReceived, totalBytesReceived, totalBytesExpected);
@@ -114,7 +125,12 @@ namespace cocos2d { namespace network {
             }
             else
             {
-                // data task
+                // data task, the platforms receiving the data at the end don't stream it
+                if (onDataTaskReceive && data.size())
+                {
+                    onDataTaskReceive(task, data.data(), (int64_t)data.size());
+                    data.clear();
+                }
                 if (onDataTaskSuccess)
                 {
                     onDataTaskSuccess(task, data);
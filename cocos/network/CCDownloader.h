@@ -81,6 +81,13 @@ namespace network {
         std::function<void(const DownloadTask& task,
                            std::vector<unsigned char>& data)> onDataTaskSuccess;
 
+        // When set, receives the data of a data task as it arrives, on the cocos thread, instead of accumulating it,
+        // onDataTaskSuccess is then called with empty data. The platforms only getting the data at the end pass it
+        // in one call.
+        std::function<void(const DownloadTask& task,
+                           const unsigned char* data,
+                           int64_t size)> onDataTaskReceive;
+
         std::function<void(const DownloadTask& task)> onFileTaskSuccess;
         
         std::function<void(const DownloadTask& task,
@@ -99,6 +106,7 @@ namespace network {
         
     private:
         std::unique_ptr<IDownloaderImpl> _impl;
+        std::vector<unsigned char> _receiveBuffer;
     };
 
 }}  // namespace cocos2d::network
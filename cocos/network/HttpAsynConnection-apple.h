@@ -38,6 +38,7 @@
     NSString *sslFile;
     NSDictionary *responseHeader;
     NSMutableData *responseData;
+    BOOL (^dataHandler)(NSData *data);
     NSInteger getDataTime;
     NSInteger responseCode;
     NSString *statusString;
@@ -57,6 +58,9 @@
 
 @property (strong) NSMutableData *responseData;
 
+// receives each chunk of data instead of responseData when set, returning NO cancels the connection
+@property (copy) BOOL (^dataHandler)(NSData *data);
+
 @property (readonly) NSInteger getDataTime;
 
 @property (readonly) NSInteger responseCode;
@@ -39,6 +39,7 @@
 @synthesize sslFile = sslFile;
 @synthesize responseHeader = responseHeader;
 @synthesize responseData = responseData;
+@synthesize dataHandler = dataHandler;
 @synthesize getDataTime = getDataTime;
 @synthesize responseCode = responseCode;
 @synthesize statusString = statusString;
@@ -54,6 +55,7 @@
     [sslFile release];
     [responseHeader release];
     [responseData release];
+    [dataHandler release];
     [responseError release];
     [conn release];
     [runLoop release];
@@ -136,7 +138,18 @@
     didReceiveData:(NSData *)data
 {
     //NSLog(@"get some data");
-    [responseData appendData:data];
+    if (dataHandler)
+    {
+        if (!dataHandler(data))
+        {
+            [connection cancel];
+            finish = true;
+        }
+    }
+    else
+    {
+        [responseData appendData:data];
+    }
     getDataTime++;
 }
 
@@ -706,9 +706,8 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     char* contentInfo = urlConnection.getResponseContent(response);
     if (nullptr != contentInfo) 
     {
-        std::vector<char> * recvBuffer = (std::vector<char>*)response->getResponseData();
-        recvBuffer->clear();
-        recvBuffer->insert(recvBuffer->begin(), (char*)contentInfo, ((char*)contentInfo) + urlConnection.getContentLength());
+        // the whole body comes through JNI at once, it is still passed to where the request wants it
+        response->writeResponseData(contentInfo, urlConnection.getContentLength());
     }
     free(contentInfo);
     
@@ -721,7 +720,12 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     // write data to HttpResponse
     response->setResponseCode(responseCode);
 
-    if (responseCode == -1)
+    if (!response->finishResponseData(responseCode != -1))
+    {
+        response->setSucceed(false);
+        response->setErrorBuffer(response->getResponseDataError());
+    }
+    else if (responseCode == -1)
     {
         response->setSucceed(false);
         response->setErrorBuffer(responseMessage);
@@ -879,6 +883,8 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 HttpClient::HttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(6)
+, _maxRequestsPerHost(0)
 , _isInited(false)
 , _threadCount(0)
 , _requestSentinel(new HttpRequest())
@@ -928,13 +934,25 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    enqueueRequest(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
     _sleepCondition.notify_one();
 }
 
+// Insert a request after the queued ones of the same or of a higher priority, _requestQueueMutex must be locked
+void HttpClient::enqueueRequest(HttpRequest* request)
+{
+    ssize_t index = _requestQueue.size();
+    while (index > 0 && _requestQueue.at(index - 1) != _requestSentinel
+           && _requestQueue.at(index - 1)->getPriority() < request->getPriority())
+    {
+        --index;
+    }
+    _requestQueue.insert(index, request);
+}
+
 void HttpClient::sendImmediate(HttpRequest* request)
 {
     if(nullptr == request)
@@ -1037,6 +1055,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
     
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxConcurrentRequests = std::max(value, 1);
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxRequestsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxRequestsPerHost = std::max(value, 0);
+}
+
+int HttpClient::getMaxRequestsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxRequestsPerHost;
+}
+    
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
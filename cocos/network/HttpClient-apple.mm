@@ -222,6 +222,11 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
         
         httpAsynConn.sslFile = [NSString stringWithUTF8String:sslCaFileName.substr(0, pos).c_str()];
     }
+    // the body is passed to where the request wants it as it arrives
+    HttpResponse *response = (HttpResponse*)stream;
+    httpAsynConn.dataHandler = ^BOOL(NSData *data) {
+        return response->writeResponseData((const char*)[data bytes], [data length]) ? YES : NO;
+    };
     [httpAsynConn startRequest:nsrequest];
     
     while( httpAsynConn.finish != true)
@@ -292,12 +297,6 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
     long headerlen = [headerData length];
     headerBuffer->insert(headerBuffer->end(), (char*)headerptr, (char*)headerptr+headerlen);
 
-    //handle response data
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
-    const void* ptr = [httpAsynConn.responseData bytes];
-    long len = [httpAsynConn.responseData length];
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+len);
-    
     return 1;
 }
 
@@ -371,6 +370,8 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 HttpClient::HttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(6)
+, _maxRequestsPerHost(0)
 , _isInited(false)
 , _threadCount(0)
 , _requestSentinel(new HttpRequest())
@@ -428,13 +429,25 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
     
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    enqueueRequest(request);
     _requestQueueMutex.unlock();
     
     // Notify thread start to work
     _sleepCondition.notify_one();
 }
 
+// Insert a request after the queued ones of the same or of a higher priority, _requestQueueMutex must be locked
+void HttpClient::enqueueRequest(HttpRequest* request)
+{
+    ssize_t index = _requestQueue.size();
+    while (index > 0 && _requestQueue.at(index - 1) != _requestSentinel
+           && _requestQueue.at(index - 1)->getPriority() < request->getPriority())
+    {
+        --index;
+    }
+    _requestQueue.insert(index, request);
+}
+
 void HttpClient::sendImmediate(HttpRequest* request)
 {
     if(!request)
@@ -521,7 +534,7 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     retValue = processTask(this,
                            request,
                            requestType,
-                           response->getResponseData(),
+                           response,
                            &responseCode,
                            response->getResponseHeader(),
                            responseMessage);
@@ -529,7 +542,12 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     // write data to HttpResponse
     response->setResponseCode(responseCode);
     
-    if (retValue != 0) 
+    if (!response->finishResponseData(retValue != 0))
+    {
+        response->setSucceed(false);
+        response->setErrorBuffer(response->getResponseDataError());
+    }
+    else if (retValue != 0) 
     {
         response->setSucceed(true);
     }
@@ -589,6 +607,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
     
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxConcurrentRequests = std::max(value, 1);
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxRequestsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxRequestsPerHost = std::max(value, 0);
+}
+
+int HttpClient::getMaxRequestsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxRequestsPerHost;
+}
+    
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
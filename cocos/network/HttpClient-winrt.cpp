@@ -197,7 +197,12 @@ namespace network {
         }
 
         writeData(xhr.getResponseHeader(), response->getResponseHeader());
-        writeData(xhr.getResponseData(), response->getResponseData());
+        std::vector<char>* responseData = xhr.getResponseData();
+        if (responseData && !responseData->empty())
+        {
+            // the whole body is received at once, it is still passed to where the request wants it
+            response->writeResponseData(responseData->data(), responseData->size());
+        }
         retValue = ok ? 0 : 1;
         errorStr = xhr.getErrorMessage();
         responseCode = xhr.getStatusCode();
@@ -205,7 +210,12 @@ namespace network {
         // write data to HttpResponse
         response->setResponseCode(responseCode);
 
-        if (retValue != 0)
+        if (!response->finishResponseData(retValue == 0))
+        {
+            response->setSucceed(false);
+            response->setErrorBuffer(response->getResponseDataError());
+        }
+        else if (retValue != 0)
         {
             response->setSucceed(false);
             response->setErrorBuffer(errorStr.c_str());
@@ -248,6 +258,8 @@ namespace network {
     HttpClient::HttpClient()
         : _timeoutForConnect(30)
         , _timeoutForRead(60)
+        , _maxConcurrentRequests(6)
+        , _maxRequestsPerHost(0)
     {
     }
 
@@ -299,7 +311,7 @@ namespace network {
 
         if (nullptr != s_requestQueue) {
             s_requestQueueMutex.lock();
-            s_requestQueue->pushBack(request);
+            enqueueRequest(request);
             s_requestQueueMutex.unlock();
 
             // Notify thread start to work
@@ -307,6 +319,18 @@ namespace network {
         }
     }
 
+    // Insert a request after the queued ones of the same or of a higher priority, s_requestQueueMutex must be locked
+    void HttpClient::enqueueRequest(HttpRequest* request)
+    {
+        ssize_t index = s_requestQueue->size();
+        while (index > 0 && s_requestQueue->at(index - 1) != s_requestSentinel
+               && s_requestQueue->at(index - 1)->getPriority() < request->getPriority())
+        {
+            --index;
+        }
+        s_requestQueue->insert(index, request);
+    }
+
     void HttpClient::sendImmediate(HttpRequest* request)
     {
         if (!request)
@@ -322,6 +346,30 @@ namespace network {
         t.detach();
     }
 
+    void HttpClient::setMaxConcurrentRequests(int value)
+    {
+        std::lock_guard<std::mutex> lock(_concurrencyMutex);
+        _maxConcurrentRequests = std::max(value, 1);
+    }
+
+    int HttpClient::getMaxConcurrentRequests()
+    {
+        std::lock_guard<std::mutex> lock(_concurrencyMutex);
+        return _maxConcurrentRequests;
+    }
+
+    void HttpClient::setMaxRequestsPerHost(int value)
+    {
+        std::lock_guard<std::mutex> lock(_concurrencyMutex);
+        _maxRequestsPerHost = std::max(value, 0);
+    }
+
+    int HttpClient::getMaxRequestsPerHost()
+    {
+        std::lock_guard<std::mutex> lock(_concurrencyMutex);
+        return _maxRequestsPerHost;
+    }
+
     // Poll and notify main thread if responses exists in queue
     void HttpClient::dispatchResponseCallbacks()
     {
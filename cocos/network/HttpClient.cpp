@@ -26,6 +26,8 @@
 
 #include "HttpClient.h"
 #include <queue>
+#include <unordered_map>
+#include <algorithm>
 #include <errno.h>
 #include <curl/curl.h>
 #include "base/CCDirector.h"
@@ -46,14 +48,12 @@ typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *str
 // Callback function used by libcurl for collect response data
 static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse *response = (HttpResponse*)stream;
     size_t sizes = size * nmemb;
     
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
+    // pass data to where the request wants it, the response data by default
+    // write data maybe called more than once in a single request, returning less than sizes aborts it
+    return response->writeResponseData((char*)ptr, sizes) ? sizes : 0;
 }
 
 // Callback function used by libcurl for collect header data
@@ -70,56 +70,305 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
 }
 
 
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
+static bool initCURL(HttpClient* client, CURL* handle, HttpRequest* request, curl_slist** headers, write_callback callback, void* stream, write_callback headerCallback, void* headerStream, char* errorBuffer);
+static bool setRequestTypeOptions(CURL* handle, HttpRequest* request);
+
+// The longest wait for socket activity while requests are running, so that new requests start soon after send()
+static const long TRANSFER_POLL_INTERVAL = 10;
+
+// A request of the queue performed by the curl multi handle of the network thread
+struct HttpTransfer
+{
+    HttpRequest* request;
+    HttpResponse* response;
+    CURL* handle;
+    curl_slist* headers;
+    std::string host;
+    char errorBuffer[HttpClient::RESPONSE_BUFFER_SIZE];
+};
+
+// Returns "scheme://host[:port]" of url, the requests with the same key count for the same host
+static std::string getHostKey(const std::string& url)
+{
+    size_t begin = url.find("://");
+    std::string scheme = (begin == std::string::npos) ? "http" : url.substr(0, begin);
+    begin = (begin == std::string::npos) ? 0 : begin + 3;
+
+    size_t end = url.find_first_of("/?#", begin);
+    std::string authority = url.substr(begin, (end == std::string::npos) ? std::string::npos : end - begin);
+    size_t userInfo = authority.rfind('@');
+    if (userInfo != std::string::npos)
+    {
+        authority.erase(0, userInfo + 1);
+    }
+
+    std::string key = scheme + "://" + authority;
+    std::transform(key.begin(), key.end(), key.begin(), ::tolower);
+    return key;
+}
 
 // Worker thread
 void HttpClient::networkThread()
 {   
 	increaseThreadCount();
-    
-    while (true) 
-    {
-        HttpRequest *request;
 
-        // step 1: send http request if the requestQueue isn't empty
+    // the connections, the DNS cache and the TLS sessions of the multi handle are reused by all the requests,
+    // the share handle gives them the same cookies too; both are only used by this thread
+    CURLM* multiHandle = curl_multi_init();
+    CURLSH* shareHandle = curl_share_init();
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+
+    std::vector<HttpTransfer*> transfers;
+    std::vector<CURL*> idleHandles;
+    std::unordered_map<std::string, int> hostTransfers;
+    std::vector<HttpRequest*> startingRequests;
+    int maxConnects = 0;
+    bool quit = false;
+
+    auto finishTransfer = [&](HttpTransfer* transfer, CURLcode code) {
+        HttpResponse* response = transfer->response;
+        long responseCode = -1;
+        if (code == CURLE_OK && transfer->handle)
         {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-			{
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
+            curl_easy_getinfo(transfer->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+        }
+        else if (transfer->errorBuffer[0] == '\0')
+        {
+            strncpy(transfer->errorBuffer, curl_easy_strerror(code), RESPONSE_BUFFER_SIZE - 1);
         }
 
-        if (request == _requestSentinel) {
-            break;
+        // write data to HttpResponse
+        response->setResponseCode(responseCode);
+        bool succeeded = (code == CURLE_OK && responseCode >= 200 && responseCode < 300);
+        if (!response->finishResponseData(succeeded))
+        {
+            response->setSucceed(false);
+            response->setErrorBuffer(response->getResponseDataError());
+        }
+        else if (!succeeded)
+        {
+            response->setSucceed(false);
+            response->setErrorBuffer(transfer->errorBuffer);
+        }
+        else
+        {
+            response->setSucceed(true);
         }
 
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-        
-		processResponse(response, _responseMessage);
-        
+        if (transfer->handle)
+        {
+#if LIBCURL_VERSION_NUM >= 0x071101
+            // the shared cookies are written to the cookie file when a handle is cleaned up, pooled handles never are
+            if (!getCookieFilename().empty())
+            {
+                curl_easy_setopt(transfer->handle, CURLOPT_COOKIELIST, "FLUSH");
+            }
+#endif
+            // keep the handle for the next requests
+            curl_easy_reset(transfer->handle);
+            idleHandles.push_back(transfer->handle);
+        }
+        if (transfer->headers)
+        {
+            curl_slist_free_all(transfer->headers);
+        }
+        auto host = hostTransfers.find(transfer->host);
+        if (--host->second == 0)
+        {
+            hostTransfers.erase(host);
+        }
+        transfers.erase(std::find(transfers.begin(), transfers.end(), transfer));
+        delete transfer;
 
         // add response packet into queue
         _responseQueueMutex.lock();
         _responseQueue.pushBack(response);
         _responseQueueMutex.unlock();
-        
+
 		_schedulerMutex.lock();
 		if (nullptr != _scheduler)
 		{
 			_scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
 		}
 		_schedulerMutex.unlock();
+    };
+    
+    while (!quit) 
+    {
+        int maxConcurrentRequests;
+        int maxRequestsPerHost;
+        {
+            std::lock_guard<std::mutex> lock(_concurrencyMutex);
+            maxConcurrentRequests = _maxConcurrentRequests;
+            maxRequestsPerHost = _maxRequestsPerHost;
+        }
+        if (maxConnects != maxConcurrentRequests * 2)
+        {
+            // keep enough idle connections for the next requests to all the hosts in use
+            maxConnects = maxConcurrentRequests * 2;
+            curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, (long)maxConnects);
+        }
+
+        // step 1: take the requests that the limits allow from the requestQueue, it is sorted by priority
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (_requestQueue.empty() && transfers.empty())
+			{
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+
+            ssize_t index = 0;
+            while (index < _requestQueue.size()
+                   && (int)(transfers.size() + startingRequests.size()) < maxConcurrentRequests)
+            {
+                HttpRequest* request = _requestQueue.at(index);
+                if (request == _requestSentinel)
+                {
+                    // the requests sent before destroyInstance() are performed first
+                    quit = (index == 0 && transfers.empty() && startingRequests.empty());
+                    break;
+                }
+
+                int& hostCount = hostTransfers[getHostKey(request->getUrl())];
+                if (maxRequestsPerHost > 0 && hostCount >= maxRequestsPerHost)
+                {
+                    // the host is busy, look for a request to another host
+                    ++index;
+                    continue;
+                }
+                ++hostCount;
+
+                // the retain of send() keeps the request
+                startingRequests.push_back(request);
+                _requestQueue.erase(index);
+            }
+        }
+
+        // step 2: add the requests to the multi handle
+        for (auto request : startingRequests)
+        {
+            // Create a HttpResponse object, the default setting is http access failed
+            HttpTransfer* transfer = new (std::nothrow) HttpTransfer();
+            transfer->request = request;
+            transfer->response = new (std::nothrow) HttpResponse(request);
+            transfer->headers = nullptr;
+            transfer->host = getHostKey(request->getUrl());
+            transfer->errorBuffer[0] = '\0';
+            if (idleHandles.empty())
+            {
+                transfer->handle = curl_easy_init();
+            }
+            else
+            {
+                transfer->handle = idleHandles.back();
+                idleHandles.pop_back();
+            }
+            transfers.push_back(transfer);
+
+            if (!transfer->handle)
+            {
+                strncpy(transfer->errorBuffer, "Alloc curl handle failed.", RESPONSE_BUFFER_SIZE - 1);
+                finishTransfer(transfer, CURLE_OUT_OF_MEMORY);
+                continue;
+            }
+
+            bool ok = initCURL(this, transfer->handle, request, &transfer->headers,
+                               writeData, transfer->response,
+                               writeHeaderData, transfer->response->getResponseHeader(),
+                               transfer->errorBuffer)
+                && setRequestTypeOptions(transfer->handle, request)
+                && CURLE_OK == curl_easy_setopt(transfer->handle, CURLOPT_SHARE, shareHandle)
+                && CURLE_OK == curl_easy_setopt(transfer->handle, CURLOPT_PRIVATE, transfer)
+                && CURLM_OK == curl_multi_add_handle(multiHandle, transfer->handle);
+            if (!ok)
+            {
+                finishTransfer(transfer, CURLE_FAILED_INIT);
+            }
+        }
+        startingRequests.clear();
+
+        if (transfers.empty())
+        {
+            continue;
+        }
+
+        // step 3: libcurl async access, all the running requests progress together
+        int runningHandles = 0;
+        CURLMcode mcode = CURLM_CALL_MULTI_PERFORM;
+        while (CURLM_CALL_MULTI_PERFORM == mcode)
+        {
+            mcode = curl_multi_perform(multiHandle, &runningHandles);
+        }
+        if (CURLM_OK != mcode)
+        {
+            CCLOGERROR("HttpClient: curl_multi_perform failed: %s", curl_multi_strerror(mcode));
+            while (!transfers.empty())
+            {
+                curl_multi_remove_handle(multiHandle, transfers.back()->handle);
+                finishTransfer(transfers.back(), CURLE_FAILED_INIT);
+            }
+            continue;
+        }
+
+        bool finished = false;
+        CURLMsg* message;
+        int messagesInQueue = 0;
+        while ((message = curl_multi_info_read(multiHandle, &messagesInQueue)))
+        {
+            if (message->msg == CURLMSG_DONE)
+            {
+                HttpTransfer* transfer = nullptr;
+                curl_easy_getinfo(message->easy_handle, CURLINFO_PRIVATE, (char**)&transfer);
+                CURLcode code = message->data.result;
+                curl_multi_remove_handle(multiHandle, transfer->handle);
+                finishTransfer(transfer, code);
+                finished = true;
+            }
+        }
+
+        // step 4: wait for socket activity, unless finished requests made room for queued ones
+        if (!finished && !transfers.empty())
+        {
+            long timeoutMS = -1;
+            curl_multi_timeout(multiHandle, &timeoutMS);
+            if (timeoutMS < 0 || timeoutMS > TRANSFER_POLL_INTERVAL)
+            {
+                timeoutMS = TRANSFER_POLL_INTERVAL;
+            }
+
+            /* get file descriptors from the transfers */
+            fd_set fdread;
+            fd_set fdwrite;
+            fd_set fdexcep;
+            int maxfd = -1;
+
+            FD_ZERO(&fdread);
+            FD_ZERO(&fdwrite);
+            FD_ZERO(&fdexcep);
+
+            curl_multi_fdset(multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+            if (maxfd == -1)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMS));
+            }
+            else
+            {
+                struct timeval timeout;
+                timeout.tv_sec = timeoutMS / 1000;
+                timeout.tv_usec = (timeoutMS % 1000) * 1000;
+                select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &timeout);
+            }
+        }
+    }
+
+    for (auto handle : idleHandles)
+    {
+        curl_easy_cleanup(handle);
     }
+    curl_multi_cleanup(multiHandle);
+    curl_share_cleanup(shareHandle);
     
     // cleanup: if worker thread received quit signal, clean up un-completed request queue
     _requestQueueMutex.lock();
@@ -179,11 +428,11 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, HttpClient::getInstance()->getTimeoutForRead());
+    code = curl_easy_setopt(handle, CURLOPT_TIMEOUT, client->getTimeoutForRead());
     if (code != CURLE_OK) {
         return false;
     }
-    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, HttpClient::getInstance()->getTimeoutForConnect());
+    code = curl_easy_setopt(handle, CURLOPT_CONNECTTIMEOUT, client->getTimeoutForConnect());
     if (code != CURLE_OK) {
         return false;
     }
@@ -204,9 +453,76 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
 
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
 
+#if LIBCURL_VERSION_NUM >= 0x071900
+    // keep the idle connections of the network thread open for the next requests to the same host
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+#endif
+
     return true;
 }
 
+// Inits a CURL handle for request, the custom headers are appended to *headers, which the caller frees
+static bool initCURL(HttpClient* client, CURL* handle, HttpRequest* request, curl_slist** headers, write_callback callback, void* stream, write_callback headerCallback, void* headerStream, char* errorBuffer)
+{
+    if (!configureCURL(client, handle, errorBuffer))
+        return false;
+
+    /* get custom header data (if set) */
+    std::vector<std::string> customHeaders = request->getHeaders();
+    if (!customHeaders.empty())
+    {
+        /* append custom headers one by one */
+        for (std::vector<std::string>::iterator it = customHeaders.begin(); it != customHeaders.end(); ++it)
+            *headers = curl_slist_append(*headers, it->c_str());
+        /* set custom headers for curl */
+        if (CURLE_OK != curl_easy_setopt(handle, CURLOPT_HTTPHEADER, *headers))
+            return false;
+    }
+    std::string cookieFilename = client->getCookieFilename();
+    if (!cookieFilename.empty()) {
+        if (CURLE_OK != curl_easy_setopt(handle, CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
+            return false;
+        }
+        if (CURLE_OK != curl_easy_setopt(handle, CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+            return false;
+        }
+    }
+
+    return CURLE_OK == curl_easy_setopt(handle, CURLOPT_URL, request->getUrl())
+        && CURLE_OK == curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, callback)
+        && CURLE_OK == curl_easy_setopt(handle, CURLOPT_WRITEDATA, stream)
+        && CURLE_OK == curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, headerCallback)
+        && CURLE_OK == curl_easy_setopt(handle, CURLOPT_HEADERDATA, headerStream);
+}
+
+// Sets the options of the type of request: GET, POST, PUT or DELETE
+static bool setRequestTypeOptions(CURL* handle, HttpRequest* request)
+{
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET: // HTTP GET
+        return CURLE_OK == curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+    case HttpRequest::Type::POST: // HTTP POST
+        return CURLE_OK == curl_easy_setopt(handle, CURLOPT_POST, 1L)
+            && CURLE_OK == curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request->getRequestData())
+            && CURLE_OK == curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, (long)request->getRequestDataSize());
+
+    case HttpRequest::Type::PUT:
+        return CURLE_OK == curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, "PUT")
+            && CURLE_OK == curl_easy_setopt(handle, CURLOPT_POSTFIELDS, request->getRequestData())
+            && CURLE_OK == curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, (long)request->getRequestDataSize());
+
+    case HttpRequest::Type::DELETE:
+        return CURLE_OK == curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, "DELETE")
+            && CURLE_OK == curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+
+    default:
+        CCLOGERROR("CCHttpClient: unknown request type, only GET, POST, PUT and DELETE are supported");
+        return false;
+    }
+}
+
 class CURLRaii
 {
     /// Instance of CURL
@@ -229,12 +545,6 @@ public:
             curl_slist_free_all(_headers);
     }
 
-    template <class T>
-    bool setOption(CURLoption option, T data)
-    {
-        return CURLE_OK == curl_easy_setopt(_curl, option, data);
-    }
-
     /**
      * @brief Inits CURL instance for common usage
      * @param request Null not allowed
@@ -243,38 +553,9 @@ public:
      */
     bool init(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, write_callback headerCallback, void* headerStream, char* errorBuffer)
     {
-        if (!_curl)
-            return false;
-		if (!configureCURL(client, _curl, errorBuffer))
-            return false;
-
-        /* get custom header data (if set) */
-        std::vector<std::string> headers=request->getHeaders();
-        if(!headers.empty())
-        {
-            /* append custom headers one by one */
-            for (std::vector<std::string>::iterator it = headers.begin(); it != headers.end(); ++it)
-                _headers = curl_slist_append(_headers,it->c_str());
-            /* set custom headers for curl */
-            if (!setOption(CURLOPT_HTTPHEADER, _headers))
-                return false;
-        }
-		std::string cookieFilename = client->getCookieFilename();
-		if (!cookieFilename.empty()) {
-			if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
-                return false;
-            }
-			if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
-                return false;
-            }
-        }
-
-        return setOption(CURLOPT_URL, request->getUrl())
-                && setOption(CURLOPT_WRITEFUNCTION, callback)
-                && setOption(CURLOPT_WRITEDATA, stream)
-                && setOption(CURLOPT_HEADERFUNCTION, headerCallback)
-                && setOption(CURLOPT_HEADERDATA, headerStream);
-        
+        return _curl
+            && initCURL(client, _curl, request, &_headers, callback, stream, headerCallback, headerStream, errorBuffer)
+            && setRequestTypeOptions(_curl, request);
     }
 
     /// @param responseCode Null not allowed
@@ -293,51 +574,6 @@ public:
     }
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
-{
-    CURLRaii curl;
-	bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
-}
-
 // HttpClient implementation
 HttpClient* HttpClient::getInstance()
 {
@@ -398,6 +634,8 @@ void HttpClient::setSSLVerification(const std::string& caFile)
 HttpClient::HttpClient()
 : _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(6)
+, _maxRequestsPerHost(0)
 , _isInited(false)
 , _threadCount(0)
 , _requestSentinel(new HttpRequest())
@@ -448,13 +686,25 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
 	_requestQueueMutex.lock();
-	_requestQueue.pushBack(request);
+	enqueueRequest(request);
 	_requestQueueMutex.unlock();
 
 	// Notify thread start to work
 	_sleepCondition.notify_one();
 }
 
+// Insert a request after the queued ones of the same or of a higher priority, _requestQueueMutex must be locked
+void HttpClient::enqueueRequest(HttpRequest* request)
+{
+    ssize_t index = _requestQueue.size();
+    while (index > 0 && _requestQueue.at(index - 1) != _requestSentinel
+           && _requestQueue.at(index - 1)->getPriority() < request->getPriority())
+    {
+        --index;
+    }
+    _requestQueue.insert(index, request);
+}
+
 void HttpClient::sendImmediate(HttpRequest* request)
 {
     if(!request)
@@ -515,56 +765,30 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
 	int retValue = 0;
 
 	// Process the request -> get response packet
-	switch (request->getRequestType())
-	{
-	case HttpRequest::Type::GET: // HTTP GET
-		retValue = processGetTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::POST: // HTTP POST
-		retValue = processPostTask(this, request,
+	CURLRaii curl;
+	if (curl.init(this, request,
 			writeData,
-			response->getResponseData(),
-			&responseCode,
+			response,
 			writeHeaderData,
 			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::PUT:
-		retValue = processPutTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	case HttpRequest::Type::DELETE:
-		retValue = processDeleteTask(this, request,
-			writeData,
-			response->getResponseData(),
-			&responseCode,
-			writeHeaderData,
-			response->getResponseHeader(),
-			responseMessage);
-		break;
-
-	default:
-		CCASSERT(true, "CCHttpClient: unknown request type, only GET and POSt are supported");
-		break;
+			responseMessage)
+		&& curl.perform(&responseCode))
+	{
+		retValue = 0;
+	}
+	else
+	{
+		retValue = 1;
 	}
 
 	// write data to HttpResponse
 	response->setResponseCode(responseCode);
-	if (retValue != 0)
+	if (!response->finishResponseData(retValue == 0))
+	{
+		response->setSucceed(false);
+		response->setErrorBuffer(response->getResponseDataError());
+	}
+	else if (retValue != 0)
 	{
 		response->setSucceed(false);
 		response->setErrorBuffer(responseMessage);
@@ -623,6 +847,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
     
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxConcurrentRequests = std::max(value, 1);
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxRequestsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    _maxRequestsPerHost = std::max(value, 0);
+}
+
+int HttpClient::getMaxRequestsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_concurrencyMutex);
+    return _maxRequestsPerHost;
+}
+    
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -194,6 +194,55 @@ public:
      */
     int getTimeoutForRead();
     
+    /**@~english
+     * Set the number of requests added by send() that are performed at the same time, 6 by default.
+     * The requests of a client share their connections, which stay open between requests to the same host.
+     * Set it to 1 to perform the requests one after the other, in the order of the queue.
+     * Only the libcurl implementation performs several requests at the same time.
+     *
+     * @~chinese 
+     * 设置同时执行的send()请求的数量，默认为6。客户端的请求共享连接，对同一主机的请求之间连接保持打开。
+     * 设置为1时按照队列的顺序逐个执行请求。只有libcurl的实现会同时执行多个请求。
+     * 
+     * @param value @~english the number of concurrent requests, at least 1.
+     * @~chinese 并发请求的数量，至少为1。
+     */
+    void setMaxConcurrentRequests(int value);
+    
+    /**@~english
+     * Get the number of requests added by send() that are performed at the same time.
+     *
+     * @~chinese 
+     * 获取同时执行的send()请求的数量。
+     * 
+     * @return @~english the number of concurrent requests.
+     * @~chinese 并发请求的数量。
+     */
+    int getMaxConcurrentRequests();
+    
+    /**@~english
+     * Set the number of requests to the same host that are performed at the same time, 0 (no limit) by default.
+     * The requests waiting for a busy host don't delay the requests to the other hosts.
+     *
+     * @~chinese 
+     * 设置同时执行的对同一主机的请求数量，默认为0（不限制）。等待繁忙主机的请求不会推迟对其他主机的请求。
+     * 
+     * @param value @~english the number of concurrent requests per host, 0 for no limit.
+     * @~chinese 每个主机的并发请求数量，0表示不限制。
+     */
+    void setMaxRequestsPerHost(int value);
+    
+    /**@~english
+     * Get the number of requests to the same host that are performed at the same time.
+     *
+     * @~chinese 
+     * 获取同时执行的对同一主机的请求数量。
+     * 
+     * @return @~english the number of concurrent requests per host, 0 for no limit.
+     * @~chinese 每个主机的并发请求数量，0表示不限制。
+     */
+    int getMaxRequestsPerHost();
+    
     /**@~english
      *Get the Cookie object
      *
@@ -243,6 +292,7 @@ private:
     void networkThreadAlone(HttpRequest* request, HttpResponse* response);
 
     void dispatchResponseCallbacks();
+    void enqueueRequest(HttpRequest* request);
     
     void processResponse(HttpResponse* response, char* responseMessage);
     void increaseThreadCount();
@@ -257,6 +307,10 @@ private:
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
     
+    int _maxConcurrentRequests;
+    int _maxRequestsPerHost;
+    std::mutex _concurrencyMutex;
+    
     int  _threadCount;
     std::mutex _threadCountMutex;
     
@@ -43,8 +43,11 @@ namespace network {
 class HttpClient;
 class HttpResponse;
 
+class HttpRequest;
+
 typedef std::function<void(HttpClient* client, HttpResponse* response)> ccHttpRequestCallback;
 typedef void (cocos2d::Ref::*SEL_HttpResponse)(HttpClient* client, HttpResponse* response);
+typedef std::function<bool(HttpRequest* request, const char* data, size_t size)> ccHttpResponseDataCallback;
 #define httpresponse_selector(_SELECTOR) (cocos2d::network::SEL_HttpResponse)(&_SELECTOR)
 
 /** @~english
@@ -101,6 +104,11 @@ public:
         _pSelector = nullptr;
         _pCallback = nullptr;
         _pUserData = nullptr;
+        _priority = 0;
+        _responseDataCallback = nullptr;
+        _responseBuffer = nullptr;
+        _responseBufferCapacity = 0;
+        _responseDecompressed = false;
     };
     
     /** @~english Destructor.  @~chinese 析构函数。*/
@@ -439,6 +447,178 @@ public:
    	{
    		return _headers;
    	}
+
+    /** @~english
+     * Set the priority of the request. HttpClient::send() queues a request after the queued requests of the same
+     * or of a higher priority, and before the ones of a lower priority. The default priority is 0.
+     *
+     * @~chinese 
+     * 设置请求的优先级。HttpClient::send()把请求排在相同或更高优先级的请求之后，更低优先级的请求之前。默认优先级为0。
+     * 
+     * @param priority @~english the priority, higher values are sent first.
+     * @~chinese 优先级，值越大越先发送。
+     */
+    inline void setPriority(int priority)
+    {
+        _priority = priority;
+    }
+    
+    /** @~english
+     * Get the priority of the request.
+     *
+     * @~chinese 
+     * 获取请求的优先级。
+     * 
+     * @return @~english the priority of the request.
+     * @~chinese 请求的优先级。
+     */
+    inline int getPriority()
+    {
+        return _priority;
+    }
+
+    /** @~english
+     * Stream the response body to a callback instead of keeping it in HttpResponse::getResponseData().
+     * The callback is called on the network thread with each chunk of the body as it arrives, the chunk is only
+     * valid during the call. Returning false aborts the request, which then fails.
+     * It takes precedence over setResponseFile() and setResponseBuffer().
+     *
+     * @~chinese 
+     * 把响应体流式地传给回调函数，而不是保存在HttpResponse::getResponseData()中。
+     * 回调函数在网络线程中调用，参数是刚收到的一段响应体，它只在调用期间有效。返回false会中止请求，请求失败。
+     * 它优先于setResponseFile()和setResponseBuffer()。
+     * 
+     * @param callback @~english the callback, nullptr to keep the body in the response.
+     * @~chinese 回调函数，nullptr表示把响应体保存在响应中。
+     */
+    inline void setResponseDataCallback(const ccHttpResponseDataCallback& callback)
+    {
+        _responseDataCallback = callback;
+    }
+    
+    /** @~english
+     * Get the callback receiving the response body.
+     *
+     * @~chinese 
+     * 获取接收响应体的回调函数。
+     * 
+     * @return @~english the callback set by setResponseDataCallback().
+     * @~chinese setResponseDataCallback()设置的回调函数。
+     */
+    inline const ccHttpResponseDataCallback& getResponseDataCallback()
+    {
+        return _responseDataCallback;
+    }
+
+    /** @~english
+     * Write the response body to a file as it arrives, instead of keeping it in HttpResponse::getResponseData().
+     * An existing file is replaced. The file is removed if the request fails.
+     * It takes precedence over setResponseBuffer().
+     *
+     * @~chinese 
+     * 把收到的响应体写入文件，而不是保存在HttpResponse::getResponseData()中。已存在的文件会被替换。如果请求失败，文件会被删除。
+     * 它优先于setResponseBuffer()。
+     * 
+     * @param path @~english the full path of the file, an empty string to keep the body in the response.
+     * @~chinese 文件的完整路径，空字符串表示把响应体保存在响应中。
+     */
+    inline void setResponseFile(const std::string& path)
+    {
+        _responseFile = path;
+    }
+    
+    /** @~english
+     * Get the file receiving the response body.
+     *
+     * @~chinese 
+     * 获取接收响应体的文件。
+     * 
+     * @return @~english the path set by setResponseFile().
+     * @~chinese setResponseFile()设置的路径。
+     */
+    inline const std::string& getResponseFile()
+    {
+        return _responseFile;
+    }
+
+    /** @~english
+     * Copy the response body into a buffer owned by the caller, instead of keeping it in
+     * HttpResponse::getResponseData(). The request fails if the body doesn't fit, the number of bytes written is
+     * HttpResponse::getResponseDataLength(). The buffer must stay valid until the response callback is called.
+     *
+     * @~chinese 
+     * 把响应体复制到调用者拥有的缓冲区中，而不是保存在HttpResponse::getResponseData()中。如果缓冲区放不下响应体，请求失败，
+     * 写入的字节数为HttpResponse::getResponseDataLength()。缓冲区在响应回调被调用之前必须有效。
+     * 
+     * @param buffer @~english the buffer, nullptr to keep the body in the response.
+     * @~chinese 缓冲区，nullptr表示把响应体保存在响应中。
+     * @param capacity @~english the size of the buffer in bytes.
+     * @~chinese 缓冲区的字节数。
+     */
+    inline void setResponseBuffer(char* buffer, size_t capacity)
+    {
+        _responseBuffer = buffer;
+        _responseBufferCapacity = buffer ? capacity : 0;
+    }
+    
+    /** @~english
+     * Get the buffer receiving the response body.
+     *
+     * @~chinese 
+     * 获取接收响应体的缓冲区。
+     * 
+     * @return @~english the buffer set by setResponseBuffer().
+     * @~chinese setResponseBuffer()设置的缓冲区。
+     */
+    inline char* getResponseBuffer()
+    {
+        return _responseBuffer;
+    }
+    
+    /** @~english
+     * Get the size of the buffer receiving the response body.
+     *
+     * @~chinese 
+     * 获取接收响应体的缓冲区的字节数。
+     * 
+     * @return @~english the capacity set by setResponseBuffer().
+     * @~chinese setResponseBuffer()设置的字节数。
+     */
+    inline size_t getResponseBufferCapacity()
+    {
+        return _responseBufferCapacity;
+    }
+
+    /** @~english
+     * Inflate a gzip or zlib compressed response body while it arrives, see InflateStream.
+     * The response data, its callback, its file or its buffer then receive the inflated body. The request fails
+     * if the body isn't compressed or is cut short. The default value is false.
+     *
+     * @~chinese 
+     * 在接收gzip或zlib压缩的响应体的同时将其解压，参考InflateStream。响应数据、回调函数、文件或者缓冲区接收的是解压后的响应体。
+     * 如果响应体没有被压缩或者不完整，请求失败。默认值为false。
+     * 
+     * @param decompressed @~english whether the body is inflated.
+     * @~chinese 是否解压响应体。
+     */
+    inline void setResponseDecompressed(bool decompressed)
+    {
+        _responseDecompressed = decompressed;
+    }
+    
+    /** @~english
+     * Get whether the response body is inflated while it arrives.
+     *
+     * @~chinese 
+     * 获取是否在接收响应体的同时将其解压。
+     * 
+     * @return @~english the value set by setResponseDecompressed().
+     * @~chinese setResponseDecompressed()设置的值。
+     */
+    inline bool isResponseDecompressed()
+    {
+        return _responseDecompressed;
+    }
     
 private:
     inline void doSetResponseCallback(Ref* pTarget, SEL_HttpResponse pSelector)
@@ -467,6 +647,12 @@ protected:
     ccHttpRequestCallback       _pCallback;      /// C++11 style callbacks
     void*                       _pUserData;      /// You can add your customed data here 
     std::vector<std::string>    _headers;		      /// custom http headers
+    int                         _priority;       /// requests of a higher priority are sent first
+    ccHttpResponseDataCallback  _responseDataCallback;   /// receives the body on the network thread
+    std::string                 _responseFile;           /// receives the body when not empty
+    char*                       _responseBuffer;         /// receives the body when not nullptr
+    size_t                      _responseBufferCapacity;
+    bool                        _responseDecompressed;   /// the body is inflated before it is received
 };
 
 }
@@ -0,0 +1,189 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "network/HttpResponse.h"
+#include <string.h>
+#include "base/ZipUtils.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+namespace network {
+
+HttpResponse::~HttpResponse()
+{
+    if (_responseFileHandle)
+    {
+        // the request was dropped before it finished
+        finishResponseData(false);
+    }
+    CC_SAFE_DELETE(_inflateStream);
+
+    if (_pHttpRequest)
+    {
+        _pHttpRequest->release();
+    }
+}
+
+void HttpResponse::failResponseData(const std::string& error)
+{
+    if (!_responseDataFailed)
+    {
+        _responseDataFailed = true;
+        _responseDataError = error;
+    }
+}
+
+bool HttpResponse::startResponseData()
+{
+    _responseDataStarted = true;
+    if (_pHttpRequest == nullptr)
+    {
+        return true;
+    }
+
+    if (_pHttpRequest->isResponseDecompressed())
+    {
+        _inflateStream = new (std::nothrow) InflateStream();
+        if (_inflateStream == nullptr
+            || !_inflateStream->init([this](const unsigned char* data, size_t size) {
+                return receiveResponseData((const char*)data, size);
+            }))
+        {
+            failResponseData("can't initialize the decompression of the response");
+            return false;
+        }
+    }
+
+    if (!_pHttpRequest->getResponseDataCallback() && !_pHttpRequest->getResponseFile().empty())
+    {
+        const std::string& path = _pHttpRequest->getResponseFile();
+        _responseFileHandle = fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "wb");
+        if (_responseFileHandle == nullptr)
+        {
+            failResponseData("can't open the response file: " + path);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool HttpResponse::receiveResponseData(const char* data, size_t size)
+{
+    HttpRequest* request = _pHttpRequest;
+    if (request && request->getResponseDataCallback())
+    {
+        if (!request->getResponseDataCallback()(request, data, size))
+        {
+            failResponseData("the response was aborted by its data callback");
+            return false;
+        }
+    }
+    else if (_responseFileHandle)
+    {
+        if (fwrite(data, 1, size, _responseFileHandle) != size)
+        {
+            failResponseData("can't write the response file: " + request->getResponseFile());
+            return false;
+        }
+    }
+    else if (request && request->getResponseBuffer())
+    {
+        if (size > request->getResponseBufferCapacity() - _responseDataLength)
+        {
+            failResponseData("the response doesn't fit in its buffer");
+            return false;
+        }
+        memcpy(request->getResponseBuffer() + _responseDataLength, data, size);
+    }
+    else
+    {
+        _responseData.insert(_responseData.end(), data, data + size);
+    }
+
+    _responseDataLength += size;
+    return true;
+}
+
+bool HttpResponse::writeResponseData(const char* data, size_t size)
+{
+    if (!_responseDataStarted && !startResponseData())
+    {
+        return false;
+    }
+    if (_responseDataFailed)
+    {
+        return false;
+    }
+    if (size == 0)
+    {
+        return true;
+    }
+
+    if (_inflateStream)
+    {
+        if (!_inflateStream->write(data, size))
+        {
+            failResponseData("incorrect compressed data in the response");
+            return false;
+        }
+        return true;
+    }
+    return receiveResponseData(data, size);
+}
+
+bool HttpResponse::finishResponseData(bool succeeded)
+{
+    // an empty body still creates the response file
+    if (!_responseDataStarted && succeeded)
+    {
+        startResponseData();
+    }
+
+    if (succeeded && !_responseDataFailed && _inflateStream && !_inflateStream->isFinished())
+    {
+        failResponseData("the compressed response is incomplete");
+    }
+
+    if (_responseFileHandle)
+    {
+        if (fclose(_responseFileHandle) != 0)
+        {
+            failResponseData("can't write the response file: " + _pHttpRequest->getResponseFile());
+        }
+        _responseFileHandle = nullptr;
+
+        if (!succeeded || _responseDataFailed)
+        {
+            FileUtils::getInstance()->removeFile(_pHttpRequest->getResponseFile());
+        }
+    }
+    CC_SAFE_DELETE(_inflateStream);
+
+    return !_responseDataFailed;
+}
+
+}
+
+NS_CC_END
@@ -26,6 +26,7 @@
 #ifndef __HTTP_RESPONSE__
 #define __HTTP_RESPONSE__
 
+#include <stdio.h>
 #include "network/HttpRequest.h"
 
 /**
@@ -35,6 +36,8 @@
 
 NS_CC_BEGIN
 
+class InflateStream;
+
 namespace network {
 
 /** 
@@ -66,6 +69,11 @@ public:
         _responseData.clear();
         _errorBuffer.clear();
         _responseDataString = "";
+        _responseDataLength = 0;
+        _responseDataStarted = false;
+        _responseDataFailed = false;
+        _responseFileHandle = nullptr;
+        _inflateStream = nullptr;
     }
     
     /** @~english
@@ -75,13 +83,7 @@ public:
      * 析构函数时, 它也在HttpClient内部调用。
      * 用户不需手动的触发这个析构函数。
      */
-    virtual ~HttpResponse()
-    {
-        if (_pHttpRequest)
-        {
-            _pHttpRequest->release();
-        }
-    }
+    virtual ~HttpResponse();
     
     /** @~english
      * Override autorelease method to prevent developers from calling it.
@@ -142,6 +144,19 @@ public:
     {
         return &_responseData;
     }
+
+    /** @~english
+     * Get the length of the response body, which is also the number of bytes passed to the response data callback,
+     * or written to the response file or buffer of the request, see HttpRequest::setResponseDataCallback().
+     * @~chinese 
+     * 获取响应体的长度，也就是传给请求的响应数据回调函数、写入响应文件或缓冲区的字节数，参考HttpRequest::setResponseDataCallback()。
+     * @return @~english the length of the response body, after it is inflated.
+     * @~chinese 响应体的长度，解压之后的长度。
+     */
+    inline size_t getResponseDataLength()
+    {
+        return _responseDataLength;
+    }
     
     /**@~english
      * Get the response headers.
@@ -210,6 +225,47 @@ public:
     inline void setResponseData(std::vector<char>* data)
     {
         _responseData = *data;
+        _responseDataLength = _responseData.size();
+    }
+
+    /** @~english
+     * Pass the next chunk of the response body to where the request wants it, it is used by HttpClient.
+     * The body is inflated first if the request asks for it, then passed to the response data callback, written
+     * to the response file or buffer, or else appended to the response data.
+     * @~chinese 
+     * 把下一段响应体交给请求指定的目标，它由HttpClient调用。如果请求需要，响应体先被解压，
+     * 然后传给响应数据回调函数，写入响应文件或缓冲区，否则追加到响应数据之后。
+     * @param data @~english the chunk of the body.
+     * @~chinese 一段响应体。
+     * @param size @~english the size of the chunk.
+     * @~chinese 这段响应体的大小。
+     * @return @~english false if the body can't be received, getResponseDataError() tells why.
+     * @~chinese 如果无法接收响应体，返回false，getResponseDataError()返回原因。
+     */
+    bool writeResponseData(const char* data, size_t size);
+
+    /** @~english
+     * Close the response file and check that the whole body was received, it is used by HttpClient
+     * after the last call to writeResponseData().
+     * @~chinese 
+     * 关闭响应文件，检查是否接收了整个响应体，HttpClient在最后一次调用writeResponseData()之后调用它。
+     * @param succeeded @~english whether the request succeeded, the response file is removed otherwise.
+     * @~chinese 请求是否成功，否则删除响应文件。
+     * @return @~english false if a chunk of the body couldn't be received, or if the body is incomplete.
+     * @~chinese 如果有一段响应体无法接收，或者响应体不完整，返回false。
+     */
+    bool finishResponseData(bool succeeded);
+
+    /** @~english
+     * Get why the response body couldn't be received.
+     * @~chinese 
+     * 获取无法接收响应体的原因。
+     * @return @~english the reason, an empty string if there was no error.
+     * @~chinese 原因，没有错误时为空字符串。
+     */
+    inline const char* getResponseDataError()
+    {
+        return _responseDataError.c_str();
     }
     
     /** @~english
@@ -280,6 +336,9 @@ public:
     
 protected:
     bool initWithRequest(HttpRequest* request);
+    bool startResponseData();
+    bool receiveResponseData(const char* data, size_t size);
+    void failResponseData(const std::string& error);
     
     // properties
     HttpRequest*        _pHttpRequest;  /// the corresponding HttpRequest pointer who leads to this response 
@@ -289,6 +348,12 @@ protected:
     long                _responseCode;    /// the status code returned from libcurl, e.g. 200, 404
     std::string         _errorBuffer;   /// if _responseCode != 200, please read _errorBuffer to find the reason
     std::string         _responseDataString; // the returned raw data. You can also dump it as a string
+    size_t              _responseDataLength;    /// the length of the received body
+    bool                _responseDataStarted;
+    bool                _responseDataFailed;
+    std::string         _responseDataError;     /// why the body couldn't be received
+    FILE*               _responseFileHandle;    /// the open response file of the request
+    InflateStream*      _inflateStream;         /// inflates the body if the request wants it
     
 };
 
@@ -33,19 +33,58 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <queue>
 #include <list>
+#include <deque>
+#include <algorithm>
 #include <signal.h>
 #include <errno.h>
 
 #include "libwebsockets.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef WSAPOLLFD WsPollFd;
+#define wsPoll WSAPoll
+#define wsCloseSocket closesocket
+#else
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+typedef struct pollfd WsPollFd;
+#define wsPoll poll
+#define wsCloseSocket close
+#endif
+
 #define WS_WRITE_BUFFER_SIZE 2048
 
+// The number of messages to the UI thread that a websocket holds before they are moved to a slower queue
+#define WS_UI_MESSAGE_SLOT_COUNT 32
+// The payload buffer allocated for each message slot, the buffers grow with the largest messages and are kept
+#define WS_UI_MESSAGE_BUFFER_SIZE 2048
+// The longest wait of the websocket thread, libwebsockets checks the timeouts of the connections every second
+#define WS_SERVICE_TIMEOUT_MS 1000
+// The wait of the websocket thread while messages wait for room in the ring of a websocket
+#define WS_PENDING_MESSAGES_TIMEOUT_MS 5
+
 NS_CC_BEGIN
 
 namespace network {
 
+enum WS_MSG {
+    WS_MSG_TO_SUBTRHEAD_SENDING_STRING = 0,
+    WS_MSG_TO_SUBTRHEAD_SENDING_BINARY,
+    WS_MSG_TO_UITHREAD_OPEN,
+    WS_MSG_TO_UITHREAD_MESSAGE,
+    WS_MSG_TO_UITHREAD_ERROR,
+    WS_MSG_TO_UITHREAD_CLOSE
+};
+
 class WsMessage
 {
 public:
@@ -56,6 +95,9 @@ public:
 
 /**
  *  @brief Websocket thread helper, it's used for sending message between UI thread and websocket thread.
+ *
+ *  The messages to the UI thread are written by the websocket thread in a ring of slots and read by the UI thread,
+ *  without locking. Each slot keeps its payload buffer, so that receiving a message doesn't allocate memory.
  */
 class WsThreadHelper : public Ref
 {
@@ -63,36 +105,110 @@ public:
     WsThreadHelper();
     ~WsThreadHelper();
         
-    // Creates a new thread
+    // Adds the websocket to the websocket thread shared by all the websockets
     bool createThread(const WebSocket& ws);
-    // Quits sub-thread (websocket thread).
+    // Makes the websocket thread release the websocket.
     void quitSubThread();
     
     // Schedule callback function
     virtual void update(float dt);
     
     // Sends message to UI thread. It's needed to be invoked in sub-thread.
-    void sendMessageToUIThread(WsMessage *msg);
+    void sendMessageToUIThread(unsigned int what, const char* bytes = nullptr, ssize_t len = 0, bool isBinary = false);
+    
+    // Moves the messages waiting for room in the ring to it, returns false if some are left. Invoked in sub-thread.
+    bool flushPendingUIMessages();
     
     // Sends message to sub-thread(websocket thread). It's needs to be invoked in UI thread.
     void sendMessageToSubThread(WsMessage *msg);
     
-    // Waits the sub-thread (websocket thread) to exit,
+    // Waits the sub-thread (websocket thread) to release the websocket,
     void joinSubThread();
     
-    
-protected:
-    void wsThreadEntryFunc();
+    // Invoked by the websocket thread once it released the websocket.
+    void onSubThreadEnded();
     
 private:
-    std::list<WsMessage*>* _UIWsMessageQueue;
+    struct UIMessageSlot
+    {
+        WsMessage msg;
+        WebSocket::Data data;
+        std::vector<char> buffer;
+    };
+    
+    struct PendingUIMessage
+    {
+        unsigned int what;
+        std::vector<char> bytes;
+        bool isBinary;
+    };
+    
+    bool pushUIMessage(unsigned int what, const char* bytes, ssize_t len, bool isBinary);
+    
+    // Written by the websocket thread from _UIMessageTail, read by the UI thread from _UIMessageHead
+    UIMessageSlot _UIMessageSlots[WS_UI_MESSAGE_SLOT_COUNT];
+    std::atomic<unsigned int> _UIMessageHead;
+    std::atomic<unsigned int> _UIMessageTail;
+    // Messages waiting for room in the ring, only used by the websocket thread
+    std::deque<PendingUIMessage> _pendingUIMessages;
+    
     std::list<WsMessage*>* _subThreadWsMessageQueue;
-    std::mutex   _UIWsMessageQueueMutex;
     std::mutex   _subThreadWsMessageQueueMutex;
-    std::thread* _subThreadInstance;
+    std::atomic<bool> _subThreadWsMessageQueued;
+    
+    std::mutex _subThreadEndedMutex;
+    std::condition_variable _subThreadEndedCondition;
+    bool _subThreadEnded;
+    
     WebSocket* _ws;
-    bool _needQuit;
+    std::atomic<bool> _needQuit;
+    // Set by joinSubThread(), the UI thread doesn't read the messages while it waits
+    std::atomic<bool> _joining;
     friend class WebSocket;
+    friend class WsServiceThread;
+};
+
+/**
+ *  @brief The thread servicing the connections of all the websockets.
+ *
+ *  It waits with poll() on the sockets of all the libwebsockets contexts and on a socket that wakeUp() writes to,
+ *  then services the contexts whose sockets are ready. A context is only serviced by this thread.
+ */
+class WsServiceThread
+{
+public:
+    static WsServiceThread* getInstance();
+    
+    // Adds a websocket, its context is created by the websocket thread. Invoked in UI thread.
+    void addWebSocket(WebSocket* ws);
+    
+    // Makes the websocket thread look at the websockets without waiting for their sockets. Invoked in any thread.
+    void wakeUp();
+    
+    // Follows the sockets of the contexts, see LWS_CALLBACK_ADD_POLL_FD. Invoked in sub-thread.
+    void setPollFd(WebSocket* ws, int fd, int events);
+    void removePollFd(int fd);
+    
+private:
+    WsServiceThread();
+    
+    void threadEntryFunc();
+    void removeWebSocket(WebSocket* ws);
+    
+    std::mutex _newWebSocketsMutex;
+    std::vector<WebSocket*> _newWebSockets;
+    
+    // only used by the websocket thread, the first poll fd is the wake up socket
+    std::vector<WebSocket*> _webSockets;
+    std::vector<WsPollFd> _pollFds;
+    std::vector<WebSocket*> _pollFdOwners;
+    
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    SOCKET _wakeUpSocket;
+#else
+    int _wakeUpSocket;
+#endif
+    bool _canWakeUp;
 };
 
 // Wrapper for converting websocket callback from static function to member function of WebSocket class.
@@ -116,11 +232,18 @@ public:
 
 // Implementation of WsThreadHelper
 WsThreadHelper::WsThreadHelper()
-: _subThreadInstance(nullptr)
+: _UIMessageHead(0)
+, _UIMessageTail(0)
+, _subThreadWsMessageQueued(false)
+, _subThreadEnded(false)
 , _ws(nullptr)
 , _needQuit(false)
+, _joining(false)
 {
-    _UIWsMessageQueue = new std::list<WsMessage*>();
+    for (auto& slot : _UIMessageSlots)
+    {
+        slot.buffer.reserve(WS_UI_MESSAGE_BUFFER_SIZE);
+    }
     _subThreadWsMessageQueue = new std::list<WsMessage*>();
     
     Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
@@ -130,8 +253,13 @@ WsThreadHelper::~WsThreadHelper()
 {
     Director::getInstance()->getScheduler()->unscheduleAllForTarget(this);
     joinSubThread();
-    CC_SAFE_DELETE(_subThreadInstance);
-    delete _UIWsMessageQueue;
+    for (auto msg : *_subThreadWsMessageQueue)
+    {
+        WebSocket::Data* data = (WebSocket::Data*)msg->obj;
+        CC_SAFE_DELETE_ARRAY(data->bytes);
+        CC_SAFE_DELETE(data);
+        CC_SAFE_DELETE(msg);
+    }
     delete _subThreadWsMessageQueue;
 }
 
@@ -139,8 +267,8 @@ bool WsThreadHelper::createThread(const WebSocket& ws)
 {
     _ws = const_cast<WebSocket*>(&ws);
     
-    // Creates websocket thread
-    _subThreadInstance = new std::thread(&WsThreadHelper::wsThreadEntryFunc, this);
+    // The websocket thread creates the context of the websocket
+    WsServiceThread::getInstance()->addWebSocket(_ws);
     return true;
 }
 
@@ -149,84 +277,348 @@ void WsThreadHelper::quitSubThread()
     _needQuit = true;
 }
 
-void WsThreadHelper::wsThreadEntryFunc()
+bool WsThreadHelper::pushUIMessage(unsigned int what, const char* bytes, ssize_t len, bool isBinary)
 {
-    _ws->onSubThreadStarted();
+    unsigned int tail = _UIMessageTail.load(std::memory_order_relaxed);
+    if (tail - _UIMessageHead.load(std::memory_order_acquire) == WS_UI_MESSAGE_SLOT_COUNT)
+    {
+        return false;
+    }
     
-    while (!_needQuit)
+    UIMessageSlot& slot = _UIMessageSlots[tail % WS_UI_MESSAGE_SLOT_COUNT];
+    slot.msg.what = what;
+    slot.msg.obj = nullptr;
+    if (what == WS_MSG_TO_UITHREAD_MESSAGE)
     {
-        if (_ws->onSubThreadLoop())
+        slot.buffer.assign(bytes, bytes + len);
+        if (!isBinary)
         {
-            break;
+            // text messages are null terminated
+            slot.buffer.push_back('\0');
         }
+        slot.data.bytes = slot.buffer.data();
+        slot.data.len = len;
+        slot.data.issued = 0;
+        slot.data.isBinary = isBinary;
+        slot.msg.obj = &slot.data;
     }
     
+    _UIMessageTail.store(tail + 1, std::memory_order_release);
+    return true;
 }
 
-void WsThreadHelper::sendMessageToUIThread(WsMessage *msg)
+void WsThreadHelper::sendMessageToUIThread(unsigned int what, const char* bytes, ssize_t len, bool isBinary)
 {
-    std::lock_guard<std::mutex> lk(_UIWsMessageQueueMutex);
-    _UIWsMessageQueue->push_back(msg);
+    if (_pendingUIMessages.empty() && pushUIMessage(what, bytes, len, isBinary))
+    {
+        return;
+    }
+    
+    // the UI thread is late, keep the message until the ring has room for it
+    PendingUIMessage pending;
+    pending.what = what;
+    if (bytes)
+    {
+        pending.bytes.assign(bytes, bytes + len);
+    }
+    pending.isBinary = isBinary;
+    _pendingUIMessages.push_back(std::move(pending));
 }
 
-void WsThreadHelper::sendMessageToSubThread(WsMessage *msg)
+bool WsThreadHelper::flushPendingUIMessages()
 {
-    std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
-    _subThreadWsMessageQueue->push_back(msg);
+    while (!_pendingUIMessages.empty())
+    {
+        const PendingUIMessage& pending = _pendingUIMessages.front();
+        if (!pushUIMessage(pending.what, pending.bytes.data(), (ssize_t)pending.bytes.size(), pending.isBinary))
+        {
+            return false;
+        }
+        _pendingUIMessages.pop_front();
+    }
+    return true;
 }
 
-void WsThreadHelper::joinSubThread()
+void WsThreadHelper::sendMessageToSubThread(WsMessage *msg)
 {
-    if (_subThreadInstance->joinable())
     {
-        _subThreadInstance->join();
+        std::lock_guard<std::mutex> lk(_subThreadWsMessageQueueMutex);
+        _subThreadWsMessageQueue->push_back(msg);
     }
+    _subThreadWsMessageQueued = true;
+    WsServiceThread::getInstance()->wakeUp();
 }
 
-void WsThreadHelper::update(float dt)
+void WsThreadHelper::joinSubThread()
+{
+    _joining = true;
+    WsServiceThread::getInstance()->wakeUp();
+    std::unique_lock<std::mutex> lk(_subThreadEndedMutex);
+    _subThreadEndedCondition.wait(lk, [this]{ return _subThreadEnded; });
+}
+
+void WsThreadHelper::onSubThreadEnded()
 {
-    /* Avoid locking if, in most cases, the queue is empty. This could be a little faster.
-    size() is not thread-safe, it might return a strange value, but it should be OK in our scenario.
-    */
-    if (0 == _UIWsMessageQueue->size()) 
-        return;	
+    std::lock_guard<std::mutex> lk(_subThreadEndedMutex);
+    _subThreadEnded = true;
+    _subThreadEndedCondition.notify_all();
+}
 
+void WsThreadHelper::update(float dt)
+{
+    unsigned int head = _UIMessageHead.load(std::memory_order_relaxed);
+    unsigned int tail = _UIMessageTail.load(std::memory_order_acquire);
+    
     // Returns quickly if no message
-    _UIWsMessageQueueMutex.lock();
+    if (head == tail)
+        return;
+    
+    // The delegate may delete the websocket, which releases this helper
+    retain();
+    
+    // Process all messages in the queue, in case it's piling up faster than being processed
+    while (head != tail && _ws)
+    {
+        _ws->onUIThreadReceiveMessage(&_UIMessageSlots[head % WS_UI_MESSAGE_SLOT_COUNT].msg);
+        _UIMessageHead.store(++head, std::memory_order_release);
+    }
+    
+    release();
+}
 
-    if (0 == _UIWsMessageQueue->size())
+// Implementation of WsServiceThread
+WsServiceThread* WsServiceThread::getInstance()
+{
+    static WsServiceThread* instance = new (std::nothrow) WsServiceThread();
+    return instance;
+}
+
+WsServiceThread::WsServiceThread()
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    // the sockets are created before libwebsockets initializes Winsock in libwebsocket_create_context()
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
     {
-        _UIWsMessageQueueMutex.unlock();
-        return;
+        CCLOGERROR("WsServiceThread: can't initialize Winsock");
     }
+#endif
     
-    // Gets message
-    // Process all messages in the queue, in case it's piling up faster than being processed
-    std::list<WsMessage*> messages;
-    while (!_UIWsMessageQueue->empty()) {
-        messages.push_back(_UIWsMessageQueue->front());
-        _UIWsMessageQueue->pop_front();
+    // A UDP socket connected to itself, wakeUp() sends it a datagram to end the wait of poll()
+    _wakeUpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    bool validSocket = _wakeUpSocket != INVALID_SOCKET;
+#else
+    bool validSocket = _wakeUpSocket >= 0;
+#endif
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t addrLen = sizeof(addr);
+    if (!validSocket
+        || bind(_wakeUpSocket, (struct sockaddr*)&addr, addrLen) != 0
+        || getsockname(_wakeUpSocket, (struct sockaddr*)&addr, &addrLen) != 0
+        || connect(_wakeUpSocket, (struct sockaddr*)&addr, addrLen) != 0)
+    {
+        CCLOGERROR("WsServiceThread: can't create the wake up socket, errno: %d", errno);
+        validSocket = false;
     }
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    u_long nonBlocking = 1;
+    validSocket = validSocket && ioctlsocket(_wakeUpSocket, FIONBIO, &nonBlocking) == 0;
+#else
+    validSocket = validSocket && fcntl(_wakeUpSocket, F_SETFL, fcntl(_wakeUpSocket, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    
+    // without the wake up socket, poll() ignores the first fd and the websockets are checked every WS_SERVICE_TIMEOUT_MS
+    _canWakeUp = validSocket;
+    WsPollFd pollFd;
+    pollFd.fd = _wakeUpSocket;
+    if (!_canWakeUp)
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+        pollFd.fd = INVALID_SOCKET;
+#else
+        pollFd.fd = -1;
+#endif
+    }
+    pollFd.events = POLLIN;
+    pollFd.revents = 0;
+    _pollFds.push_back(pollFd);
+    _pollFdOwners.push_back(nullptr);
+    
+    std::thread(&WsServiceThread::threadEntryFunc, this).detach();
+}
+
+void WsServiceThread::addWebSocket(WebSocket* ws)
+{
+    {
+        std::lock_guard<std::mutex> lk(_newWebSocketsMutex);
+        _newWebSockets.push_back(ws);
+    }
+    wakeUp();
+}
+
+void WsServiceThread::wakeUp()
+{
+    char byte = 0;
+    // a full buffer means a wake up is already pending
+    send(_wakeUpSocket, &byte, 1, 0);
+}
 
-    _UIWsMessageQueueMutex.unlock();
+void WsServiceThread::setPollFd(WebSocket* ws, int fd, int events)
+{
+    for (size_t i = 1; i < _pollFds.size(); ++i)
+    {
+        if ((int)_pollFds[i].fd == fd)
+        {
+            _pollFds[i].events = events;
+            _pollFdOwners[i] = ws;
+            return;
+        }
+    }
     
-    for (auto msg : messages) {
-        if (_ws)
+    WsPollFd pollFd;
+    pollFd.fd = fd;
+    pollFd.events = events;
+    pollFd.revents = 0;
+    _pollFds.push_back(pollFd);
+    _pollFdOwners.push_back(ws);
+}
+
+void WsServiceThread::removePollFd(int fd)
+{
+    for (size_t i = 1; i < _pollFds.size(); ++i)
+    {
+        if ((int)_pollFds[i].fd == fd)
         {
-            _ws->onUIThreadReceiveMessage(msg);
+            _pollFds.erase(_pollFds.begin() + i);
+            _pollFdOwners.erase(_pollFdOwners.begin() + i);
+            return;
         }
-        CC_SAFE_DELETE(msg);
     }
 }
 
-enum WS_MSG {
-    WS_MSG_TO_SUBTRHEAD_SENDING_STRING = 0,
-    WS_MSG_TO_SUBTRHEAD_SENDING_BINARY,
-    WS_MSG_TO_UITHREAD_OPEN,
-    WS_MSG_TO_UITHREAD_MESSAGE,
-    WS_MSG_TO_UITHREAD_ERROR,
-    WS_MSG_TO_UITHREAD_CLOSE
-};
+void WsServiceThread::removeWebSocket(WebSocket* ws)
+{
+    for (size_t i = _pollFds.size() - 1; i > 0; --i)
+    {
+        if (_pollFdOwners[i] == ws)
+        {
+            _pollFds.erase(_pollFds.begin() + i);
+            _pollFdOwners.erase(_pollFdOwners.begin() + i);
+        }
+    }
+    _webSockets.erase(std::find(_webSockets.begin(), _webSockets.end(), ws));
+    ws->_wsHelper->onSubThreadEnded();
+}
+
+void WsServiceThread::threadEntryFunc()
+{
+    std::vector<WebSocket*> readyWebSockets;
+    std::vector<WebSocket*> newWebSockets;
+    auto lastServiceTime = std::chrono::steady_clock::now();
+    bool pendingUIMessages = false;
+    
+    while (true)
+    {
+        // step 1: wait for the sockets, unless a websocket already has work to do
+        int timeout = (_webSockets.empty() && _canWakeUp) ? -1 : WS_SERVICE_TIMEOUT_MS;
+        if (pendingUIMessages)
+        {
+            timeout = WS_PENDING_MESSAGES_TIMEOUT_MS;
+        }
+        int ready = wsPoll(_pollFds.data(), (unsigned long)_pollFds.size(), timeout);
+        
+        if (ready > 0 && (_pollFds[0].revents & POLLIN))
+        {
+            char buffer[64];
+            while (recv(_wakeUpSocket, buffer, sizeof(buffer), 0) > 0)
+            {
+            }
+        }
+        
+        // step 2: the new websockets create their context and connect
+        {
+            std::lock_guard<std::mutex> lk(_newWebSocketsMutex);
+            newWebSockets.swap(_newWebSockets);
+        }
+        for (auto ws : newWebSockets)
+        {
+            _webSockets.push_back(ws);
+            ws->onSubThreadStarted();
+        }
+        newWebSockets.clear();
+        
+        // step 3: find the websockets to service, the whole list when the libwebsockets timeouts must be checked
+        readyWebSockets.clear();
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastServiceTime >= std::chrono::milliseconds(WS_SERVICE_TIMEOUT_MS))
+        {
+            lastServiceTime = now;
+            readyWebSockets = _webSockets;
+        }
+        else
+        {
+            for (size_t i = 1; ready > 0 && i < _pollFds.size(); ++i)
+            {
+                if (_pollFds[i].revents != 0
+                    && std::find(readyWebSockets.begin(), readyWebSockets.end(), _pollFdOwners[i]) == readyWebSockets.end())
+                {
+                    readyWebSockets.push_back(_pollFdOwners[i]);
+                }
+            }
+            for (auto ws : _webSockets)
+            {
+                if (ws->_wsHelper->_subThreadWsMessageQueued
+                    && std::find(readyWebSockets.begin(), readyWebSockets.end(), ws) == readyWebSockets.end())
+                {
+                    readyWebSockets.push_back(ws);
+                }
+            }
+        }
+        
+        // step 4: service them, the websockets that closed release their context
+        for (auto ws : readyWebSockets)
+        {
+            if (ws->_wsHelper->_subThreadWsMessageQueued.exchange(false)
+                && ws->_wsInstance && ws->_readyState == WebSocket::State::OPEN)
+            {
+                // LWS_CALLBACK_CLIENT_WRITEABLE is called by this service
+                libwebsocket_callback_on_writable(ws->_wsContext, ws->_wsInstance);
+            }
+            ws->onSubThreadLoop();
+        }
+        
+        pendingUIMessages = false;
+        for (size_t i = _webSockets.size(); i > 0; --i)
+        {
+            WebSocket* ws = _webSockets[i - 1];
+            if (ws->_wsHelper->_needQuit
+                || ws->_readyState == WebSocket::State::CLOSED
+                || ws->_readyState == WebSocket::State::CLOSING)
+            {
+                ws->onSubThreadLoop();
+                // the websocket is kept until the UI thread has room for its last messages, the close one included,
+                // unless the UI thread waits for it to be released and doesn't read them anymore
+                if (ws->_wsHelper->flushPendingUIMessages() || ws->_wsHelper->_joining)
+                {
+                    removeWebSocket(ws);
+                }
+                else
+                {
+                    pendingUIMessages = true;
+                }
+            }
+            else if (!ws->_wsHelper->flushPendingUIMessages())
+            {
+                pendingUIMessages = true;
+            }
+        }
+    }
+}
 
 WebSocket::WebSocket()
 : _readyState(State::CONNECTING)
@@ -246,6 +638,12 @@ WebSocket::WebSocket()
 WebSocket::~WebSocket()
 {
     close();
+    if (_wsHelper)
+    {
+        // the websocket thread may still be destroying the context if the server closed the connection
+        _wsHelper->joinSubThread();
+        _wsHelper->_ws = nullptr;
+    }
     CC_SAFE_RELEASE_NULL(_wsHelper);
     
     if(_wsProtocols)
@@ -401,20 +799,22 @@ WebSocket::State WebSocket::getReadyState()
 
 int WebSocket::onSubThreadLoop()
 {
-    if (_readyState == State::CLOSED || _readyState == State::CLOSING)
+    if (_readyState == State::CLOSED || _readyState == State::CLOSING || _wsHelper->_needQuit)
     {
-        libwebsocket_context_destroy(_wsContext);
+        if (_wsContext)
+        {
+            libwebsocket_context_destroy(_wsContext);
+            _wsContext = nullptr;
+        }
         // return 1 to exit the loop.
         return 1;
     }
     
-    if (_wsContext && _readyState != State::CLOSED && _readyState != State::CLOSING)
+    if (_wsContext)
     {
+        // the websocket thread only calls it when a socket of the context is ready, it doesn't wait
         libwebsocket_service(_wsContext, 0);
     }
-    
-    // Sleep 50 ms
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
     // return 0 to continue the loop.
     return 0;
@@ -459,10 +859,8 @@ void WebSocket::onSubThreadStarted()
                                              name.c_str(), -1);
                                              
         if(nullptr == _wsInstance) {
-            WsMessage* msg = new (std::nothrow) WsMessage();
-            msg->what = WS_MSG_TO_UITHREAD_ERROR;
             _readyState = State::CLOSING;
-            _wsHelper->sendMessageToUIThread(msg);
+            _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_ERROR);
         }
 
 	}
@@ -484,44 +882,53 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
 
 	switch (reason)
     {
+        case LWS_CALLBACK_ADD_POLL_FD:
+        case LWS_CALLBACK_CHANGE_MODE_POLL_FD:
+            {
+                // the websocket thread waits for the sockets of the context
+                struct libwebsocket_pollargs* args = (struct libwebsocket_pollargs*)in;
+                WsServiceThread::getInstance()->setPollFd(this, args->fd, args->events);
+            }
+            break;
         case LWS_CALLBACK_DEL_POLL_FD:
         case LWS_CALLBACK_PROTOCOL_DESTROY:
         case LWS_CALLBACK_CLIENT_CONNECTION_ERROR:
             {
-                WsMessage* msg = nullptr;
+                if (reason == LWS_CALLBACK_DEL_POLL_FD)
+                {
+                    WsServiceThread::getInstance()->removePollFd(((struct libwebsocket_pollargs*)in)->fd);
+                }
+                
                 if (reason == LWS_CALLBACK_CLIENT_CONNECTION_ERROR
                     || (reason == LWS_CALLBACK_PROTOCOL_DESTROY && _readyState == State::CONNECTING)
                     || (reason == LWS_CALLBACK_DEL_POLL_FD && _readyState == State::CONNECTING)
                     )
                 {
-                    msg = new (std::nothrow) WsMessage();
-                    msg->what = WS_MSG_TO_UITHREAD_ERROR;
                     _readyState = State::CLOSING;
+                    _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_ERROR);
                 }
                 else if (reason == LWS_CALLBACK_PROTOCOL_DESTROY && _readyState == State::CLOSING)
                 {
-                    msg = new (std::nothrow) WsMessage();
-                    msg->what = WS_MSG_TO_UITHREAD_CLOSE;
-                }
-
-                if (msg)
-                {
-                    _wsHelper->sendMessageToUIThread(msg);
+                    _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_CLOSE);
                 }
             }
             break;
         case LWS_CALLBACK_CLIENT_ESTABLISHED:
             {
-                WsMessage* msg = new (std::nothrow) WsMessage();
-                msg->what = WS_MSG_TO_UITHREAD_OPEN;
                 _readyState = State::OPEN;
                 
                 /*
-                 * start the ball rolling,
+                 * start the ball rolling if messages were sent while connecting,
                  * LWS_CALLBACK_CLIENT_WRITEABLE will come next service
                  */
-                libwebsocket_callback_on_writable(ctx, wsi);
-                _wsHelper->sendMessageToUIThread(msg);
+                {
+                    std::lock_guard<std::mutex> lk(_wsHelper->_subThreadWsMessageQueueMutex);
+                    if (!_wsHelper->_subThreadWsMessageQueue->empty())
+                    {
+                        libwebsocket_callback_on_writable(ctx, wsi);
+                    }
+                }
+                _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_OPEN);
             }
             break;
             
@@ -577,6 +984,7 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                         }
 
                         bytesWrite = libwebsocket_write(wsi,  &buf[LWS_SEND_BUFFER_PRE_PADDING], n, (libwebsocket_write_protocol)writeProtocol);
+                        CC_SAFE_DELETE_ARRAY(buf);
                         //fixme: the log is not thread safe
 //                        CCLOG("[websocket:send] bytesWrite => %d", bytesWrite);
 
@@ -596,16 +1004,18 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                         {
                             CC_SAFE_DELETE_ARRAY(data->bytes);
                             CC_SAFE_DELETE(data);
-                            CC_SAFE_DELETE_ARRAY(buf);
                             _wsHelper->_subThreadWsMessageQueue->erase(iter++);
                             CC_SAFE_DELETE(subThreadMsg);
                         }
                     }
                 }
                 
-                /* get notified as soon as we can write again */
+                /* get notified as soon as we can write again, until the queue is empty */
                 
-                libwebsocket_callback_on_writable(ctx, wsi);
+                if (!_wsHelper->_subThreadWsMessageQueue->empty())
+                {
+                    libwebsocket_callback_on_writable(ctx, wsi);
+                }
             }
             break;
             
@@ -618,10 +1028,8 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                 
                 if (_readyState != State::CLOSED)
                 {
-                    WsMessage* msg = new (std::nothrow) WsMessage();
                     _readyState = State::CLOSED;
-                    msg->what = WS_MSG_TO_UITHREAD_CLOSE;
-                    _wsHelper->sendMessageToUIThread(msg);
+                    _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_CLOSE);
                 }
             }
             break;
@@ -630,6 +1038,15 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
             {
                 if (in && len > 0)
                 {
+                    _pendingFrameDataLen = libwebsockets_remaining_packet_payload (wsi);
+
+                    if (_currentDataLen == 0 && _pendingFrameDataLen == 0)
+                    {
+                        // The whole message is here, it's copied in the payload buffer of a message slot
+                        _wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_MESSAGE, (const char*)in, len, lws_frame_is_binary(wsi) != 0);
+                        break;
+                    }
+
                     // Accumulate the data (increasing the buffer as we go)
                     if (_currentDataLen == 0)
                     {
@@ -647,8 +1064,6 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                         _currentDataLen = _currentDataLen + len;
                     }
 
-                    _pendingFrameDataLen = libwebsockets_remaining_packet_payload (wsi);
-
                     if (_pendingFrameDataLen > 0)
                     {
                         //CCLOG("%ld bytes of pending data to receive, consider increasing the libwebsocket rx_buffer_size value.", _pendingFrameDataLen);
@@ -657,36 +1072,11 @@ int WebSocket::onSocketCallback(struct libwebsocket_context *ctx,
                     // If no more data pending, send it to the client thread
                     if (_pendingFrameDataLen == 0)
                     {
-						WsMessage* msg = new (std::nothrow) WsMessage();
-						msg->what = WS_MSG_TO_UITHREAD_MESSAGE;
-
-						char* bytes = nullptr;
-						Data* data = new (std::nothrow) Data();
-
-						if (lws_frame_is_binary(wsi))
-						{
-
-							bytes = new char[_currentDataLen];
-							data->isBinary = true;
-						}
-						else
-						{
-							bytes = new char[_currentDataLen+1];
-							bytes[_currentDataLen] = '\0';
-							data->isBinary = false;
-						}
-
-						memcpy(bytes, _currentData, _currentDataLen);
-
-						data->bytes = bytes;
-						data->len = _currentDataLen;
-						msg->obj = (void*)data;
+						_wsHelper->sendMessageToUIThread(WS_MSG_TO_UITHREAD_MESSAGE, _currentData, _currentDataLen, lws_frame_is_binary(wsi) != 0);
 
 						CC_SAFE_DELETE_ARRAY(_currentData);
 						_currentData = nullptr;
 						_currentDataLen = 0;
-
-						_wsHelper->sendMessageToUIThread(msg);
                     }
                 }
             }
@@ -709,10 +1099,9 @@ void WebSocket::onUIThreadReceiveMessage(WsMessage* msg)
             break;
         case WS_MSG_TO_UITHREAD_MESSAGE:
             {
+                // the payload belongs to the message slot, it's reused once the delegate returns
                 Data* data = (Data*)msg->obj;
                 _delegate->onMessage(this, *data);
-                CC_SAFE_DELETE_ARRAY(data->bytes);
-                CC_SAFE_DELETE(data);
             }
             break;
         case WS_MSG_TO_UITHREAD_CLOSE:
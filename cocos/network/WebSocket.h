@@ -50,6 +50,7 @@ NS_CC_BEGIN
 namespace network {
 
 class WsThreadHelper;
+class WsServiceThread;
 class WsMessage;
 
 /**
@@ -224,6 +225,7 @@ private:
     char *_currentData;
 
     friend class WsThreadHelper;
+    friend class WsServiceThread;
     WsThreadHelper* _wsHelper;
 
     struct libwebsocket*         _wsInstance;
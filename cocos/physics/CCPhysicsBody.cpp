@@ -25,6 +25,7 @@
 #if CC_USE_PHYSICS
 
 #include <climits>
+#include <cfloat>
 #include <algorithm>
 #include <cmath>
 
@@ -75,6 +76,12 @@ PhysicsBody::PhysicsBody()
 , _momentSetByUser(false)
 , _recordScaleX(1.f)
 , _recordScaleY(1.f)
+, _previousPosX(0.f)
+, _previousPosY(0.f)
+, _previousAngle(0.f)
+, _displayedPosX(FLT_MAX)
+, _displayedPosY(FLT_MAX)
+, _displayedRotation(FLT_MAX)
 {
     _name = COMPONENT_NAME;
 }
@@ -898,6 +905,8 @@ void PhysicsBody::beforeSimulation(const Mat4& parentToWorldTransform, const Mat
 
     _recordPosX = worldPosition.x;
     _recordPosY = worldPosition.y;
+    // with a fixed time step, the first frame starts from the node
+    _displayedPosX = _displayedPosY = _displayedRotation = FLT_MAX;
 
     if (_owner->getAnchorPoint() != Vec2::ANCHOR_MIDDLE)
     {
@@ -922,6 +931,62 @@ void PhysicsBody::afterSimulation(const Mat4& parentToWorldTransform, float pare
     _owner->setRotation(getRotation() - parentRotation);
 }
 
+void PhysicsBody::beforeFixedSimulation(const Mat4& parentToWorldTransform, const Mat4& nodeToWorldTransform, float scaleX, float scaleY, float rotation)
+{
+    if (_recordScaleX != scaleX || _recordScaleY != scaleY)
+    {
+        _recordScaleX = scaleX;
+        _recordScaleY = scaleY;
+        setScale(scaleX, scaleY);
+    }
+
+    auto worldPosition = _ownerCenterOffset;
+    nodeToWorldTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
+
+    // the node shows an interpolated transform, it is only pushed to the body when the game moved the node
+    if (_displayedPosX != worldPosition.x || _displayedPosY != worldPosition.y || _displayedRotation != rotation)
+    {
+        setRotation(rotation);
+        setPosition(worldPosition.x, worldPosition.y);
+        savePreviousState();
+    }
+
+    if (_owner->getAnchorPoint() != Vec2::ANCHOR_MIDDLE)
+    {
+        parentToWorldTransform.getInversed().transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
+        _offset.x = worldPosition.x - _owner->getPositionX();
+        _offset.y = worldPosition.y - _owner->getPositionY();
+    }
+}
+
+void PhysicsBody::afterFixedSimulation(const Mat4& parentToWorldTransform, float parentRotation, float alpha, float elapsed)
+{
+    Vec3 positionInParent(_previousPosX + (_cpBody->p.x - _previousPosX) * alpha + _cpBody->v.x * elapsed - _positionOffset.x,
+                          _previousPosY + (_cpBody->p.y - _previousPosY) * alpha + _cpBody->v.y * elapsed - _positionOffset.y,
+                          0.f);
+    parentToWorldTransform.getInversed().transformVector(positionInParent.x, positionInParent.y, positionInParent.z, 1.f, &positionInParent);
+    _owner->setPosition(positionInParent.x - _offset.x, positionInParent.y - _offset.y);
+
+    float angle = _previousAngle + (_cpBody->a - _previousAngle) * alpha + _cpBody->w * elapsed;
+    _owner->setRotation(-angle * 180.0f / (float)M_PI - _rotationOffset - parentRotation);
+}
+
+void PhysicsBody::recordDisplayedTransform(const Mat4& nodeToWorldTransform, float rotation)
+{
+    auto worldPosition = _ownerCenterOffset;
+    nodeToWorldTransform.transformVector(worldPosition.x, worldPosition.y, worldPosition.z, 1.f, &worldPosition);
+    _displayedPosX = worldPosition.x;
+    _displayedPosY = worldPosition.y;
+    _displayedRotation = rotation;
+}
+
+void PhysicsBody::savePreviousState()
+{
+    _previousPosX = _cpBody->p.x;
+    _previousPosY = _cpBody->p.y;
+    _previousAngle = _cpBody->a;
+}
+
 void PhysicsBody::onEnter()
 {
     addToPhysicsWorld();
@@ -745,6 +745,13 @@ protected:
 
     void beforeSimulation(const Mat4& parentToWorldTransform, const Mat4& nodeToWorldTransform, float scaleX, float scaleY, float rotation);
     void afterSimulation(const Mat4& parentToWorldTransform, float parentRotation);
+
+    // fixed time step: the body is only moved to the node when the node was moved since afterFixedSimulation()
+    void beforeFixedSimulation(const Mat4& parentToWorldTransform, const Mat4& nodeToWorldTransform, float scaleX, float scaleY, float rotation);
+    // shows previous + (current - previous) * alpha + velocity * elapsed on the node
+    void afterFixedSimulation(const Mat4& parentToWorldTransform, float parentRotation, float alpha, float elapsed);
+    void recordDisplayedTransform(const Mat4& nodeToWorldTransform, float rotation);
+    void savePreviousState();
 protected:
     std::vector<PhysicsJoint*> _joints;
     Vector<PhysicsShape*> _shapes;
@@ -786,6 +793,15 @@ protected:
     float _recordPosX;
     float _recordPosY;
 
+    // state of the body before the last fixed step, in chipmunk coordinates
+    float _previousPosX;
+    float _previousPosY;
+    float _previousAngle;
+    // world transform of the owner written by the last afterFixedSimulation()
+    float _displayedPosX;
+    float _displayedPosY;
+    float _displayedRotation;
+
     friend class PhysicsWorld;
     friend class PhysicsShape;
     friend class PhysicsJoint;
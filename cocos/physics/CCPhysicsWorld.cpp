@@ -25,6 +25,7 @@
 #include "physics/CCPhysicsWorld.h"
 #if CC_USE_PHYSICS
 #include <algorithm>
+#include <cmath>
 #include <climits>
 
 #include "chipmunk.h"
@@ -799,6 +800,16 @@ void PhysicsWorld::step(float delta)
     }
 }
 
+void PhysicsWorld::setFixedTimeStep(float step)
+{
+    if (step >= 0.0f && step != _fixedTimeStep)
+    {
+        _fixedTimeStep = step;
+        _updateRateCount = 0;
+        _updateTime = 0.0f;
+    }
+}
+
 void PhysicsWorld::update(float delta, bool userCall/* = false*/)
 {
     if(!_delayAddBodies.empty())
@@ -810,8 +821,9 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
         updateBodies();
     }
     
+    const bool fixedStep = !userCall && _fixedTimeStep > 0.0f;
     auto sceneToWorldTransform = _scene->getNodeToParentTransform();
-    beforeSimulation(_scene, sceneToWorldTransform, 1.f, 1.f, 0.f);
+    beforeSimulation(sceneToWorldTransform, fixedStep);
 
     if (!_delayAddJoints.empty() || !_delayRemoveJoints.empty())
     {
@@ -827,6 +839,10 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
     {
         cpSpaceStep(_cpSpace, delta);
     }
+    else if (fixedStep)
+    {
+        stepFixed(delta);
+    }
     else
     {
         _updateTime += delta;
@@ -847,9 +863,35 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
         debugDraw();
     }
 
-    // Update physics position, should loop as the same sequence as node tree.
+    // Update physics position, parents before children.
     // PhysicsWorld::afterSimulation() will depend on the sequence.
-    afterSimulation(_scene, sceneToWorldTransform, 0.f);
+    afterSimulation(sceneToWorldTransform, fixedStep);
+}
+
+void PhysicsWorld::stepFixed(float delta)
+{
+    _updateTime += delta * _speed;
+
+    int steps = std::min((int)(_updateTime / _fixedTimeStep), _maxFixedSteps);
+    for (int i = 0; i < steps; ++i)
+    {
+        if (i == steps - 1)
+        {
+            // the nodes are interpolated from the state before the last step
+            for (auto& body : _bodies)
+            {
+                body->savePreviousState();
+            }
+        }
+        cpSpaceStep(_cpSpace, _fixedTimeStep);
+    }
+
+    _updateTime -= steps * _fixedTimeStep;
+    if (_updateTime >= _fixedTimeStep)
+    {
+        // too far behind, drop the time the steps of this frame could not catch up
+        _updateTime = fmodf(_updateTime, _fixedTimeStep);
+    }
 }
 
 PhysicsWorld* PhysicsWorld::construct(Scene* scene)
@@ -873,6 +915,9 @@ PhysicsWorld::PhysicsWorld()
 , _updateRateCount(0)
 , _updateTime(0.0f)
 , _substeps(1)
+, _fixedTimeStep(0.0f)
+, _maxFixedSteps(5)
+, _interpolation(Interpolation::INTERPOLATE)
 , _cpSpace(nullptr)
 , _updateBodyTransform(false)
 , _scene(nullptr)
@@ -895,39 +940,97 @@ PhysicsWorld::~PhysicsWorld()
     CC_SAFE_DELETE(_debugDraw);
 }
 
-void PhysicsWorld::beforeSimulation(Node *node, const Mat4& parentToWorldTransform, float nodeParentScaleX, float nodeParentScaleY, float parentRotation)
+void PhysicsWorld::collectSimulatedBodies()
 {
-    auto scaleX = nodeParentScaleX * node->getScaleX();
-    auto scaleY = nodeParentScaleY * node->getScaleY();
-    auto rotation = parentRotation + node->getRotation();
+    _simulatedBodies.clear();
+    for (auto& body : _bodies)
+    {
+        auto owner = body->getOwner();
+        if (owner == nullptr)
+        {
+            continue;
+        }
 
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
+        SimulatedBody simulatedBody = { body, 0, owner->getScaleX(), owner->getScaleY(), 0.0f };
+        auto node = owner->getParent();
+        auto root = owner;
+        for (; node; node = node->getParent())
+        {
+            ++simulatedBody.depth;
+            simulatedBody.scaleX *= node->getScaleX();
+            simulatedBody.scaleY *= node->getScaleY();
+            simulatedBody.parentRotation += node->getRotation();
+            root = node;
+        }
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
-    {
-        physicsBody->beforeSimulation(parentToWorldTransform, nodeToWorldTransform, scaleX, scaleY, rotation);
+        if (root == _scene)
+        {
+            _simulatedBodies.push_back(simulatedBody);
+        }
     }
 
-    for (auto child : node->getChildren())
-        beforeSimulation(child, nodeToWorldTransform, scaleX, scaleY, rotation);
+    std::stable_sort(_simulatedBodies.begin(), _simulatedBodies.end(), [](const SimulatedBody& a, const SimulatedBody& b) {
+        return a.depth < b.depth;
+    });
 }
 
-void PhysicsWorld::afterSimulation(Node *node, const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsWorld::beforeSimulation(const Mat4& sceneToWorldTransform, bool fixedStep)
 {
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
-    auto nodeRotation = parentRotation + node->getRotation();
+    collectSimulatedBodies();
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+    for (auto& simulatedBody : _simulatedBodies)
     {
-        physicsBody->afterSimulation(parentToWorldTransform, parentRotation);
-    }
+        auto owner = simulatedBody.body->getOwner();
+        auto parent = owner->getParent();
+        auto parentToWorldTransform = parent ? sceneToWorldTransform * parent->getNodeToWorldTransform() : sceneToWorldTransform;
+        auto nodeToWorldTransform = parentToWorldTransform * owner->getNodeToParentTransform();
+        auto rotation = simulatedBody.parentRotation + owner->getRotation();
 
-    for (auto child : node->getChildren())
-        afterSimulation(child, nodeToWorldTransform, nodeRotation);
+        if (fixedStep)
+        {
+            simulatedBody.body->beforeFixedSimulation(parentToWorldTransform, nodeToWorldTransform, simulatedBody.scaleX, simulatedBody.scaleY, rotation);
+        }
+        else
+        {
+            simulatedBody.body->beforeSimulation(parentToWorldTransform, nodeToWorldTransform, simulatedBody.scaleX, simulatedBody.scaleY, rotation);
+        }
+    }
 }
 
+void PhysicsWorld::afterSimulation(const Mat4& sceneToWorldTransform, bool fixedStep)
+{
+    // the contact callbacks may have removed bodies or nodes
+    collectSimulatedBodies();
+
+    float alpha = 1.0f;
+    float elapsed = 0.0f;
+    if (fixedStep && _interpolation == Interpolation::INTERPOLATE)
+    {
+        alpha = _updateTime / _fixedTimeStep;
+    }
+    else if (fixedStep && _interpolation == Interpolation::EXTRAPOLATE)
+    {
+        elapsed = _updateTime;
+    }
+
+    for (auto& simulatedBody : _simulatedBodies)
+    {
+        auto owner = simulatedBody.body->getOwner();
+        auto parent = owner->getParent();
+        auto parentToWorldTransform = parent ? sceneToWorldTransform * parent->getNodeToWorldTransform() : sceneToWorldTransform;
+
+        if (fixedStep)
+        {
+            simulatedBody.body->afterFixedSimulation(parentToWorldTransform, simulatedBody.parentRotation, alpha, elapsed);
+            simulatedBody.body->recordDisplayedTransform(parentToWorldTransform * owner->getNodeToParentTransform(),
+                                                         simulatedBody.parentRotation + owner->getRotation());
+        }
+        else
+        {
+            simulatedBody.body->afterSimulation(parentToWorldTransform, simulatedBody.parentRotation);
+        }
+    }
+}
 
 PhysicsDebugDraw::PhysicsDebugDraw(PhysicsWorld& world)
 : _drawNode(nullptr)
@@ -396,6 +396,96 @@ public:
      */
     inline int getSubsteps() const { return _substeps; }
 
+    /** @~english How the nodes are placed between two fixed steps, see setFixedTimeStep().
+     * @~chinese 两次固定步长迭代之间如何放置节点，参见setFixedTimeStep()。
+     */
+    enum class Interpolation
+    {
+        /** @~english The nodes show the state of the last step. @~chinese 节点显示最后一次迭代的状态。 */
+        NONE,
+        /** @~english The nodes are placed between the last two steps, one step behind the simulation. @~chinese 节点位于最后两次迭代的状态之间，比仿真落后一个步长。 */
+        INTERPOLATE,
+        /** @~english The nodes are moved ahead of the last step along the velocities of the bodies. @~chinese 节点从最后一次迭代的状态沿刚体的速度向前移动。 */
+        EXTRAPOLATE
+    };
+
+    /**@~english
+     * Set a fixed time step for this physics world.
+     *
+     * The frame times are accumulated and the world is stepped by exactly step seconds as many times as they allow,
+     * at most getMaxFixedSteps() times per frame: the time left once this limit is reached is dropped, so that a slow
+     * frame does not make the next ones slower. The nodes show the bodies as set by setInterpolation().
+     * A node moved by the game is moved to the same place in the physics world before the next step.
+     * setSubsteps() and setUpdateRate() are ignored when the step is not 0.
+     * @~chinese 
+     * 为物理世界设置固定的迭代步长。
+     * 
+     * 每帧的时间会被累加起来，物理世界按照累加的时间尽可能多次地迭代step秒，每帧最多getMaxFixedSteps()次：
+     * 达到上限后剩余的时间会被丢弃，以免一个慢的帧拖慢后面的帧。节点按照setInterpolation()的设置显示刚体。
+     * 被游戏移动的节点，会在下一次迭代之前被移动到物理世界中的相同位置。
+     * step不为0时，setSubsteps()和setUpdateRate()不起作用。
+     * @attention @~english if you setAutoStep(false), this won't work.
+     * @~chinese 如果设置setAutoStep(false),那么这个函数将不起作用。
+     * @param step @~english The time of a step in seconds, for example 1/30. 0, the default value, steps the world once per update.
+     * @~chinese 一次迭代的时间，单位为秒，例如1/30。默认值0表示每次更新迭代一次物理世界。
+     */
+    void setFixedTimeStep(float step);
+
+    /**@~english
+     * Get the fixed time step of this physics world.
+     *
+     * @~chinese 
+     * 获取物理世界的固定迭代步长。
+     * 
+     * @return @~english A float number, 0 when the step is not fixed.
+     * @~chinese 一个浮点数，步长不固定时为0。
+     */
+    inline float getFixedTimeStep() const { return _fixedTimeStep; }
+
+    /**@~english
+     * Set the maximum number of fixed steps in one update of this physics world.
+     *
+     * @~chinese 
+     * 设置物理世界一次更新中固定步长迭代的最大次数。
+     * 
+     * @param steps @~english An interger number, default value is 5.
+     * @~chinese 一个interger的数字,默认值是5。
+     */
+    inline void setMaxFixedSteps(int steps) { if(steps > 0) { _maxFixedSteps = steps; } }
+
+    /**@~english
+     * Get the maximum number of fixed steps in one update of this physics world.
+     *
+     * @~chinese 
+     * 获取物理世界一次更新中固定步长迭代的最大次数。
+     * 
+     * @return @~english An interger number.
+     * @~chinese 一个interger的数字。
+     */
+    inline int getMaxFixedSteps() const { return _maxFixedSteps; }
+
+    /**@~english
+     * Set how the nodes are placed between two fixed steps.
+     *
+     * @~chinese 
+     * 设置两次固定步长迭代之间如何放置节点。
+     * 
+     * @param interpolation @~english Default value is Interpolation::INTERPOLATE.
+     * @~chinese 默认值是Interpolation::INTERPOLATE。
+     */
+    inline void setInterpolation(Interpolation interpolation) { _interpolation = interpolation; }
+
+    /**@~english
+     * Get how the nodes are placed between two fixed steps.
+     *
+     * @~chinese 
+     * 获取两次固定步长迭代之间如何放置节点。
+     * 
+     * @return @~english An Interpolation value.
+     * @~chinese 一个Interpolation值。
+     */
+    inline Interpolation getInterpolation() const { return _interpolation; }
+
     /**@~english
      * Set the debug draw mask of this physics world.
      *
@@ -494,6 +584,9 @@ protected:
     int _updateRateCount;
     float _updateTime;
     int _substeps;
+    float _fixedTimeStep;
+    int _maxFixedSteps;
+    Interpolation _interpolation;
     cpSpace* _cpSpace;
     
     bool _updateBodyTransform;
@@ -516,8 +609,23 @@ protected:
     PhysicsWorld();
     virtual ~PhysicsWorld();
     
-    void beforeSimulation(Node *node, const Mat4& parentToWorldTransform, float nodeParentScaleX, float nodeParentScaleY, float parentRotation);
-    void afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation);
+    // a body of the world with the transform of its owner in the scene
+    struct SimulatedBody
+    {
+        PhysicsBody* body;
+        int depth;
+        float scaleX;
+        float scaleY;
+        float parentRotation;
+    };
+
+    // fills _simulatedBodies with the bodies whose owner is in the scene, parents before children
+    void collectSimulatedBodies();
+    void stepFixed(float delta);
+    void beforeSimulation(const Mat4& sceneToWorldTransform, bool fixedStep);
+    void afterSimulation(const Mat4& sceneToWorldTransform, bool fixedStep);
+
+    std::vector<SimulatedBody> _simulatedBodies;
 
     friend class Node;
     friend class Sprite;
@@ -87,6 +87,7 @@ bool Physics3DRigidBody::init(Physics3DRigidBodyDes* info)
     btDefaultMotionState* myMotionState = new btDefaultMotionState(transform);
     btRigidBody::btRigidBodyConstructionInfo rbInfo(mass,myMotionState,shape,localInertia);
     _btRigidBody = new btRigidBody(rbInfo);
+    _btRigidBody->setUserPointer(this);
     _type = Physics3DObject::PhysicsObjType::RIGID_BODY;
     _physics3DShape = info->shape;
     _physics3DShape->retain();
@@ -412,20 +413,7 @@ public:
 
     Physics3DObject* getPhysicsObject(const btCollisionObject* btObj)
     {
-        for (auto it : _collider->getPhysicsWorld()->getPhysicsObjects())
-        {
-            if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
-            {
-                if (static_cast<Physics3DRigidBody*>(it)->getRigidBody() == btObj)
-                    return it;
-            }
-            else if (it->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
-            {
-                if (static_cast<Physics3DCollider*>(it)->getGhostObject() == btObj)
-                    return it;
-            }
-        }
-        return nullptr;
+        return Physics3DWorld::getPhysicsObject(btObj);
     }
 
 private:
@@ -535,6 +523,7 @@ bool Physics3DCollider::init(Physics3DColliderDes *info)
     _physics3DShape = info->shape;
     _physics3DShape->retain();
     _btGhostObject = new btCollider(this);
+    _btGhostObject->setUserPointer(this);
     _btGhostObject->setCollisionShape(_physics3DShape->getbtShape());
     
     setTrigger(info->isTrigger);
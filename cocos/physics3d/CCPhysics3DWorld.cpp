@@ -24,6 +24,7 @@
 
 #include "CCPhysics3D.h"
 #include "renderer/CCRenderer.h"
+#include "base/CCThreadPool.h"
 
 #if CC_USE_3D_PHYSICS
 
@@ -31,6 +32,68 @@
 
 NS_CC_BEGIN
 
+namespace
+{
+    // the queries of a batch handled by one job
+    const size_t QUERIES_PER_JOB = 16;
+
+    // what btCollisionWorld::rayTest does for each broadphase leaf, see btSingleRayCallback
+    struct RayLeafCallback : public btDbvt::ICollide
+    {
+        RayLeafCallback(const btVector3& from, const btVector3& to, btCollisionWorld::RayResultCallback& result)
+        : _result(result)
+        {
+            _fromTransform.setIdentity();
+            _fromTransform.setOrigin(from);
+            _toTransform.setIdentity();
+            _toTransform.setOrigin(to);
+        }
+
+        virtual void Process(const btDbvtNode* leaf)
+        {
+            btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+            btCollisionObject* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+            if (_result.needsCollision(object->getBroadphaseHandle()))
+            {
+                btCollisionWorld::rayTestSingle(_fromTransform, _toTransform, object, object->getCollisionShape(), object->getWorldTransform(), _result);
+            }
+        }
+
+        btTransform _fromTransform;
+        btTransform _toTransform;
+        btCollisionWorld::RayResultCallback& _result;
+    };
+
+    // what btCollisionWorld::convexSweepTest does for each broadphase leaf, see btSingleSweepCallback
+    struct SweepLeafCallback : public btDbvt::ICollide
+    {
+        SweepLeafCallback(const btConvexShape* shape, const btTransform& from, const btTransform& to, btScalar allowedPenetration, btCollisionWorld::ConvexResultCallback& result)
+        : _shape(shape)
+        , _fromTransform(from)
+        , _toTransform(to)
+        , _allowedPenetration(allowedPenetration)
+        , _result(result)
+        {
+        }
+
+        virtual void Process(const btDbvtNode* leaf)
+        {
+            btBroadphaseProxy* proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+            btCollisionObject* object = static_cast<btCollisionObject*>(proxy->m_clientObject);
+            if (_result.needsCollision(object->getBroadphaseHandle()))
+            {
+                btCollisionWorld::objectQuerySingle(_shape, _fromTransform, _toTransform, object, object->getCollisionShape(), object->getWorldTransform(), _result, _allowedPenetration);
+            }
+        }
+
+        const btConvexShape* _shape;
+        btTransform _fromTransform;
+        btTransform _toTransform;
+        btScalar _allowedPenetration;
+        btCollisionWorld::ConvexResultCallback& _result;
+    };
+}
+
 Physics3DWorld::Physics3DWorld()
 : _btPhyiscsWorld(nullptr)
 , _collisionConfiguration(nullptr)
@@ -291,22 +354,98 @@ bool Physics3DWorld::sweepShape(Physics3DShape* shape, const cocos2d::Mat4& star
     return false;
 }
 
-Physics3DObject* Physics3DWorld::getPhysicsObject(const btCollisionObject* btObj)
+int Physics3DWorld::rayCastMany(const std::vector<cocos2d::Vec3>& startPositions, const std::vector<cocos2d::Vec3>& endPositions, std::vector<Physics3DWorld::HitResult>* results)
 {
-    for(auto it : _objects)
-    {
-        if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
+    CCASSERT(startPositions.size() == endPositions.size(), "Physics3DWorld::rayCastMany: as many start and end positions are needed");
+    size_t count = startPositions.size();
+    results->resize(count);
+    std::vector<unsigned char> hits(count, 0);
+    ThreadPool::getInstance()->parallelFor((count + QUERIES_PER_JOB - 1) / QUERIES_PER_JOB, [&](size_t job) {
+        size_t end = std::min(count, (job + 1) * QUERIES_PER_JOB);
+        for (size_t i = job * QUERIES_PER_JOB; i < end; ++i)
         {
-            if (static_cast<Physics3DRigidBody*>(it)->getRigidBody() == btObj)
-                return it;
+            hits[i] = rayCastConcurrent(startPositions[i], endPositions[i], &(*results)[i]);
         }
-        else if (it->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
+    });
+    return (int)std::count(hits.begin(), hits.end(), 1);
+}
+
+int Physics3DWorld::sweepShapeMany(Physics3DShape* shape, const std::vector<cocos2d::Mat4>& startTransforms, const std::vector<cocos2d::Mat4>& endTransforms, std::vector<Physics3DWorld::HitResult>* results)
+{
+    CC_ASSERT(shape->getShapeType() != Physics3DShape::ShapeType::HEIGHT_FIELD && shape->getShapeType() != Physics3DShape::ShapeType::MESH);
+    CCASSERT(startTransforms.size() == endTransforms.size(), "Physics3DWorld::sweepShapeMany: as many start and end transforms are needed");
+    size_t count = startTransforms.size();
+    results->resize(count);
+    std::vector<unsigned char> hits(count, 0);
+    ThreadPool::getInstance()->parallelFor((count + QUERIES_PER_JOB - 1) / QUERIES_PER_JOB, [&](size_t job) {
+        size_t end = std::min(count, (job + 1) * QUERIES_PER_JOB);
+        for (size_t i = job * QUERIES_PER_JOB; i < end; ++i)
         {
-            if (static_cast<Physics3DCollider*>(it)->getGhostObject() == btObj)
-                return it;
+            hits[i] = sweepShapeConcurrent(shape, startTransforms[i], endTransforms[i], &(*results)[i]);
         }
+    });
+    return (int)std::count(hits.begin(), hits.end(), 1);
+}
+
+bool Physics3DWorld::rayCastConcurrent(const cocos2d::Vec3& startPos, const cocos2d::Vec3& endPos, Physics3DWorld::HitResult* result) const
+{
+    // btDbvtBroadphase::rayTest keeps its stack in the tree, the static btDbvt::rayTest allocates its own
+    auto btStart = convertVec3TobtVector3(startPos);
+    auto btEnd = convertVec3TobtVector3(endPos);
+    btCollisionWorld::ClosestRayResultCallback btResult(btStart, btEnd);
+    RayLeafCallback callback(btStart, btEnd, btResult);
+    for (int i = 0; i < 2; ++i)
+    {
+        btDbvt::rayTest(_broadphase->m_sets[i].m_root, btStart, btEnd, callback);
+    }
+    if (btResult.hasHit())
+    {
+        result->hitObj = getPhysicsObject(btResult.m_collisionObject);
+        result->hitPosition = convertbtVector3ToVec3(btResult.m_hitPointWorld);
+        result->hitNormal = convertbtVector3ToVec3(btResult.m_hitNormalWorld);
+        return true;
+    }
+    result->hitObj = nullptr;
+    return false;
+}
+
+bool Physics3DWorld::sweepShapeConcurrent(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, Physics3DWorld::HitResult* result) const
+{
+    auto btStart = convertMat4TobtTransform(startTransform);
+    auto btEnd = convertMat4TobtTransform(endTransform);
+    auto castShape = static_cast<btConvexShape*>(shape->getbtShape());
+    btCollisionWorld::ClosestConvexResultCallback btResult(btStart.getOrigin(), btEnd.getOrigin());
+
+    // the broadphase candidates are the leaves overlapping the box swept by the shape, as in convexSweepTest
+    btVector3 linVel, angVel;
+    btTransformUtil::calculateVelocity(btStart, btEnd, 1.0f, linVel, angVel);
+    btTransform rotation;
+    rotation.setIdentity();
+    rotation.setRotation(btStart.getRotation());
+    btVector3 aabbMin, aabbMax;
+    castShape->calculateTemporalAabb(rotation, linVel, angVel, 1.0f, aabbMin, aabbMax);
+    auto volume = btDbvtVolume::FromMM(btStart.getOrigin() + aabbMin, btStart.getOrigin() + aabbMax);
+
+    SweepLeafCallback callback(castShape, btStart, btEnd, _btPhyiscsWorld->getDispatchInfo().m_allowedCcdPenetration, btResult);
+    for (int i = 0; i < 2; ++i)
+    {
+        _broadphase->m_sets[i].collideTV(_broadphase->m_sets[i].m_root, volume, callback);
     }
-    return nullptr;
+    if (btResult.hasHit())
+    {
+        result->hitObj = getPhysicsObject(btResult.m_hitCollisionObject);
+        result->hitPosition = convertbtVector3ToVec3(btResult.m_hitPointWorld);
+        result->hitNormal = convertbtVector3ToVec3(btResult.m_hitNormalWorld);
+        return true;
+    }
+    result->hitObj = nullptr;
+    return false;
+}
+
+Physics3DObject* Physics3DWorld::getPhysicsObject(const btCollisionObject* btObj)
+{
+    // Physics3DRigidBody and Physics3DCollider keep a pointer to themselves in their bullet object
+    return static_cast<Physics3DObject*>(btObj->getUserPointer());
 }
 
 void Physics3DWorld::collisionChecking()
@@ -175,6 +175,26 @@ public:
     */
     bool sweepShape(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, HitResult* result);
 
+    /** @~english Casts a batch of rays, on the worker threads of the ThreadPool. The world must not be changed
+     * (objects added, removed or moved, stepSimulate called) until it returns.
+     @~chinese 在ThreadPool的工作线程中投射一批射线。函数返回之前不能修改物理世界（添加、删除或移动对象，调用stepSimulate）。
+     * @param startPositions @~english  The start positions of the rays. @~chinese 射线的起始位置。
+     * @param endPositions @~english  The end positions of the rays, as many as startPositions. @~chinese 射线的结束位置，数量与startPositions相同。
+     * @param results @~english  Filled with the closest hit of each ray, hitObj is nullptr when a ray hits nothing. @~chinese 填充每条射线最近的碰撞结果，射线没有碰到物体时hitObj为nullptr。
+     * @return @~english The number of rays that hit an object. @~chinese 碰到物体的射线数量。
+     */
+    int rayCastMany(const std::vector<cocos2d::Vec3>& startPositions, const std::vector<cocos2d::Vec3>& endPositions, std::vector<HitResult>* results);
+
+    /** @~english Performs a batch of swept shape casts, on the worker threads of the ThreadPool, see rayCastMany().
+    @~chinese 在ThreadPool的工作线程中执行一批掠形投射，参见rayCastMany()。
+     * @param shape @~english  The convex shape to sweep. @~chinese 掠过的凸形状。
+     * @param startTransforms @~english  The start transforms of the sweeps. @~chinese 掠形投射的起始变换。
+     * @param endTransforms @~english  The end transforms of the sweeps, as many as startTransforms. @~chinese 掠形投射的结束变换，数量与startTransforms相同。
+     * @param results @~english  Filled with the closest hit of each sweep. @~chinese 填充每次投射最近的碰撞结果。
+     * @return @~english The number of sweeps that hit an object. @~chinese 碰到物体的投射数量。
+     */
+    int sweepShapeMany(Physics3DShape* shape, const std::vector<cocos2d::Mat4>& startTransforms, const std::vector<cocos2d::Mat4>& endTransforms, std::vector<HitResult>* results);
+
 CC_CONSTRUCTOR_ACCESS:
 
     Physics3DWorld();
@@ -182,12 +202,16 @@ CC_CONSTRUCTOR_ACCESS:
 
     bool init(Physics3DWorldDes* info);
 
-    Physics3DObject* getPhysicsObject(const btCollisionObject* btObj);
+    static Physics3DObject* getPhysicsObject(const btCollisionObject* btObj);
 
     void collisionChecking();
     bool needCollisionChecking();
 
     void setGhostPairCallback();
+
+    // the thread safe parts of rayCast() and sweepShape(), bullet's own queries share a traversal stack
+    bool rayCastConcurrent(const cocos2d::Vec3& startPos, const cocos2d::Vec3& endPos, HitResult* result) const;
+    bool sweepShapeConcurrent(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, HitResult* result) const;
 protected:
     std::vector<Physics3DObject*>      _objects;
     std::vector<Physics3DComponent*>   _physicsComponents; //physics3d components
@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "base/CCData.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventType.h"
 #include "platform/CCSAXParser.h"
 #include "base/ccUtils.h"
 
@@ -850,6 +852,12 @@ std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, con
     return relativeFile.substr(0, relativeFile.rfind('/')+1) + getNewFilename(filename);
 }
 
+static void notifySearchPathsChanged()
+{
+    // the caches keyed by full path drop the files that may now resolve to other ones
+    Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(EVENT_SEARCH_PATHS_CHANGED);
+}
+
 void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& searchResolutionsOrder)
 {
     bool existDefault = false;
@@ -875,6 +883,7 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
     {
         _searchResolutionsOrderArray.push_back("");
     }
+    notifySearchPathsChanged();
 }
 
 void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool front)
@@ -888,6 +897,7 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     } else {
         _searchResolutionsOrderArray.push_back(resOrder);
     }
+    notifySearchPathsChanged();
 }
 
 const std::vector<std::string>& FileUtils::getSearchResolutionsOrder() const
@@ -942,6 +952,7 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         //CCLOG("Default root path doesn't exist, adding it.");
         _searchPathArray.push_back(_defaultResRootPath);
     }
+    notifySearchPathsChanged();
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -960,6 +971,11 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
     } else {
         _searchPathArray.push_back(path);
     }
+    // the files found already are still found in the same place when the path is searched last
+    if (front)
+    {
+        notifySearchPathsChanged();
+    }
 }
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
@@ -25,66 +25,341 @@
 #include "platform/CCSAXParser.h"
 
 #include <vector> // because its based on windows 8 build :P
+#include <string.h>
+#include <ctype.h>
 
 #include "platform/CCFileUtils.h"
-#include "tinyxml2.h"
 
 
 NS_CC_BEGIN
 
-class XmlSaxHander : public tinyxml2::XMLVisitor
+/*
+ * Reads the document in place and calls the SAXParser callbacks while it goes, without building a document first.
+ * The names, the attribute values and the texts are slices of the buffer: the names and the values are
+ * NUL terminated by writing over the character that follows them, the entities are decoded in place,
+ * since they are never shorter than what they stand for. The attribute and the open element arrays are
+ * reused from one element to the next, so that nothing is allocated per node.
+ *
+ * It reports what the tinyxml2 based parser reported: elements, attributes, texts that are not only
+ * white space, with their entities decoded and their line ends normalized, and CDATA sections as texts.
+ * Declarations, comments and DOCTYPE are skipped.
+ */
+class SAXTokenizer
 {
 public:
-    XmlSaxHander():_ccsaxParserImp(0){};
-    
-    virtual bool VisitEnter( const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* firstAttribute );
-    virtual bool VisitExit( const tinyxml2::XMLElement& element );
-    virtual bool Visit( const tinyxml2::XMLText& text );
-    virtual bool Visit( const tinyxml2::XMLUnknown&){ return true; }
+    explicit SAXTokenizer(SAXParser* parser) : _parser(parser) {}
 
-    void setSAXParserImp(SAXParser* parser)
-    {
-        _ccsaxParserImp = parser;
-    }
+    // xml must be NUL terminated, it is modified
+    bool parse(char* xml);
 
 private:
-    SAXParser *_ccsaxParserImp;
-};
+    char* parseStartTag(char* p);
+    char* parseEndTag(char* p);
+    char* parseText(char* p);
+
+    static char* skipWhiteSpace(char* p);
+    static bool isWhiteSpace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+    static char* skipName(char* p);
+    static char* decode(char* begin, char* end);
 
+    SAXParser* _parser;
+    std::vector<const char*> _attributes;
+    std::vector<const char*> _elements;
+};
 
-bool XmlSaxHander::VisitEnter( const tinyxml2::XMLElement& element, const tinyxml2::XMLAttribute* firstAttribute )
+bool SAXTokenizer::parse(char* xml)
 {
-    //log(" VisitEnter %s",element.Value());
+    _elements.clear();
+
+    char* p = xml;
+    // UTF-8 byte order mark
+    if ((unsigned char)p[0] == 0xEF && (unsigned char)p[1] == 0xBB && (unsigned char)p[2] == 0xBF)
+    {
+        p += 3;
+    }
 
-    std::vector<const char*> attsVector;
-    for( const tinyxml2::XMLAttribute* attrib = firstAttribute; attrib; attrib = attrib->Next() )
+    while (p && *p)
     {
-        //log("%s", attrib->Name());
-        attsVector.push_back(attrib->Name());
-        //log("%s",attrib->Value());
-        attsVector.push_back(attrib->Value());
+        if (*p != '<')
+        {
+            p = parseText(p);
+        }
+        else if (p[1] == '/')
+        {
+            p = parseEndTag(p + 2);
+        }
+        else if (p[1] == '?')
+        {
+            // declaration or processing instruction
+            p = strstr(p + 2, "?>");
+            p = p ? p + 2 : nullptr;
+        }
+        else if (strncmp(p, "<!--", 4) == 0)
+        {
+            p = strstr(p + 4, "-->");
+            p = p ? p + 3 : nullptr;
+        }
+        else if (strncmp(p, "<![CDATA[", 9) == 0)
+        {
+            char* text = p + 9;
+            p = strstr(text, "]]>");
+            if (p)
+            {
+                SAXParser::textHandler(_parser, (const CC_XML_CHAR *)text, static_cast<int>(p - text));
+                p += 3;
+            }
+        }
+        else if (p[1] == '!')
+        {
+            // DOCTYPE, with its internal subset
+            int depth = 0;
+            for (p += 2; *p && (*p != '>' || depth > 0); ++p)
+            {
+                if (*p == '[') ++depth;
+                else if (*p == ']') --depth;
+            }
+            p = *p ? p + 1 : nullptr;
+        }
+        else
+        {
+            p = parseStartTag(p + 1);
+        }
     }
-    
-    // nullptr is used in c++11
-    //attsVector.push_back(nullptr);
-    attsVector.push_back(nullptr);
 
-    SAXParser::startElement(_ccsaxParserImp, (const CC_XML_CHAR *)element.Value(), (const CC_XML_CHAR **)(&attsVector[0]));
+    if (!p)
+    {
+        CCLOG("cocos2d: SAXParser: malformed xml");
+        return false;
+    }
+    if (!_elements.empty())
+    {
+        CCLOG("cocos2d: SAXParser: element %s is not closed", _elements.back());
+        return false;
+    }
     return true;
 }
-bool XmlSaxHander::VisitExit( const tinyxml2::XMLElement& element )
+
+char* SAXTokenizer::parseStartTag(char* p)
 {
-    //log("VisitExit %s",element.Value());
+    char* name = p;
+    char* nameEnd = skipName(p);
+    if (nameEnd == name)
+    {
+        return nullptr;
+    }
 
-    SAXParser::endElement(_ccsaxParserImp, (const CC_XML_CHAR *)element.Value());
-    return true;
+    _attributes.clear();
+    bool empty = false;
+    p = nameEnd;
+    while (true)
+    {
+        p = skipWhiteSpace(p);
+        if (*p == '>')
+        {
+            ++p;
+            break;
+        }
+        if (*p == '/' && p[1] == '>')
+        {
+            empty = true;
+            p += 2;
+            break;
+        }
+
+        char* attributeName = p;
+        char* attributeNameEnd = skipName(p);
+        if (attributeNameEnd == attributeName)
+        {
+            return nullptr;
+        }
+        p = skipWhiteSpace(attributeNameEnd);
+        if (*p != '=')
+        {
+            return nullptr;
+        }
+        p = skipWhiteSpace(p + 1);
+        char quote = *p;
+        if (quote != '"' && quote != '\'')
+        {
+            return nullptr;
+        }
+        char* value = p + 1;
+        char* valueEnd = strchr(value, quote);
+        if (!valueEnd)
+        {
+            return nullptr;
+        }
+        p = valueEnd + 1;
+
+        *attributeNameEnd = '\0';
+        *decode(value, valueEnd) = '\0';
+        _attributes.push_back(attributeName);
+        _attributes.push_back(value);
+    }
+
+    // the character after the name was read above
+    *nameEnd = '\0';
+    _attributes.push_back(nullptr);
+    SAXParser::startElement(_parser, (const CC_XML_CHAR *)name, (const CC_XML_CHAR **)_attributes.data());
+
+    if (empty)
+    {
+        SAXParser::endElement(_parser, (const CC_XML_CHAR *)name);
+    }
+    else
+    {
+        _elements.push_back(name);
+    }
+    return p;
 }
 
-bool XmlSaxHander::Visit( const tinyxml2::XMLText& text )
+char* SAXTokenizer::parseEndTag(char* p)
 {
-    //log("Visit %s",text.Value());
-    SAXParser::textHandler(_ccsaxParserImp, (const CC_XML_CHAR *)text.Value(), static_cast<int>(strlen(text.Value())));
-    return true;
+    char* name = p;
+    char* nameEnd = skipName(p);
+    p = skipWhiteSpace(nameEnd);
+    if (*p != '>' || _elements.empty())
+    {
+        return nullptr;
+    }
+
+    *nameEnd = '\0';
+    if (strcmp(_elements.back(), name) != 0)
+    {
+        CCLOG("cocos2d: SAXParser: element %s is closed by %s", _elements.back(), name);
+        return nullptr;
+    }
+    _elements.pop_back();
+    SAXParser::endElement(_parser, (const CC_XML_CHAR *)name);
+    return p + 1;
+}
+
+char* SAXTokenizer::parseText(char* p)
+{
+    char* text = p;
+    bool whiteSpace = true;
+    for (; *p && *p != '<'; ++p)
+    {
+        whiteSpace = whiteSpace && isWhiteSpace(*p);
+    }
+
+    // like tinyxml2, the white space between the elements isn't reported, and the text isn't NUL terminated
+    if (!whiteSpace)
+    {
+        char* textEnd = decode(text, p);
+        SAXParser::textHandler(_parser, (const CC_XML_CHAR *)text, static_cast<int>(textEnd - text));
+    }
+    return p;
+}
+
+char* SAXTokenizer::skipWhiteSpace(char* p)
+{
+    while (isWhiteSpace(*p))
+    {
+        ++p;
+    }
+    return p;
+}
+
+char* SAXTokenizer::skipName(char* p)
+{
+    while (*p && !isWhiteSpace(*p) && *p != '>' && *p != '/' && *p != '=')
+    {
+        ++p;
+    }
+    return p;
+}
+
+char* SAXTokenizer::decode(char* begin, char* end)
+{
+    static const struct { const char* name; size_t length; char value; } entities[] = {
+        { "&amp;", 5, '&' }, { "&lt;", 4, '<' }, { "&gt;", 4, '>' }, { "&quot;", 6, '"' }, { "&apos;", 6, '\'' },
+    };
+
+    // nothing to do for most of the slices
+    char* p = begin;
+    while (p < end && *p != '&' && *p != '\r')
+    {
+        ++p;
+    }
+
+    char* out = p;
+    while (p < end)
+    {
+        if (*p == '\r')
+        {
+            *out++ = '\n';
+            p += (p + 1 < end && p[1] == '\n') ? 2 : 1;
+            continue;
+        }
+        if (*p != '&')
+        {
+            *out++ = *p++;
+            continue;
+        }
+
+        bool decoded = false;
+        if (p + 2 < end && p[1] == '#')
+        {
+            // character reference, written as UTF-8
+            bool hex = (p[2] == 'x' || p[2] == 'X');
+            char* digits = p + (hex ? 3 : 2);
+            char* q = digits;
+            unsigned long code = 0;
+            while (q < end && q - digits < 8 && isxdigit((unsigned char)*q) && (hex || isdigit((unsigned char)*q)))
+            {
+                code = code * (hex ? 16 : 10) + (isdigit((unsigned char)*q) ? *q - '0' : (tolower((unsigned char)*q) - 'a' + 10));
+                ++q;
+            }
+            if (q > digits && q < end && *q == ';' && code > 0 && code <= 0x10FFFF)
+            {
+                if (code < 0x80)
+                {
+                    *out++ = static_cast<char>(code);
+                }
+                else if (code < 0x800)
+                {
+                    *out++ = static_cast<char>(0xC0 | (code >> 6));
+                    *out++ = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else if (code < 0x10000)
+                {
+                    *out++ = static_cast<char>(0xE0 | (code >> 12));
+                    *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                else
+                {
+                    *out++ = static_cast<char>(0xF0 | (code >> 18));
+                    *out++ = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                    *out++ = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                    *out++ = static_cast<char>(0x80 | (code & 0x3F));
+                }
+                p = q + 1;
+                decoded = true;
+            }
+        }
+        else
+        {
+            for (const auto& entity : entities)
+            {
+                if (static_cast<size_t>(end - p) >= entity.length && strncmp(p, entity.name, entity.length) == 0)
+                {
+                    *out++ = entity.value;
+                    p += entity.length;
+                    decoded = true;
+                    break;
+                }
+            }
+        }
+
+        // unknown entities are kept as they are
+        if (!decoded)
+        {
+            *out++ = *p++;
+        }
+    }
+    return out;
 }
 
 SAXParser::SAXParser()
@@ -105,21 +380,20 @@ bool SAXParser::init(const char *encoding)
 
 bool SAXParser::parse(const char* xmlData, size_t dataLength)
 {
-    tinyxml2::XMLDocument tinyDoc;
-    tinyDoc.Parse(xmlData, dataLength);
-    XmlSaxHander printer;
-    printer.setSAXParserImp(this);
-    
-    return tinyDoc.Accept( &printer );  
+    // the tokenizer works in place, on a NUL terminated copy
+    std::string xml(xmlData, dataLength);
+    SAXTokenizer tokenizer(this);
+    return tokenizer.parse(&xml[0]);
 }
 
 bool SAXParser::parse(const std::string& filename)
 {
     bool ret = false;
-    Data data = FileUtils::getInstance()->getDataFromFile(filename);
-    if (!data.isNull())
+    std::string xml = FileUtils::getInstance()->getStringFromFile(filename);
+    if (!xml.empty())
     {
-        ret = parse((const char*)data.getBytes(), data.getSize());
+        SAXTokenizer tokenizer(this);
+        ret = tokenizer.parse(&xml[0]);
     }
 
     return ret;
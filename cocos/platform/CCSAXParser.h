@@ -63,8 +63,8 @@ public:
      */
     virtual void endElement(void *ctx, const char *name) = 0;
     
-    /** @~english The text between the nodes.
-     * @~chinese 节点之间的文本。
+    /** @~english The text between the nodes. It is not NUL terminated, only len characters belong to it.
+     * @~chinese 节点之间的文本。文本不以NUL结尾，只有前len个字符属于它。
      * @js NA
      * @lua NA
      */
@@ -74,10 +74,13 @@ public:
 /**@~english
  * SAXParser is a fast and efficient XML parser. It scan documents line by line, scan while parsing.
  * You should inherit SAXDelegator and implement the method, and then through the SAXParser: : setDelegator to delegate.
+ * No document is built: the names, attribute values and texts passed to the delegator point into the parsed buffer,
+ * and are only valid during the callback.
  *
  * @~chinese 
  * SAXParser是一个快速高效的XML解释器。它逐行扫描文档，一边扫描一边解析。
  * 你应当继承SAXDelegator并实现其中的方法，然后通过SAXParser::setDelegator来进行委托。
+ * 解析时不会构建文档：传给委托的名字、属性值和文本都指向被解析的缓冲区，只在回调期间有效。
  *
  * @see SAXDelegator
  */
@@ -82,12 +82,15 @@ int Application::run()
     while (!glview->windowShouldClose())
     {
         lastTime = getCurrentMillSecond();
+        // read before mainLoop(), which may purge the director
+        bool useFixedDeltaTime = director->getFixedDeltaTime() > 0;
 
         director->mainLoop();
         glview->pollEvents();
 
         curTime = getCurrentMillSecond();
-        if (curTime - lastTime < _animationInterval)
+        // with a fixed delta time the frames are simulated, don't wait for the next one
+        if (curTime - lastTime < _animationInterval && !useFixedDeltaTime)
         {
             usleep((_animationInterval - curTime + lastTime)*1000);
         }
@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/linux/CCGLViewHeadless-linux.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
+
+#include <string.h>
+
+NS_CC_BEGIN
+
+GLViewHeadless* GLViewHeadless::create(const std::string& viewName, const Size& frameSize)
+{
+    auto ret = new (std::nothrow) GLViewHeadless;
+    if(ret && ret->initWithSize(viewName, frameSize)) {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+GLViewHeadless::GLViewHeadless()
+: _isOpen(false)
+, _swappedFrames(0)
+{
+    memset(&_lastFrameStats, 0, sizeof(_lastFrameStats));
+}
+
+GLViewHeadless::~GLViewHeadless()
+{
+}
+
+bool GLViewHeadless::initWithSize(const std::string& viewName, const Size& frameSize)
+{
+    setViewName(viewName);
+
+    NullGL::install();
+    _isOpen = true;
+
+    setFrameSize(frameSize.width, frameSize.height);
+
+    return true;
+}
+
+void GLViewHeadless::end()
+{
+    _isOpen = false;
+    // Release self, like GLViewImpl does.
+    release();
+}
+
+bool GLViewHeadless::isOpenGLReady()
+{
+    return _isOpen;
+}
+
+void GLViewHeadless::swapBuffers()
+{
+    _lastFrameStats = NullGL::getStats();
+    NullGL::resetStats();
+    ++_swappedFrames;
+}
+
+void GLViewHeadless::setIMEKeyboardState(bool /*open*/)
+{
+
+}
+
+bool GLViewHeadless::windowShouldClose()
+{
+    return !_isOpen;
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_GLVIEW_HEADLESS_LINUX_H__
+#define __CC_GLVIEW_HEADLESS_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "base/ccConfig.h"
+#if CC_USE_NULL_GL
+
+#include "platform/CCGLView.h"
+#include "platform/linux/CCNullGL-linux.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @class GLViewHeadless
+ * @brief @~english A GLView without window nor OpenGL context, drawing through NullGL.
+ * Combined with Director::setFixedDeltaTime(), it runs scenes unattended, e.g. for benchmarks on CI machines.
+ * The view closes when Director::end() is called.
+ * @~chinese 一个没有窗口和OpenGL上下文的GLView，通过NullGL进行绘制。
+ * 配合Director::setFixedDeltaTime()使用，可以在无人值守的情况下运行场景，例如在持续集成的机器上进行性能测试。
+ * 调用Director::end()时视图关闭。
+ */
+class CC_DLL GLViewHeadless : public GLView
+{
+public:
+    /** @~english Creates a headless view and installs NullGL.
+     * @~chinese 创建一个无窗口的视图并安装NullGL。
+     * @param viewName @~english The name of the view.
+     * @~chinese 视图的名字。
+     * @param frameSize @~english The size of the frame, in pixels.
+     * @~chinese 帧的大小，以像素为单位。
+     * @return @~english An autoreleased GLViewHeadless object.
+     * @~chinese 一个自动释放的GLViewHeadless对象。
+     */
+    static GLViewHeadless* create(const std::string& viewName, const Size& frameSize);
+
+    /** @~english Gets the NullGL statistics of the last swapped frame.
+     * @~chinese 获取上一个交换的帧的NullGL统计数据。
+     */
+    const NullGL::Stats& getLastFrameStats() const { return _lastFrameStats; }
+
+    /** @~english Gets the number of swapped frames.
+     * @~chinese 获取已交换的帧数。
+     */
+    unsigned int getSwappedFrames() const { return _swappedFrames; }
+
+    // Overrides
+    virtual void end() override;
+    virtual bool isOpenGLReady() override;
+    virtual void swapBuffers() override;
+    virtual void setIMEKeyboardState(bool open) override;
+    virtual bool windowShouldClose() override;
+
+CC_CONSTRUCTOR_ACCESS:
+    GLViewHeadless();
+    virtual ~GLViewHeadless();
+
+    bool initWithSize(const std::string& viewName, const Size& frameSize);
+
+protected:
+    bool _isOpen;
+    unsigned int _swappedFrames;
+    NullGL::Stats _lastFrameStats;
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // CC_USE_NULL_GL
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_GLVIEW_HEADLESS_LINUX_H__
@@ -0,0 +1,767 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/linux/CCNullGL-linux.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
+
+#include <string.h>
+#include <set>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "platform/CCGL.h"
+
+static cocos2d::NullGL::Stats s_stats;
+static bool s_installed = false;
+
+static GLuint s_nextName = 1;
+static std::set<GLenum> s_enabledCaps;
+static GLint s_viewport[4] = {0, 0, 0, 0};
+static GLint s_scissorBox[4] = {0, 0, 0, 0};
+static GLfloat s_clearColor[4] = {0, 0, 0, 0};
+static GLfloat s_clearDepth = 1;
+static GLint s_clearStencil = 0;
+static GLboolean s_depthMask = GL_TRUE;
+static GLboolean s_colorMask[4] = {GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE};
+static GLuint s_currentProgram = 0;
+static GLuint s_boundTexture = 0;
+static GLuint s_boundArrayBuffer = 0;
+static GLuint s_boundElementBuffer = 0;
+static GLuint s_boundFramebuffer = 0;
+static GLuint s_boundRenderbuffer = 0;
+// storage of the buffers, so that glMapBuffer can return writable memory
+static std::unordered_map<GLuint, std::vector<char>> s_bufferData;
+
+static const char* NULL_GL_EXTENSIONS =
+    "GL_ARB_vertex_array_object GL_ARB_framebuffer_object GL_ARB_texture_non_power_of_two "
+    "GL_EXT_texture_compression_s3tc GL_EXT_blend_func_separate";
+
+static size_t bytesPerPixel(GLenum format, GLenum type)
+{
+    switch (type)
+    {
+        case GL_UNSIGNED_SHORT_4_4_4_4:
+        case GL_UNSIGNED_SHORT_5_5_5_1:
+        case GL_UNSIGNED_SHORT_5_6_5:
+            return 2;
+        default:
+            break;
+    }
+
+    switch (format)
+    {
+        case GL_RGBA:
+            return 4;
+        case GL_RGB:
+            return 3;
+        case GL_LUMINANCE_ALPHA:
+            return 2;
+        default:
+            return 1;
+    }
+}
+
+static GLuint& boundBuffer(GLenum target)
+{
+    return target == GL_ELEMENT_ARRAY_BUFFER ? s_boundElementBuffer : s_boundArrayBuffer;
+}
+
+static void genNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        names[i] = s_nextName++;
+    }
+}
+
+static void emptyString(GLsizei bufSize, GLsizei* length, GLchar* str)
+{
+    if (length)
+        *length = 0;
+    if (str && bufSize > 0)
+        str[0] = '\0';
+}
+
+//
+// OpenGL 1.1: exported by libGL, so they are defined here and take precedence over it
+//
+
+void GLAPIENTRY glAlphaFunc(GLenum func, GLclampf ref) {}
+void GLAPIENTRY glCullFace(GLenum mode) {}
+void GLAPIENTRY glFrontFace(GLenum mode) {}
+void GLAPIENTRY glHint(GLenum target, GLenum mode) {}
+void GLAPIENTRY glLineWidth(GLfloat width) {}
+void GLAPIENTRY glPointSize(GLfloat size) {}
+void GLAPIENTRY glPolygonMode(GLenum face, GLenum mode) {}
+void GLAPIENTRY glPolygonOffset(GLfloat factor, GLfloat units) {}
+void GLAPIENTRY glDepthFunc(GLenum func) {}
+void GLAPIENTRY glStencilFunc(GLenum func, GLint ref, GLuint mask) {}
+void GLAPIENTRY glStencilMask(GLuint mask) {}
+void GLAPIENTRY glStencilOp(GLenum fail, GLenum zfail, GLenum zpass) {}
+void GLAPIENTRY glPixelStorei(GLenum pname, GLint param) {}
+void GLAPIENTRY glTexParameterf(GLenum target, GLenum pname, GLfloat param) {}
+void GLAPIENTRY glTexParameteri(GLenum target, GLenum pname, GLint param) {}
+void GLAPIENTRY glEnableClientState(GLenum array) {}
+void GLAPIENTRY glFinish(void) {}
+void GLAPIENTRY glFlush(void) {}
+
+void GLAPIENTRY glEnable(GLenum cap)
+{
+    s_enabledCaps.insert(cap);
+    ++s_stats.capabilityChanges;
+}
+
+void GLAPIENTRY glDisable(GLenum cap)
+{
+    s_enabledCaps.erase(cap);
+    ++s_stats.capabilityChanges;
+}
+
+GLboolean GLAPIENTRY glIsEnabled(GLenum cap)
+{
+    return s_enabledCaps.count(cap) ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+}
+
+void GLAPIENTRY glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    s_scissorBox[0] = x;
+    s_scissorBox[1] = y;
+    s_scissorBox[2] = width;
+    s_scissorBox[3] = height;
+}
+
+void GLAPIENTRY glClearColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha)
+{
+    s_clearColor[0] = red;
+    s_clearColor[1] = green;
+    s_clearColor[2] = blue;
+    s_clearColor[3] = alpha;
+}
+
+void GLAPIENTRY glClearDepth(GLclampd depth)
+{
+    s_clearDepth = (GLfloat)depth;
+}
+
+void GLAPIENTRY glClearStencil(GLint s)
+{
+    s_clearStencil = s;
+}
+
+void GLAPIENTRY glClear(GLbitfield mask)
+{
+    ++s_stats.clears;
+}
+
+void GLAPIENTRY glDepthMask(GLboolean flag)
+{
+    s_depthMask = flag;
+}
+
+void GLAPIENTRY glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+    s_colorMask[0] = red;
+    s_colorMask[1] = green;
+    s_colorMask[2] = blue;
+    s_colorMask[3] = alpha;
+}
+
+void GLAPIENTRY glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+    ++s_stats.blendFuncChanges;
+}
+
+void GLAPIENTRY glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+    ++s_stats.drawCalls;
+    s_stats.drawnVertices += count;
+}
+
+void GLAPIENTRY glDrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices)
+{
+    ++s_stats.drawCalls;
+    s_stats.drawnVertices += count;
+}
+
+void GLAPIENTRY glGenTextures(GLsizei n, GLuint* textures)
+{
+    genNames(n, textures);
+}
+
+void GLAPIENTRY glDeleteTextures(GLsizei n, const GLuint* textures) {}
+
+GLboolean GLAPIENTRY glIsTexture(GLuint texture)
+{
+    return texture != 0 ? GL_TRUE : GL_FALSE;
+}
+
+void GLAPIENTRY glBindTexture(GLenum target, GLuint texture)
+{
+    s_boundTexture = texture;
+    ++s_stats.textureBinds;
+}
+
+void GLAPIENTRY glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    if (pixels)
+        s_stats.textureUploadBytes += width * height * bytesPerPixel(format, type);
+}
+
+void GLAPIENTRY glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels)
+{
+    if (pixels)
+        s_stats.textureUploadBytes += width * height * bytesPerPixel(format, type);
+}
+
+void GLAPIENTRY glCopyTexImage2D(GLenum target, GLint level, GLenum internalformat, GLint x, GLint y, GLsizei width, GLsizei height, GLint border) {}
+void GLAPIENTRY glCopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height) {}
+
+void GLAPIENTRY glGetTexParameterfv(GLenum target, GLenum pname, GLfloat* params)
+{
+    params[0] = 0;
+}
+
+void GLAPIENTRY glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid* pixels)
+{
+    memset(pixels, 0, width * height * bytesPerPixel(format, type));
+}
+
+GLenum GLAPIENTRY glGetError(void)
+{
+    return GL_NO_ERROR;
+}
+
+const GLubyte* GLAPIENTRY glGetString(GLenum name)
+{
+    switch (name)
+    {
+        case GL_VENDOR:
+            return (const GLubyte*)"cocos2d-x";
+        case GL_RENDERER:
+            return (const GLubyte*)"NullGL";
+        case GL_VERSION:
+            return (const GLubyte*)"2.1 NullGL";
+        case GL_SHADING_LANGUAGE_VERSION:
+            return (const GLubyte*)"1.20";
+        case GL_EXTENSIONS:
+            return (const GLubyte*)NULL_GL_EXTENSIONS;
+        default:
+            return (const GLubyte*)"";
+    }
+}
+
+void GLAPIENTRY glGetIntegerv(GLenum pname, GLint* params)
+{
+    switch (pname)
+    {
+        case GL_MAX_TEXTURE_SIZE:
+            params[0] = 4096;
+            break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_TEXTURE_IMAGE_UNITS:
+        case GL_MAX_VERTEX_ATTRIBS:
+            params[0] = 16;
+            break;
+        case GL_MAX_VERTEX_UNIFORM_COMPONENTS:
+            params[0] = 1024;
+            break;
+        case GL_DEPTH_BITS:
+            params[0] = 24;
+            break;
+        case GL_STENCIL_BITS:
+            params[0] = 8;
+            break;
+        case GL_VIEWPORT:
+            memcpy(params, s_viewport, sizeof(s_viewport));
+            break;
+        case GL_SCISSOR_BOX:
+            memcpy(params, s_scissorBox, sizeof(s_scissorBox));
+            break;
+        case GL_STENCIL_CLEAR_VALUE:
+            params[0] = s_clearStencil;
+            break;
+        case GL_CURRENT_PROGRAM:
+            params[0] = s_currentProgram;
+            break;
+        case GL_TEXTURE_BINDING_2D:
+            params[0] = s_boundTexture;
+            break;
+        case GL_ARRAY_BUFFER_BINDING:
+            params[0] = s_boundArrayBuffer;
+            break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+            params[0] = s_boundElementBuffer;
+            break;
+        case GL_FRAMEBUFFER_BINDING:
+            params[0] = s_boundFramebuffer;
+            break;
+        case GL_RENDERBUFFER_BINDING:
+            params[0] = s_boundRenderbuffer;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void GLAPIENTRY glGetFloatv(GLenum pname, GLfloat* params)
+{
+    switch (pname)
+    {
+        case GL_COLOR_CLEAR_VALUE:
+            memcpy(params, s_clearColor, sizeof(s_clearColor));
+            break;
+        case GL_DEPTH_CLEAR_VALUE:
+            params[0] = s_clearDepth;
+            break;
+        default:
+            params[0] = 0;
+            break;
+    }
+}
+
+void GLAPIENTRY glGetBooleanv(GLenum pname, GLboolean* params)
+{
+    switch (pname)
+    {
+        case GL_DEPTH_WRITEMASK:
+            params[0] = s_depthMask;
+            break;
+        case GL_COLOR_WRITEMASK:
+            memcpy(params, s_colorMask, sizeof(s_colorMask));
+            break;
+        default:
+            params[0] = glIsEnabled(pname);
+            break;
+    }
+}
+
+//
+// OpenGL 1.2 and later: loaded by GLEW, install() points the function pointers to these
+//
+
+static void GLAPIENTRY nullActiveTexture(GLenum texture) {}
+static void GLAPIENTRY nullSampleCoverage(GLclampf value, GLboolean invert) {}
+static void GLAPIENTRY nullBlendColor(GLclampf red, GLclampf green, GLclampf blue, GLclampf alpha) {}
+static void GLAPIENTRY nullBlendEquation(GLenum mode) {}
+static void GLAPIENTRY nullBlendEquationSeparate(GLenum modeRGB, GLenum modeAlpha) {}
+static void GLAPIENTRY nullStencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask) {}
+static void GLAPIENTRY nullStencilMaskSeparate(GLenum face, GLuint mask) {}
+static void GLAPIENTRY nullStencilOpSeparate(GLenum face, GLenum sfail, GLenum dpfail, GLenum dppass) {}
+static void GLAPIENTRY nullReleaseShaderCompiler(void) {}
+static void GLAPIENTRY nullGenerateMipmap(GLenum target) {}
+
+static void GLAPIENTRY nullBlendFuncSeparate(GLenum sfactorRGB, GLenum dfactorRGB, GLenum sfactorAlpha, GLenum dfactorAlpha)
+{
+    ++s_stats.blendFuncChanges;
+}
+
+static void GLAPIENTRY nullCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const GLvoid* data)
+{
+    s_stats.textureUploadBytes += imageSize;
+}
+
+static void GLAPIENTRY nullCompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const GLvoid* data)
+{
+    s_stats.textureUploadBytes += imageSize;
+}
+
+// buffers
+
+static void GLAPIENTRY nullGenBuffers(GLsizei n, GLuint* buffers)
+{
+    genNames(n, buffers);
+}
+
+static void GLAPIENTRY nullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+    {
+        s_bufferData.erase(buffers[i]);
+    }
+}
+
+static GLboolean GLAPIENTRY nullIsBuffer(GLuint buffer)
+{
+    return buffer != 0 ? GL_TRUE : GL_FALSE;
+}
+
+static void GLAPIENTRY nullBindBuffer(GLenum target, GLuint buffer)
+{
+    boundBuffer(target) = buffer;
+    ++s_stats.bufferBinds;
+}
+
+static void GLAPIENTRY nullBufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage)
+{
+    s_bufferData[boundBuffer(target)].resize(size);
+    if (data)
+        s_stats.bufferUploadBytes += size;
+}
+
+static void GLAPIENTRY nullBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const GLvoid* data)
+{
+    s_stats.bufferUploadBytes += size;
+}
+
+static GLvoid* GLAPIENTRY nullMapBuffer(GLenum target, GLenum access)
+{
+    auto& storage = s_bufferData[boundBuffer(target)];
+    return storage.empty() ? nullptr : storage.data();
+}
+
+static GLboolean GLAPIENTRY nullUnmapBuffer(GLenum target)
+{
+    auto& storage = s_bufferData[boundBuffer(target)];
+    s_stats.bufferUploadBytes += storage.size();
+    return GL_TRUE;
+}
+
+static void GLAPIENTRY nullGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    genNames(n, arrays);
+}
+
+static void GLAPIENTRY nullDeleteVertexArrays(GLsizei n, const GLuint* arrays) {}
+
+static void GLAPIENTRY nullBindVertexArray(GLuint array)
+{
+    ++s_stats.bufferBinds;
+}
+
+static void GLAPIENTRY nullEnableVertexAttribArray(GLuint index) {}
+static void GLAPIENTRY nullDisableVertexAttribArray(GLuint index) {}
+static void GLAPIENTRY nullVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* pointer) {}
+static void GLAPIENTRY nullVertexAttrib1f(GLuint index, GLfloat x) {}
+static void GLAPIENTRY nullVertexAttrib1fv(GLuint index, const GLfloat* v) {}
+static void GLAPIENTRY nullVertexAttrib2f(GLuint index, GLfloat x, GLfloat y) {}
+static void GLAPIENTRY nullVertexAttrib2fv(GLuint index, const GLfloat* v) {}
+static void GLAPIENTRY nullVertexAttrib3f(GLuint index, GLfloat x, GLfloat y, GLfloat z) {}
+static void GLAPIENTRY nullVertexAttrib3fv(GLuint index, const GLfloat* v) {}
+static void GLAPIENTRY nullVertexAttrib4f(GLuint index, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {}
+static void GLAPIENTRY nullVertexAttrib4fv(GLuint index, const GLfloat* v) {}
+
+// framebuffers
+
+static void GLAPIENTRY nullGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    genNames(n, framebuffers);
+}
+
+static void GLAPIENTRY nullDeleteFramebuffers(GLsizei n, const GLuint* framebuffers) {}
+
+static GLboolean GLAPIENTRY nullIsFramebuffer(GLuint framebuffer)
+{
+    return framebuffer != 0 ? GL_TRUE : GL_FALSE;
+}
+
+static void GLAPIENTRY nullBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    s_boundFramebuffer = framebuffer;
+    ++s_stats.framebufferBinds;
+}
+
+static GLenum GLAPIENTRY nullCheckFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+static void GLAPIENTRY nullFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) {}
+static void GLAPIENTRY nullFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) {}
+
+static void GLAPIENTRY nullGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    genNames(n, renderbuffers);
+}
+
+static void GLAPIENTRY nullDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) {}
+
+static GLboolean GLAPIENTRY nullIsRenderbuffer(GLuint renderbuffer)
+{
+    return renderbuffer != 0 ? GL_TRUE : GL_FALSE;
+}
+
+static void GLAPIENTRY nullBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+    s_boundRenderbuffer = renderbuffer;
+}
+
+static void GLAPIENTRY nullRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) {}
+
+// shaders and programs: they always compile and link, and have no active attribute or uniform
+
+static GLuint GLAPIENTRY nullCreateShader(GLenum type)
+{
+    return s_nextName++;
+}
+
+static GLuint GLAPIENTRY nullCreateProgram(void)
+{
+    return s_nextName++;
+}
+
+static void GLAPIENTRY nullDeleteShader(GLuint shader) {}
+static void GLAPIENTRY nullDeleteProgram(GLuint program) {}
+static void GLAPIENTRY nullShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) {}
+static void GLAPIENTRY nullCompileShader(GLuint shader) {}
+static void GLAPIENTRY nullAttachShader(GLuint program, GLuint shader) {}
+static void GLAPIENTRY nullDetachShader(GLuint program, GLuint shader) {}
+static void GLAPIENTRY nullBindAttribLocation(GLuint program, GLuint index, const GLchar* name) {}
+static void GLAPIENTRY nullLinkProgram(GLuint program) {}
+static void GLAPIENTRY nullValidateProgram(GLuint program) {}
+
+static GLboolean GLAPIENTRY nullIsShader(GLuint shader)
+{
+    return shader != 0 ? GL_TRUE : GL_FALSE;
+}
+
+static GLboolean GLAPIENTRY nullIsProgram(GLuint program)
+{
+    return program != 0 ? GL_TRUE : GL_FALSE;
+}
+
+static void GLAPIENTRY nullUseProgram(GLuint program)
+{
+    s_currentProgram = program;
+    ++s_stats.programChanges;
+}
+
+static void GLAPIENTRY nullGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    params[0] = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+static void GLAPIENTRY nullGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    params[0] = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+static void GLAPIENTRY nullGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    emptyString(bufSize, length, infoLog);
+}
+
+static void GLAPIENTRY nullGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    emptyString(bufSize, length, infoLog);
+}
+
+static void GLAPIENTRY nullGetShaderSource(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* source)
+{
+    emptyString(bufSize, length, source);
+}
+
+static void GLAPIENTRY nullGetAttachedShaders(GLuint program, GLsizei maxCount, GLsizei* count, GLuint* shaders)
+{
+    if (count)
+        *count = 0;
+}
+
+static void GLAPIENTRY nullGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    emptyString(bufSize, length, name);
+}
+
+static void GLAPIENTRY nullGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    emptyString(bufSize, length, name);
+}
+
+static GLint GLAPIENTRY nullGetAttribLocation(GLuint program, const GLchar* name)
+{
+    return 0;
+}
+
+static GLint GLAPIENTRY nullGetUniformLocation(GLuint program, const GLchar* name)
+{
+    // any valid location, the built-in uniforms are then set every time like on a real driver
+    return (GLint)(s_nextName++);
+}
+
+static void GLAPIENTRY nullGetUniformfv(GLuint program, GLint location, GLfloat* params)
+{
+    params[0] = 0;
+}
+
+static void GLAPIENTRY nullGetUniformiv(GLuint program, GLint location, GLint* params)
+{
+    params[0] = 0;
+}
+
+static void GLAPIENTRY nullUniform1f(GLint location, GLfloat v0) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform2f(GLint location, GLfloat v0, GLfloat v1) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform1i(GLint location, GLint v0) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform2i(GLint location, GLint v0, GLint v1) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform3i(GLint location, GLint v0, GLint v1, GLint v2) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform4i(GLint location, GLint v0, GLint v1, GLint v2, GLint v3) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform1fv(GLint location, GLsizei count, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform2fv(GLint location, GLsizei count, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform3fv(GLint location, GLsizei count, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform4fv(GLint location, GLsizei count, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform1iv(GLint location, GLsizei count, const GLint* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform2iv(GLint location, GLsizei count, const GLint* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform3iv(GLint location, GLsizei count, const GLint* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniform4iv(GLint location, GLsizei count, const GLint* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { ++s_stats.uniformUpdates; }
+static void GLAPIENTRY nullUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) { ++s_stats.uniformUpdates; }
+
+// glXxx is a macro expanding to the GLEW function pointer. The pointer type is taken from it,
+// since the constness of some parameters differs between GLEW versions.
+#define CC_NULL_GL_SET(name) \
+    gl##name = reinterpret_cast<std::remove_reference<decltype(gl##name)>::type>(&null##name)
+
+NS_CC_BEGIN
+
+void NullGL::install()
+{
+    CC_NULL_GL_SET(ActiveTexture);
+    CC_NULL_GL_SET(SampleCoverage);
+    CC_NULL_GL_SET(BlendColor);
+    CC_NULL_GL_SET(BlendEquation);
+    CC_NULL_GL_SET(BlendEquationSeparate);
+    CC_NULL_GL_SET(BlendFuncSeparate);
+    CC_NULL_GL_SET(StencilFuncSeparate);
+    CC_NULL_GL_SET(StencilMaskSeparate);
+    CC_NULL_GL_SET(StencilOpSeparate);
+    CC_NULL_GL_SET(ReleaseShaderCompiler);
+    CC_NULL_GL_SET(GenerateMipmap);
+    CC_NULL_GL_SET(CompressedTexImage2D);
+    CC_NULL_GL_SET(CompressedTexSubImage2D);
+
+    CC_NULL_GL_SET(GenBuffers);
+    CC_NULL_GL_SET(DeleteBuffers);
+    CC_NULL_GL_SET(IsBuffer);
+    CC_NULL_GL_SET(BindBuffer);
+    CC_NULL_GL_SET(BufferData);
+    CC_NULL_GL_SET(BufferSubData);
+    CC_NULL_GL_SET(MapBuffer);
+    CC_NULL_GL_SET(UnmapBuffer);
+    CC_NULL_GL_SET(GenVertexArrays);
+    CC_NULL_GL_SET(DeleteVertexArrays);
+    CC_NULL_GL_SET(BindVertexArray);
+    CC_NULL_GL_SET(EnableVertexAttribArray);
+    CC_NULL_GL_SET(DisableVertexAttribArray);
+    CC_NULL_GL_SET(VertexAttribPointer);
+    CC_NULL_GL_SET(VertexAttrib1f);
+    CC_NULL_GL_SET(VertexAttrib1fv);
+    CC_NULL_GL_SET(VertexAttrib2f);
+    CC_NULL_GL_SET(VertexAttrib2fv);
+    CC_NULL_GL_SET(VertexAttrib3f);
+    CC_NULL_GL_SET(VertexAttrib3fv);
+    CC_NULL_GL_SET(VertexAttrib4f);
+    CC_NULL_GL_SET(VertexAttrib4fv);
+
+    CC_NULL_GL_SET(GenFramebuffers);
+    CC_NULL_GL_SET(DeleteFramebuffers);
+    CC_NULL_GL_SET(IsFramebuffer);
+    CC_NULL_GL_SET(BindFramebuffer);
+    CC_NULL_GL_SET(CheckFramebufferStatus);
+    CC_NULL_GL_SET(FramebufferTexture2D);
+    CC_NULL_GL_SET(FramebufferRenderbuffer);
+    CC_NULL_GL_SET(GenRenderbuffers);
+    CC_NULL_GL_SET(DeleteRenderbuffers);
+    CC_NULL_GL_SET(IsRenderbuffer);
+    CC_NULL_GL_SET(BindRenderbuffer);
+    CC_NULL_GL_SET(RenderbufferStorage);
+
+    CC_NULL_GL_SET(CreateShader);
+    CC_NULL_GL_SET(CreateProgram);
+    CC_NULL_GL_SET(DeleteShader);
+    CC_NULL_GL_SET(DeleteProgram);
+    CC_NULL_GL_SET(ShaderSource);
+    CC_NULL_GL_SET(CompileShader);
+    CC_NULL_GL_SET(AttachShader);
+    CC_NULL_GL_SET(DetachShader);
+    CC_NULL_GL_SET(BindAttribLocation);
+    CC_NULL_GL_SET(LinkProgram);
+    CC_NULL_GL_SET(ValidateProgram);
+    CC_NULL_GL_SET(IsShader);
+    CC_NULL_GL_SET(IsProgram);
+    CC_NULL_GL_SET(UseProgram);
+    CC_NULL_GL_SET(GetShaderiv);
+    CC_NULL_GL_SET(GetProgramiv);
+    CC_NULL_GL_SET(GetShaderInfoLog);
+    CC_NULL_GL_SET(GetProgramInfoLog);
+    CC_NULL_GL_SET(GetShaderSource);
+    CC_NULL_GL_SET(GetAttachedShaders);
+    CC_NULL_GL_SET(GetActiveAttrib);
+    CC_NULL_GL_SET(GetActiveUniform);
+    CC_NULL_GL_SET(GetAttribLocation);
+    CC_NULL_GL_SET(GetUniformLocation);
+    CC_NULL_GL_SET(GetUniformfv);
+    CC_NULL_GL_SET(GetUniformiv);
+
+    CC_NULL_GL_SET(Uniform1f);
+    CC_NULL_GL_SET(Uniform2f);
+    CC_NULL_GL_SET(Uniform3f);
+    CC_NULL_GL_SET(Uniform4f);
+    CC_NULL_GL_SET(Uniform1i);
+    CC_NULL_GL_SET(Uniform2i);
+    CC_NULL_GL_SET(Uniform3i);
+    CC_NULL_GL_SET(Uniform4i);
+    CC_NULL_GL_SET(Uniform1fv);
+    CC_NULL_GL_SET(Uniform2fv);
+    CC_NULL_GL_SET(Uniform3fv);
+    CC_NULL_GL_SET(Uniform4fv);
+    CC_NULL_GL_SET(Uniform1iv);
+    CC_NULL_GL_SET(Uniform2iv);
+    CC_NULL_GL_SET(Uniform3iv);
+    CC_NULL_GL_SET(Uniform4iv);
+    CC_NULL_GL_SET(UniformMatrix2fv);
+    CC_NULL_GL_SET(UniformMatrix3fv);
+    CC_NULL_GL_SET(UniformMatrix4fv);
+
+    s_installed = true;
+    resetStats();
+}
+
+bool NullGL::isInstalled()
+{
+    return s_installed;
+}
+
+const NullGL::Stats& NullGL::getStats()
+{
+    return s_stats;
+}
+
+void NullGL::resetStats()
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+NS_CC_END
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX && CC_USE_NULL_GL
@@ -0,0 +1,122 @@
+/****************************************************************************
+Copyright (c) 2016 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_NULL_GL_LINUX_H__
+#define __CC_NULL_GL_LINUX_H__
+
+#include "platform/CCPlatformConfig.h"
+#if CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#include "base/ccConfig.h"
+#if CC_USE_NULL_GL
+
+#include <stddef.h>
+#include "platform/CCPlatformMacros.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+/** @class NullGL
+ * @brief @~english A null OpenGL backend that counts the calls instead of drawing, for benchmarks and tests on machines without a GPU.
+ *
+ * When the engine is built with CC_USE_NULL_GL, the OpenGL 1.1 entry points are defined by the engine itself,
+ * and install() points the GLEW function pointers to the same kind of stubs. Objects get fresh names,
+ * buffers keep some storage so that they can be mapped, shaders always compile and programs always link.
+ * GLViewHeadless installs it when it is created.
+ * @~chinese 一个只统计调用而不进行绘制的OpenGL空后端，用于在没有GPU的机器上进行性能测试和单元测试。
+ *
+ * 使用CC_USE_NULL_GL编译引擎时，OpenGL 1.1的函数由引擎自己定义，install()会把GLEW的函数指针指向同样的空实现。
+ * 创建对象时会分配新的名字，缓冲区会保留存储空间以便映射，着色器总是编译成功，程序总是链接成功。
+ * GLViewHeadless在创建时会安装它。
+ */
+class CC_DLL NullGL
+{
+public:
+    /** @struct Stats
+     * @brief @~english The calls that reached the null backend since the last resetStats().
+     * @~chinese 自上次调用resetStats()以来到达空后端的调用统计。
+     */
+    struct Stats
+    {
+        /** glDrawArrays and glDrawElements calls */
+        unsigned int drawCalls;
+        /** vertices (or indices) submitted by the draw calls */
+        unsigned int drawnVertices;
+        /** glClear calls */
+        unsigned int clears;
+        /** glUseProgram calls */
+        unsigned int programChanges;
+        /** glBindTexture calls */
+        unsigned int textureBinds;
+        /** glBindBuffer and glBindVertexArray calls */
+        unsigned int bufferBinds;
+        /** glBindFramebuffer calls */
+        unsigned int framebufferBinds;
+        /** glBlendFunc and glBlendFuncSeparate calls */
+        unsigned int blendFuncChanges;
+        /** glEnable and glDisable calls */
+        unsigned int capabilityChanges;
+        /** glUniform* calls */
+        unsigned int uniformUpdates;
+        /** bytes passed to glBufferData and glBufferSubData */
+        size_t bufferUploadBytes;
+        /** bytes passed to glTexImage2D, glTexSubImage2D and glCompressedTexImage2D */
+        size_t textureUploadBytes;
+    };
+
+    /** @~english Points the GLEW function pointers to the null backend. It is safe to call it more than once.
+     * @~chinese 把GLEW的函数指针指向空后端。可以多次调用。
+     */
+    static void install();
+
+    /** @~english Whether install() was called.
+     * @~chinese 是否已经调用过install()。
+     */
+    static bool isInstalled();
+
+    /** @~english Gets the statistics recorded since the last resetStats().
+     * @~chinese 获取自上次调用resetStats()以来记录的统计数据。
+     */
+    static const Stats& getStats();
+
+    /** @~english Resets the statistics, usually at the beginning of a frame.
+     * @~chinese 重置统计数据，通常在每帧开始时调用。
+     */
+    static void resetStats();
+};
+
+// end of platform group
+/// @}
+
+NS_CC_END
+
+#endif // CC_USE_NULL_GL
+
+#endif // CC_TARGET_PLATFORM == CC_PLATFORM_LINUX
+
+#endif // __CC_NULL_GL_LINUX_H__
@@ -308,6 +308,13 @@ public:
     */
     static const char* SHADER_3D_SKINPOSITION_TEXTURE;
     /**@~english
+    Built in shader used for 3D instanced drawing, support Position and Texture vertex attribute, with the model view
+    matrix and the color of every instance read from the a_instanceModelView0-3 and a_instanceColor attributes.
+     * @~chinese 
+     * 内置shader，用于3D实例化绘制。支持位置，纹理坐标。每个实例的模型视图矩阵和颜色从a_instanceModelView0-3和a_instanceColor属性读取。
+    */
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
+    /**@~english
     Built in shader used for 3D, support Position and Normal vertex attribute, used in lighting. with color specified by a uniform.
      * @~chinese 
      * 内置shader，用于3D光照渲染。支持顶点，法线。颜色通过uniform指定。
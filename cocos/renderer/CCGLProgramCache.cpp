@@ -58,6 +58,7 @@ enum {
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
     kShaderType_3DSkinPositionTex,
+    kShaderType_3DPositionTexInstanced,
     kShaderType_3DPositionNormal,
     kShaderType_3DPositionNormalTex,
     kShaderType_3DSkinPositionNormalTex,
@@ -237,6 +238,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
     _programs.insert(std::make_pair(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE, p));
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+    _programs.insert(std::make_pair(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, p));
+
     p = new GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
     _programs.insert( std::make_pair(GLProgram::SHADER_3D_POSITION_NORMAL, p) );
@@ -382,6 +387,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionTex);
 
+    p = getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+
     p = getGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPositionNormal);
@@ -511,6 +520,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_3DSkinPositionTex:
             p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag);
             break;
+        case kShaderType_3DPositionTexInstanced:
+            p->initWithByteArrays(cc3D_PositionTexInstanced_vert, cc3D_ColorTexInstanced_frag);
+            break;
         case kShaderType_3DPositionNormal:
             {
                 std::string def = getShaderMacrosForLight();
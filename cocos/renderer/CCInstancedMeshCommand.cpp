@@ -0,0 +1,314 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#include "renderer/CCInstancedMeshCommand.h"
+#include <string.h>
+#include "base/ccMacros.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCVertexAttribBinding.h"
+#include "renderer/CCVertexIndexBuffer.h"
+#include "renderer/CCTechnique.h"
+#include "renderer/CCMaterial.h"
+#include "renderer/CCPass.h"
+#include "renderer/CCRenderer.h"
+#include "3d/CCMeshVertexIndexData.h"
+
+// glDrawElementsInstanced and glVertexAttribDivisor come from GL_EXT_instanced_arrays on iOS, and from
+// GL_ARB_draw_instanced and GL_ARB_instanced_arrays on desktop, loaded by GLEW on Linux and Windows.
+// The other platforms always draw the instances one by one.
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS)
+#define CC_INSTANCING_AVAILABLE 1
+#define glDrawElementsInstancedCC glDrawElementsInstancedEXT
+#define glVertexAttribDivisorCC glVertexAttribDivisorEXT
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+#define CC_INSTANCING_AVAILABLE 1
+#define glDrawElementsInstancedCC glDrawElementsInstancedARB
+#define glVertexAttribDivisorCC glVertexAttribDivisorARB
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+#define CC_INSTANCING_AVAILABLE 1
+#define CC_INSTANCING_LOADED_BY_GLEW 1
+#define glDrawElementsInstancedCC glDrawElementsInstancedARB
+#define glVertexAttribDivisorCC glVertexAttribDivisorARB
+#else
+#define CC_INSTANCING_AVAILABLE 0
+#endif
+
+NS_CC_BEGIN
+
+namespace
+{
+    // the per instance attributes of SHADER_3D_POSITION_TEXTURE_INSTANCED, in the order of the instance data
+    const char* s_instanceAttributeNames[] =
+    {
+        "a_instanceModelView0",
+        "a_instanceModelView1",
+        "a_instanceModelView2",
+        "a_instanceModelView3",
+        "a_instanceColor",
+    };
+    const int INSTANCE_ATTRIBUTE_COUNT = sizeof(s_instanceAttributeNames) / sizeof(s_instanceAttributeNames[0]);
+}
+
+bool MeshInstanceBuffer::Key::operator==(const Key& other) const
+{
+    return mesh == other.mesh && program == other.program && texture == other.texture
+        && renderQueue == other.renderQueue && globalZOrder == other.globalZOrder && flags == other.flags;
+}
+
+size_t MeshInstanceBuffer::KeyHash::operator()(const Key& key) const
+{
+    size_t hash = std::hash<const void*>()(key.mesh);
+    hash = hash * 31 + std::hash<const void*>()(key.program);
+    hash = hash * 31 + std::hash<const void*>()(key.texture);
+    hash = hash * 31 + (size_t)key.renderQueue;
+    hash = hash * 31 + std::hash<float>()(key.globalZOrder);
+    return hash * 31 + (size_t)key.flags;
+}
+
+MeshInstanceBuffer::MeshInstanceBuffer()
+: _batchCount(0)
+{
+}
+
+void MeshInstanceBuffer::clear()
+{
+    for (int i = 0; i < _batchCount; ++i)
+        _batches[i].data.clear();
+    _batchCount = 0;
+    _batchIndices.clear();
+}
+
+int MeshInstanceBuffer::addInstance(const Key& key, const Mat4& modelView, const Vec4& color, bool* isNewBatch)
+{
+    int batch;
+    auto iter = _batchIndices.find(key);
+    bool found = (iter != _batchIndices.end());
+    if (found)
+    {
+        batch = iter->second;
+    }
+    else
+    {
+        batch = _batchCount++;
+        if (batch == (int)_batches.size())
+            _batches.push_back(Batch());
+        _batches[batch].key = key;
+        _batchIndices[key] = batch;
+    }
+
+    if (isNewBatch)
+        *isNewBatch = !found;
+
+    auto& data = _batches[batch].data;
+    size_t offset = data.size();
+    data.resize(offset + FLOATS_PER_INSTANCE);
+    memcpy(&data[offset], modelView.m, 16 * sizeof(float));
+    data[offset + 16] = color.x;
+    data[offset + 17] = color.y;
+    data[offset + 18] = color.z;
+    data[offset + 19] = color.w;
+    return batch;
+}
+
+InstancedMeshCommand::InstancedMeshCommand()
+: _material(nullptr)
+, _meshIndexData(nullptr)
+, _buffer(nullptr)
+, _batch(0)
+, _instanceVBO(0)
+, _instanceVBOSize(0)
+{
+    func = CC_CALLBACK_0(InstancedMeshCommand::draw, this);
+}
+
+InstancedMeshCommand::~InstancedMeshCommand()
+{
+    if (_instanceVBO)
+        glDeleteBuffers(1, &_instanceVBO);
+}
+
+void InstancedMeshCommand::init(float globalZOrder, Material* material, MeshIndexData* meshIndexData,
+                                const MeshInstanceBuffer* buffer, int batch, uint32_t flags)
+{
+    CCASSERT(material && meshIndexData && buffer, "Invalid arguments");
+    CCASSERT(material->getTechnique()->getPassCount() == 1, "Instanced meshes need a material with one pass");
+
+    // the first instance gives the depth of the command
+    CustomCommand::init(globalZOrder, Mat4(buffer->getInstanceData(batch)), flags);
+
+    _material = material;
+    _meshIndexData = meshIndexData;
+    _buffer = buffer;
+    _batch = batch;
+}
+
+bool InstancedMeshCommand::isHardwareInstancingAvailable()
+{
+#if CC_INSTANCING_AVAILABLE
+    if (!Configuration::getInstance()->supportsInstancing())
+        return false;
+#if CC_INSTANCING_LOADED_BY_GLEW
+    return glDrawElementsInstancedCC != nullptr && glVertexAttribDivisorCC != nullptr;
+#else
+    return true;
+#endif
+#else
+    return false;
+#endif
+}
+
+void InstancedMeshCommand::draw()
+{
+    auto pass = _material->getTechnique()->getPassByIndex(0);
+    int count = _buffer->getInstanceCount(_batch);
+    const float* instances = _buffer->getInstanceData(_batch);
+
+    // only the unlit textured program has an instanced version
+    auto program = pass->getGLProgramState()->getGLProgram();
+    if (count > 1
+        && program == GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE)
+        && isHardwareInstancingAvailable())
+    {
+        drawInstanced(pass, count, instances);
+    }
+    else
+    {
+        drawEach(pass, count, instances);
+    }
+}
+
+void InstancedMeshCommand::drawInstanced(Pass* pass, int count, const float* instances)
+{
+#if CC_INSTANCING_AVAILABLE
+    auto glProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED);
+    auto glProgram = glProgramState->getGLProgram();
+    auto vertexAttribBinding = VertexAttribBinding::create(_meshIndexData, glProgramState);
+
+    GLint locations[INSTANCE_ATTRIBUTE_COUNT];
+    uint32_t instanceAttribsFlags = 0;
+    for (int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; ++i)
+    {
+        auto attrib = glProgram->getVertexAttrib(s_instanceAttributeNames[i]);
+        locations[i] = attrib ? attrib->index : -1;
+        if (locations[i] >= 0)
+            instanceAttribsFlags |= 1 << locations[i];
+    }
+
+    // upload the instances, growing the buffer when needed
+    size_t size = count * MeshInstanceBuffer::FLOATS_PER_INSTANCE * sizeof(float);
+    if (!_instanceVBO)
+        glGenBuffers(1, &_instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO);
+    if (size > _instanceVBOSize)
+    {
+        glBufferData(GL_ARRAY_BUFFER, size, instances, GL_DYNAMIC_DRAW);
+        _instanceVBOSize = size;
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, size, instances);
+    }
+
+    // the vertex attributes of the mesh, then the ones of the instances
+    vertexAttribBinding->bind();
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        for (int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; ++i)
+        {
+            if (locations[i] >= 0)
+                glEnableVertexAttribArray(locations[i]);
+        }
+    }
+    else
+    {
+        GL::enableVertexAttribs(vertexAttribBinding->getVertexAttribsFlags() | instanceAttribsFlags);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _instanceVBO);
+    const GLsizei stride = MeshInstanceBuffer::FLOATS_PER_INSTANCE * sizeof(float);
+    for (int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; ++i)
+    {
+        if (locations[i] < 0)
+            continue;
+        glVertexAttribPointer(locations[i], 4, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(i * 4 * sizeof(float)));
+        glVertexAttribDivisorCC(locations[i], 1);
+    }
+
+    glProgramState->applyGLProgram(Mat4::IDENTITY);
+    glProgramState->applyUniforms();
+    pass->RenderState::bind(pass);
+
+    auto indexCount = _meshIndexData->getIndexBuffer()->getIndexNumber();
+    glDrawElementsInstancedCC(_meshIndexData->getPrimitiveType(), (GLsizei)indexCount, GL_UNSIGNED_SHORT, 0, count);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, indexCount * count);
+
+    // the attributes are shared by all the programs when there is no VAO
+    for (int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; ++i)
+    {
+        if (locations[i] >= 0)
+            glVertexAttribDivisorCC(locations[i], 0);
+    }
+
+    RenderState::StateBlock::restore(0);
+    vertexAttribBinding->unbind();
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+#else
+    drawEach(pass, count, instances);
+#endif
+}
+
+void InstancedMeshCommand::drawEach(Pass* pass, int count, const float* instances)
+{
+    auto glProgram = pass->getGLProgramState()->getGLProgram();
+    auto colorUniform = glProgram->getUniform("u_color");
+    GLint colorLocation = colorUniform ? colorUniform->location : -1;
+    auto primitive = _meshIndexData->getPrimitiveType();
+    auto indexCount = _meshIndexData->getIndexBuffer()->getIndexNumber();
+
+    // bind the pass once, then only the matrices and the color change
+    pass->bind(Mat4(instances));
+    for (int i = 0; i < count; ++i)
+    {
+        const float* instance = instances + i * MeshInstanceBuffer::FLOATS_PER_INSTANCE;
+        if (i > 0)
+            glProgram->setUniformsForBuiltins(Mat4(instance));
+        if (colorLocation >= 0)
+            glProgram->setUniformLocationWith4fv(colorLocation, instance + 16, 1);
+
+        glDrawElements(primitive, (GLsizei)indexCount, GL_UNSIGNED_SHORT, 0);
+    }
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(count, indexCount * count);
+    pass->unbind();
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
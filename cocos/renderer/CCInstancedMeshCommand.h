@@ -0,0 +1,206 @@
+/****************************************************************************
+ Copyright (c) 2016 Chukong Technologies Inc.
+
+ http://www.cocos2d-x.org
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef _CC_INSTANCEDMESHCOMMAND_H_
+#define _CC_INSTANCEDMESHCOMMAND_H_
+
+#include <vector>
+#include <unordered_map>
+#include "renderer/CCCustomCommand.h"
+#include "math/CCMath.h"
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+NS_CC_BEGIN
+
+class Material;
+class Pass;
+class MeshIndexData;
+
+/**
+ * @class MeshInstanceBuffer
+ * @brief
+ * @~english
+ * Collects the instances of meshes drawn in one frame, grouped by what they share: the mesh, the program,
+ * the texture, the render queue, the global Z order and whether they are rendered as 3D. The batches keep the order
+ * in which their first instance was added, and the instances of a batch the order in which they were added.
+ * Each instance is stored as FLOATS_PER_INSTANCE floats, its model view matrix (column major) followed by its
+ * color, which is the layout of the instance attributes of the instanced shaders. The buffer doesn't call
+ * OpenGL, so that it can be used and tested without a context.
+ * @~chinese
+ * 收集一帧中绘制的网格实例，按照它们共享的内容分组：网格、着色器程序、纹理、渲染队列、全局Z顺序以及是否作为3D渲染。
+ * 批次按照第一个实例加入的顺序排列，批次中的实例按照加入的顺序排列。
+ * 每个实例保存为FLOATS_PER_INSTANCE个浮点数，先是模型视图矩阵（列主序），然后是颜色，与实例化着色器的实例属性的布局相同。
+ * 这个类不调用OpenGL，因此可以在没有OpenGL上下文的情况下使用和测试。
+ */
+class CC_DLL MeshInstanceBuffer
+{
+public:
+    /** @~english The number of floats of an instance: 16 for the model view matrix and 4 for the color.
+     * @~chinese 一个实例的浮点数个数：模型视图矩阵16个，颜色4个。
+     */
+    static const int FLOATS_PER_INSTANCE = 20;
+
+    /** @~english What the instances of a batch share.
+     * @~chinese 一个批次中的实例共享的内容。
+     */
+    struct Key
+    {
+        const void* mesh;
+        const void* program;
+        const void* texture;
+        int renderQueue;
+        float globalZOrder;
+        uint32_t flags;
+
+        bool operator==(const Key& other) const;
+    };
+
+    MeshInstanceBuffer();
+
+    /** @~english Removes all the batches, keeping the memory they use for the next frame.
+     * @~chinese 删除所有的批次，保留它们使用的内存供下一帧使用。
+     */
+    void clear();
+
+    /** @~english Adds an instance to the batch of key, creating the batch if needed.
+     * @~chinese 把一个实例加入key对应的批次中，需要时创建这个批次。
+     * @param isNewBatch @~english Set to true when the instance is the first one of its batch, may be nullptr.
+     * @~chinese 如果实例是批次中的第一个，设为true，可以为nullptr。
+     * @return @~english The index of the batch of the instance.
+     * @~chinese 实例所在批次的索引。
+     */
+    int addInstance(const Key& key, const Mat4& modelView, const Vec4& color, bool* isNewBatch = nullptr);
+
+    /** @~english The number of batches.
+     * @~chinese 批次的个数。
+     */
+    int getBatchCount() const { return _batchCount; }
+
+    /** @~english What the instances of a batch share.
+     * @~chinese 一个批次中的实例共享的内容。
+     */
+    const Key& getKey(int batch) const { return _batches[batch].key; }
+
+    /** @~english The number of instances in a batch.
+     * @~chinese 一个批次中实例的个数。
+     */
+    int getInstanceCount(int batch) const { return (int)(_batches[batch].data.size() / FLOATS_PER_INSTANCE); }
+
+    /** @~english The instances of a batch, FLOATS_PER_INSTANCE floats per instance.
+     * @~chinese 一个批次中的实例，每个实例FLOATS_PER_INSTANCE个浮点数。
+     */
+    const float* getInstanceData(int batch) const { return _batches[batch].data.data(); }
+
+protected:
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Batch
+    {
+        Key key;
+        std::vector<float> data;
+    };
+
+    // batches of the previous frames stay allocated, only the first _batchCount ones are in use
+    std::vector<Batch> _batches;
+    int _batchCount;
+    std::unordered_map<Key, int, KeyHash> _batchIndices;
+};
+
+/**
+ * @class InstancedMeshCommand
+ * @brief
+ * @~english
+ * Draws the instances of a batch of a MeshInstanceBuffer, see Renderer::addMeshInstance().
+ * When the context supports instanced arrays and the pass uses the SHADER_3D_POSITION_TEXTURE program, the instances
+ * are uploaded to a vertex buffer and drawn with one instanced draw call, using the
+ * SHADER_3D_POSITION_TEXTURE_INSTANCED program. Otherwise the pass is bound once and each instance is drawn
+ * after setting its matrices and its u_color uniform.
+ * @~chinese
+ * 绘制MeshInstanceBuffer中一个批次的实例，参考Renderer::addMeshInstance()。
+ * 当OpenGL上下文支持实例化数组，并且pass使用SHADER_3D_POSITION_TEXTURE程序时，实例被上传到一个顶点缓冲区中，
+ * 使用SHADER_3D_POSITION_TEXTURE_INSTANCED程序通过一次实例化绘制调用完成绘制。
+ * 否则pass只绑定一次，每个实例在设置其矩阵和u_color uniform之后绘制。
+ */
+class CC_DLL InstancedMeshCommand : public CustomCommand
+{
+public:
+    /**
+    @~english Constructor.
+    @~chinese 构造函数。
+    */
+    InstancedMeshCommand();
+    /**
+    @~english Destructor.
+    @~chinese 析构函数。
+    */
+    ~InstancedMeshCommand();
+
+    /**@~english
+     Init the command with the instances of a batch. The buffer must not change until the command is drawn.
+     * @~chinese
+     * 用一个批次的实例初始化命令。在命令绘制之前缓冲区不能改变。
+     @param globalZOrder @~english GlobalZOrder of the command. @~chinese 命令的GlobalZOrder。
+     @param material @~english The material of the first instance, its technique must have one pass.
+     * @~chinese 第一个实例的材质，材质的technique只能有一个pass。
+     @param meshIndexData @~english The mesh of the instances. @~chinese 实例的网格。
+     @param buffer @~english The buffer holding the instances. @~chinese 保存实例的缓冲区。
+     @param batch @~english The batch of the instances in the buffer. @~chinese 实例在缓冲区中的批次。
+     @param flags @~english The render flags of the first instance. @~chinese 第一个实例的渲染标记。
+     */
+    void init(float globalZOrder, Material* material, MeshIndexData* meshIndexData,
+              const MeshInstanceBuffer* buffer, int batch, uint32_t flags);
+
+    /** @~english Whether this build and the current context can draw the instances with one draw call.
+     * @~chinese 当前的编译和OpenGL上下文是否可以通过一次绘制调用绘制实例。
+     */
+    static bool isHardwareInstancingAvailable();
+
+protected:
+    void draw();
+    void drawInstanced(Pass* pass, int count, const float* instances);
+    void drawEach(Pass* pass, int count, const float* instances);
+
+    Material* _material;
+    MeshIndexData* _meshIndexData;
+    const MeshInstanceBuffer* _buffer;
+    int _batch;
+
+    GLuint _instanceVBO;
+    size_t _instanceVBOSize;
+};
+
+NS_CC_END
+
+/**
+ end of support group
+ @}
+ */
+#endif // _CC_INSTANCEDMESHCOMMAND_H_
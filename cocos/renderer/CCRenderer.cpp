@@ -37,6 +37,7 @@
 #include "renderer/CCMaterial.h"
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
+#include "renderer/CCGLProgramState.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/ccGLStateCache.h"
 
@@ -45,20 +46,34 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/CCThreadPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include "math/MathUtil.h"
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// Maps a float to an unsigned key that sorts in the same order
+static inline uint32_t floatToSortKey(float value)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    // -0.0f and 0.0f compare equal, give them the same key
+    if (value == 0.0f)
+        value = 0.0f;
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+static inline uint32_t globalOrderSortKey(RenderCommand* command)
 {
-    return  a->getDepth() > b->getDepth();
+    return floatToSortKey(command->getGlobalOrder());
+}
+
+static inline uint32_t depthSortKey(RenderCommand* command)
+{
+    // farthest first
+    return ~floatToSortKey(command->getDepth());
 }
 
 // queue
@@ -112,9 +127,96 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    sortCommands(_commands[QUEUE_GROUP::TRANSPARENT_3D], depthSortKey);
+    sortCommands(_commands[QUEUE_GROUP::GLOBALZ_NEG], globalOrderSortKey);
+    sortCommands(_commands[QUEUE_GROUP::GLOBALZ_POS], globalOrderSortKey);
+}
+
+void RenderQueue::sortCommands(std::vector<RenderCommand*>& commands, uint32_t (*sortKey)(RenderCommand*))
+{
+    const size_t count = commands.size();
+    if (count < 2)
+        return;
+
+    _sortEntries.resize(count);
+    bool sorted = true;
+    uint32_t previousKey = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        uint32_t key = sortKey(commands[i]);
+        _sortEntries[i].key = key;
+        _sortEntries[i].command = commands[i];
+        sorted = sorted && key >= previousKey;
+        previousKey = key;
+    }
+
+    // Commands are pushed in visit order, which usually matches the order of the last frame
+    if (sorted)
+        return;
+
+    SortEntry* result = _sortEntries.data();
+    if (count <= 32)
+    {
+        // insertion sort, stable
+        for (size_t i = 1; i < count; ++i)
+        {
+            SortEntry entry = result[i];
+            size_t j = i;
+            while (j > 0 && result[j - 1].key > entry.key)
+            {
+                result[j] = result[j - 1];
+                --j;
+            }
+            result[j] = entry;
+        }
+    }
+    else
+    {
+        // LSD radix sort on 8 bits digits, stable
+        size_t histogram[4][256];
+        memset(histogram, 0, sizeof(histogram));
+        for (size_t i = 0; i < count; ++i)
+        {
+            uint32_t key = result[i].key;
+            ++histogram[0][key & 0xFF];
+            ++histogram[1][(key >> 8) & 0xFF];
+            ++histogram[2][(key >> 16) & 0xFF];
+            ++histogram[3][key >> 24];
+        }
+
+        _sortScratch.resize(count);
+        SortEntry* source = result;
+        SortEntry* destination = _sortScratch.data();
+        for (int pass = 0; pass < 4; ++pass)
+        {
+            size_t* counts = histogram[pass];
+            const int shift = pass * 8;
+
+            // all the keys share this digit, the pass would not move anything
+            if (counts[(source[0].key >> shift) & 0xFF] == count)
+                continue;
+
+            size_t offset = 0;
+            for (int digit = 0; digit < 256; ++digit)
+            {
+                size_t digitCount = counts[digit];
+                counts[digit] = offset;
+                offset += digitCount;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                destination[counts[(source[i].key >> shift) & 0xFF]++] = source[i];
+            }
+            std::swap(source, destination);
+        }
+        result = source;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = result[i].command;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -203,11 +305,14 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 Renderer::Renderer()
 :_lastMaterialID(0)
 ,_lastBatchedMeshCommand(nullptr)
+,_usedInstancedMeshCommands(0)
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_numberQuads(0)
 ,_glViewAssigned(false)
 ,_isRendering(false)
+,_recordedListCount(0)
+,_isParallelRecording(false)
 ,_isDepthTestFor2D(false)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
@@ -229,6 +334,9 @@ Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+
+    for (auto command : _instancedMeshCommands)
+        delete command;
     
     glDeleteBuffers(2, _buffersVBO);
     glDeleteBuffers(2, _quadbuffersVBO);
@@ -390,28 +498,119 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (_isParallelRecording)
+    {
+        // each thread only touches its own slot and its own list
+        size_t list = _recordingListOfThread[ThreadPool::getInstance()->getCurrentThreadIndex()];
+        _recordedCommands[list].push_back({command, renderQueue});
+        return;
+    }
+
     _renderGroups[renderQueue].push_back(command);
 }
 
+bool Renderer::addMeshInstance(float globalZOrder, Material* material, MeshIndexData* meshIndexData,
+                               const Mat4& modelView, const Vec4& color, uint32_t flags)
+{
+    CCASSERT(!_isRendering, "Cannot add mesh instance while rendering");
+
+    // the instance buffer and the commands are not shared between threads
+    if (_isParallelRecording)
+        return false;
+
+    auto pass = material->getTechnique()->getPassByIndex(0);
+    MeshInstanceBuffer::Key key;
+    key.mesh = meshIndexData;
+    key.program = pass->getGLProgramState()->getGLProgram();
+    key.texture = pass->getTexture();
+    key.renderQueue = _commandGroupStack.top();
+    key.globalZOrder = globalZOrder;
+    // the dirty bits differ between the nodes, only the queue matters
+    key.flags = flags & Node::FLAGS_RENDER_AS_3D;
+
+    bool isNewBatch = false;
+    int batch = _meshInstances.addInstance(key, modelView, color, &isNewBatch);
+    if (isNewBatch)
+    {
+        if (_usedInstancedMeshCommands == _instancedMeshCommands.size())
+            _instancedMeshCommands.push_back(new (std::nothrow) InstancedMeshCommand());
+
+        auto command = _instancedMeshCommands[_usedInstancedMeshCommands++];
+        command->init(globalZOrder, material, meshIndexData, &_meshInstances, batch, flags);
+        addCommand(command, key.renderQueue);
+    }
+    return true;
+}
+
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_isParallelRecording, "Cannot change render queue while recording in parallel");
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    CCASSERT(!_isParallelRecording, "Cannot change render queue while recording in parallel");
     _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
 {
+    CCASSERT(!_isParallelRecording, "Cannot create render queue while recording in parallel");
     RenderQueue newRenderQueue;
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
 
+size_t Renderer::beginParallelRecording(size_t listCount)
+{
+    CCASSERT(!_isParallelRecording, "Parallel recording can not be nested");
+
+    // the lists keep their capacity from one frame to the next
+    size_t firstList = _recordedListCount;
+    _recordedListCount += listCount;
+    if (_recordedCommands.size() < _recordedListCount)
+        _recordedCommands.resize(_recordedListCount);
+    for (size_t i = firstList; i < _recordedListCount; ++i)
+        _recordedCommands[i].clear();
+
+    _recordingListOfThread.resize(ThreadPool::getInstance()->getThreadCount() + 1, 0);
+    _isParallelRecording = true;
+    return firstList;
+}
+
+void Renderer::setRecordingList(size_t index)
+{
+    CCASSERT(_isParallelRecording && index < _recordedListCount, "Invalid recording list");
+    _recordingListOfThread[ThreadPool::getInstance()->getCurrentThreadIndex()] = index;
+}
+
+void Renderer::endParallelRecording()
+{
+    _isParallelRecording = false;
+}
+
+void Renderer::mergeRecordedCommands(size_t index)
+{
+    CCASSERT(!_isParallelRecording, "Cannot merge commands while recording in parallel");
+    CCASSERT(index < _recordedListCount, "Invalid recording list");
+    for (auto& recorded : _recordedCommands[index])
+    {
+        _renderGroups[recorded.renderQueue].push_back(recorded.command);
+    }
+    _recordedCommands[index].clear();
+}
+
+void Renderer::releaseRecordedLists(size_t firstList)
+{
+    CCASSERT(!_isParallelRecording && firstList <= _recordedListCount, "Invalid recording list");
+    for (size_t i = firstList; i < _recordedListCount; ++i)
+        _recordedCommands[i].clear();
+    _recordedListCount = firstList;
+}
+
 void Renderer::processRenderCommand(RenderCommand* command)
 {
     auto commandType = command->getType();
@@ -737,6 +936,10 @@ void Renderer::clean()
     _numberQuads = 0;
     _lastMaterialID = 0;
     _lastBatchedMeshCommand = nullptr;
+
+    // the commands of the instances are kept for the next render
+    _meshInstances.clear();
+    _usedInstancedMeshCommands = 0;
 }
 
 void Renderer::clear()
@@ -776,22 +979,11 @@ void Renderer::setDepthTest(bool enable)
 
 void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 {
-    memcpy(_verts + _filledVertex, cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
     const Mat4& modelView = cmd->getModelView();
+    MathUtil::transformVertices(_verts + _filledVertex, cmd->getVertices(), cmd->getVertexCount(), modelView);
     
-    for(ssize_t i=0; i< cmd->getVertexCount(); ++i)
-    {
-        V3F_C4B_T2F *q = &_verts[i + _filledVertex];
-        Vec3 *vec1 = (Vec3*)&q->vertices;
-        modelView.transformPoint(vec1);
-    }
-    
-    const unsigned short* indices = cmd->getIndices();
     //fill index
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
-    {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
-    }
+    MathUtil::transformIndices(_indices + _filledIndex, cmd->getIndices(), cmd->getIndexCount(), _filledVertex);
     
     _filledVertex += cmd->getVertexCount();
     _filledIndex += cmd->getIndexCount();
@@ -801,11 +993,7 @@ void Renderer::fillQuads(const QuadCommand *cmd)
 {
     const Mat4& modelView = cmd->getModelView();
     const V3F_C4B_T2F* quads =  (V3F_C4B_T2F*)cmd->getQuads();
-    for(ssize_t i=0; i< cmd->getQuadCount() * 4; ++i)
-    {
-        _quadVerts[i + _numberQuads * 4] = quads[i];
-        modelView.transformPoint(quads[i].vertices,&(_quadVerts[i + _numberQuads * 4].vertices));
-    }
+    MathUtil::transformVertices(_quadVerts + _numberQuads * 4, quads, cmd->getQuadCount() * 4, modelView);
     
     _numberQuads += cmd->getQuadCount();
 }
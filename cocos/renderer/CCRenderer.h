@@ -32,6 +32,7 @@
 #include "platform/CCPlatformMacros.h"
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
+#include "renderer/CCInstancedMeshCommand.h"
 #include "platform/CCGL.h"
 
 /**
@@ -45,6 +46,8 @@ class EventListenerCustom;
 class QuadCommand;
 class TrianglesCommand;
 class MeshCommand;
+class Material;
+class MeshIndexData;
 
 /** 
 @class RenderQueue
@@ -164,10 +167,26 @@ public:
     void restoreRenderState();
     
 protected:
+    /**
+    @~english Stable sort of a sub queue by an unsigned key, skipped when the commands are already in order. 
+    @~chinese 按无符号键值对子队列进行稳定排序，如果命令已经有序则跳过。*/
+    void sortCommands(std::vector<RenderCommand*>& commands, uint32_t (*sortKey)(RenderCommand*));
+
     /**
     @~english The commands in the render queue. 
     @~chinese 渲染队列中的命令。*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+
+    struct SortEntry
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+    /**
+    @~english Buffers reused by sortCommands() from one frame to the next. 
+    @~chinese sortCommands()每帧重复使用的缓冲区。*/
+    std::vector<SortEntry> _sortEntries;
+    std::vector<SortEntry> _sortScratch;
     
     /**
     @~english Cull state. 
@@ -280,6 +299,84 @@ public:
     */
     int createRenderQueue();
 
+    /** 
+    @~english Starts recording render commands from several threads at once, see `Node::setParallelVisitRoot`.
+    Until `endParallelRecording` is called, `addCommand` stores the commands into the list selected
+    by the calling thread with `setRecordingList`, instead of adding them to the render queues.
+    Groups can not be pushed or popped while recording.
+    The lists are taken after the ones still waiting to be merged, so a recording can start before
+    the lists of another one are merged, as long as the lists are released in the reverse order.
+    @~chinese 开始在多个线程中同时记录渲染命令，参见`Node::setParallelVisitRoot`。
+    在调用`endParallelRecording`之前，`addCommand`会把命令存放到调用线程通过`setRecordingList`选择的列表中，而不是加入渲染队列。
+    记录期间不能入栈或出栈渲染队列。
+    新的列表位于仍在等待合并的列表之后，因此在另一次记录的列表合并之前可以开始新的记录，只要按相反的顺序释放列表。
+    @param listCount @~english the number of recording lists. @~chinese 记录列表的数量。
+    @return @~english the index of the first list of this recording. @~chinese 本次记录的第一个列表的索引。
+    */
+    size_t beginParallelRecording(size_t listCount);
+
+    /** 
+    @~english Selects the recording list used by the calling thread.
+    @~chinese 选择调用线程使用的记录列表。
+    @param index @~english the index of the list, the first list plus a value in [0, listCount).
+    @~chinese 列表的索引，第一个列表的索引加上[0, listCount)范围内的值。
+    */
+    void setRecordingList(size_t index);
+
+    /** 
+    @~english Stops recording, the recorded lists are kept until they are merged.
+    @~chinese 停止记录，记录的列表会一直保留到被合并。
+    */
+    void endParallelRecording();
+
+    /** 
+    @~english Adds the commands of a recording list into their render queues, in the order they were recorded.
+    @~chinese 按记录的顺序把记录列表中的命令加入到对应的渲染队列中。
+    @param index @~english the index of the list. @~chinese 列表的索引。
+    */
+    void mergeRecordedCommands(size_t index);
+
+    /** 
+    @~english Gets the number of commands of a recording list that are not merged yet.
+    @~chinese 获取记录列表中尚未合并的命令数量。
+    @param index @~english the index of the list. @~chinese 列表的索引。
+    */
+    size_t getRecordedCommandCount(size_t index) const { return _recordedCommands[index].size(); }
+
+    /** 
+    @~english Releases the lists of a recording and of the recordings started after it, the commands not merged are dropped.
+    @~chinese 释放一次记录以及在它之后开始的记录的列表，未合并的命令被丢弃。
+    @param firstList @~english the index returned by `beginParallelRecording`. @~chinese `beginParallelRecording`返回的索引。
+    */
+    void releaseRecordedLists(size_t firstList);
+
+    /** 
+    @~english Whether render commands are being recorded from several threads.
+    @~chinese 是否正在多个线程中记录渲染命令。
+    */
+    bool isParallelRecording() const { return _isParallelRecording; }
+
+    /** 
+    @~english Adds an instance of a mesh, to be drawn by an `InstancedMeshCommand`.
+    The instances sharing the mesh, the program and the texture of the material, the render queue, the global Z order
+    and the FLAGS_RENDER_AS_3D flag are drawn together by one command, added where the first of them was added, with the render state
+    and the uniforms of the material of the first instance, except the matrices and `u_color` which are the ones of
+    each instance.
+    @~chinese 加入一个网格实例，由`InstancedMeshCommand`绘制。
+    共享网格、材质的着色器程序和纹理、渲染队列、全局Z顺序和FLAGS_RENDER_AS_3D标记的实例由一个命令一起绘制，命令加入在第一个实例加入的位置，
+    使用第一个实例的材质的渲染状态和uniform，矩阵和`u_color`除外，它们使用每个实例自己的值。
+    @param globalZOrder @~english GlobalZOrder of the instance. @~chinese 实例的GlobalZOrder。
+    @param material @~english The material of the instance, its technique must have one pass. @~chinese 实例的材质，材质的technique只能有一个pass。
+    @param meshIndexData @~english The mesh of the instance. @~chinese 实例的网格。
+    @param modelView @~english The model view matrix of the instance. @~chinese 实例的模型视图矩阵。
+    @param color @~english The color of the instance. @~chinese 实例的颜色。
+    @param flags @~english The render flags of the instance. @~chinese 实例的渲染标记。
+    @return @~english False when the instance can't be batched while recording in parallel, the caller then draws it with its own command.
+    @~chinese 在并行记录时实例不能被批处理，返回false，调用者需要用自己的命令绘制它。
+    */
+    bool addMeshInstance(float globalZOrder, Material* material, MeshIndexData* meshIndexData,
+                         const Mat4& modelView, const Vec4& color, uint32_t flags);
+
     /** 
     @~english Renders into the GLView all the queued `RenderCommand` objects  
     @~chinese 执行所有保存的渲染命令，将其渲染到GLView上。
@@ -397,9 +494,27 @@ protected:
     
     std::vector<RenderQueue> _renderGroups;
 
+    // commands recorded by Node::visit on worker threads, and the list each thread writes into.
+    // The first _recordedListCount lists are waiting to be merged.
+    struct RecordedCommand
+    {
+        RenderCommand* command;
+        int renderQueue;
+    };
+    std::vector<std::vector<RecordedCommand>> _recordedCommands;
+    std::vector<size_t> _recordingListOfThread;
+    size_t _recordedListCount;
+    bool _isParallelRecording;
+
     uint32_t _lastMaterialID;
 
     MeshCommand*              _lastBatchedMeshCommand;
+
+    // instances of meshes added since the last render, and the commands drawing them
+    MeshInstanceBuffer _meshInstances;
+    std::vector<InstancedMeshCommand*> _instancedMeshCommands;
+    size_t _usedInstancedMeshCommands;
+
     std::vector<TrianglesCommand*> _batchedCommands;
     std::vector<QuadCommand*> _batchQuadCommands;
 
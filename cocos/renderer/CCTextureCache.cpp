@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -56,10 +58,17 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncLoadThreadCount(1)
+, _asyncUploadBudget(0)
+, _asyncSequence(0)
 , _needQuit(false)
 , _asyncRefCount(0)
 {
+    unsigned int cores = std::thread::hardware_concurrency();
+    if (cores > 1)
+    {
+        _asyncLoadThreadCount = std::min(static_cast<int>(cores) - 1, 4);
+    }
 }
 
 TextureCache::~TextureCache()
@@ -69,7 +78,14 @@ TextureCache::~TextureCache()
     for( auto it=_textures.begin(); it!=_textures.end(); ++it)
         (it->second)->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    for (auto thread : _loadingThreads)
+        delete thread;
+
+    // the requests left when the loading threads quit
+    for (auto asyncStruct : _requestQueue)
+        delete asyncStruct;
+    for (auto asyncStruct : _responseQueue)
+        delete asyncStruct;
 }
 
 void TextureCache::destroyInstance()
@@ -93,68 +109,126 @@ std::string TextureCache::getDescription() const
 struct TextureCache::AsyncStruct
 {
 public:
-    AsyncStruct(const std::string& fn, std::function<void(Texture2D*)> f) : filename(fn), callback(f), loadSuccess(false) {}
+    struct Callback
+    {
+        std::string key;
+        std::function<void(Texture2D*, const AsyncLoadInfo&)> function;
+    };
+
+
+    AsyncStruct(const std::string& fn, int p, unsigned int seq)
+    : filename(fn), priority(p), sequence(seq), loadSuccess(false), cancelled(false), decodeTime(0)
+    , requestTime(std::chrono::steady_clock::now()) {}
     
     std::string filename;
-    std::function<void(Texture2D*)> callback;
+    std::vector<Callback> callbacks;
+    int priority;
+    unsigned int sequence;
     Image image;
     bool loadSuccess;
+    bool cancelled;
+    float decodeTime;
+    std::chrono::steady_clock::time_point requestTime;
 };
 
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
+ - _requestQueue, _asyncLoadThreadCount and _needQuit: locked by _requestMutex
  - _responseQueue: locked by _responseMutex
+ - AsyncStruct::priority: written with both locks held, read with either of them
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
  - image data: new in Load thread, delete in GL thread(by Image instance)
  
  Note:
- - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - all AsyncStruct in flight are referenced in _asyncStructs by full path, for coalescing, cancel and unbind use.
+ - the callbacks of a coalesced request keep the key of their caller, cancel removes only the caller's ones.
+ - both queues are kept sorted by priority, then by request order.
  
  How to deal add image many times?
- - At first, this situation is abnormal, we only ensure the logic is correct.
  - If the image has been loaded, the after load image call will return immediately.
- - If the image request is in queue already, there will be more than one request in queue,
- - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
+ - If the image request is in flight already, the callback is added to that request.
+ - In addImageAsyncCallback, will still check the cache to ensure only create one texture.
  
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a problem.
+ - Creating a big texture is not free, so the work can be limited by _asyncUploadBudget,
+   the remaining responses are processed in the next frames.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback)
+{
+    std::function<void(Texture2D*, const AsyncLoadInfo&)> wrapper = nullptr;
+    if (callback)
+    {
+        wrapper = [callback](Texture2D* texture, const AsyncLoadInfo&) { callback(texture); };
+    }
+    addImageAsync(path, wrapper, 0, "");
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*, const AsyncLoadInfo&)>& callback, int priority, const std::string &callbackKey)
 {
     Texture2D *texture = nullptr;
 
     std::string fullpath = FileUtils::getInstance()->fullPathForFilename(path);
 
+    AsyncLoadInfo info;
+    info.path = fullpath;
+    info.decodeTime = 0;
+    info.uploadTime = 0;
+    info.totalTime = 0;
+
     auto it = _textures.find(fullpath);
     if( it != _textures.end() )
         texture = it->second;
 
     if (texture != nullptr)
     {
-        if (callback) callback(texture);
+        if (callback) callback(texture, info);
+        return;
+    }
+
+    // coalesce with the request in flight for the same file
+    auto pending = _asyncStructs.find(fullpath);
+    if (pending != _asyncStructs.end())
+    {
+        AsyncStruct *data = pending->second;
+        data->callbacks.push_back({callbackKey, callback});
+        if (priority > data->priority)
+        {
+            std::lock_guard<std::mutex> requestLock(_requestMutex);
+            std::lock_guard<std::mutex> responseLock(_responseMutex);
+            auto queued = std::find(_requestQueue.begin(), _requestQueue.end(), data);
+            auto decoded = std::find(_responseQueue.begin(), _responseQueue.end(), data);
+            data->priority = priority;
+            if (queued != _requestQueue.end())
+            {
+                _requestQueue.erase(queued);
+                insertByPriority(_requestQueue, data);
+            }
+            else if (decoded != _responseQueue.end())
+            {
+                _responseQueue.erase(decoded);
+                insertByPriority(_responseQueue, data);
+            }
+        }
         return;
     }
 
     // check if file exists
     if ( fullpath.empty() || ! FileUtils::getInstance()->isFileExist( fullpath ) ) {
-        if (callback) callback(nullptr);
+        if (callback) callback(nullptr, info);
         return;
     }
 
     // lazy init
-    if (_loadingThread == nullptr)
+    if (_loadingThreads.empty())
     {
-        // create a new thread to load images
-        _loadingThread = new std::thread(&TextureCache::loadImage, this);
-        _needQuit = false;
+        startLoadingThreads();
     }
 
     if (0 == _asyncRefCount)
@@ -165,82 +239,180 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     ++_asyncRefCount;
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, callback);
+    AsyncStruct *data = new (std::nothrow) AsyncStruct(fullpath, priority, _asyncSequence++);
+    data->callbacks.push_back({callbackKey, callback});
     
     // add async struct into queue
-    _asyncStructQueue.push_back(data);
+    _asyncStructs[fullpath] = data;
     _requestMutex.lock();
-    _requestQueue.push_back(data);
+    insertByPriority(_requestQueue, data);
     _requestMutex.unlock();
 
     _sleepCondition.notify_one();
 }
 
+void TextureCache::insertByPriority(std::deque<AsyncStruct*>& queue, AsyncStruct* asyncStruct)
+{
+    auto pos = std::upper_bound(queue.begin(), queue.end(), asyncStruct, [](const AsyncStruct* a, const AsyncStruct* b) {
+        return a->priority > b->priority || (a->priority == b->priority && a->sequence < b->sequence);
+    });
+    queue.insert(pos, asyncStruct);
+}
+
+bool TextureCache::cancelImageAsync(const std::string &filename, const std::string &callbackKey)
+{
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    auto it = _asyncStructs.find(fullpath);
+    if (it == _asyncStructs.end())
+    {
+        return false;
+    }
+
+    AsyncStruct *data = it->second;
+    auto& callbacks = data->callbacks;
+    auto removed = std::remove_if(callbacks.begin(), callbacks.end(), [&callbackKey](const AsyncStruct::Callback& callback) {
+        return callback.key == callbackKey;
+    });
+    if (removed == callbacks.end())
+    {
+        return false;
+    }
+    callbacks.erase(removed, callbacks.end());
+
+    // other callers still wait for the texture
+    if (!callbacks.empty())
+    {
+        return true;
+    }
+
+    _asyncStructs.erase(it);
+
+    bool queued = false;
+    _requestMutex.lock();
+    auto pos = std::find(_requestQueue.begin(), _requestQueue.end(), data);
+    if (pos != _requestQueue.end())
+    {
+        _requestQueue.erase(pos);
+        queued = true;
+    }
+    _requestMutex.unlock();
+
+    if (queued)
+    {
+        delete data;
+        --_asyncRefCount;
+    }
+    else
+    {
+        // being decoded or waiting for the upload, addImageAsyncCallBack drops it
+        data->cancelled = true;
+    }
+    return true;
+}
+
 void TextureCache::unbindImageAsync(const std::string& filename)
 {
-    if (_asyncStructQueue.empty())
+    if (_asyncStructs.empty())
     {
         return;
     }
     std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
-    for (auto it = _asyncStructQueue.begin(); it != _asyncStructQueue.end(); ++it)
+    auto it = _asyncStructs.find(fullpath);
+    if (it != _asyncStructs.end())
     {
-        if ((*it)->filename == fullpath)
-        {
-            (*it)->callback = nullptr;
-        }
+        it->second->callbacks.clear();
     }
 }
 
 void TextureCache::unbindAllImageAsync()
 {
-    if (_asyncStructQueue.empty())
+    if (_asyncStructs.empty())
     {
         return;
 
     }
-    for (auto it = _asyncStructQueue.begin(); it != _asyncStructQueue.end(); ++it)
+    for (auto it = _asyncStructs.begin(); it != _asyncStructs.end(); ++it)
     {
-        (*it)->callback = nullptr;
+        it->second->callbacks.clear();
     }
 }
 
-void TextureCache::loadImage()
+void TextureCache::setAsyncLoadThreadCount(int count)
 {
-    AsyncStruct *asyncStruct = nullptr;
-    std::mutex signalMutex;
-    std::unique_lock<std::mutex> signal(signalMutex);
-    while (!_needQuit)
+    count = std::max(count, 1);
+
+    std::vector<std::thread*> retired;
+    _requestMutex.lock();
+    _asyncLoadThreadCount = count;
+    while (_loadingThreads.size() > static_cast<size_t>(count))
+    {
+        retired.push_back(_loadingThreads.back());
+        _loadingThreads.pop_back();
+    }
+    _requestMutex.unlock();
+
+    if (!retired.empty())
     {
-        // pop an AsyncStruct from request queue
-        _requestMutex.lock();
-        if(_requestQueue.empty())
+        _sleepCondition.notify_all();
+        for (auto thread : retired)
         {
-            asyncStruct = nullptr;
-        }else
+            thread->join();
+            delete thread;
+        }
+    }
+    else if (!_loadingThreads.empty())
+    {
+        startLoadingThreads();
+    }
+}
+
+void TextureCache::startLoadingThreads()
+{
+    _requestMutex.lock();
+    _needQuit = false;
+    _requestMutex.unlock();
+
+    // the threads are only created and destroyed by the GL thread
+    for (int i = static_cast<int>(_loadingThreads.size()); i < _asyncLoadThreadCount; ++i)
+    {
+        _loadingThreads.push_back(new std::thread(&TextureCache::loadImage, this, i));
+    }
+}
+
+void TextureCache::loadImage(int threadIndex)
+{
+    while (true)
+    {
+        // pop the AsyncStruct with the highest priority from request queue
+        AsyncStruct *asyncStruct = nullptr;
         {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _sleepCondition.wait(lock, [this, threadIndex]() {
+                return _needQuit || threadIndex >= _asyncLoadThreadCount || !_requestQueue.empty();
+            });
+            if (_needQuit || threadIndex >= _asyncLoadThreadCount)
+            {
+                break;
+            }
             asyncStruct = _requestQueue.front();
             _requestQueue.pop_front();
         }
-        _requestMutex.unlock();
-        
-        if (nullptr == asyncStruct) {
-            _sleepCondition.wait(signal);
-            continue;
-        }
         
         // load image
+        auto start = std::chrono::steady_clock::now();
         asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+        asyncStruct->decodeTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
 
         // push the asyncStruct to response queue
         _responseMutex.lock();
-        _responseQueue.push_back(asyncStruct);
+        insertByPriority(_responseQueue, asyncStruct);
         _responseMutex.unlock();
     }
 }
 
 void TextureCache::addImageAsyncCallBack(float dt)
 {
+    auto frameStart = std::chrono::steady_clock::now();
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
     while (true)
@@ -254,16 +426,27 @@ void TextureCache::addImageAsyncCallBack(float dt)
         {
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
-            
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
         
         if (nullptr == asyncStruct) {
             break;
         }
+
+        if (asyncStruct->cancelled)
+        {
+            delete asyncStruct;
+            --_asyncRefCount;
+            continue;
+        }
+
+        auto pending = _asyncStructs.find(asyncStruct->filename);
+        if (pending != _asyncStructs.end() && pending->second == asyncStruct)
+        {
+            _asyncStructs.erase(pending);
+        }
+
+        auto uploadStart = std::chrono::steady_clock::now();
         
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
@@ -297,16 +480,33 @@ void TextureCache::addImageAsyncCallBack(float dt)
                 CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
             }
         }
+
+        auto uploadEnd = std::chrono::steady_clock::now();
+        AsyncLoadInfo info;
+        info.path = asyncStruct->filename;
+        info.decodeTime = asyncStruct->decodeTime;
+        info.uploadTime = std::chrono::duration<float>(uploadEnd - uploadStart).count();
+        info.totalTime = std::chrono::duration<float>(uploadEnd - asyncStruct->requestTime).count();
         
-        // call callback function
-        if (asyncStruct->callback)
+        // call callback functions
+        for (const auto& callback : asyncStruct->callbacks)
         {
-            (asyncStruct->callback)(texture);
+            if (callback.function)
+            {
+                callback.function(texture, info);
+            }
         }
 
         // release the asyncStruct
         delete asyncStruct;
         --_asyncRefCount;
+
+        // leave the remaining uploads to the next frames
+        if (_asyncUploadBudget > 0 &&
+            std::chrono::duration<float>(std::chrono::steady_clock::now() - frameStart).count() >= _asyncUploadBudget)
+        {
+            break;
+        }
     }
 
     if (0 == _asyncRefCount)
@@ -557,10 +757,17 @@ const std::string TextureCache::getTextureFilePath( cocos2d::Texture2D *texture
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // notify sub threads to quit
+    _requestMutex.lock();
     _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    _requestMutex.unlock();
+    _sleepCondition.notify_all();
+    for (auto thread : _loadingThreads)
+    {
+        thread->join();
+        delete thread;
+    }
+    _loadingThreads.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -34,6 +34,7 @@ THE SOFTWARE.
 #include <condition_variable>
 #include <queue>
 #include <string>
+#include <vector>
 #include <unordered_map>
 #include <functional>
 
@@ -70,6 +71,22 @@ NS_CC_BEGIN
 class CC_DLL TextureCache : public Ref
 {
 public:
+    /** @struct AsyncLoadInfo
+     * @brief @~english What happened to an image loaded by addImageAsync().
+     * @~chinese addImageAsync() 加载一个图片的过程信息。
+     */
+    struct AsyncLoadInfo
+    {
+        /** @~english The full path of the image. @~chinese 图片的完整路径。*/
+        std::string path;
+        /** @~english Seconds spent decoding the image on a loading thread. @~chinese 在加载线程中解码图片所用的秒数。*/
+        float decodeTime;
+        /** @~english Seconds spent creating the texture on the main thread. @~chinese 在主线程中创建纹理所用的秒数。*/
+        float uploadTime;
+        /** @~english Seconds between the request and the callback. @~chinese 从请求到回调之间的秒数。*/
+        float totalTime;
+    };
+
     /** @~english Returns the shared instance of the cache.  @~chinese 返回 TextureCache 的实例。*/
     CC_DEPRECATED_ATTRIBUTE static TextureCache * getInstance();
 
@@ -143,6 +160,76 @@ public:
      * @since v0.8
      */
     virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*)>& callback);
+
+    /** @~english Loads an image asynchronously with a priority, and reports how long it took.
+     * Requests with a higher priority are decoded, and then uploaded, before the ones with a lower priority;
+     * requests with the same priority are served in order. If the same file is already being loaded,
+     * the callback is attached to that request instead of decoding the file twice, and the request gets
+     * the higher of the two priorities.
+     * @~chinese 按指定的优先级异步加载图片，并报告加载所用的时间。
+     * 优先级高的请求先于优先级低的请求解码和上传；优先级相同的请求按顺序处理。
+     * 如果同一个文件正在加载，回调函数会附加到这个请求上，而不会再次解码文件，请求的优先级取两者中较高的一个。
+     * @param filepath @~english The path of the image file.
+     * @~chinese 图片文件的路径。
+     * @param callback @~english Invoked on the main thread with the texture (nullptr if it failed) and the timings.
+     * @~chinese 在主线程中调用的回调函数，参数为纹理（失败时为 nullptr）和时间信息。
+     * @param priority @~english The priority of the request, 0 for the other overload.
+     * @~chinese 请求的优先级，另一个重载使用 0。
+     * @param callbackKey @~english Identifies the caller to cancelImageAsync(), empty for the other overload.
+     * @~chinese 用于在 cancelImageAsync() 中标识调用者，另一个重载使用空字符串。
+     * @since v3.11
+     */
+    virtual void addImageAsync(const std::string &filepath, const std::function<void(Texture2D*, const AsyncLoadInfo&)>& callback, int priority, const std::string &callbackKey = "");
+
+    /** @~english Cancels the asynchronous load of an image for one caller.
+     * The callbacks added with callbackKey are removed and not invoked. The callers that share the load keep
+     * theirs; once no callback is left, a request that is still queued is dropped and an image that is being
+     * decoded is thrown away when it is done, without creating the texture.
+     * @~chinese 为一个调用者取消图片的异步加载。
+     * 使用 callbackKey 添加的回调函数被移除，不会被调用。共享这次加载的其他调用者保留各自的回调函数；
+     * 没有回调函数剩下时，仍在队列中的请求将被丢弃，正在解码的图片在解码完成后被丢弃，不会创建纹理。
+     * @param filepath @~english The path of the image file.
+     * @~chinese 图片文件的路径。
+     * @param callbackKey @~english The key passed to addImageAsync().
+     * @~chinese 传给 addImageAsync() 的标识。
+     * @return @~english True if a callback of the caller was removed.
+     * @~chinese 如果移除了这个调用者的回调函数，返回 true。
+     * @since v3.11
+     */
+    virtual bool cancelImageAsync(const std::string &filepath, const std::string &callbackKey);
+
+    /** @~english Sets how many threads decode the images of addImageAsync(), 1 by default on single core devices and
+     * up to 4 otherwise. When the number is reduced, the extra threads finish the image they are decoding first.
+     * @~chinese 设置为 addImageAsync() 解码图片的线程数，单核设备默认为 1，其他设备最多为 4。
+     * 减少线程数时，多出来的线程会先完成正在解码的图片。
+     * @param count @~english The number of loading threads, at least 1.
+     * @~chinese 加载线程数，至少为 1。
+     * @since v3.11
+     */
+    void setAsyncLoadThreadCount(int count);
+
+    /** @~english Gets the number of threads used by addImageAsync().
+     * @~chinese 获取 addImageAsync() 使用的线程数。
+     * @since v3.11
+     */
+    int getAsyncLoadThreadCount() const { return _asyncLoadThreadCount; }
+
+    /** @~english Sets the time, in seconds, that creating the textures of decoded images may take per frame.
+     * Once it is used up, the remaining images wait for the next frame; at least one texture is created per frame.
+     * 0, the default, creates all of them in the frame they are decoded.
+     * @~chinese 设置每帧用于根据已解码的图片创建纹理的时间（秒）。
+     * 时间用完后，剩下的图片等到下一帧处理；每帧至少创建一个纹理。默认值 0 表示在解码完成的那一帧创建所有纹理。
+     * @param budget @~english The time per frame in seconds.
+     * @~chinese 每帧的时间（秒）。
+     * @since v3.11
+     */
+    void setAsyncUploadBudget(float budget) { _asyncUploadBudget = budget; }
+
+    /** @~english Gets the time, in seconds, that creating the textures of decoded images may take per frame.
+     * @~chinese 获取每帧用于根据已解码的图片创建纹理的时间（秒）。
+     * @since v3.11
+     */
+    float getAsyncUploadBudget() const { return _asyncUploadBudget; }
     
     /** @~english Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
@@ -284,15 +371,22 @@ public:
 
 private:
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    void loadImage(int threadIndex);
+    void startLoadingThreads();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
 public:
 protected:
     struct AsyncStruct;
     
-    std::thread* _loadingThread;
+    static void insertByPriority(std::deque<AsyncStruct*>& queue, AsyncStruct* asyncStruct);
+
+    std::vector<std::thread*> _loadingThreads;
+    int _asyncLoadThreadCount;
+    float _asyncUploadBudget;
+    unsigned int _asyncSequence;
 
-    std::deque<AsyncStruct*> _asyncStructQueue;
+    // the requests in flight, by full path
+    std::unordered_map<std::string, AsyncStruct*> _asyncStructs;
     std::deque<AsyncStruct*> _requestQueue;
     std::deque<AsyncStruct*> _responseQueue;
 
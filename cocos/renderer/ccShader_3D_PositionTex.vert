@@ -14,6 +14,29 @@ void main(void)
 }
 );
 
+const char* cc3D_PositionTexInstanced_vert = STRINGIFY(
+
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+attribute vec4 a_instanceModelView0;
+attribute vec4 a_instanceModelView1;
+attribute vec4 a_instanceModelView2;
+attribute vec4 a_instanceModelView3;
+attribute vec4 a_instanceColor;
+
+varying vec2 TextureCoordOut;
+varying vec4 ColorOut;
+
+void main(void)
+{
+    mat4 modelView = mat4(a_instanceModelView0, a_instanceModelView1, a_instanceModelView2, a_instanceModelView3);
+    gl_Position = CC_PMatrix * modelView * a_position;
+    TextureCoordOut = a_texCoord;
+    TextureCoordOut.y = 1.0 - TextureCoordOut.y;
+    ColorOut = a_instanceColor;
+}
+);
+
 const char* cc3D_SkinPositionTex_vert = STRINGIFY(
 attribute vec3 a_position;
 
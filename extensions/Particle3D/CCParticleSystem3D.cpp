@@ -26,9 +26,44 @@
 #include "CCParticle3DEmitter.h"
 #include "CCParticle3DAffector.h"
 #include "CCParticle3DRender.h"
+#include "base/CCDirector.h"
+#include "base/CCThreadPool.h"
 
 NS_CC_BEGIN
 
+namespace
+{
+    // the system simulated by each thread: slot 0 for the main thread outside of FrameJobQueue::run(),
+    // slot 1 + ThreadPool::getCurrentThreadIndex() while the frame jobs run
+    std::vector<ParticleSystem3D*> s_simulatedSystems(1, nullptr);
+    // the random numbers drawn outside of a simulation, on the main thread
+    uint32_t s_randomState = 0x9e3779b9;
+
+    size_t getSimulationSlot()
+    {
+        if (!FrameJobQueue::getInstance()->isRunning())
+            return 0;
+        return 1 + ThreadPool::getInstance()->getCurrentThreadIndex();
+    }
+
+    ParticleSystem3D* setSimulatedSystem(ParticleSystem3D* system)
+    {
+        size_t slot = getSimulationSlot();
+        CCASSERT(slot < s_simulatedSystems.size(), "ParticleSystem3D: simulating on an unexpected thread");
+        auto previous = s_simulatedSystems[slot];
+        s_simulatedSystems[slot] = system;
+        return previous;
+    }
+
+    uint32_t nextRandom(uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+}
+
 Particle3D::Particle3D()
 : color(Vec4::ONE)
 , rt_uv(Vec2::ONE)
@@ -53,8 +88,10 @@ ParticleSystem3D::ParticleSystem3D()
 , _blend(BlendFunc::ALPHA_NON_PREMULTIPLIED)
 , _keepLocal(false)
 , _isEnabled(true)
+, _randomSeed(0)
+, _randomState(1)
 {
-    
+    setRandomSeed(rand());
 }
 ParticleSystem3D::~ParticleSystem3D()
 {
@@ -158,9 +195,83 @@ Particle3DAffector* ParticleSystem3D::getAffector(int index)
 
 void ParticleSystem3D::update(float delta)
 {
-    if (_state != State::RUNNING)
+    auto frameJobQueue = FrameJobQueue::getInstance();
+    if (_director->isParallelParticlesEnabled() && !frameJobQueue->isRunning())
+    {
+        // simulated on a worker thread once the scheduler is done, together with the other systems of the tree
+        auto root = getFrameJobRoot();
+        if (root->_frameJobEntries.empty())
+        {
+            // released by finishFrameJob()
+            root->retain();
+            frameJobQueue->push(root);
+        }
+        for (auto& entry : root->_frameJobEntries)
+        {
+            if (entry.system == this)
+            {
+                entry.delta += delta;
+                return;
+            }
+        }
+        this->retain();
+        root->_frameJobEntries.push_back({this, delta, false});
         return;
-    
+    }
+
+    if (prepareUpdate())
+    {
+        auto previous = setSimulatedSystem(this);
+        simulate(delta);
+        setSimulatedSystem(previous);
+    }
+}
+
+void ParticleSystem3D::prepareFrameJob()
+{
+    size_t slotCount = 2 + ThreadPool::getInstance()->getThreadCount();
+    if (s_simulatedSystems.size() < slotCount)
+    {
+        s_simulatedSystems.resize(slotCount, nullptr);
+    }
+
+    for (auto& entry : _frameJobEntries)
+    {
+        entry.prepared = entry.system->prepareUpdate();
+    }
+}
+
+void ParticleSystem3D::runFrameJob()
+{
+    for (auto& entry : _frameJobEntries)
+    {
+        if (entry.prepared)
+        {
+            auto previous = setSimulatedSystem(entry.system);
+            entry.system->simulate(entry.delta);
+            setSimulatedSystem(previous);
+        }
+    }
+}
+
+void ParticleSystem3D::finishFrameJob()
+{
+    std::vector<FrameJobEntry> entries;
+    entries.swap(_frameJobEntries);
+    for (auto& entry : entries)
+    {
+        entry.system->release();
+    }
+    this->release();
+}
+
+bool ParticleSystem3D::prepareUpdate()
+{
+    return _state == State::RUNNING;
+}
+
+void ParticleSystem3D::simulate(float delta)
+{
     Particle3D *particle = _particlePool.getFirst();
     while (particle)
     {
@@ -215,4 +326,30 @@ void ParticleSystem3D::setEnabled( bool enabled )
     _isEnabled = enabled;
 }
 
+void ParticleSystem3D::setRandomSeed(unsigned int seed)
+{
+    _randomSeed = seed;
+    // xorshift never leaves 0
+    _randomState = seed ? seed : 0x9e3779b9;
+}
+
+float ParticleSystem3D::random0_1()
+{
+    size_t slot = getSimulationSlot();
+    auto system = slot < s_simulatedSystems.size() ? s_simulatedSystems[slot] : nullptr;
+    uint32_t value = nextRandom(system ? system->_randomState : s_randomState);
+    // 24 bits fit in the mantissa, the result is below 1
+    return (value >> 8) * (1.0f / 16777216.0f);
+}
+
+float ParticleSystem3D::randomMinus1_1()
+{
+    return random0_1() * 2.0f - 1.0f;
+}
+
+float ParticleSystem3D::randomRange(float min, float max)
+{
+    return min + random0_1() * (max - min);
+}
+
 NS_CC_END
@@ -27,6 +27,7 @@
 
 #include "2d/CCNode.h"
 #include "math/CCMath.h"
+#include "base/CCFrameJobQueue.h"
 #include <vector>
 #include <map>
 #include <list>
@@ -220,7 +221,7 @@ typedef DataPool<Particle3D> ParticlePool;
  - 多个影响器(如何影响粒子)
  - 一个渲染器(如何渲染粒子)
 */
-class CC_DLL ParticleSystem3D : public Node, public BlendProtocol
+class CC_DLL ParticleSystem3D : public Node, public BlendProtocol, public FrameJob
 {
 public:
 
@@ -232,11 +233,17 @@ public:
     };
     
     /**
-    * @~english Overwrite function.
-    * @~chinese 重写的函数。
+    * @~english Overwrite function. When Director::isParallelParticlesEnabled() is true, the simulation is deferred
+    * to a job of FrameJobQueue, shared by the systems of the same tree (see getFrameJobRoot()).
+    * @~chinese 重写的函数。当Director::isParallelParticlesEnabled()为true时，模拟被推迟到FrameJobQueue的任务中执行，
+    * 同一棵树中的粒子系统共享一个任务（参见getFrameJobRoot()）。
     * @see node update(float delta);
     */
     virtual void update(float delta) override;
+
+    virtual void prepareFrameJob() override;
+    virtual void runFrameJob() override;
+    virtual void finishFrameJob() override;
     
     /**
     * @~english Overwrite function.
@@ -244,6 +251,12 @@ public:
     * @see node draw(Renderer *renderer, const Mat4 &transform, uint32_t flags);
     */
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+
+    /**
+    * @~english Override function, the particles have no bounds.
+    * @~chinese 重写的函数，粒子没有包围盒。
+    */
+    virtual bool getCullingBounds(AABB* bounds) const override { return false; }
     
     /**
     * @~english Set the blend function.
@@ -394,11 +407,74 @@ public:
     */
     bool isEnabled(void) const { return _isEnabled; }
 
+    /**
+    * @~english Set the seed of the random numbers drawn while this system is simulated. The particles only depend on
+    * the settings of the system and on its seed, whether or not the systems are simulated on worker threads.
+    * By default the seed is taken from rand() when the system is created.
+    * @~chinese 设置模拟这个粒子系统时使用的随机数种子。无论是否在工作线程中模拟，粒子只取决于系统的设置和种子。
+    * 默认情况下，种子在创建粒子系统时由rand()生成。
+    * @param seed @~english The seed. @~chinese 种子。
+    */
+    void setRandomSeed(unsigned int seed);
+
+    /**
+    * @~english Get the seed of the random numbers.
+    * @~chinese 获取随机数种子。
+    * @return @~english The seed. @~chinese 种子。
+    */
+    unsigned int getRandomSeed() const { return _randomSeed; }
+
+    /**
+    * @~english A random number in [0, 1), drawn from the generator of the system being simulated by the calling thread.
+    * The emitters, affectors and renders use it instead of CCRANDOM_0_1().
+    * @~chinese [0, 1)之间的随机数，由调用线程正在模拟的粒子系统的随机数生成器生成。发射器、影响器和渲染器用它代替CCRANDOM_0_1()。
+    */
+    static float random0_1();
+
+    /**
+    * @~english A random number in [-1, 1), see random0_1().
+    * @~chinese [-1, 1)之间的随机数，参见random0_1()。
+    */
+    static float randomMinus1_1();
+
+    /**
+    * @~english A random number in [min, max), see random0_1().
+    * @~chinese [min, max)之间的随机数，参见random0_1()。
+    */
+    static float randomRange(float min, float max);
+
 CC_CONSTRUCTOR_ACCESS:
     ParticleSystem3D();
     virtual ~ParticleSystem3D();
     
 protected:
+
+    /**
+    * @~english The part of update() that runs on the main thread, before simulate().
+    * @~chinese update()中在simulate()之前、在主线程中执行的部分。
+    * @return @~english False when there is nothing to simulate. @~chinese 没有需要模拟的内容时返回false。
+    */
+    virtual bool prepareUpdate();
+
+    /**
+    * @~english Moves the particles, it may run on a worker thread: it only touches this system and the objects it owns.
+    * @~chinese 移动粒子，可能在工作线程中执行：只能访问这个粒子系统和它拥有的对象。
+    */
+    virtual void simulate(float delta);
+
+    /**
+    * @~english The system whose frame job simulates this system. The systems reading each other's state
+    * while they are simulated must share the same root, they are then simulated in the order of their updates.
+    * @~chinese 负责模拟这个粒子系统的任务所属的系统。模拟时互相读取状态的粒子系统必须有相同的根，它们按照更新的顺序依次模拟。
+    */
+    virtual ParticleSystem3D* getFrameJobRoot() { return this; }
+
+    struct FrameJobEntry
+    {
+        ParticleSystem3D* system; ///< retained until the job finishes
+        float delta;
+        bool prepared;
+    };
     
     State                            _state; ///< current state
     Particle3DEmitter*               _emitter; ///< the emitter
@@ -414,6 +490,10 @@ protected:
 
     bool _keepLocal; ///< use local coordinate
     bool _isEnabled;
+
+    unsigned int                     _randomSeed; ///< the seed set by setRandomSeed()
+    uint32_t                         _randomState; ///< the xorshift generator of random0_1()
+    std::vector<FrameJobEntry>       _frameJobEntries; ///< the systems simulated by the job of this root
 };
 
 // end of _3d group
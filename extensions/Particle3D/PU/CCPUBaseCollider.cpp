@@ -106,7 +106,7 @@ void PUBaseCollider::calculateRotationSpeedAfterCollision( PUParticle3D* particl
     if (particle->particleType != PUParticle3D::PT_VISUAL)
         return;
 
-    float signedFriction = CCRANDOM_0_1() > 0.5 ? -(_friction - 1) : (_friction - 1);
+    float signedFriction = ParticleSystem3D::random0_1() > 0.5 ? -(_friction - 1) : (_friction - 1);
 
     particle->rotationSpeed *= signedFriction;
     particle->zRotationSpeed *= signedFriction;
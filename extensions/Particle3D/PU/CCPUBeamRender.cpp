@@ -301,7 +301,7 @@ void PUBeamRender::updateRender( PUParticle3D *particle, float deltaTime, bool f
         float divide = (float)_numberOfSegments + 1.0f;
         for (size_t numDev = 0; numDev < _numberOfSegments; ++numDev)
         {
-            Vec3::cross(end, Vec3(CCRANDOM_MINUS1_1(), CCRANDOM_MINUS1_1(), CCRANDOM_MINUS1_1()), &perpendicular);
+            Vec3::cross(end, Vec3(ParticleSystem3D::randomMinus1_1(), ParticleSystem3D::randomMinus1_1(), ParticleSystem3D::randomMinus1_1()), &perpendicular);
             perpendicular.normalize();
             beamRendererVisualData->destinationHalf[numDev] = (((float)numDev + 1.0f) / divide) * end
                 + Vec3(_rendererScale.x * _deviation * perpendicular.x
@@ -89,9 +89,9 @@ void CCPUBoxEmitter::initParticlePosition(PUParticle3D* particle)
         particle->position = getDerivedPosition() + 
             rotMat *
             (/*_emitterScale **/
-            Vec3(CCRANDOM_MINUS1_1() * _xRange * _emitterScale.x,
-            CCRANDOM_MINUS1_1() * _yRange * _emitterScale.y,
-            CCRANDOM_MINUS1_1() * _zRange * _emitterScale.z));
+            Vec3(ParticleSystem3D::randomMinus1_1() * _xRange * _emitterScale.x,
+            ParticleSystem3D::randomMinus1_1() * _yRange * _emitterScale.y,
+            ParticleSystem3D::randomMinus1_1() * _zRange * _emitterScale.z));
     }
     //else
     //{
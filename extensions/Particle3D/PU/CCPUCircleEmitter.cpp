@@ -122,7 +122,7 @@ void PUCircleEmitter::initParticlePosition(PUParticle3D* particle)
     if (_random)
     {
         // Choose a random position on the circle.
-        angle = cocos2d::random(0.0, M_PI * 2.0);
+        angle = ParticleSystem3D::randomRange(0.0, M_PI * 2.0);
     }
     else
     {
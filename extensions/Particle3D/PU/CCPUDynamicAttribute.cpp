@@ -24,7 +24,7 @@
  ****************************************************************************/
 
 #include "CCPUDynamicAttribute.h"
-#include "base/ccRandom.h"
+#include "extensions/Particle3D/CCParticleSystem3D.h"
 #include "platform/CCStdC.h"
 
 NS_CC_BEGIN
@@ -134,7 +134,7 @@ void PUDynamicAttributeRandom::setMinMax (float min, float max)
 //-----------------------------------------------------------------------
 float PUDynamicAttributeRandom::getValue (float x)
 {
-    return cocos2d::random(_min, _max);
+    return ParticleSystem3D::randomRange(_min, _max);
 }
 
 void PUDynamicAttributeRandom::copyAttributesTo( PUDynamicAttribute* dynamicAttribute )
@@ -203,7 +203,7 @@ void PUEmitter::initParticleOrientation( PUParticle3D* particle )
     if (_particleOrientationRangeSet)
     {
         // Generate random orientation 'between' start en end.
-        Quaternion::lerp(_particleOrientationRangeStart, _particleOrientationRangeEnd, CCRANDOM_0_1(), &particle->orientation);
+        Quaternion::lerp(_particleOrientationRangeStart, _particleOrientationRangeEnd, ParticleSystem3D::random0_1(), &particle->orientation);
     }
     else
     {
@@ -238,7 +238,7 @@ void PUEmitter::generateAngle( float &angle )
     if (_dynAngle->getType() == PUDynamicAttribute::DAT_FIXED)
     {
         // Make an exception here and don't use the fixed angle.
-        angle = CCRANDOM_0_1() * angle;
+        angle = ParticleSystem3D::random0_1() * angle;
     }
 }
 
@@ -780,21 +780,21 @@ void PUEmitter::initParticleColor( PUParticle3D* particle )
     if (_particleColorRangeSet)
     {
         if (_particleColorRangeStart.x < _particleColorRangeEnd.x)
-            particle->color.x = cocos2d::random(_particleColorRangeStart.x, _particleColorRangeEnd.x);
+            particle->color.x = ParticleSystem3D::randomRange(_particleColorRangeStart.x, _particleColorRangeEnd.x);
         else
-            particle->color.x = cocos2d::random(_particleColorRangeEnd.x, _particleColorRangeStart.x);
+            particle->color.x = ParticleSystem3D::randomRange(_particleColorRangeEnd.x, _particleColorRangeStart.x);
         if (_particleColorRangeStart.y < _particleColorRangeEnd.y)
-            particle->color.y = cocos2d::random(_particleColorRangeStart.y, _particleColorRangeEnd.y);
+            particle->color.y = ParticleSystem3D::randomRange(_particleColorRangeStart.y, _particleColorRangeEnd.y);
         else
-            particle->color.y = cocos2d::random(_particleColorRangeEnd.y, _particleColorRangeStart.y);
+            particle->color.y = ParticleSystem3D::randomRange(_particleColorRangeEnd.y, _particleColorRangeStart.y);
         if (_particleColorRangeStart.z < _particleColorRangeEnd.z)
-            particle->color.z = cocos2d::random(_particleColorRangeStart.z, _particleColorRangeEnd.z);
+            particle->color.z = ParticleSystem3D::randomRange(_particleColorRangeStart.z, _particleColorRangeEnd.z);
         else
-            particle->color.z = cocos2d::random(_particleColorRangeEnd.z, _particleColorRangeStart.z);
+            particle->color.z = ParticleSystem3D::randomRange(_particleColorRangeEnd.z, _particleColorRangeStart.z);
         if (_particleColorRangeStart.w < _particleColorRangeEnd.w)
-            particle->color.w = cocos2d::random(_particleColorRangeStart.w, _particleColorRangeEnd.w);
+            particle->color.w = ParticleSystem3D::randomRange(_particleColorRangeStart.w, _particleColorRangeEnd.w);
         else
-            particle->color.w = cocos2d::random(_particleColorRangeEnd.w, _particleColorRangeStart.w);
+            particle->color.w = ParticleSystem3D::randomRange(_particleColorRangeEnd.w, _particleColorRangeStart.w);
     }
     else
     {
@@ -809,7 +809,7 @@ void PUEmitter::initParticleTextureCoords( PUParticle3D* particle )
 {
     if (_particleTextureCoordsRangeSet)
     {
-        particle->textureCoordsCurrent = (unsigned short)cocos2d::random((float)_particleTextureCoordsRangeStart, (float)_particleTextureCoordsRangeEnd + 0.999f);
+        particle->textureCoordsCurrent = (unsigned short)ParticleSystem3D::randomRange((float)_particleTextureCoordsRangeStart, (float)_particleTextureCoordsRangeEnd + 0.999f);
     }
     else
     {
@@ -108,14 +108,14 @@ void PUGeometryRotator::initParticleForEmission(PUParticle3D* particle)
         if (!_rotationAxisSet)
         {
             // Set initial random rotation axis and orientation(PU 1.4)
-            particle->orientation.x = CCRANDOM_MINUS1_1();
-            particle->orientation.y = CCRANDOM_MINUS1_1();
-            particle->orientation.z = CCRANDOM_MINUS1_1();
-            particle->orientation.w = CCRANDOM_MINUS1_1();
+            particle->orientation.x = ParticleSystem3D::randomMinus1_1();
+            particle->orientation.y = ParticleSystem3D::randomMinus1_1();
+            particle->orientation.z = ParticleSystem3D::randomMinus1_1();
+            particle->orientation.w = ParticleSystem3D::randomMinus1_1();
             particle->orientation.normalize();
-            particle->rotationAxis.x = CCRANDOM_0_1();
-            particle->rotationAxis.y = CCRANDOM_0_1();
-            particle->rotationAxis.z = CCRANDOM_0_1();
+            particle->rotationAxis.x = ParticleSystem3D::random0_1();
+            particle->rotationAxis.y = ParticleSystem3D::random0_1();
+            particle->rotationAxis.z = ParticleSystem3D::random0_1();
             particle->rotationAxis.normalize();
         }
 
@@ -95,8 +95,8 @@ const Vec3 PUTriangle::getRandomTrianglePosition (void)
     // in triangle ABC: the reflection step a=1-a; b=1-b gives a point (a,b) uniformly distributed in the 
     // triangle (0,0)(1,0)(0,1), which is then mapped affinely to ABC. Now you have barycentric coordinates 
     // a,b,c. Compute your point P = aA + bB + cC.
-    float a = CCRANDOM_0_1();
-    float b = CCRANDOM_0_1();
+    float a = ParticleSystem3D::random0_1();
+    float b = ParticleSystem3D::random0_1();
     if (a + b > 1)
     {
         a = 1 - a;
@@ -108,8 +108,8 @@ const Vec3 PUTriangle::getRandomTrianglePosition (void)
 //-----------------------------------------------------------------------
 const PUTriangle::PositionAndNormal PUTriangle::getRandomEdgePositionAndNormal (void)
 {
-    float mult = CCRANDOM_0_1();
-    float randomVal = CCRANDOM_0_1() * 3.0f;
+    float mult = ParticleSystem3D::random0_1();
+    float randomVal = ParticleSystem3D::random0_1() * 3.0f;
     PositionAndNormal pAndN;
     pAndN.position.setZero();
     pAndN.normal.setZero();
@@ -138,7 +138,7 @@ const PUTriangle::PositionAndNormal PUTriangle::getRandomEdgePositionAndNormal (
 //-----------------------------------------------------------------------
 const PUTriangle::PositionAndNormal PUTriangle::getRandomVertexAndNormal (void)
 {
-    float randomVal = CCRANDOM_0_1() * 3.0f;
+    float randomVal = ParticleSystem3D::random0_1() * 3.0f;
     PositionAndNormal pAndN;
     pAndN.position.setZero();
     pAndN.normal.setZero();
@@ -192,8 +192,8 @@ inline float MeshInfo::getGaussianRandom (float high, float cutoff)
     unsigned int max = 0;
     do
     {
-        x1 = CCRANDOM_0_1();
-        x2 = CCRANDOM_0_1();
+        x1 = ParticleSystem3D::random0_1();
+        x2 = ParticleSystem3D::random0_1();
         w = x1 * x1 + x2 * x2;
 
         // Prevent infinite loop
@@ -224,7 +224,7 @@ const size_t MeshInfo::getRandomTriangleIndex (void)
         index = (size_t)getGaussianRandom((float)_triangles.size() - 1);
     }
     else
-        index = (size_t)(CCRANDOM_0_1() * (float)(_triangles.size() - 1));
+        index = (size_t)(ParticleSystem3D::random0_1() * (float)(_triangles.size() - 1));
 
     return index;
 }
@@ -426,21 +426,57 @@ void PUParticleSystem3D::resumeParticleSystem()
     }
 }
 
-void PUParticleSystem3D::update(float delta)
+bool PUParticleSystem3D::prepareUpdate()
 {
-    if (!_isEnabled || _isMarkedForEmission) return;
+    if (!_isEnabled || _isMarkedForEmission) return false;
     if (_state != State::RUNNING){
         if (_state == State::PAUSE) 
-            return;
+            return false;
         else if (_state == State::STOP && getAliveParticleCount() <= 0){
             forceStopParticleSystem();
-            return;
+            return false;
         }
     }
 
+    if (FrameJobQueue::getInstance()->isRunning()){
+        // what forceUpdate() can't do on a worker thread: creating the renders (textures, nodes) of this system
+        // and of the systems it emits, and computing the transforms of the parent nodes shared with other systems
+        prepared();
+        prepareEmittedSystems();
+        getNodeToWorldTransform();
+    }
+    return true;
+}
+
+void PUParticleSystem3D::simulate(float delta)
+{
     forceUpdate(delta);
 }
 
+ParticleSystem3D* PUParticleSystem3D::getFrameJobRoot()
+{
+    // the techniques read the state of their parent system while they are simulated
+    PUParticleSystem3D *root = this;
+    while (root->_parentParticleSystem)
+        root = root->_parentParticleSystem;
+    return root;
+}
+
+void PUParticleSystem3D::prepareEmittedSystems()
+{
+    for (auto &iter : _emittedSystemParticlePool){
+        const ParticlePool::PoolList *lists[] = { &iter.second.getActiveDataList(), &iter.second.getUnActiveDataList() };
+        for (auto list : lists){
+            for (auto particle : *list){
+                auto system = static_cast<PUParticleSystem3D*>(static_cast<PUParticle3D*>(particle)->particleEntityPtr);
+                if (!system->_prepared)
+                    system->prepared();
+                system->prepareEmittedSystems();
+            }
+        }
+    }
+}
+
 void PUParticleSystem3D::forceUpdate( float delta )
 {
     if (!_emitters.empty())
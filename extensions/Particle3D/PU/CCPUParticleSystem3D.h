@@ -353,13 +353,6 @@ public:
     */
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
-    /**
-    * @~english Overwrite function.
-    * @~chinese 重写的函数。
-    * @see node update(float delta);
-    */
-    virtual void update(float delta) override;
-
     /**
     * @~english Force update system.
     * @~chinese 强制更新粒子系统。
@@ -751,6 +744,11 @@ protected:
     void initParticleForEmission(PUParticle3D* particle);
     void initParticleForExpiration(PUParticle3D* particle, float timeElapsed);
     void forceStopParticleSystem();
+    void prepareEmittedSystems();
+
+    virtual bool prepareUpdate() override;
+    virtual void simulate(float delta) override;
+    virtual ParticleSystem3D* getFrameJobRoot() override;
     
     inline bool isExpired(PUParticle3D* particle, float timeElapsed);
 
@@ -124,9 +124,9 @@ void PURandomiser::updatePUAffector( PUParticle3D *particle, float deltaTime )
             if (_randomDirection)
             {
                 // Random direction: Change the direction after each update
-                particle->direction.add(CCRANDOM_MINUS1_1() * _maxDeviationX,
-                    CCRANDOM_MINUS1_1() * _maxDeviationY,
-                    CCRANDOM_MINUS1_1() * _maxDeviationZ);
+                particle->direction.add(ParticleSystem3D::randomMinus1_1() * _maxDeviationX,
+                    ParticleSystem3D::randomMinus1_1() * _maxDeviationY,
+                    ParticleSystem3D::randomMinus1_1() * _maxDeviationZ);
             }
             else
             {
@@ -135,9 +135,9 @@ void PURandomiser::updatePUAffector( PUParticle3D *particle, float deltaTime )
                     return;
 
                 // Random position: Add the position deviation after each update
-                particle->position.add(CCRANDOM_MINUS1_1() * _maxDeviationX * _affectorScale.x,
-                    CCRANDOM_MINUS1_1() * _maxDeviationY * _affectorScale.y,
-                    CCRANDOM_MINUS1_1() * _maxDeviationZ * _affectorScale.z);
+                particle->position.add(ParticleSystem3D::randomMinus1_1() * _maxDeviationX * _affectorScale.x,
+                    ParticleSystem3D::randomMinus1_1() * _maxDeviationY * _affectorScale.y,
+                    ParticleSystem3D::randomMinus1_1() * _maxDeviationZ * _affectorScale.z);
             }
         }
     }
@@ -271,7 +271,7 @@ void PURibbonTrailRender::prepare()
             _visualData.push_back(visualData); // Used to assign to a particle
             if (_randomInitialColor)
             {
-                _trail->setInitialColour(i, CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1());
+                _trail->setInitialColour(i, ParticleSystem3D::random0_1(), ParticleSystem3D::random0_1(), ParticleSystem3D::random0_1());
             }
             else
             {
@@ -58,7 +58,7 @@ void PUSineForceAffector::preUpdateAffector(float deltaTime)
 
         if (_frequencyMin != _frequencyMax)
         {
-            _frequency = cocos2d::random(_frequencyMin, _frequencyMax);
+            _frequency = ParticleSystem3D::randomRange(_frequencyMin, _frequencyMax);
         }
     }
 }
@@ -112,7 +112,7 @@ void PUTextureAnimator::initParticleForEmission(PUParticle3D* particle)
     // Set first image
     if (_startRandom)
     {
-        particle->textureCoordsCurrent = (unsigned short)cocos2d::random((float)_textureCoordsStart, (float)_textureCoordsEnd + 0.999f);
+        particle->textureCoordsCurrent = (unsigned short)ParticleSystem3D::randomRange((float)_textureCoordsStart, (float)_textureCoordsEnd + 0.999f);
     }
     else
     {
@@ -212,7 +212,7 @@ void PUTextureAnimator::determineNextTextureCoords(PUParticle3D* visualParticle)
     case TAT_RANDOM:
         {
             // Generate a random texcoord index
-            visualParticle->textureCoordsCurrent = (unsigned short)cocos2d::random((float)_textureCoordsStart, (float)_textureCoordsEnd + 0.999f);
+            visualParticle->textureCoordsCurrent = (unsigned short)ParticleSystem3D::randomRange((float)_textureCoordsStart, (float)_textureCoordsEnd + 0.999f);
         }
         break;
     }
@@ -25,6 +25,7 @@
 
 #include "CCPUUtil.h"
 #include "base/ccMacros.h"
+#include "extensions/Particle3D/CCParticleSystem3D.h"
 
 NS_CC_BEGIN
 
@@ -53,7 +54,7 @@ cocos2d::Vec3 PUUtil::randomDeviant( const Vec3 &src, float angle, const Vec3& u
 
 	Quaternion q;
 	Mat4 mat;
-	Quaternion::createFromAxisAngle(src, CCRANDOM_0_1() * M_PI * 2.0f, &q);
+	Quaternion::createFromAxisAngle(src, ParticleSystem3D::random0_1() * M_PI * 2.0f, &q);
     Mat4::createRotation(q, &mat);
 
 	//{
@@ -25,6 +25,7 @@
 #include "CCEventListenerAssetsManagerEx.h"
 #include "deprecated/CCString.h"
 #include "base/CCDirector.h"
+#include "base/CCScheduler.h"
 
 #include <stdio.h>
 
@@ -33,7 +34,12 @@
 #else // from our embedded sources
 #include "unzip.h"
 #endif
-#include "base/CCAsyncTaskPool.h"
+
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
 
 using namespace cocos2d;
 using namespace std;
@@ -43,15 +49,82 @@ NS_CC_EXT_BEGIN
 #define VERSION_FILENAME        "version.manifest"
 #define TEMP_MANIFEST_FILENAME  "project.manifest.temp"
 #define MANIFEST_FILENAME       "project.manifest"
+#define JOURNAL_FILENAME        "project.manifest.journal"
 
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
 
 #define DEFAULT_CONNECTION_TIMEOUT 8
 
+#define MAX_WORKER_THREADS 4
+
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
+// Verifies and decompresses the downloaded assets, see AssetsManagerEx::processAsset()
+class AssetsManagerEx::WorkerPool
+{
+public:
+    explicit WorkerPool(int threads)
+        : _stop(false)
+    {
+        for (int index = 0; index < threads; ++index)
+        {
+            _workers.emplace_back(std::thread(std::bind(&WorkerPool::threadFunc, this)));
+        }
+    }
+
+    void addTask(const std::function<void()> &task)
+    {
+        std::unique_lock<std::mutex> lk(_queueMutex);
+        _taskQueue.emplace(task);
+        _taskCondition.notify_one();
+    }
+
+    ~WorkerPool()
+    {
+        {
+            std::unique_lock<std::mutex> lk(_queueMutex);
+            _stop = true;
+            _taskCondition.notify_all();
+        }
+
+        for (auto&& worker : _workers) {
+            worker.join();
+        }
+    }
+
+private:
+    void threadFunc()
+    {
+        while (true) {
+            std::function<void()> task = nullptr;
+            {
+                std::unique_lock<std::mutex> lk(_queueMutex);
+                while (!_stop && _taskQueue.empty())
+                {
+                    _taskCondition.wait(lk);
+                }
+                if (_taskQueue.empty())
+                {
+                    break;
+                }
+                task = std::move(_taskQueue.front());
+                _taskQueue.pop();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> _workers;
+    std::queue< std::function<void()> > _taskQueue;
+
+    std::mutex _queueMutex;
+    std::condition_variable _taskCondition;
+    bool _stop;
+};
+
 // Implementation of AssetsManagerEx
 
 AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath)
@@ -66,6 +139,9 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _tempManifest(nullptr)
 , _remoteManifest(nullptr)
 , _waitToUpdate(false)
+, _workerPool(nullptr)
+, _totalWaitToProcess(0)
+, _journal(nullptr)
 , _percent(0)
 , _percentByFile(0)
 , _totalToDownload(0)
@@ -97,6 +173,7 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
     _cacheVersionPath = _storagePath + VERSION_FILENAME;
     _cacheManifestPath = _storagePath + MANIFEST_FILENAME;
     _tempManifestPath = _storagePath + TEMP_MANIFEST_FILENAME;
+    _journalPath = _storagePath + JOURNAL_FILENAME;
 
     initManifests(manifestUrl);
 }
@@ -106,6 +183,9 @@ AssetsManagerEx::~AssetsManagerEx()
     _downloader->onTaskError = (nullptr);
     _downloader->onFileTaskSuccess = (nullptr);
     _downloader->onTaskProgress = (nullptr);
+    // the tasks of the pool retain this object, so they are all finished
+    CC_SAFE_DELETE(_workerPool);
+    closeJournal();
     CC_SAFE_RELEASE(_localManifest);
     // _tempManifest could share a ptr with _remoteManifest or _localManifest
     if (_tempManifest != _localManifest && _tempManifest != _remoteManifest)
@@ -259,6 +339,11 @@ const Manifest* AssetsManagerEx::getRemoteManifest() const
     return _remoteManifest;
 }
 
+void AssetsManagerEx::setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback)
+{
+    _verifyCallback = callback;
+}
+
 const std::string& AssetsManagerEx::getStoragePath() const
 {
     return _storagePath;
@@ -337,6 +422,9 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         {
             //There are not directory entry in some case.
             //So we need to create directory when decompressing file entry
+            //Several archives may create the same directories on the worker threads
+            static std::mutex s_directoryMutex;
+            std::lock_guard<std::mutex> lock(s_directoryMutex);
             if ( !_fileUtils->createDirectory(basename(fullPath)) )
             {
                 // Failed to create directory
@@ -407,18 +495,152 @@ bool AssetsManagerEx::decompress(const std::string &zip)
     return true;
 }
 
-void AssetsManagerEx::decompressDownloadedZip()
+void AssetsManagerEx::processAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset)
+{
+    // ASSET_UPDATED means that no error occurred
+    EventAssetsManagerEx::EventCode errorCode = EventAssetsManagerEx::EventCode::ASSET_UPDATED;
+    std::string errorStr;
+    if (_verifyCallback && !_verifyCallback(storagePath, asset))
+    {
+        _fileUtils->removeFile(storagePath);
+        errorCode = EventAssetsManagerEx::EventCode::ERROR_UPDATING;
+        errorStr = "Asset file verification failed after downloaded";
+    }
+    else if (asset.compressed)
+    {
+        if (!decompress(storagePath))
+        {
+            errorCode = EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS;
+            errorStr = "Unable to decompress file " + storagePath;
+        }
+        _fileUtils->removeFile(storagePath);
+    }
+
+    Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, customId, errorCode, errorStr]() {
+        onAssetProcessed(customId, errorCode, errorStr);
+        // retained by onSuccess()
+        release();
+    });
+}
+
+void AssetsManagerEx::onAssetProcessed(const std::string &customId, EventAssetsManagerEx::EventCode errorCode, const std::string &errorStr)
 {
-    // Decompress all compressed files
-    for (auto it = _compressedFiles.begin(); it != _compressedFiles.end(); ++it) {
-        std::string zipfile = *it;
-        if (!decompress(zipfile))
+    _totalWaitToProcess--;
+    
+    auto unitIt = _downloadUnits.find(customId);
+    if (unitIt != _downloadUnits.end())
+    {
+        _percentByFile = 100 * (float)(_totalToDownload - _totalWaitToDownload - _totalWaitToProcess) / _totalToDownload;
+        // Notify progression event
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "");
+    }
+    
+    if (errorCode == EventAssetsManagerEx::EventCode::ASSET_UPDATED)
+    {
+        // Set download state to SUCCESSED, the journal keeps it if the update is interrupted
+        _tempManifest->setAssetDownloadState(customId, Manifest::DownloadState::SUCCESSED);
+        if (_journal)
+        {
+            fprintf(_journal, "%s\n", customId.c_str());
+            fflush(_journal);
+        }
+        
+        // Notify asset updated event
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ASSET_UPDATED, customId);
+        
+        unitIt = _failedUnits.find(customId);
+        // Found unit and delete it
+        if (unitIt != _failedUnits.end())
         {
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", "Unable to decompress file " + zipfile);
+            // Remove from failed units list
+            _failedUnits.erase(unitIt);
+        }
+    }
+    else
+    {
+        // The asset has to be downloaded again
+        _tempManifest->setAssetDownloadState(customId, Manifest::DownloadState::UNSTARTED);
+        if (unitIt != _downloadUnits.end())
+        {
+            DownloadUnit unit = unitIt->second;
+            _failedUnits.emplace(unit.customId, unit);
         }
-        _fileUtils->removeFile(zipfile);
+        dispatchUpdateEvent(errorCode, customId, errorStr);
+    }
+    
+    checkUpdateFinished();
+}
+
+void AssetsManagerEx::checkUpdateFinished()
+{
+    if (_updateState != State::UPDATING && _updateState != State::UNZIPPING)
+        return;
+    
+    if (_totalWaitToDownload > 0)
+        return;
+    
+    // Downloads are finished, the last assets are still processed
+    if (_totalWaitToProcess > 0)
+    {
+        _updateState = State::UNZIPPING;
+        return;
+    }
+    
+    // Finished with error check
+    if (_failedUnits.size() > 0)
+    {
+        // Save current download manifest information for resuming
+        _tempManifest->saveToFile(_tempManifestPath);
+        closeJournal();
+        
+        _updateState = State::FAIL_TO_UPDATE;
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FAILED);
+    }
+    else
+    {
+        updateSucceed();
+    }
+}
+
+std::unordered_set<std::string> AssetsManagerEx::openJournal(const std::string &version)
+{
+    closeJournal();
+    
+    // The first line is the version of the update, each of the next ones is a finished asset
+    std::unordered_set<std::string> finished;
+    std::string content = _fileUtils->getStringFromFile(_journalPath);
+    size_t end = content.find('\n');
+    bool sameVersion = (end != std::string::npos && content.compare(0, end, version) == 0);
+    if (sameVersion)
+    {
+        // A line cut by an interruption has no end of line
+        size_t begin = end + 1;
+        while ((end = content.find('\n', begin)) != std::string::npos)
+        {
+            if (end > begin)
+            {
+                finished.insert(content.substr(begin, end - begin));
+            }
+            begin = end + 1;
+        }
+    }
+    
+    _journal = fopen(_fileUtils->getSuitableFOpen(_journalPath).c_str(), sameVersion ? "ab" : "wb");
+    if (_journal && !sameVersion)
+    {
+        fprintf(_journal, "%s\n", version.c_str());
+        fflush(_journal);
+    }
+    return finished;
+}
+
+void AssetsManagerEx::closeJournal()
+{
+    if (_journal)
+    {
+        fclose(_journal);
+        _journal = nullptr;
     }
-    _compressedFiles.clear();
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId/* = ""*/, const std::string &message/* = ""*/, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
@@ -552,21 +774,42 @@ void AssetsManagerEx::startUpdate()
     // Clean up before update
     _failedUnits.clear();
     _downloadUnits.clear();
-    _compressedFiles.clear();
-    _totalWaitToDownload = _totalToDownload = 0;
+    _totalWaitToDownload = _totalToDownload = _totalWaitToProcess = 0;
     _percent = _percentByFile = _sizeCollected = _totalSize = 0;
     _downloadedSize.clear();
     _totalEnabled = false;
     
+    // Assets finished by a previous update of the same version which was interrupted
+    std::unordered_set<std::string> finished = openJournal(_remoteManifest->getVersion());
+    
     // Temporary manifest exists, resuming previous download
     if (_tempManifest->isLoaded() && _tempManifest->versionEquals(_remoteManifest))
     {
         _tempManifest->genResumeAssetsList(&_downloadUnits);
+        for (auto it = _downloadUnits.begin(); it != _downloadUnits.end(); )
+        {
+            if (finished.find(it->first) != finished.end())
+            {
+                _tempManifest->setAssetDownloadState(it->first, Manifest::DownloadState::SUCCESSED);
+                it = _downloadUnits.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
         _totalWaitToDownload = _totalToDownload = (int)_downloadUnits.size();
-        this->batchDownload();
-        
-        std::string msg = StringUtils::format("Resuming from previous unfinished update, %d files remains to be finished.", _totalToDownload);
-        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
+        if (_totalToDownload == 0)
+        {
+            updateSucceed();
+        }
+        else
+        {
+            this->batchDownload();
+            
+            std::string msg = StringUtils::format("Resuming from previous unfinished update, %d files remains to be finished.", _totalToDownload);
+            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
+        }
     }
     // Check difference
     else
@@ -594,7 +837,7 @@ void AssetsManagerEx::startUpdate()
                 {
                     _fileUtils->removeFile(_storagePath + diff.asset.path);
                 }
-                else
+                else if (finished.find(it->first) == finished.end())
                 {
                     std::string path = diff.asset.path;
                     // Create path
@@ -612,17 +855,25 @@ void AssetsManagerEx::startUpdate()
             for (auto it = assets.cbegin(); it != assets.cend(); ++it)
             {
                 const std::string &key = it->first;
-                auto diffIt = diff_map.find(key);
-                if (diffIt == diff_map.end())
+                if (_downloadUnits.find(key) == _downloadUnits.end())
                 {
                     _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::SUCCESSED);
                 }
             }
             _totalWaitToDownload = _totalToDownload = (int)_downloadUnits.size();
-            this->batchDownload();
-            
-            std::string msg = StringUtils::format("Start to update %d files from remote package.", _totalToDownload);
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
+            if (_totalToDownload == 0)
+            {
+                updateSucceed();
+            }
+            else
+            {
+                // Save the download states, an interrupted update will resume from them and from the journal
+                _tempManifest->saveToFile(_tempManifestPath);
+                this->batchDownload();
+                
+                std::string msg = StringUtils::format("Start to update %d files from remote package.", _totalToDownload);
+                dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
+            }
         }
     }
 
@@ -631,60 +882,23 @@ void AssetsManagerEx::startUpdate()
 
 void AssetsManagerEx::updateSucceed()
 {
-    // Every thing is correctly downloaded, do the following
-    // 1. rename temporary manifest to valid manifest
+    // Every thing is correctly downloaded and decompressed, do the following
+    // 1. remove the journal of the update
+    closeJournal();
+    _fileUtils->removeFile(_journalPath);
+    // 2. rename temporary manifest to valid manifest
     _fileUtils->renameFile(_storagePath, TEMP_MANIFEST_FILENAME, MANIFEST_FILENAME);
-    // 2. swap the localManifest
+    // 3. swap the localManifest
     if (_localManifest != nullptr)
         _localManifest->release();
     _localManifest = _remoteManifest;
     _remoteManifest = nullptr;
-    // 3. make local manifest take effect
+    // 4. make local manifest take effect
     prepareLocalManifest();
-
-
-    _updateState = State::UNZIPPING;
-    // 4. decompress all compressed files
-    //decompressDownloadedZip();
-
-    struct AsyncData
-    {
-        std::vector<std::string> compressedFiles;
-        std::string errorCompressedFile;
-    };
-
-    AsyncData* asyncData = new AsyncData;
-    asyncData->compressedFiles = _compressedFiles;
-    _compressedFiles.clear();
-
-    std::function<void(void*)> mainThread = [this](void* param) {
-        AsyncData* asyncData = (AsyncData*)param;
-        if (asyncData->errorCompressedFile.empty())
-        {
-            // 5. Set update state
-            _updateState = State::UP_TO_DATE;
-            // 6. Notify finished event
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FINISHED);
-        }
-        else
-        {
-            _updateState = State::FAIL_TO_UPDATE;
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", "Unable to decompress file " + asyncData->errorCompressedFile);
-        }
-
-        delete asyncData;
-    };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, mainThread, (void*)asyncData, [this, asyncData]() {
-        // Decompress all compressed files
-        for (auto& zipFile : asyncData->compressedFiles) {
-            if (!decompress(zipFile))
-            {
-                asyncData->errorCompressedFile = zipFile;
-                break;
-            }
-            _fileUtils->removeFile(zipFile);
-        }
-    });
+    // 5. Set update state
+    _updateState = State::UP_TO_DATE;
+    // 6. Notify finished event
+    dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FINISHED);
 }
 
 void AssetsManagerEx::checkUpdate()
@@ -799,7 +1013,7 @@ void AssetsManagerEx::updateAssets(const DownloadUnits& assets)
         return;
     }
     
-    if (_updateState != State::UPDATING && _localManifest->isLoaded() && _remoteManifest->isLoaded())
+    if (_updateState != State::UPDATING && _updateState != State::UNZIPPING && _localManifest->isLoaded() && _remoteManifest->isLoaded())
     {
         int size = (int)(assets.size());
         if (size > 0)
@@ -807,9 +1021,11 @@ void AssetsManagerEx::updateAssets(const DownloadUnits& assets)
             _updateState = State::UPDATING;
             _downloadUnits.clear();
             _downloadUnits = assets;
+            _totalWaitToDownload = _totalToDownload = size;
+            openJournal(_remoteManifest->getVersion());
             this->batchDownload();
         }
-        else if (size == 0 && _totalWaitToDownload == 0)
+        else if (size == 0 && _totalWaitToDownload == 0 && _totalWaitToProcess == 0)
         {
             updateSucceed();
         }
@@ -850,10 +1066,15 @@ void AssetsManagerEx::onError(const network::DownloadTask& task,
         // Found unit and add it to failed units
         if (unitIt != _downloadUnits.end())
         {
+            // Reduce count only when unit found in _downloadUnits
+            _totalWaitToDownload--;
+            
             DownloadUnit unit = unitIt->second;
             _failedUnits.emplace(unit.customId, unit);
         }
         dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_UPDATING, task.identifier, errorStr, errorCode, errorCodeInternal);
+        
+        checkUpdateFinished();
     }
 }
 
@@ -923,58 +1144,37 @@ void AssetsManagerEx::onSuccess(const std::string &srcUrl, const std::string &st
     }
     else
     {
-        auto &assets = _remoteManifest->getAssets();
-        auto assetIt = assets.find(customId);
-        if (assetIt != assets.end())
-        {
-            // Set download state to SUCCESSED
-            _tempManifest->setAssetDownloadState(customId, Manifest::DownloadState::SUCCESSED);
-            
-            // Add file to need decompress list
-            if (assetIt->second.compressed) {
-                _compressedFiles.push_back(storagePath);
-            }
-        }
-        
         auto unitIt = _downloadUnits.find(customId);
         if (unitIt != _downloadUnits.end())
         {
             // Reduce count only when unit found in _downloadUnits
             _totalWaitToDownload--;
-            
-            _percentByFile = 100 * (float)(_totalToDownload - _totalWaitToDownload) / _totalToDownload;
-            // Notify progression event
-            dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "");
-        }
-        // Notify asset updated event
-        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ASSET_UPDATED, customId);
-        
-        unitIt = _failedUnits.find(customId);
-        // Found unit and delete it
-        if (unitIt != _failedUnits.end())
-        {
-            // Remove from failed units list
-            _failedUnits.erase(unitIt);
         }
+        _totalWaitToProcess++;
         
-        if (_totalWaitToDownload <= 0)
+        auto &assets = _remoteManifest->getAssets();
+        auto assetIt = assets.find(customId);
+        if (assetIt != assets.end())
         {
-            // Finished with error check
-            if (_failedUnits.size() > 0)
+            // Verify and decompress the asset on a worker thread, the next downloads go on meanwhile
+            if (_workerPool == nullptr)
             {
-                // Save current download manifest information for resuming
-                _tempManifest->saveToFile(_tempManifestPath);
-                
-                decompressDownloadedZip();
-                
-                _updateState = State::FAIL_TO_UPDATE;
-                dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_FAILED);
-            }
-            else
-            {
-                updateSucceed();
+                int threadCount = (int)std::thread::hardware_concurrency() - 1;
+                _workerPool = new (std::nothrow) WorkerPool(std::max(1, std::min(threadCount, MAX_WORKER_THREADS)));
             }
+            // released by processAsset()
+            retain();
+            Manifest::Asset asset = assetIt->second;
+            _workerPool->addTask([this, customId, storagePath, asset]() {
+                processAsset(customId, storagePath, asset);
+            });
         }
+        else
+        {
+            onAssetProcessed(customId, EventAssetsManagerEx::EventCode::ASSET_UPDATED, "");
+        }
+        
+        checkUpdateFinished();
     }
 }
 
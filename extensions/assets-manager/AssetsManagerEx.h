@@ -27,7 +27,10 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
+#include <functional>
+#include <stdio.h>
 
 #include "base/CCEventDispatcher.h"
 #include "platform/CCFileUtils.h"
@@ -60,6 +63,8 @@ NS_CC_EXT_BEGIN
  * - Download resuming
  * - Detailed progression informations and error informations
  * - Possibility to retry failed assets
+ * - Verification and decompression of the downloaded assets on worker threads, while the others download
+ * - A journal of the finished assets, so that an interrupted update resumes without processing them again
  * Please refer to this detailed document for its usage: 
  * http://cocos2d-x.org/docs/manual/framework/html5/v3/assets-manager/en
  * @~chinese 该类用于资源热更新支持，比如游戏过程中动态照片或脚本。和AssetsManager类相比，它是一个升级版本，支持更强大的热更新功能。
@@ -71,6 +76,8 @@ NS_CC_EXT_BEGIN
  * - 断点续传
  * - 详细的错误报告
  * - 文件下载失败重试支持
+ * - 在其他资源下载的同时，由工作线程校验和解压已下载的资源
+ * - 记录已完成资源的日志，中断的更新恢复时不需要再次处理它们
  * 详细的使用方式，请参考下面的文档： 
  * http://cocos2d-x.org/docs/manual/framework/html5/v3/assets-manager/zh
  */
@@ -119,6 +126,10 @@ public:
          * @~chinese 更新中
          */
         UPDATING,
+        /** @~english All the assets are downloaded, waiting for the last ones to be verified and decompressed
+         * @~chinese 所有资源已下载，等待最后的资源被校验和解压
+         */
+        UNZIPPING,
         /** @~english Updated to the latest version
          * @~chinese 已更新到最新版本
          */
@@ -191,6 +202,16 @@ public:
      */
     const Manifest* getRemoteManifest() const;
     
+    /** @brief @~english Set the callback verifying each downloaded asset, for example by comparing the md5 of the file
+     * with the one of the asset. It is called on a worker thread, several assets may be verified at the same time.
+     * An asset failing the verification is removed and reported with ERROR_UPDATING, it can then be downloaded again
+     * with downloadFailedAssets(). The callback must be set before the update starts.
+     * @~chinese 设置校验每个已下载资源的回调函数，比如比较文件的md5和资源的md5。它在工作线程中调用，多个资源可能同时被校验。
+     * 校验失败的资源会被删除，并通过ERROR_UPDATING报告，之后可以通过downloadFailedAssets()重新下载。回调函数必须在更新开始之前设置。
+     * @param callback @~english Returns whether the file at path is the asset. @~chinese 返回路径对应的文件是否为该资源。
+     */
+    void setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback);
+    
 CC_CONSTRUCTOR_ACCESS:
     
     AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath);
@@ -222,7 +243,27 @@ protected:
     void startUpdate();
     void updateSucceed();
     bool decompress(const std::string &filename);
-    void decompressDownloadedZip();
+    
+    /** @brief @~english Verify and decompress a downloaded asset on a worker thread.
+     * @~chinese 在工作线程中校验并解压一个已下载的资源。
+     */
+    void processAsset(const std::string &customId, const std::string &storagePath, const Manifest::Asset &asset);
+    
+    /** @brief @~english Called on the cocos thread once a downloaded asset is processed.
+     * @~chinese 已下载的资源处理完成后，在cocos线程中调用。
+     */
+    void onAssetProcessed(const std::string &customId, EventAssetsManagerEx::EventCode errorCode, const std::string &errorStr);
+    
+    /** @brief @~english Finish the update once all the assets are downloaded and processed.
+     * @~chinese 当所有资源下载并处理完成后结束更新。
+     */
+    void checkUpdateFinished();
+    
+    /** @brief @~english Read the assets finished by an interrupted update of version, and open the journal for this update.
+     * @~chinese 读取之前被中断的version版本更新中已完成的资源，并为本次更新打开日志。
+     */
+    std::unordered_set<std::string> openJournal(const std::string &version);
+    void closeJournal();
     
     /** @brief @~english Update a list of assets under the current AssetsManagerEx context
      * @~chinese 更新一个下载列表中的资源
@@ -290,6 +331,8 @@ protected:
     virtual void onSuccess(const std::string &srcUrl, const std::string &storagePath, const std::string &customId);
     
 private:
+    class WorkerPool;
+    
     void batchDownload();
     
     //! The event of the current AssetsManagerEx in event dispatcher
@@ -342,8 +385,20 @@ private:
     //! All failed units
     DownloadUnits _failedUnits;
     
-    //! All files to be decompressed
-    std::vector<std::string> _compressedFiles;
+    //! Verifies and decompresses the downloaded assets
+    WorkerPool *_workerPool;
+    
+    //! Number of downloaded assets being processed by the worker pool
+    int _totalWaitToProcess;
+    
+    //! Verifies a downloaded asset, on a worker thread
+    std::function<bool(const std::string& path, Manifest::Asset asset)> _verifyCallback;
+    
+    //! The local path of the journal of the finished assets
+    std::string _journalPath;
+    
+    //! The journal of the current update, one finished asset per line after the version
+    FILE *_journal;
     
     //! Download percent
     float _percent;
@@ -316,19 +316,18 @@ void Manifest::setAssetDownloadState(const std::string &key, const Manifest::Dow
                 rapidjson::Value &assets = _json[KEY_ASSETS];
                 if (assets.IsObject())
                 {
-                    for (rapidjson::Value::MemberIterator itr = assets.MemberBegin(); itr != assets.MemberEnd(); ++itr)
+                    // FindMember() is still a linear search, but it stops at the asset and doesn't copy every name
+                    rapidjson::Value::MemberIterator itr = assets.FindMember(key.c_str());
+                    if (itr != assets.MemberEnd())
                     {
-                        std::string jkey = itr->name.GetString();
-                        if (jkey == key) {
-                            rapidjson::Value &entry = itr->value;
-                            if (entry.HasMember(KEY_DOWNLOAD_STATE) && entry[KEY_DOWNLOAD_STATE].IsInt())
-                            {
-                                entry[KEY_DOWNLOAD_STATE].SetInt((int) state);
-                            }
-                            else
-                            {
-                                entry.AddMember<int>(KEY_DOWNLOAD_STATE, (int)state, _json.GetAllocator());
-                            }
+                        rapidjson::Value &entry = itr->value;
+                        if (entry.HasMember(KEY_DOWNLOAD_STATE) && entry[KEY_DOWNLOAD_STATE].IsInt())
+                        {
+                            entry[KEY_DOWNLOAD_STATE].SetInt((int) state);
+                        }
+                        else
+                        {
+                            entry.AddMember<int>(KEY_DOWNLOAD_STATE, (int)state, _json.GetAllocator());
                         }
                     }
                 }
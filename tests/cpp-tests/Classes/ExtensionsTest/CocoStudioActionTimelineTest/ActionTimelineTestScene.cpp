@@ -26,6 +26,7 @@ CocoStudioActionTimelineTests::CocoStudioActionTimelineTests()
     ADD_TEST_CASE(TestTimelineExtensionData);
     ADD_TEST_CASE(TestActionTimelineBlendFuncFrame);
     ADD_TEST_CASE(TestAnimationClipEndCallBack);
+    ADD_TEST_CASE(TestNodePrototypeCache);
 }
 
 CocoStudioActionTimelineTests::~CocoStudioActionTimelineTests()
@@ -677,3 +678,60 @@ std::string TestAnimationClipEndCallBack::title() const
 {
     return "Test ActionTimeline Frame End Call Back\n and Animation Clip End Call Back";
 }
+
+// TestNodePrototypeCache
+void TestNodePrototypeCache::onEnter()
+{
+    ActionTimelineBaseTest::onEnter();
+
+    auto label = Label::createWithTTF("Loading the prototype...", "fonts/Marker Felt.ttf", 16);
+    label->setPosition(VisibleRect::center().x, VisibleRect::top().y - 100);
+    addChild(label, 1);
+
+    // the file and its sheets are read in the background, the nodes are then created without parsing the file
+    NodePrototypeCache::getInstance()->setEnabled(true);
+    auto fileName = "ActionTimeline/DemoPlayer.csb";
+    NodePrototypeCache::getInstance()->loadPrototypeAsync(fileName, [this, label, fileName](NodePrototype* prototype) {
+        if (!prototype)
+        {
+            label->setString("Can't load the prototype");
+            return;
+        }
+
+        const int count = 50;
+        auto start = utils::gettime();
+        for (int i = 0; i < count; ++i)
+        {
+            Node* node = CSLoader::createNode(fileName);
+            ActionTimeline* action = CSLoader::createTimeline(fileName);
+            node->runAction(action);
+            action->gotoFrameAndPlay(0);
+
+            node->setScale(0.1f);
+            node->setPosition(VisibleRect::left().x + 40 + (i % 10) * 40, VisibleRect::bottom().y + 40 + (i / 10) * 40);
+            addChild(node);
+        }
+        auto elapsed = (float)(utils::gettime() - start) * 1000;
+
+        label->setString(StringUtils::format("%d nodes created in %.2f ms\ncache: %d KB used, %d KB budget", count, elapsed,
+            (int)(NodePrototypeCache::getInstance()->getMemoryUsage() / 1024),
+            (int)(NodePrototypeCache::getInstance()->getMemoryBudget() / 1024)));
+    });
+}
+
+void TestNodePrototypeCache::onExit()
+{
+    NodePrototypeCache::getInstance()->setEnabled(false);
+
+    ActionTimelineBaseTest::onExit();
+}
+
+std::string TestNodePrototypeCache::title() const
+{
+    return "Test NodePrototypeCache";
+}
+
+std::string TestNodePrototypeCache::subtitle() const
+{
+    return "Prototype loaded asynchronously, then instantiated 50 times";
+}
@@ -155,4 +155,15 @@ public:
     virtual void onEnter() override;
     virtual std::string title() const override;
 };
+
+class TestNodePrototypeCache : public ActionTimelineBaseTest
+{
+public:
+    CREATE_FUNC(TestNodePrototypeCache);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
 #endif  // __ANIMATION_SCENE_H__
@@ -13,6 +13,8 @@ HttpClientTests::HttpClientTests()
 
 HttpClientTest::HttpClientTest() 
 : _labelStatusCode(nullptr)
+, _concurrentRequestsPending(0)
+, _concurrentRequestsStartTime(0)
 {
     auto winSize = Director::getInstance()->getWinSize();
 
@@ -86,6 +88,18 @@ HttpClientTest::HttpClientTest()
     itemDelete->setPosition(RIGHT, winSize.height - MARGIN - 5 * SPACE);
     menuRequest->addChild(itemDelete);
     
+    // Concurrent Get
+    auto labelConcurrentGet = Label::createWithTTF("Test 20 Concurrent Gets", "fonts/arial.ttf", 22);
+    auto itemConcurrentGet = MenuItemLabel::create(labelConcurrentGet, CC_CALLBACK_1(HttpClientTest::onMenuConcurrentGetTestClicked, this));
+    itemConcurrentGet->setPosition(winSize.width / 2, winSize.height - MARGIN - 7 * SPACE);
+    menuRequest->addChild(itemConcurrentGet);
+    
+    // Streamed Get
+    auto labelStreamedGet = Label::createWithTTF("Test Gzip Get Streamed To File", "fonts/arial.ttf", 22);
+    auto itemStreamedGet = MenuItemLabel::create(labelStreamedGet, CC_CALLBACK_1(HttpClientTest::onMenuStreamedGetTestClicked, this));
+    itemStreamedGet->setPosition(winSize.width / 2, winSize.height - MARGIN - 8 * SPACE);
+    menuRequest->addChild(itemStreamedGet);
+    
     // Response Code Label
     _labelStatusCode = Label::createWithTTF("HTTP Status Code", "fonts/arial.ttf", 18);
     _labelStatusCode->setPosition(winSize.width / 2,  winSize.height - MARGIN - 6 * SPACE);
@@ -335,6 +349,72 @@ void HttpClientTest::onMenuDeleteTestClicked(Ref *sender, bool isImmediate)
     _labelStatusCode->setString("waiting...");
 }
 
+void HttpClientTest::onMenuConcurrentGetTestClicked(cocos2d::Ref *sender)
+{
+    const int REQUEST_COUNT = 20;
+    if (_concurrentRequestsPending > 0)
+    {
+        return;
+    }
+
+    // the requests share the connections to the host, the last one is sent first thanks to its priority
+    HttpClient::getInstance()->setMaxConcurrentRequests(6);
+    _concurrentRequestsPending = REQUEST_COUNT;
+    _concurrentRequestsStartTime = utils::gettime();
+    for (int i = 0; i < REQUEST_COUNT; ++i)
+    {
+        HttpRequest* request = new (std::nothrow) HttpRequest();
+        request->setUrl("http://httpbin.org/get");
+        request->setRequestType(HttpRequest::Type::GET);
+        request->setPriority(i == REQUEST_COUNT - 1 ? 1 : 0);
+        request->setResponseCallback([this](HttpClient* client, HttpResponse* response) {
+            log("concurrent GET %s completed, code %ld", response->getHttpRequest()->getTag(), response->getResponseCode());
+            if (--_concurrentRequestsPending == 0)
+            {
+                char statusString[64] = {};
+                sprintf(statusString, "%d GETs completed in %.0f ms", REQUEST_COUNT, (utils::gettime() - _concurrentRequestsStartTime) * 1000);
+                _labelStatusCode->setString(statusString);
+            }
+        });
+        request->setTag(StringUtils::format("%d", i).c_str());
+        HttpClient::getInstance()->send(request);
+        request->release();
+    }
+
+    // waiting
+    _labelStatusCode->setString("waiting...");
+}
+
+void HttpClientTest::onMenuStreamedGetTestClicked(cocos2d::Ref *sender)
+{
+    // the gzip body is inflated and written to the file as it arrives, it is never held in memory
+    std::string path = FileUtils::getInstance()->getWritablePath() + "HttpClientTest_gzip.json";
+    HttpRequest* request = new (std::nothrow) HttpRequest();
+    request->setUrl("http://httpbin.org/gzip");
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setResponseDecompressed(true);
+    request->setResponseFile(path);
+    request->setResponseCallback([this, path](HttpClient* client, HttpResponse* response) {
+        char statusString[128] = {};
+        if (response->isSucceed())
+        {
+            sprintf(statusString, "%d bytes inflated to a file", (int)response->getResponseDataLength());
+            log("streamed GET: %s", FileUtils::getInstance()->getStringFromFile(path).c_str());
+        }
+        else
+        {
+            sprintf(statusString, "streamed GET failed: %s", response->getErrorBuffer());
+        }
+        _labelStatusCode->setString(statusString);
+    });
+    request->setTag("GET gzip streamed");
+    HttpClient::getInstance()->send(request);
+    request->release();
+
+    // waiting
+    _labelStatusCode->setString("waiting...");
+}
+
 void HttpClientTest::onHttpRequestCompleted(HttpClient *sender, HttpResponse *response)
 {
     if (!response)
@@ -22,6 +22,8 @@ public:
     void onMenuPostBinaryTestClicked(cocos2d::Ref *sender, bool isImmediate);
     void onMenuPutTestClicked(cocos2d::Ref *sender, bool isImmediate);
     void onMenuDeleteTestClicked(cocos2d::Ref *sender, bool isImmediate);
+    void onMenuConcurrentGetTestClicked(cocos2d::Ref *sender);
+    void onMenuStreamedGetTestClicked(cocos2d::Ref *sender);
     
     //Http Response Callback
     void onHttpRequestCompleted(cocos2d::network::HttpClient *sender, cocos2d::network::HttpResponse *response);
@@ -30,6 +32,8 @@ public:
 
 private:
     cocos2d::Label* _labelStatusCode;
+    int _concurrentRequestsPending;
+    double _concurrentRequestsStartTime;
 };
 
 #endif //__HTTPREQUESTHTTP_H
@@ -71,6 +71,7 @@ CocosNodeTests::CocosNodeTests()
     ADD_TEST_CASE(NodeNormalizedPositionTest2);
     ADD_TEST_CASE(NodeNormalizedPositionBugTest);
     ADD_TEST_CASE(NodeNameTest);
+    ADD_TEST_CASE(NodeSpatialIndexTest);
 }
 
 TestCocosNodeDemo::TestCocosNodeDemo(void)
@@ -1442,3 +1443,59 @@ void NodeNameTest::test(float dt)
     CCAssert(findChildren.size() == 50, "");
     
 }
+
+//------------------------------------------------------------------
+//
+// NodeSpatialIndexTest
+//
+//------------------------------------------------------------------
+NodeSpatialIndexTest::NodeSpatialIndexTest()
+{
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _menuItem = MenuItemFont::create("", CC_CALLBACK_1(NodeSpatialIndexTest::switchSpatialIndexCallback, this));
+    _menuItem->setColor(Color3B(0, 200, 20));
+    auto menu = Menu::create(_menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    _menuItem->setPosition(VisibleRect::left().x + 80, VisibleRect::top().y - 70);
+    addChild(menu, 1);
+
+    // a world 10 screens wide and 10 screens high, of which one screen is in sight
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 250;
+    const int rows = 200;
+    _world = Node::create();
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite::create("Images/r1.png");
+        sprite->setPosition(s.width * 10 * (i % columns + 0.5f) / columns, s.height * 10 * (i / columns + 0.5f) / rows);
+        _world->addChild(sprite);
+    }
+    addChild(_world);
+
+    auto scroll = Sequence::create(MoveBy::create(10, Vec2(-s.width * 9, 0)),
+                                   MoveBy::create(10, Vec2(0, -s.height * 9)),
+                                   MoveBy::create(10, Vec2(s.width * 9, 0)),
+                                   MoveBy::create(10, Vec2(0, s.height * 9)),
+                                   nullptr);
+    _world->runAction(RepeatForever::create(scroll));
+
+    switchSpatialIndexCallback(nullptr);
+}
+
+std::string NodeSpatialIndexTest::title() const
+{
+    return "Spatial Index";
+}
+
+std::string NodeSpatialIndexTest::subtitle() const
+{
+    return "50000 sprites, 1% of them in sight: compare the frame time";
+}
+
+void NodeSpatialIndexTest::switchSpatialIndexCallback(Ref* sender)
+{
+    bool enabled = !_world->isSpatialIndexEnabled();
+    _world->setSpatialIndexEnabled(enabled);
+    _menuItem->setString(enabled ? "Spatial index: On" : "Spatial index: Off");
+}
@@ -329,4 +329,19 @@ public:
     void test(float dt);
 };
 
+class NodeSpatialIndexTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeSpatialIndexTest);
+    NodeSpatialIndexTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void switchSpatialIndexCallback(cocos2d::Ref* sender);
+
+protected:
+    cocos2d::Node* _world;
+    cocos2d::MenuItemFont* _menuItem;
+};
+
 #endif
@@ -60,6 +60,7 @@ Physics3DTests::Physics3DTests()
     ADD_TEST_CASE(Physics3DCollisionCallbackDemo);
     ADD_TEST_CASE(Physics3DColliderDemo);
     ADD_TEST_CASE(Physics3DTerrainDemo);
+    ADD_TEST_CASE(Physics3DRayCastManyDemo);
 #endif
 };
 
@@ -837,4 +838,98 @@ bool Physics3DColliderDemo::init()
     return true;
 }
 
+std::string Physics3DRayCastManyDemo::subtitle() const
+{
+    return "Physics3D batched ray casts and sweeps";
+}
+
+bool Physics3DRayCastManyDemo::init()
+{
+    if (!Physics3DTestDemo::init())
+        return false;
+
+    //a floor and a grid of static boxes to cast at
+    Physics3DRigidBodyDes rbDes;
+    rbDes.mass = 0.0f;
+    rbDes.shape = Physics3DShape::createBox(Vec3(60.0f, 1.0f, 60.0f));
+    auto floor = PhysicsSprite3D::create("Sprite3DTest/box.c3t", &rbDes);
+    floor->setTexture("Sprite3DTest/plane.png");
+    floor->setScaleX(60);
+    floor->setScaleZ(60);
+    this->addChild(floor);
+    floor->setCameraMask((unsigned short)CameraFlag::USER1);
+    floor->syncNodeToPhysics();
+    floor->setSyncFlag(Physics3DComponent::PhysicsSyncFlag::NONE);
+
+    rbDes.shape = Physics3DShape::createBox(Vec3(2.0f, 2.0f, 2.0f));
+    for (int i = 0; i < 10; ++i)
+    {
+        for (int j = 0; j < 10; ++j)
+        {
+            auto sprite = PhysicsSprite3D::create("Sprite3DTest/box.c3t", &rbDes);
+            sprite->setTexture("Images/CyanSquare.png");
+            sprite->setPosition3D(Vec3(-22.5f + 5.0f * i, 1.0f + (i + j) % 3, -22.5f + 5.0f * j));
+            sprite->setScale(2.0f);
+            sprite->syncNodeToPhysics();
+            sprite->setSyncFlag(Physics3DComponent::PhysicsSyncFlag::NONE);
+            sprite->setCameraMask((unsigned short)CameraFlag::USER1);
+            this->addChild(sprite);
+        }
+    }
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 12);
+    _label = Label::createWithTTF(ttfConfig, "");
+    _label->setPosition(Vec2(VisibleRect::center().x, VisibleRect::bottom().y + 30));
+    this->addChild(_label);
+
+    physicsScene->setPhysics3DDebugCamera(_camera);
+    scheduleUpdate();
+    return true;
+}
+
+void Physics3DRayCastManyDemo::update(float delta)
+{
+    _time += delta;
+    auto world = getPhysics3DWorld();
+
+    //a grid of vertical rays and sweeps moving over the boxes, compared with the single queries
+    std::vector<Vec3> starts, ends;
+    std::vector<Mat4> startTransforms, endTransforms;
+    for (int i = 0; i < 32; ++i)
+    {
+        for (int j = 0; j < 32; ++j)
+        {
+            Vec3 start(-28.0f + 1.75f * i + 3.0f * sinf(_time), 20.0f, -28.0f + 1.75f * j);
+            Vec3 end(start.x, -5.0f, start.z);
+            starts.push_back(start);
+            ends.push_back(end);
+            Mat4 startTransform, endTransform;
+            Mat4::createTranslation(start, &startTransform);
+            Mat4::createTranslation(end, &endTransform);
+            startTransforms.push_back(startTransform);
+            endTransforms.push_back(endTransform);
+        }
+    }
+
+    std::vector<Physics3DWorld::HitResult> rayResults, sweepResults;
+    int rayHits = world->rayCastMany(starts, ends, &rayResults);
+    auto sphere = Physics3DShape::createSphere(0.5f);
+    int sweepHits = world->sweepShapeMany(sphere, startTransforms, endTransforms, &sweepResults);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < starts.size(); ++i)
+    {
+        Physics3DWorld::HitResult result;
+        world->rayCast(starts[i], ends[i], &result);
+        if (result.hitObj != rayResults[i].hitObj || (result.hitObj && result.hitPosition.distance(rayResults[i].hitPosition) > 0.01f))
+            ++mismatches;
+        world->sweepShape(sphere, startTransforms[i], endTransforms[i], &result);
+        if (result.hitObj != sweepResults[i].hitObj)
+            ++mismatches;
+    }
+
+    _label->setString(StringUtils::format("%d rays: %d hits, %d sweeps: %d hits, %d different from rayCast/sweepShape",
+                                          (int)starts.size(), rayHits, (int)startTransforms.size(), sweepHits, mismatches));
+}
+
 #endif
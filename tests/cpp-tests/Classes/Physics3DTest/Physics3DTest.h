@@ -147,6 +147,24 @@ public:
 private:
 };
 
+class Physics3DRayCastManyDemo : public Physics3DTestDemo
+{
+public:
+
+    CREATE_FUNC(Physics3DRayCastManyDemo);
+    Physics3DRayCastManyDemo():_label(nullptr), _time(0.0f){};
+    virtual ~Physics3DRayCastManyDemo(){};
+
+    virtual std::string subtitle() const override;
+
+    virtual bool init() override;
+    virtual void update(float delta) override;
+
+private:
+    cocos2d::Label* _label;
+    float _time;
+};
+
 class Physics3DColliderDemo : public Physics3DTestDemo
 {
 public:
@@ -27,6 +27,7 @@ PhysicsTests::PhysicsTests()
     ADD_TEST_CASE(PhysicsFixedUpdate);
     ADD_TEST_CASE(PhysicsTransformTest);
     ADD_TEST_CASE(PhysicsIssue9959);
+    ADD_TEST_CASE(PhysicsFixedTimeStepTest);
 }
 
 namespace
@@ -1867,4 +1868,73 @@ std::string PhysicsIssue9959::subtitle() const
     return "Test Scale9Sprite run scale/move/rotation action in physics scene";
 }
 
-#endif
\ No newline at end of file
+void PhysicsFixedTimeStepTest::onEnter()
+{
+    PhysicsDemo::onEnter();
+
+    _physicsWorld->setFixedTimeStep(1 / 30.0f);
+    _physicsWorld->setInterpolation(PhysicsWorld::Interpolation::NONE);
+
+    auto wall = Node::create();
+    wall->addComponent(PhysicsBody::createEdgeBox(VisibleRect::getVisibleRect().size, PhysicsMaterial(0.1f, 1.0f, 0.0f)));
+    wall->setPosition(VisibleRect::center());
+    addChild(wall);
+
+    for (int i = 0; i < 6; ++i)
+    {
+        auto ball = Sprite::create("Images/ball.png");
+        ball->setPosition(VisibleRect::center() + Vec2(-150.0f + 60.0f * i, 40.0f * (i % 3)));
+        auto ballBody = PhysicsBody::createCircle(ball->getContentSize().width / 2, PhysicsMaterial(0.1f, 1.0f, 0.0f));
+        ballBody->setVelocity(Vec2(300.0f - 100.0f * i, 150.0f));
+        ballBody->setTag(DRAG_BODYS_TAG);
+        ball->addComponent(ballBody);
+        addChild(ball);
+
+        auto box = Sprite::create("Images/YellowSquare.png");
+        box->setScale(0.25f);
+        box->setPosition(VisibleRect::center() + Vec2(-150.0f + 60.0f * i, -100.0f));
+        auto boxBody = PhysicsBody::createBox(box->getContentSize(), PhysicsMaterial(0.1f, 1.0f, 0.0f));
+        boxBody->setAngularVelocity(2.0f);
+        boxBody->setTag(DRAG_BODYS_TAG);
+        box->addComponent(boxBody);
+        addChild(box);
+    }
+
+    MenuItemFont::setFontSize(18);
+    auto item = MenuItemFont::create("Mode(none)", CC_CALLBACK_1(PhysicsFixedTimeStepTest::changeModeCallback, this));
+
+    auto menu = Menu::create(item, nullptr);
+    addChild(menu);
+    menu->setPosition(Vec2(VisibleRect::left().x + 100, VisibleRect::top().y - 10));
+}
+
+void PhysicsFixedTimeStepTest::changeModeCallback(Ref* sender)
+{
+    switch (_physicsWorld->getInterpolation())
+    {
+        case PhysicsWorld::Interpolation::NONE:
+            _physicsWorld->setInterpolation(PhysicsWorld::Interpolation::INTERPOLATE);
+            ((MenuItemFont*)sender)->setString("Mode(interpolate)");
+            break;
+        case PhysicsWorld::Interpolation::INTERPOLATE:
+            _physicsWorld->setInterpolation(PhysicsWorld::Interpolation::EXTRAPOLATE);
+            ((MenuItemFont*)sender)->setString("Mode(extrapolate)");
+            break;
+        default:
+            _physicsWorld->setInterpolation(PhysicsWorld::Interpolation::NONE);
+            ((MenuItemFont*)sender)->setString("Mode(none)");
+            break;
+    }
+}
+
+std::string PhysicsFixedTimeStepTest::title() const
+{
+    return "Fixed Time Step";
+}
+
+std::string PhysicsFixedTimeStepTest::subtitle() const
+{
+    return "Physics at 30 Hz, the balls move smoothly with interpolation";
+}
+
+#endif
@@ -267,4 +267,16 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class PhysicsFixedTimeStepTest : public PhysicsDemo
+{
+public:
+    CREATE_FUNC(PhysicsFixedTimeStepTest);
+
+    void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void changeModeCallback(cocos2d::Ref* sender);
+};
+
 #endif // #if CC_USE_PHYSICS
\ No newline at end of file
@@ -69,6 +69,8 @@ Sprite3DTests::Sprite3DTests()
     ADD_TEST_CASE(MotionStreak3DTest);
     ADD_TEST_CASE(Sprite3DPropertyTest);
     ADD_TEST_CASE(Sprite3DNormalMappingTest);
+    ADD_TEST_CASE(Sprite3DSharedPoseTest);
+    ADD_TEST_CASE(Sprite3DInstancingTest);
 };
 
 //------------------------------------------------------------------
@@ -2688,4 +2690,152 @@ void Sprite3DPropertyTest::refreshSpriteRender()
         }
         mesh->setTexture(cacheTex, cocos2d::NTextureData::Usage::Diffuse, false);
     }
-}
\ No newline at end of file
+}
+
+Sprite3DSharedPoseTest::Sprite3DSharedPoseTest()
+: _sharedPose(false)
+{
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _menuItem = MenuItemFont::create("", CC_CALLBACK_1(Sprite3DSharedPoseTest::switchSharedPoseCallback, this));
+    _menuItem->setColor(Color3B(0, 200, 20));
+    auto menu = Menu::create(_menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    _menuItem->setPosition(VisibleRect::left().x + 70, VisibleRect::top().y - 70);
+    addChild(menu, 1);
+
+    // 200 orcs, the first four of them animated at different speeds
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 20;
+    const int rows = 10;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite3D::create("Sprite3DTest/orc.c3b");
+        sprite->setScale(0.8f);
+        sprite->setRotation3D(Vec3(0, 180, 0));
+        sprite->setPosition(s.width * (i % columns + 0.5f) / columns, s.height * 0.8f * (i / columns + 0.5f) / rows);
+        addChild(sprite);
+
+        if (i < 4)
+        {
+            runAnimation(sprite, 0.5f + 0.25f * i);
+            _leaders.push_back(sprite);
+        }
+        else
+        {
+            _followers.push_back(sprite);
+        }
+    }
+
+    setSharedPose(true);
+}
+
+std::string Sprite3DSharedPoseTest::title() const
+{
+    return "Sprite3D Shared Poses";
+}
+
+std::string Sprite3DSharedPoseTest::subtitle() const
+{
+    return "200 orcs sharing the poses of 4 animated ones";
+}
+
+void Sprite3DSharedPoseTest::runAnimation(Sprite3D* sprite, float speed)
+{
+    auto animation = Animation3D::create("Sprite3DTest/orc.c3b");
+    if (animation)
+    {
+        auto animate = Animate3D::create(animation);
+        animate->setSpeed(speed);
+        auto repeat = RepeatForever::create(animate);
+        repeat->setTag(110);
+        sprite->runAction(repeat);
+    }
+}
+
+void Sprite3DSharedPoseTest::setSharedPose(bool shared)
+{
+    _sharedPose = shared;
+    _menuItem->setString(shared ? "Shared Poses: On" : "Shared Poses: Off");
+
+    for (size_t i = 0; i < _followers.size(); ++i)
+    {
+        auto follower = _followers[i];
+        auto leader = _leaders[i % _leaders.size()];
+        if (shared)
+        {
+            // the followers don't evaluate their animation any more
+            follower->stopActionByTag(110);
+            follower->getSkeleton()->setPoseSource(leader->getSkeleton());
+        }
+        else
+        {
+            follower->getSkeleton()->setPoseSource(nullptr);
+            runAnimation(follower, 0.5f + 0.25f * (i % _leaders.size()));
+        }
+    }
+}
+
+void Sprite3DSharedPoseTest::switchSharedPoseCallback(Ref* sender)
+{
+    setSharedPose(!_sharedPose);
+}
+
+Sprite3DInstancingTest::Sprite3DInstancingTest()
+: _instancing(false)
+{
+    MenuItemFont::setFontName("fonts/arial.ttf");
+    MenuItemFont::setFontSize(15);
+    _menuItem = MenuItemFont::create("", CC_CALLBACK_1(Sprite3DInstancingTest::switchInstancingCallback, this));
+    _menuItem->setColor(Color3B(0, 200, 20));
+    auto menu = Menu::create(_menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    _menuItem->setPosition(VisibleRect::left().x + 70, VisibleRect::top().y - 70);
+    addChild(menu, 1);
+
+    // 400 ships using the same mesh, program and texture, with their own transform and color
+    auto s = Director::getInstance()->getWinSize();
+    auto glProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_3D_POSITION_TEXTURE);
+    const int columns = 25;
+    const int rows = 16;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite3D::create("Sprite3DTest/boss1.obj");
+        sprite->setGLProgramState(glProgramState);
+        sprite->setTexture("Sprite3DTest/boss.png");
+        sprite->setScale(1.5f);
+        sprite->setPosition(s.width * (i % columns + 0.5f) / columns, s.height * 0.8f * (i / columns + 0.5f) / rows);
+        sprite->setColor(Color3B(155 + (i * 37) % 100, 155 + (i * 61) % 100, 155 + (i * 89) % 100));
+        sprite->runAction(RepeatForever::create(RotateBy::create(2.0f + (i % 5) * 0.5f, Vec3(0, 360, 0))));
+        addChild(sprite);
+        _sprites.push_back(sprite);
+    }
+
+    setInstancing(true);
+}
+
+std::string Sprite3DInstancingTest::title() const
+{
+    return "Sprite3D Instancing";
+}
+
+std::string Sprite3DInstancingTest::subtitle() const
+{
+    return InstancedMeshCommand::isHardwareInstancingAvailable() ?
+        "400 ships drawn with one instanced draw call" :
+        "400 ships, no instanced arrays: one draw call per ship, one bind";
+}
+
+void Sprite3DInstancingTest::setInstancing(bool enabled)
+{
+    _instancing = enabled;
+    _menuItem->setString(enabled ? "Instancing: On" : "Instancing: Off");
+
+    for (auto sprite : _sprites)
+        sprite->setInstancingEnabled(enabled);
+}
+
+void Sprite3DInstancingTest::switchInstancingCallback(Ref* sender)
+{
+    setInstancing(!_instancing);
+}
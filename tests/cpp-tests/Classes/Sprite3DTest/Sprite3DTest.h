@@ -615,4 +615,42 @@ protected:
     std::string _texFile;
 };
 
+class Sprite3DSharedPoseTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSharedPoseTest);
+    Sprite3DSharedPoseTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void switchSharedPoseCallback(cocos2d::Ref* sender);
+
+protected:
+    void runAnimation(cocos2d::Sprite3D* sprite, float speed);
+    void setSharedPose(bool shared);
+
+    std::vector<cocos2d::Sprite3D*> _leaders;
+    std::vector<cocos2d::Sprite3D*> _followers;
+    bool _sharedPose;
+    cocos2d::MenuItemFont* _menuItem;
+};
+
+class Sprite3DInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DInstancingTest);
+    Sprite3DInstancingTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void switchInstancingCallback(cocos2d::Ref* sender);
+
+protected:
+    void setInstancing(bool enabled);
+
+    std::vector<cocos2d::Sprite3D*> _sprites;
+    bool _instancing;
+    cocos2d::MenuItemFont* _menuItem;
+};
+
 #endif
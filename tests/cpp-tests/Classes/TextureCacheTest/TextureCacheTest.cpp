@@ -8,6 +8,8 @@ USING_NS_CC;
 TextureCacheTests::TextureCacheTests()
 {
     ADD_TEST_CASE(TextureCacheTest);
+    ADD_TEST_CASE(TextureCacheAsyncPriorityTest);
+    ADD_TEST_CASE(TextureCacheAsyncCancelTest);
 }
 
 TextureCacheTest::TextureCacheTest()
@@ -130,3 +132,113 @@ void TextureCacheTest::addSprite()
     this->addChild(s14);
     this->addChild(s15);
 }
+
+TextureCacheAsyncPriorityTest::TextureCacheAsyncPriorityTest()
+: _numberOfLoaded(0)
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->removeUnusedTextures();
+
+    // create at most one texture per frame, uploads are spread over the next frames
+    _uploadBudget = cache->getAsyncUploadBudget();
+    cache->setAsyncUploadBudget(0.0001f);
+
+    auto callback = CC_CALLBACK_2(TextureCacheAsyncPriorityTest::loadingCallBack, this);
+    cache->addImageAsync("Images/background1.png", callback, 0);
+    cache->addImageAsync("Images/background2.png", callback, 0);
+    cache->addImageAsync("Images/background3.png", callback, 0);
+    cache->addImageAsync("Images/grossini_dance_atlas.png", callback, 1);
+    cache->addImageAsync("Images/blocks.png", callback, 2);
+    // coalesced with the request above, and raises its priority
+    cache->addImageAsync("Images/background3.png", callback, 3);
+    // never loaded
+    cache->addImageAsync("Images/atlastest.png", callback, 0, "priority");
+    cache->cancelImageAsync("Images/atlastest.png", "priority");
+}
+
+void TextureCacheAsyncPriorityTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->unbindAllImageAsync();
+    cache->setAsyncUploadBudget(_uploadBudget);
+
+    TestCase::onExit();
+}
+
+void TextureCacheAsyncPriorityTest::loadingCallBack(cocos2d::Texture2D *texture, const TextureCache::AsyncLoadInfo& info)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    auto name = info.path.substr(info.path.find_last_of('/') + 1);
+    auto label = Label::createWithTTF(StringUtils::format("%d. %s: decode %.1f ms, upload %.1f ms, total %.1f ms",
+                                                          _numberOfLoaded + 1, name.c_str(),
+                                                          info.decodeTime * 1000, info.uploadTime * 1000, info.totalTime * 1000),
+                                      "fonts/arial.ttf", 12);
+    label->setPosition(Vec2(size.width / 2, size.height - 90 - _numberOfLoaded * 20));
+    this->addChild(label);
+
+    ++_numberOfLoaded;
+}
+
+std::string TextureCacheAsyncPriorityTest::title() const
+{
+    return "Async load priorities";
+}
+
+std::string TextureCacheAsyncPriorityTest::subtitle() const
+{
+    return "background3 and blocks first, atlastest cancelled, background3 listed twice";
+}
+
+TextureCacheAsyncCancelTest::TextureCacheAsyncCancelTest()
+: _cancelledCalls(0)
+, _keptCalls(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->removeTextureForKey("Images/background1.png");
+
+    // both callers share one load, the second one leaves before it is done
+    cache->addImageAsync("Images/background1.png", CC_CALLBACK_2(TextureCacheAsyncCancelTest::keptCallBack, this), 0, "kept");
+    cache->addImageAsync("Images/background1.png", CC_CALLBACK_2(TextureCacheAsyncCancelTest::cancelledCallBack, this), 0, "cancelled");
+    bool cancelled = cache->cancelImageAsync("Images/background1.png", "cancelled");
+    CCASSERT(cancelled, "the cancelled caller should have a callback bound");
+    bool cancelledAgain = cache->cancelImageAsync("Images/background1.png", "cancelled");
+    CCASSERT(!cancelledAgain, "the cancelled caller should have no callback left");
+
+    _label = Label::createWithTTF("loading...", "fonts/arial.ttf", 15);
+    _label->setPosition(Vec2(size.width / 2, size.height / 2));
+    this->addChild(_label);
+}
+
+void TextureCacheAsyncCancelTest::onExit()
+{
+    Director::getInstance()->getTextureCache()->unbindAllImageAsync();
+
+    TestCase::onExit();
+}
+
+void TextureCacheAsyncCancelTest::keptCallBack(cocos2d::Texture2D *texture, const TextureCache::AsyncLoadInfo& info)
+{
+    ++_keptCalls;
+    CCASSERT(texture != nullptr, "the kept caller should get the texture");
+    CCASSERT(_cancelledCalls == 0, "the cancelled caller should not be called back");
+    _label->setString(StringUtils::format("kept caller called %d time(s), cancelled caller called %d time(s)", _keptCalls, _cancelledCalls));
+}
+
+void TextureCacheAsyncCancelTest::cancelledCallBack(cocos2d::Texture2D *texture, const TextureCache::AsyncLoadInfo& info)
+{
+    ++_cancelledCalls;
+    CCASSERT(false, "the cancelled caller should not be called back");
+}
+
+std::string TextureCacheAsyncCancelTest::title() const
+{
+    return "Async load cancelled by one caller";
+}
+
+std::string TextureCacheAsyncCancelTest::subtitle() const
+{
+    return "kept caller called once, cancelled caller never";
+}
@@ -25,4 +25,42 @@ private:
     int _numberOfLoadedSprites;
 };
 
+class TextureCacheAsyncPriorityTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCacheAsyncPriorityTest);
+
+    TextureCacheAsyncPriorityTest();
+
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void loadingCallBack(cocos2d::Texture2D *texture, const cocos2d::TextureCache::AsyncLoadInfo& info);
+
+private:
+    int _numberOfLoaded;
+    float _uploadBudget;
+};
+
+class TextureCacheAsyncCancelTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCacheAsyncCancelTest);
+
+    TextureCacheAsyncCancelTest();
+
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void keptCallBack(cocos2d::Texture2D *texture, const cocos2d::TextureCache::AsyncLoadInfo& info);
+    void cancelledCallBack(cocos2d::Texture2D *texture, const cocos2d::TextureCache::AsyncLoadInfo& info);
+
+private:
+    cocos2d::Label *_label;
+    int _cancelledCalls;
+    int _keptCalls;
+};
+
 #endif // _TEXTURECACHE_TEST_H_
@@ -42,6 +42,7 @@ FastTileMapTests::FastTileMapTests()
     ADD_TEST_CASE(TMXBug987New);
     ADD_TEST_CASE(TMXBug787New);
     ADD_TEST_CASE(TMXGIDObjectsTestNew);
+    ADD_TEST_CASE(TMXChunkedLayerTestNew);
 }
 
 TileDemoNew::TileDemoNew()
@@ -1355,3 +1356,71 @@ std::string TMXGIDObjectsTestNew::subtitle() const
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXChunkedLayerTestNew
+//
+//------------------------------------------------------------------
+TMXChunkedLayerTestNew::TMXChunkedLayerTestNew()
+{
+    // a 4096x4096 layer built in memory, drawn from the chunks around the screen
+    auto mapInfo = new (std::nothrow) TMXMapInfo();
+    mapInfo->autorelease();
+    mapInfo->setOrientation(TMXOrientationOrtho);
+    mapInfo->setTileSize(Size(32, 32));
+
+    auto tileset = new (std::nothrow) TMXTilesetInfo();
+    tileset->autorelease();
+    tileset->_firstGid = 1;
+    tileset->_tileSize = Size(32, 32);
+    tileset->_spacing = 2;
+    tileset->_margin = 2;
+    tileset->_sourceImage = "TileMaps/fixed-ortho-test2.png";
+
+    const int size = 4096;
+    auto layerInfo = new (std::nothrow) TMXLayerInfo();
+    layerInfo->autorelease();
+    layerInfo->_name = "chunked";
+    layerInfo->_layerSize = Size(size, size);
+    layerInfo->_visible = true;
+    layerInfo->_opacity = 255;
+    layerInfo->_tiles = (uint32_t*)malloc(size * size * sizeof(uint32_t));
+    for (int i = 0; i < size * size; ++i)
+    {
+        int x = i % size;
+        int y = i / size;
+        layerInfo->_tiles[i] = 1 + (x / 4 + y / 4 * 7) % 198;
+    }
+
+    _layer = cocos2d::experimental::TMXLayer::create(tileset, layerInfo, mapInfo);
+    layerInfo->_ownTiles = false;
+    _layer->setupTiles();
+    addChild(_layer, 0, kTagTileMap);
+
+    _layer->runAction(RepeatForever::create(Sequence::create(MoveBy::create(20, Vec2(-20000, -10000)),
+                                                             MoveBy::create(20, Vec2(20000, 10000)),
+                                                             nullptr)));
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 15);
+    _label->setPosition(VisibleRect::center().x, VisibleRect::top().y - 80);
+    addChild(_label, 1);
+
+    scheduleUpdate();
+}
+
+void TMXChunkedLayerTestNew::update(float dt)
+{
+    _label->setString(StringUtils::format("%d chunks of %dx%d tiles built", _layer->getResidentChunkCount(),
+                                          _layer->getChunkSize(), _layer->getChunkSize()));
+}
+
+std::string TMXChunkedLayerTestNew::title() const
+{
+    return "TMX chunked layer";
+}
+
+std::string TMXChunkedLayerTestNew::subtitle() const
+{
+    return "4096x4096 tiles, only the chunks near the screen have vertices";
+}
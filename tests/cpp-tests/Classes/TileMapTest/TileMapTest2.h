@@ -310,4 +310,18 @@ public:
     virtual std::string subtitle() const override;   
 };
 
+class TMXChunkedLayerTestNew : public TileDemoNew
+{
+public:
+    CREATE_FUNC(TMXChunkedLayerTestNew);
+    TMXChunkedLayerTestNew();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    cocos2d::experimental::TMXLayer* _layer;
+    cocos2d::Label* _label;
+};
+
 #endif
@@ -1,5 +1,9 @@
 #include "UnitTest.h"
 #include "RefPtrTest.h"
+#include "2d/CCSpatialIndex.h"
+#include "3d/CCFrustum.h"
+#include "3d/CCAnimation3D.h"
+#include <zlib.h>
 
 USING_NS_CC;
 
@@ -43,6 +47,12 @@ UnitTests::UnitTests()
     ADD_TEST_CASE(ValueTest);
     ADD_TEST_CASE(RefPtrTest);
     ADD_TEST_CASE(UTFConversionTest);
+    ADD_TEST_CASE(Animation3DSamplingTest);
+    ADD_TEST_CASE(MeshInstanceBufferTest);
+    ADD_TEST_CASE(SpatialIndexTest);
+    ADD_TEST_CASE(InflateStreamTest);
+    ADD_TEST_CASE(ActionBatchOrderTest);
+    ADD_TEST_CASE(ParallelRecordingTest);
 #ifdef UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
     ADD_TEST_CASE(MathUtilTest);
 #endif
@@ -779,6 +789,480 @@ std::string UTFConversionTest::subtitle() const
     return "UTF8 <-> UTF16 Conversion Test, no crash";
 }
 
+// Animation3DSamplingTest
+
+namespace
+{
+    // gives access to init(), so that the keys don't come from a file
+    class Animation3DForTest : public Animation3D
+    {
+    public:
+        using Animation3D::init;
+    };
+
+    float maxDifference(const float* a, const float* b, int count)
+    {
+        float difference = 0.0f;
+        for (int i = 0; i < count; ++i)
+            difference = std::max(difference, std::fabs(a[i] - b[i]));
+        return difference;
+    }
+
+    // q and -q are the same rotation
+    float quatDifference(const float* a, const Quaternion& b)
+    {
+        float sign = (a[0] * b.x + a[1] * b.y + a[2] * b.z + a[3] * b.w) < 0.0f ? -1.0f : 1.0f;
+        float expected[4] = { b.x * sign, b.y * sign, b.z * sign, b.w * sign };
+        return maxDifference(a, expected, 4);
+    }
+}
+
+void Animation3DSamplingTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    Animation3DData data;
+    data._totalTime = 1.0f;
+
+    // the largest component is each of the four, positive and negative, the keys are too far apart to be dropped
+    Quaternion packed[] = {
+        Quaternion(0.9f, 0.3f, -0.2f, 0.1f), Quaternion(-0.1f, -0.8f, 0.4f, 0.2f),
+        Quaternion(0.3f, 0.2f, 0.85f, -0.4f), Quaternion(0.0f, 0.0f, 0.0f, 1.0f),
+        Quaternion(0.1f, -0.6f, 0.2f, -0.7f), Quaternion(-0.95f, 0.1f, 0.1f, 0.2f),
+    };
+    const int packedCount = sizeof(packed) / sizeof(packed[0]);
+    for (int i = 0; i < packedCount; ++i)
+    {
+        packed[i].normalize();
+        data._rotationKeys["packed"].push_back(Animation3DData::QuatKey(i / (packedCount - 1.0f), packed[i]));
+    }
+
+    // a bone with uneven keys, some of them close enough to the interpolation of their neighbours to be dropped
+    const int keyCount = 60;
+    std::vector<Animation3DData::Vec3Key> translations;
+    std::vector<Animation3DData::QuatKey> rotations;
+    for (int i = 0; i < keyCount; ++i)
+    {
+        float time = std::pow(i / (keyCount - 1.0f), 1.5f);
+        Vec3 translation(10.0f * std::sin(time * 7.0f), i < keyCount / 2 ? 2.0f * time : 1.0f, -5.0f * time);
+        Vec3 axis(std::cos(time * 3.0f), std::sin(time * 3.0f), 0.5f);
+        axis.normalize();
+        translations.push_back(Animation3DData::Vec3Key(time, translation));
+        rotations.push_back(Animation3DData::QuatKey(time, Quaternion(axis, time * 6.0f)));
+    }
+    data._translationKeys["curve"] = translations;
+    data._rotationKeys["curve"] = rotations;
+
+    auto animation = new (std::nothrow) Animation3DForTest();
+    animation->init(data);
+    animation->autorelease();
+
+    const Animation3D::Track* packedTrack = nullptr;
+    const Animation3D::Track* curveTrack = nullptr;
+    for (const auto& track : animation->getTracks())
+    {
+        if (track.name == "packed")
+            packedTrack = &track;
+        else if (track.name == "curve")
+            curveTrack = &track;
+    }
+    CCASSERT(packedTrack && curveTrack && packedTrack->translation < 0 && curveTrack->scale < 0, "one track per bone");
+
+    // the packed quaternions come back within the precision of 15 bits per component
+    float sampled[4], expected[4];
+    unsigned int cursor = 0;
+    for (int i = 0; i < packedCount; ++i)
+    {
+        animation->sampleQuat(packedTrack->rotation, i / (packedCount - 1.0f), &cursor, EvaluateType::INT_QUAT_SLERP, sampled);
+        CCASSERT(quatDifference(sampled, packed[i]) < 0.0001f, "quaternion packed and unpacked");
+    }
+
+    // the dropped keys are reproduced within the tolerance of the reduction
+    cursor = 0;
+    unsigned int rotationCursor = 0;
+    for (int i = 0; i < keyCount; ++i)
+    {
+        animation->sampleVec3(curveTrack->translation, translations[i]._time, &cursor, EvaluateType::INT_LINEAR, sampled);
+        CCASSERT(maxDifference(sampled, &translations[i]._key.x, 3) < 0.002f, "translation key kept");
+        animation->sampleQuat(curveTrack->rotation, rotations[i]._time, &rotationCursor, EvaluateType::INT_QUAT_SLERP, sampled);
+        CCASSERT(quatDifference(sampled, rotations[i]._key) < 0.0005f, "rotation key kept");
+    }
+
+    // the cursors give the keys the binary search of AnimationCurve finds, playing forward, backward and looping
+    std::vector<float> times;
+    for (int i = 0; i <= 500; ++i)
+        times.push_back(i / 500.0f);
+    for (int i = 500; i >= 0; --i)
+        times.push_back(i / 500.0f);
+    for (int i = 0; i < 1000; ++i)
+        times.push_back(std::fmod(i * 0.0137f, 1.0f));
+
+    auto curve = animation->getBoneCurveByName("curve");
+    CCASSERT(curve && curve->translateCurve && curve->rotCurve && !curve->scaleCurve, "curves built from the packed keys");
+    cursor = 0;
+    rotationCursor = 0;
+    for (float time : times)
+    {
+        animation->sampleVec3(curveTrack->translation, time, &cursor, EvaluateType::INT_LINEAR, sampled);
+        curve->translateCurve->evaluate(time, expected, EvaluateType::INT_LINEAR);
+        CCASSERT(maxDifference(sampled, expected, 3) < 0.00001f, "translation as found by the binary search");
+        animation->sampleQuat(curveTrack->rotation, time, &rotationCursor, EvaluateType::INT_QUAT_SLERP, sampled);
+        curve->rotCurve->evaluate(time, expected, EvaluateType::INT_QUAT_SLERP);
+        CCASSERT(maxDifference(sampled, expected, 4) < 0.00001f, "rotation as found by the binary search");
+    }
+}
+
+std::string Animation3DSamplingTest::subtitle() const
+{
+    return "Animation3D packed keys and cursors, no assert";
+}
+
+// MeshInstanceBufferTest
+
+void MeshInstanceBufferTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    int meshA = 0, meshB = 0, program = 0;
+    MeshInstanceBuffer::Key keyA = { &meshA, &program, nullptr, 0, 0.0f, 0 };
+    MeshInstanceBuffer::Key keyB = { &meshB, &program, nullptr, 0, 0.0f, 0 };
+    MeshInstanceBuffer::Key keyC = keyA;
+    keyC.renderQueue = 1;
+
+    Mat4 transforms[4];
+    for (int i = 0; i < 4; ++i)
+        Mat4::createTranslation(i * 10.0f, i * 20.0f, i * 30.0f, &transforms[i]);
+    Vec4 color(0.25f, 0.5f, 0.75f, 1.0f);
+
+    MeshInstanceBuffer buffer;
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        // the calls stay out of CCASSERT, which compiles to nothing in release builds
+        bool isNewBatch = false;
+        int batch = buffer.addInstance(keyA, transforms[0], color, &isNewBatch);
+        CCASSERT(batch == 0 && isNewBatch, "first batch");
+        batch = buffer.addInstance(keyB, transforms[1], color, &isNewBatch);
+        CCASSERT(batch == 1 && isNewBatch, "second batch");
+        batch = buffer.addInstance(keyA, transforms[2], color, &isNewBatch);
+        CCASSERT(batch == 0 && !isNewBatch, "same key, same batch");
+        batch = buffer.addInstance(keyC, transforms[3], color, &isNewBatch);
+        CCASSERT(batch == 2 && isNewBatch, "other queue, other batch");
+
+        CCASSERT(buffer.getBatchCount() == 3, "three batches");
+        CCASSERT(buffer.getInstanceCount(0) == 2 && buffer.getInstanceCount(1) == 1 && buffer.getInstanceCount(2) == 1, "instance counts");
+        CCASSERT(buffer.getKey(1) == keyB, "batches keep their key");
+
+        // the model view matrix, column major, then the color
+        const float* instance = buffer.getInstanceData(0) + MeshInstanceBuffer::FLOATS_PER_INSTANCE;
+        CCASSERT(memcmp(instance, transforms[2].m, sizeof(transforms[2].m)) == 0, "matrix of the second instance");
+        CCASSERT(instance[12] == 20.0f && instance[13] == 40.0f && instance[14] == 60.0f, "translation in the last column");
+        CCASSERT(instance[16] == color.x && instance[17] == color.y && instance[18] == color.z && instance[19] == color.w, "color after the matrix");
+
+        // the next frame starts empty
+        buffer.clear();
+        CCASSERT(buffer.getBatchCount() == 0, "no batch after clear");
+    }
+}
+
+std::string MeshInstanceBufferTest::subtitle() const
+{
+    return "MeshInstanceBuffer batching, no assert";
+}
+
+// SpatialIndexTest
+
+void SpatialIndexTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // a 10x10 grid of 10x10 nodes, 100 points apart
+    const float margin = 8.0f;
+    SpatialIndex index(margin);
+    Vector<Node*> nodes;
+    std::vector<int> items;
+    for (int y = 0; y < 10; ++y)
+    {
+        for (int x = 0; x < 10; ++x)
+        {
+            auto node = Node::create();
+            node->setContentSize(Size(10, 10));
+            node->setPosition(x * 100.0f, y * 100.0f);
+            nodes.pushBack(node);
+            items.push_back(index.add(node));
+        }
+    }
+
+    // the calls stay out of CCASSERT, which compiles to nothing in release builds
+    // nothing is culled before the first cull
+    CCASSERT(!index.isCulled(items[99]), "not culled before cull()");
+
+    Mat4 projection;
+    Mat4::createOrthographicOffCenter(0, 500, 0, 500, -1, 1, &projection);
+    Frustum frustum;
+    frustum.initFrustum(projection);
+
+    index.update();
+    CCASSERT(index.getHeight() < 10, "the tree is balanced");
+    int visible = index.cull(frustum);
+    CCASSERT(visible == 36, "nodes from 0 to 500 on both axes are in sight");
+    CCASSERT(!index.isCulled(items[0]) && !index.isCulled(items[55]), "inside the frustum");
+    CCASSERT(index.isCulled(items[99]) && index.isCulled(items[6]), "outside the frustum");
+
+    // a small move stays within the margin, a large one moves the item into sight
+    nodes.at(99)->setPosition(905, 905);
+    index.update();
+    visible = index.cull(frustum);
+    CCASSERT(visible == 36, "small move");
+    nodes.at(99)->setPosition(250, 250);
+    index.update();
+    visible = index.cull(frustum);
+    CCASSERT(visible == 37 && !index.isCulled(items[99]), "moved into sight");
+
+    // a change below an item is only seen once the item is invalidated
+    auto child = Node::create();
+    child->setContentSize(Size(10, 10));
+    child->setPosition(-700, 0);
+    nodes.at(9)->addChild(child);
+    index.update();
+    visible = index.cull(frustum);
+    CCASSERT(visible == 38 && !index.isCulled(items[9]), "the child of item 9 is in sight");
+    child->setPosition(-600, 0);
+    index.update();
+    visible = index.cull(frustum);
+    CCASSERT(visible == 38, "not seen without invalidate()");
+    child->setPosition(-100, 0);
+    index.invalidate(items[9]);
+    index.update();
+    visible = index.cull(frustum);
+    CCASSERT(visible == 37 && index.isCulled(items[9]), "seen after invalidate()");
+
+    // nodes without bounds are never culled
+    auto drawNode = DrawNode::create();
+    drawNode->setPosition(5000, 5000);
+    int drawNodeItem = index.add(drawNode);
+    index.update();
+    index.cull(frustum);
+    CCASSERT(!index.isCulled(drawNodeItem), "DrawNode has no bounds");
+
+    std::vector<Node*> found;
+    index.query(AABB(Vec3(95, 95, -1), Vec3(105, 105, 1)), &found);
+    CCASSERT(found.size() == 1 && found[0] == nodes.at(11), "query");
+
+    // removed items leave the tree
+    for (int i = 0; i < 50; ++i)
+        index.remove(items[i]);
+    visible = index.cull(frustum);
+    CCASSERT(visible == 7, "the row at 500 and the moved node are left in sight");
+    found.clear();
+    index.query(AABB(Vec3(-1000, -1000, -1), Vec3(2000, 2000, 1)), &found);
+    CCASSERT(found.size() == 50, "50 items left");
+
+    index.disableCulling();
+    CCASSERT(!index.isCulled(items[98]), "culling disabled");
+
+    AABB bounds;
+    auto parent = Node::create();
+    parent->setPosition(100, 0);
+    auto empty = Node::create();
+    parent->addChild(empty);
+    bool bounded = SpatialIndex::computeSubtreeBounds(parent, &bounds);
+    CCASSERT(!bounded, "nothing drawn");
+    empty->setContentSize(Size(10, 20));
+    empty->setPosition(50, 0);
+    bounded = SpatialIndex::computeSubtreeBounds(parent, &bounds);
+    CCASSERT(bounded, "bounded");
+    CCASSERT(bounds._min.x == 150 && bounds._max.x == 160 && bounds._max.y == 20, "in the coordinates of the parent");
+}
+
+std::string SpatialIndexTest::subtitle() const
+{
+    return "SpatialIndex culling, no assert";
+}
+
+// InflateStreamTest
+
+static std::string deflateForTest(const std::string& data, int windowBits)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    std::string out(deflateBound(&stream, (uLong)data.size()), '\0');
+    stream.next_in = (Bytef*)data.data();
+    stream.avail_in = (uInt)data.size();
+    stream.next_out = (Bytef*)&out[0];
+    stream.avail_out = (uInt)out.size();
+    deflate(&stream, Z_FINISH);
+    out.resize(stream.total_out);
+    deflateEnd(&stream);
+    return out;
+}
+
+void InflateStreamTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    std::string data;
+    for (int i = 0; i < 20000; ++i)
+        data += StringUtils::format("{\"id\":%d,\"name\":\"item_%d\"},", i, i * 7);
+
+    std::string inflated;
+    InflateStream stream;
+    auto output = [&inflated](const unsigned char* block, size_t size) {
+        CCASSERT(size <= 1024, "blocks are at most the buffer size");
+        inflated.append((const char*)block, size);
+        return true;
+    };
+
+    // gzip and zlib are both detected, the chunks can be of any size
+    const int windowBits[] = { 15 + 16, 15 };
+    for (int format = 0; format < 2; ++format)
+    {
+        std::string deflated = deflateForTest(data, windowBits[format]);
+        inflated.clear();
+        // the calls stay out of CCASSERT, which compiles to nothing in release builds
+        bool ok = stream.init(output, 1024);
+        CCASSERT(ok, "init");
+        for (size_t i = 0; i < deflated.size(); i += 333)
+        {
+            ok = stream.write(deflated.data() + i, std::min<size_t>(333, deflated.size() - i));
+            CCASSERT(ok, "write");
+            CCASSERT(stream.isFinished() == (i + 333 >= deflated.size()), "finished after the last chunk only");
+        }
+        CCASSERT(inflated == data && stream.getTotalOut() == data.size(), "inflated data");
+    }
+
+    // concatenated gzip members
+    std::string members = deflateForTest(data.substr(0, 1000), 15 + 16) + deflateForTest(data.substr(1000), 15 + 16);
+    inflated.clear();
+    stream.init(output, 1024);
+    bool written = stream.write(members.data(), members.size());
+    CCASSERT(written && stream.isFinished() && inflated == data, "gzip members");
+
+    // corrupted data, and an output aborting the stream
+    stream.init(output, 1024);
+    written = stream.write("not compressed", 14);
+    bool failed = stream.hasFailed();
+    bool writtenAfterFailure = stream.write("", 0);
+    CCASSERT(!written && failed && !writtenAfterFailure, "corrupted data");
+    int blocks = 0;
+    stream.init([&blocks](const unsigned char*, size_t) { return ++blocks < 2; }, 1024);
+    written = stream.write(members.data(), members.size());
+    CCASSERT(!written && blocks == 2, "aborted by the output");
+}
+
+std::string InflateStreamTest::subtitle() const
+{
+    return "InflateStream of gzip and zlib data, no assert";
+}
+
+// ActionBatchOrderTest
+
+void ActionBatchOrderTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // a manager stepped by hand, the MoveBy is batched and the ActionFloat is not
+    auto manager = new (std::nothrow) ActionManager();
+    auto node = Node::create();
+    std::vector<float> seen;
+    auto record = [&seen, node](float) { seen.push_back(node->getPositionX()); };
+
+    // added first, the move is stepped first
+    manager->addAction(MoveBy::create(1, Vec2(100, 0)), node, false);
+    manager->addAction(ActionFloat::create(1, 0, 1, record), node, false);
+    manager->update(0);
+    manager->update(0.5f);
+    CCASSERT(seen.size() == 2 && seen[1] == 50, "the action added after the move sees its position");
+    CCASSERT(node->getPositionX() == 50, "the move is stepped once");
+
+    // added last, the move is stepped last
+    manager->removeAllActionsFromTarget(node);
+    node->setPositionX(0);
+    seen.clear();
+    manager->addAction(ActionFloat::create(1, 0, 1, record), node, false);
+    manager->addAction(MoveBy::create(1, Vec2(100, 0)), node, false);
+    manager->update(0);
+    manager->update(0.5f);
+    CCASSERT(seen.size() == 2 && seen[1] == 0, "the action added before the move doesn't see its position");
+    CCASSERT(node->getPositionX() == 50, "the move is stepped once");
+
+    // a node that only runs batched actions: the last scale added wins, also once an earlier one is removed
+    manager->removeAllActionsFromTarget(node);
+    manager->addAction(ScaleTo::create(0.25f, 1), node, false);
+    manager->addAction(ScaleTo::create(1, 2), node, false);
+    manager->addAction(ScaleTo::create(1, 3), node, false);
+    manager->update(0);
+    manager->update(0.5f);
+    manager->update(0.25f);
+    CCASSERT(node->getScaleX() == 2.5f, "the scales are stepped in the order they were added");
+
+    manager->release();
+}
+
+std::string ActionBatchOrderTest::subtitle() const
+{
+    return "Batched actions keep the order of the actions of a node, no assert";
+}
+
+// ParallelRecordingTest
+
+void ParallelRecordingTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto pool = ThreadPool::getInstance();
+    auto renderer = Director::getInstance()->getRenderer();
+    const size_t listCount = 64;
+    const size_t commandsPerList = 1000;
+    std::vector<CustomCommand> commands(listCount * commandsPerList);
+
+    // the calling thread runs jobs too, each index must always belong to the same thread
+    std::vector<std::thread::id> threadOfIndex(pool->getThreadCount() + 1);
+    std::mutex threadOfIndexMutex;
+    bool indicesValid = true;
+
+    auto start = std::chrono::steady_clock::now();
+    size_t firstList = renderer->beginParallelRecording(listCount);
+    pool->parallelFor(listCount, [&](size_t list) {
+        size_t index = pool->getCurrentThreadIndex();
+        {
+            std::lock_guard<std::mutex> lock(threadOfIndexMutex);
+            if (index >= threadOfIndex.size())
+                indicesValid = false;
+            else if (threadOfIndex[index] == std::thread::id())
+                threadOfIndex[index] = std::this_thread::get_id();
+            else if (threadOfIndex[index] != std::this_thread::get_id())
+                indicesValid = false;
+        }
+
+        renderer->setRecordingList(firstList + list);
+        for (size_t i = 0; i < commandsPerList; ++i)
+        {
+            renderer->addCommand(&commands[list * commandsPerList + i]);
+        }
+    });
+    renderer->endParallelRecording();
+    auto elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+    CCASSERT(indicesValid, "each thread has its own index");
+    for (size_t list = 0; list < listCount; ++list)
+    {
+        size_t recorded = renderer->getRecordedCommandCount(firstList + list);
+        CCASSERT(recorded == commandsPerList, "no command is lost or recorded in the list of another thread");
+    }
+
+    // the commands are not drawn
+    renderer->releaseRecordedLists(firstList);
+
+    log("ParallelRecordingTest: %d commands recorded by %d threads in %.3f ms",
+        static_cast<int>(commands.size()), static_cast<int>(pool->getThreadCount() + 1), elapsed * 1000);
+}
+
+std::string ParallelRecordingTest::subtitle() const
+{
+    return "Render commands added from several threads, no assert";
+}
+
 // MathUtilTest
 
 namespace UnitTest {
@@ -48,6 +48,54 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class Animation3DSamplingTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(Animation3DSamplingTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class MeshInstanceBufferTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(MeshInstanceBufferTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class SpatialIndexTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(SpatialIndexTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class InflateStreamTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(InflateStreamTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ActionBatchOrderTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ActionBatchOrderTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class ParallelRecordingTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(ParallelRecordingTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 class MathUtilTest : public UnitTestDemo
 {
 public:
@@ -4,6 +4,7 @@
 #include <vector>
 #include <sstream>
 #include <iomanip>
+#include <chrono>
 
 using namespace std;
 
@@ -16,6 +17,7 @@ USING_NS_CC;
 UserDefaultTests::UserDefaultTests()
 {
     ADD_TEST_CASE(UserDefaultTest);
+    ADD_TEST_CASE(UserDefaultBatchTest);
 }
 
 UserDefaultTest::UserDefaultTest()
@@ -177,3 +179,53 @@ UserDefaultTest::~UserDefaultTest()
 }
 
 
+
+UserDefaultBatchTest::UserDefaultBatchTest()
+{
+    const int count = 300;
+    char key[32];
+
+    // a game writing its settings at startup
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i)
+    {
+        sprintf(key, "batch_%d", i);
+        UserDefault::getInstance()->setIntegerForKey(key, i);
+    }
+    auto setTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    UserDefault::getInstance()->flush();
+    auto flushTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // read the values back from the file
+    UserDefault::destroyInstance();
+    int errors = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        sprintf(key, "batch_%d", i);
+        if (UserDefault::getInstance()->getIntegerForKey(key, -1) != i)
+        {
+            ++errors;
+        }
+        UserDefault::getInstance()->deleteValueForKey(key);
+    }
+    UserDefault::getInstance()->flush();
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(StringUtils::format("%d values set in %.2f ms, flushed in %.2f ms\n%d read back wrong",
+                                                          count, setTime, flushTime, errors),
+                                      "fonts/arial.ttf", 16);
+    label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(label);
+}
+
+std::string UserDefaultBatchTest::title() const
+{
+    return "UserDefault batched writes";
+}
+
+std::string UserDefaultBatchTest::subtitle() const
+{
+    return "Should read back 0 wrong values";
+}
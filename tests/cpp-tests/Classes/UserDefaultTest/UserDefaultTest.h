@@ -20,4 +20,14 @@ private:
     cocos2d::Label* _label;
 };
 
+class UserDefaultBatchTest : public TestCase
+{
+public:
+    CREATE_FUNC(UserDefaultBatchTest);
+    UserDefaultBatchTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif // _USERDEFAULT_TEST_H_
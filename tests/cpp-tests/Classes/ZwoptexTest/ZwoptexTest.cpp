@@ -6,6 +6,7 @@ USING_NS_CC;
 ZwoptexTests::ZwoptexTests()
 {
     ADD_TEST_CASE(ZwoptexGenericTest);
+    ADD_TEST_CASE(ZwoptexBinarySheetTest);
 }
 
 //------------------------------------------------------------------
@@ -123,3 +124,47 @@ std::string ZwoptexGenericTest::subtitle() const
 {
     return "Coordinate Formats, Rotation, Trimming, flipX/Y";
 }
+
+//------------------------------------------------------------------
+//
+// ZwoptexBinarySheetTest
+//
+//------------------------------------------------------------------
+void ZwoptexBinarySheetTest::onEnter()
+{
+    ZwoptexTest::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // converted from zwoptex/grossini.plist (format 2) and animations/grossini_polygon.plist (format 3, polygons)
+    // by tools/spritesheet/convert_plist_to_ccsheet.py
+    auto cache = SpriteFrameCache::getInstance();
+    cache->addSpriteFramesWithFile("zwoptex/grossini.ccsheet");
+
+    auto sprite1 = Sprite::createWithSpriteFrameName("grossini_dance_01.png");
+    sprite1->setPosition(Vec2(s.width/2 - 80, s.height/2));
+    addChild(sprite1);
+
+    // both sheets use the same frame names
+    cache->removeSpriteFramesFromFile("zwoptex/grossini.ccsheet");
+    cache->addSpriteFramesWithFile("animations/grossini_polygon.ccsheet");
+
+    auto sprite2 = Sprite::createWithSpriteFrameName("grossini_dance_01.png");
+    sprite2->setPosition(Vec2(s.width/2 + 80, s.height/2));
+    addChild(sprite2);
+}
+
+ZwoptexBinarySheetTest::~ZwoptexBinarySheetTest()
+{
+    SpriteFrameCache::getInstance()->removeSpriteFramesFromFile("animations/grossini_polygon.ccsheet");
+}
+
+std::string ZwoptexBinarySheetTest::title() const
+{
+    return "Binary sprite sheets";
+}
+
+std::string ZwoptexBinarySheetTest::subtitle() const
+{
+    return "Left: rectangle frame, right: polygon frame";
+}
@@ -30,4 +30,17 @@ protected:
     int counter;
 };
 
+class ZwoptexBinarySheetTest : public ZwoptexTest
+{
+public:
+    CREATE_FUNC(ZwoptexBinarySheetTest);
+
+    virtual ~ZwoptexBinarySheetTest();
+
+    virtual void onEnter() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif // __ZWOPTEX_TEST_H__
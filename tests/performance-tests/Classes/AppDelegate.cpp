@@ -39,7 +39,11 @@ bool AppDelegate::applicationDidFinishLaunching() {
     auto director = Director::getInstance();
     auto glview = director->getOpenGLView();
     if(!glview) {
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && CC_USE_NULL_GL
+        // no window nor GPU: run every test unattended with simulated frames
+        glview = GLViewHeadless::create("performance-tests", designResolutionSize);
+        director->setFixedDeltaTime(1.0f / 60);
+#elif (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
         glview = GLViewImpl::createWithRect("performance-tests", Rect(0, 0, designResolutionSize.width, designResolutionSize.height));
 #else
         glview = GLViewImpl::create("performance-tests");
@@ -76,6 +80,10 @@ bool AppDelegate::applicationDidFinishLaunching() {
 
     TestController::getInstance();
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && CC_USE_NULL_GL
+    TestController::getInstance()->startAutoTest();
+#endif
+
     return true;
 }
 
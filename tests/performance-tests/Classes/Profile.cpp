@@ -262,6 +262,7 @@ void Profile::flush()
     FILE *fp = fopen(fullPath.c_str(), "w");
     fputs(out, fp);
     fclose(fp);
+    cocos2d::log("write performance log : %s", fullPath.c_str());
 #else  // #else USE_JSON_FORMAT
     // Write the test data into plist file.
     std::string plistFullPath = genStr("%s/%s", writablePath.c_str(), PLIST_FILE_NAME);
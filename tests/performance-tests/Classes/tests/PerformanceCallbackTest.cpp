@@ -40,6 +40,7 @@ PerformceCallbackTests::PerformceCallbackTests()
     ADD_TEST_CASE(SimulateNewSchedulerCallbackPerfTest);
     ADD_TEST_CASE(InvokeMemberFunctionPerfTest);
     ADD_TEST_CASE(InvokeStdFunctionPerfTest);
+    ADD_TEST_CASE(IntervalTimersPerfTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -183,3 +184,57 @@ void InvokeStdFunctionPerfTest::onUpdate(float dt)
     }
     CC_PROFILER_STOP(_profileName.c_str());
 }
+
+// IntervalTimersPerfTest
+
+IntervalTimersPerfTest::IntervalTimersPerfTest()
+: _timerScheduler(nullptr)
+{
+}
+
+IntervalTimersPerfTest::~IntervalTimersPerfTest()
+{
+    CC_SAFE_RELEASE(_timerScheduler);
+}
+
+void IntervalTimersPerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "IntervalTimers";
+
+    // one timer per target, with intervals between 1 and 10 seconds, like per-entity cooldowns
+    CC_SAFE_RELEASE(_timerScheduler);
+    _timerScheduler = new (std::nothrow) Scheduler();
+    _timerTargets.assign(LOOP_COUNT, 0);
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        int* target = &_timerTargets[i];
+        float interval = 1.0f + (i % 90) * 0.1f;
+        _timerScheduler->schedule([target](float dt){
+            ++(*target);
+        }, target, interval, false, "cooldown");
+    }
+}
+
+void IntervalTimersPerfTest::onExit()
+{
+    _timerScheduler->unscheduleAll();
+    PerformanceCallbackScene::onExit();
+}
+
+std::string IntervalTimersPerfTest::title() const
+{
+    return "Interval timers perf test";
+}
+
+std::string IntervalTimersPerfTest::subtitle() const
+{
+    return "See console";
+}
+
+void IntervalTimersPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    _timerScheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
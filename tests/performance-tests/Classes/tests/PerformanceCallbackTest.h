@@ -90,4 +90,25 @@ private:
     std::function<void(float)> _callback;
 };
 
+// IntervalTimersPerfTest
+class IntervalTimersPerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(IntervalTimersPerfTest);
+    
+    IntervalTimersPerfTest();
+    virtual ~IntervalTimersPerfTest();
+    
+    // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+private:
+    cocos2d::Scheduler* _timerScheduler;
+    std::vector<int> _timerTargets;
+};
+
 #endif /* __PERFORMANCE_CALLBACK_TEST_H__ */
@@ -40,6 +40,8 @@ PerformceMathTests::PerformceMathTests()
 {
     ADD_TEST_CASE(PerformanceMathLayer1);
     ADD_TEST_CASE(PerformanceMathLayer2);
+    ADD_TEST_CASE(PerformanceMathLayer3);
+    ADD_TEST_CASE(PerformanceMathLayer4);
 }
 
 void PerformanceMathLayer::onEnter()
@@ -164,3 +166,69 @@ void PerformanceMathLayer2::doPerformanceTest(float dt)
     CC_PROFILER_STOP(_profileName.c_str());
     
 }
+
+void PerformanceMathVertexLayer::onEnter()
+{
+    PerformanceMathLayer::onEnter();
+    
+    Mat4::createRotation(Vec3(0,0,1), 0.5f, &_modelView);
+    _modelView.translate(100, 50, 0);
+}
+
+void PerformanceMathVertexLayer::prepareBuffers()
+{
+    // _loopCount is the number of vertices, grouped in quads like the renderer does
+    size_t vertexCount = _loopCount / 4 * 4;
+    if (_srcVerts.size() == vertexCount)
+        return;
+    
+    _srcVerts.resize(vertexCount);
+    _dstVerts.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        _srcVerts[i].vertices = Vec3(CCRANDOM_0_1() * 1000, CCRANDOM_0_1() * 1000, 0);
+        _srcVerts[i].colors = Color4B::WHITE;
+        _srcVerts[i].texCoords = Tex2F(CCRANDOM_0_1(), CCRANDOM_0_1());
+    }
+    
+    static const unsigned short quadIndices[] = { 0, 1, 2, 3, 2, 1 };
+    size_t indexCount = vertexCount / 4 * 6;
+    _srcIndices.resize(indexCount);
+    _dstIndices.resize(indexCount);
+    for (size_t i = 0; i < indexCount; ++i)
+    {
+        _srcIndices[i] = quadIndices[i % 6];
+    }
+}
+
+void PerformanceMathLayer3::doPerformanceTest(float dt)
+{
+    prepareBuffers();
+    if (_srcVerts.empty())
+        return;
+    
+    CC_PROFILER_START(_profileName.c_str());
+    // the per vertex path Renderer used before the batched kernels
+    memcpy(&_dstVerts[0], &_srcVerts[0], sizeof(V3F_C4B_T2F) * _srcVerts.size());
+    for (size_t i = 0; i < _dstVerts.size(); ++i)
+    {
+        _modelView.transformPoint(&_dstVerts[i].vertices);
+    }
+    for (size_t i = 0; i < _srcIndices.size(); ++i)
+    {
+        _dstIndices[i] = 1000 + _srcIndices[i];
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+void PerformanceMathLayer4::doPerformanceTest(float dt)
+{
+    prepareBuffers();
+    if (_srcVerts.empty())
+        return;
+    
+    CC_PROFILER_START(_profileName.c_str());
+    MathUtil::transformVertices(&_dstVerts[0], &_srcVerts[0], _srcVerts.size(), _modelView);
+    MathUtil::transformIndices(&_dstIndices[0], &_srcIndices[0], _srcIndices.size(), 1000);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
@@ -67,4 +67,49 @@ public:
     
 };
 
+class PerformanceMathVertexLayer : public PerformanceMathLayer
+{
+public:
+    virtual void onEnter() override;
+    
+protected:
+    void prepareBuffers();
+    
+    std::vector<cocos2d::V3F_C4B_T2F> _srcVerts;
+    std::vector<cocos2d::V3F_C4B_T2F> _dstVerts;
+    std::vector<unsigned short> _srcIndices;
+    std::vector<unsigned short> _dstIndices;
+    cocos2d::Mat4 _modelView;
+};
+
+class PerformanceMathLayer3 : public PerformanceMathVertexLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer3);
+
+    PerformanceMathLayer3()
+    {
+        _profileName = "TransformVerticesScalar";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Vertices and indices, per vertex transformPoint"; }
+};
+
+class PerformanceMathLayer4 : public PerformanceMathVertexLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer4);
+
+    PerformanceMathLayer4()
+    {
+        _profileName = "TransformVerticesBatched";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Vertices and indices, MathUtil batched kernels"; }
+};
+
 #endif //__PERFORMANCE_MATH_TEST_H__
@@ -1,5 +1,6 @@
 #include "PerformanceParticleTest.h"
 #include "Profile.h"
+#include "2d/CCParticleKernels.h"
 
 USING_NS_CC;
 
@@ -36,6 +37,8 @@ PerformceParticleTests::PerformceParticleTests()
     ADD_TEST_CASE(ParticlePerformTest2);
     ADD_TEST_CASE(ParticlePerformTest3);
     ADD_TEST_CASE(ParticlePerformTest4);
+    ADD_TEST_CASE(ParticleEmittersPerfTest);
+    ADD_TEST_CASE(ParticleEmittersParallelPerfTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -498,3 +501,144 @@ void ParticlePerformTest4::initWithSubTest(int subtest, int particles)
     particleSize = 64;
     ParticleMainScene::initWithSubTest(subtest, particles);
 }
+
+////////////////////////////////////////////////////////
+//
+// ParticleEmittersPerfTest
+//
+////////////////////////////////////////////////////////
+enum {
+    kEmittersCount = 24,
+    kEmitterParticles = 2000,
+};
+
+void ParticleEmittersPerfTest::onEnter()
+{
+    TestCase::onEnter();
+
+    CC_PROFILER_PURGE_ALL();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin(isParallel() ? "ParticleEmittersParallelTest" : "ParticleEmittersTest",
+                                              genStrVector("Type", "Emitters", "Particles", nullptr),
+                                              genStrVector("Avg", "Min", "Max", nullptr));
+    }
+
+    // half of the emitters in gravity mode, half in radius mode, all of them full after their first second
+    auto s = Director::getInstance()->getWinSize();
+    auto texture = Director::getInstance()->getTextureCache()->addImage("Images/fire.png");
+    _emitters.clear();
+    for (int i = 0; i < kEmittersCount; ++i)
+    {
+        auto emitter = ParticleSystemQuad::createWithTotalParticles(kEmitterParticles);
+        emitter->setTexture(texture);
+        // the same particles in every run, serial or parallel
+        emitter->setRandomSeed(i + 1);
+        emitter->setDuration(ParticleSystem::DURATION_INFINITY);
+        emitter->setEmitterMode(i % 2 ? ParticleSystem::Mode::RADIUS : ParticleSystem::Mode::GRAVITY);
+        if (emitter->getEmitterMode() == ParticleSystem::Mode::GRAVITY)
+        {
+            emitter->setGravity(Vec2(0, -90));
+            emitter->setSpeed(180);
+            emitter->setSpeedVar(50);
+            emitter->setRadialAccel(-20);
+            emitter->setRadialAccelVar(10);
+            emitter->setTangentialAccel(30);
+            emitter->setTangentialAccelVar(10);
+        }
+        else
+        {
+            emitter->setStartRadius(0);
+            emitter->setStartRadiusVar(10);
+            emitter->setEndRadius(120);
+            emitter->setEndRadiusVar(20);
+            emitter->setRotatePerSecond(90);
+            emitter->setRotatePerSecondVar(45);
+        }
+        emitter->setAngle(90);
+        emitter->setAngleVar(180);
+        emitter->setLife(1.0f);
+        emitter->setLifeVar(0.5f);
+        emitter->setEmissionRate(kEmitterParticles / emitter->getLife());
+        emitter->setStartColor(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+        emitter->setStartColorVar(Color4F(0.5f, 0.5f, 0.5f, 0.0f));
+        emitter->setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+        emitter->setStartSize(8);
+        emitter->setStartSizeVar(4);
+        emitter->setEndSize(2);
+        emitter->setStartSpin(0);
+        emitter->setEndSpin(360);
+        emitter->setEndSpinVar(90);
+        emitter->setPosition(Vec2(s.width * (i % 6 + 0.5f) / 6, s.height * (i / 6 + 0.5f) / 4));
+        addChild(emitter);
+
+        // the emitters are stepped by this test, to time them together
+        emitter->unscheduleUpdate();
+        _emitters.push_back(emitter);
+    }
+
+    Director::getInstance()->setParallelParticlesEnabled(isParallel());
+
+    schedule(CC_SCHEDULE_SELECTOR(ParticleEmittersPerfTest::stepEmitters));
+    schedule(CC_SCHEDULE_SELECTOR(ParticleEmittersPerfTest::dumpProfilerInfo), 2);
+}
+
+void ParticleEmittersPerfTest::onExit()
+{
+    Director::getInstance()->setParallelParticlesEnabled(false);
+    TestCase::onExit();
+}
+
+void ParticleEmittersPerfTest::stepEmitters(float dt)
+{
+    CC_PROFILER_START("ParticleEmittersUpdate");
+    for (auto emitter : _emitters)
+    {
+        emitter->update(dt);
+    }
+    // in parallel mode the updates above only queued the emitters, the Director would run them after the scheduler
+    FrameJobQueue::getInstance()->run();
+    CC_PROFILER_STOP("ParticleEmittersUpdate");
+}
+
+void ParticleEmittersPerfTest::dumpProfilerInfo(float dt)
+{
+    CC_PROFILER_DISPLAY_TIMERS();
+
+    if (this->isAutoTesting()) {
+        // record the test result to class Profile
+        auto timer = Profiler::getInstance()->_activeTimers.at("ParticleEmittersUpdate");
+        auto typeStr = genStr("%s%s", ParticleKernels::isVectorized() ? "SIMD" : "scalar", isParallel() ? " parallel" : "");
+        auto emittersStr = genStr("%d", kEmittersCount);
+        auto particlesStr = genStr("%d", kEmitterParticles);
+        auto avgStr = genStr("%ldµ", timer->_averageTime2);
+        auto minStr = genStr("%ldµ", timer->minTime);
+        auto maxStr = genStr("%ldµ", timer->maxTime);
+        Profile::getInstance()->addTestResult(genStrVector(typeStr.c_str(), emittersStr.c_str(), particlesStr.c_str(), nullptr),
+                                              genStrVector(avgStr.c_str(), minStr.c_str(), maxStr.c_str(), nullptr));
+
+        this->setAutoTesting(false);
+        Profile::getInstance()->testCaseEnd();
+    }
+}
+
+std::string ParticleEmittersPerfTest::title() const
+{
+    return "Emitters update";
+}
+
+std::string ParticleEmittersPerfTest::subtitle() const
+{
+    return StringUtils::format("%d emitters x %d particles, %s kernels, see console", kEmittersCount, kEmitterParticles,
+                               ParticleKernels::isVectorized() ? "SIMD" : "scalar");
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleEmittersParallelPerfTest
+//
+////////////////////////////////////////////////////////
+std::string ParticleEmittersParallelPerfTest::title() const
+{
+    return "Emitters update on worker threads";
+}
@@ -76,4 +76,34 @@ public:
     virtual void initWithSubTest(int subtest, int particles) override;
 };
 
+class ParticleEmittersPerfTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleEmittersPerfTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void stepEmitters(float dt);
+    void dumpProfilerInfo(float dt);
+
+protected:
+    virtual bool isParallel() const { return false; }
+
+    std::vector<cocos2d::ParticleSystem*> _emitters;
+};
+
+class ParticleEmittersParallelPerfTest : public ParticleEmittersPerfTest
+{
+public:
+    CREATE_FUNC(ParticleEmittersParallelPerfTest);
+
+    virtual std::string title() const override;
+
+protected:
+    virtual bool isParallel() const override { return true; }
+};
+
 #endif
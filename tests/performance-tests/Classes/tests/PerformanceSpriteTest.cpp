@@ -38,7 +38,7 @@ USING_NS_CC;
 #define CC_ROUND(__f__) roundf(__f__)
 #endif
 
-#define MAX_SUB_TEST_NUM        15
+#define MAX_SUB_TEST_NUM        16
 #define DELAY_TIME              2
 #define STAT_TIME               3
 
@@ -63,6 +63,7 @@ PerformceSpriteTests::PerformceSpriteTests()
     ADD_TEST_CASE(SpritePerformTestE);
     ADD_TEST_CASE(SpritePerformTestF);
     ADD_TEST_CASE(SpritePerformTestG);
+    ADD_TEST_CASE(SpritePerformTestH);
 }
 
 int SpriteMainScene::_quantityNodes = 50;
@@ -106,6 +107,8 @@ void SubTest::initWithSubTest(int subtest, Node* p)
      *12: 64 (16-bit) PNG Batch Node of 32 x 32 each
      *
      *13:    (16-bit) PNG sprites. 33% from test4, 33% from test8, 33% from test12
+     *
+     *16: 1 (32-bit) sprite sheet with rectangular frames, in a RetainedBatchNode
     */
 
     // purge textures
@@ -180,6 +183,12 @@ void SubTest::initWithSubTest(int subtest, Node* p)
             SpriteFrameCache::getInstance()->addSpriteFramesWithFile("Images/grossini_polygon.plist"); // sprite sheet with triangulation of sprite outlines
             break;
 
+        case 16:
+            Texture2D::setDefaultAlphaPixelFormat(Texture2D::PixelFormat::RGBA8888);
+            _parentNode = RetainedBatchNode::create();
+            SpriteFrameCache::getInstance()->addSpriteFramesWithFile("Images/grossini_quad.plist"); // sprite sheet with rectangular frames
+            break;
+
         default:
             break;
     }
@@ -317,6 +326,7 @@ Sprite* SubTest::createSpriteWithTag(int tag)
         }
         case 14:
         case 15:
+        case 16:
         {
             sprite = Sprite::createWithSpriteFrameName("grossini_dance_05.png");
             _parentNode->addChild(sprite, 0, tag+100);
@@ -669,6 +679,21 @@ void performanceActions20(Sprite* sprite)
     sprite->runAction(permanentScaleLoop);
 }
 
+void performanceTweens(Sprite* sprite)
+{
+    auto size = Director::getInstance()->getWinSize();
+    sprite->setPosition(Vec2((rand() % (int)size.width), (rand() % (int)size.height)));
+
+    // long tweens, so that they all keep running while the test measures
+    float duration = 60.0f + (rand() % 1000) / 100.0f;
+    auto destination = Vec2((rand() % (int)size.width), (rand() % (int)size.height));
+    sprite->runAction(EaseSineInOut::create(MoveTo::create(duration, destination)));
+    sprite->runAction(EaseBackOut::create(ScaleTo::create(duration, 0.5f + CCRANDOM_0_1())));
+    sprite->runAction(RotateTo::create(duration, 360.0f * CCRANDOM_0_1()));
+    sprite->runAction(FadeTo::create(duration, 64));
+    sprite->runAction(TintTo::create(duration, rand() % 256, rand() % 256, rand() % 256));
+}
+
 void performanceRotationScale(Sprite* sprite)
 {
     auto size = Director::getInstance()->getWinSize();
@@ -830,3 +855,21 @@ void SpritePerformTestG::doTest(Sprite* sprite)
 {
     performanceActions20(sprite);
 }
+
+////////////////////////////////////////////////////////
+//
+// SpritePerformTestH
+//
+////////////////////////////////////////////////////////
+std::string SpritePerformTestH::title() const
+{
+    char str[32] = {0};
+    sprintf(str, "H (%d) tweens", _subtestNumber);
+    std::string strRet = str;
+    return strRet;
+}
+
+void SpritePerformTestH::doTest(Sprite* sprite)
+{
+    performanceTweens(sprite);
+}
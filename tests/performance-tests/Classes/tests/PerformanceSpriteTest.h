@@ -160,4 +160,14 @@ public:
     virtual std::string getTestCaseName() override { return "G"; }
 };
 
+class SpritePerformTestH : public SpriteMainScene
+{
+public:
+    CREATE_FUNC(SpritePerformTestH);
+
+    virtual void doTest(cocos2d::Sprite* sprite) override;
+    virtual std::string title() const override;
+    virtual std::string getTestCaseName() override { return "H"; }
+};
+
 #endif
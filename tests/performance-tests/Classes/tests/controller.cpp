@@ -83,6 +83,13 @@ void TestController::traverseThreadFunc()
     // write the test data into file.
     Profile::getInstance()->flush();
     Profile::destroyInstance();
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) && CC_USE_NULL_GL
+    // nobody is watching a headless run, quit once the report is written
+    _director->getScheduler()->performFunctionInCocosThread([](){
+        Director::getInstance()->end();
+    });
+#endif
 }
 
 void TestController::traverseTestList(TestList* testList)
@@ -0,0 +1,169 @@
+#!/usr/bin/python
+#convert_plist_to_ccsheet.py
+#
+# Converts the sprite sheet plist files read by SpriteFrameCache (formats 0 to 3,
+# including TexturePacker polygon meshes) to the binary .ccsheet format, which
+# SpriteFrameCache loads without parsing any string.
+#
+# Layout, little endian, every block 4 byte aligned, offsets in bytes from the start of the file:
+#  header:  char magic[4] = 'CCSS', uint32 version = 1, uint32 frameCount, uint32 aliasCount,
+#           float textureWidth, float textureHeight, uint32 textureFileName (string),
+#           uint32 frames, uint32 aliases, uint32 strings, uint32 stringsSize
+#  frames:  uint32 name (string), float rect[4], float offset[2], float sourceSize[2], uint32 flags
+#           (1: rotated, 2: polygon), uint32 vertexCount, uint32 indexCount, uint32 vertices, uint32 indices
+#  aliases: uint32 name (string), uint32 frame index
+#  polygon: int32 vertices[vertexCount * 2], int32 verticesUV[vertexCount * 2] at 'vertices',
+#           uint16 triangles[indexCount] at 'indices'
+#  strings: NUL terminated UTF-8 strings, a string is an offset from the start of this block
+#
+# The frames keep the values passed to SpriteFrame::createWithTexture(), whatever the format of the plist.
+
+import plistlib
+import os.path
+import argparse
+import re
+import struct
+
+MAGIC = b'CCSS'
+VERSION = 1
+HEADER_FORMAT = '<4s3I2f5I'
+FRAME_FORMAT = '<I8f5I'
+ALIAS_FORMAT = '<2I'
+
+FLAG_ROTATED = 1
+FLAG_POLYGON = 2
+
+#parse "{x,y}" and "{{x,y},{w,h}}" like cocos2d::PointFromString and RectFromString
+def parseFloats(string):
+    return [float(value) for value in re.findall(r'[-+]?[0-9]*\.?[0-9]+(?:[eE][-+]?[0-9]+)?', string)]
+
+def parseIntegers(string):
+    return [int(value) for value in string.split()]
+
+def readPlist(filename):
+    if hasattr(plistlib, 'load'):
+        with open(filename, 'rb') as fp:
+            return plistlib.load(fp)
+    return plistlib.readPlist(filename)
+
+class StringTable:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = dict()
+
+    def add(self, string):
+        if string not in self.offsets:
+            self.offsets[string] = len(self.data)
+            self.data += string.encode('utf-8') + b'\0'
+        return self.offsets[string]
+
+#returns (name, rect, offset, sourceSize, rotated, polygon, aliases) of a frame
+def readFrame(name, frameDict, format):
+    polygon = None
+    aliases = []
+    if format == 0:
+        rect = [frameDict['x'], frameDict['y'], frameDict['width'], frameDict['height']]
+        offset = [frameDict['offsetX'], frameDict['offsetY']]
+        sourceSize = [abs(int(frameDict.get('originalWidth', 0))), abs(int(frameDict.get('originalHeight', 0)))]
+        rotated = False
+    elif format == 1 or format == 2:
+        rect = parseFloats(frameDict['frame'])
+        offset = parseFloats(frameDict['offset'])
+        sourceSize = parseFloats(frameDict['sourceSize'])
+        rotated = format == 2 and bool(frameDict.get('rotated', False))
+    else:
+        spriteSize = parseFloats(frameDict['spriteSize'])
+        textureRect = parseFloats(frameDict['textureRect'])
+        rect = [textureRect[0], textureRect[1], spriteSize[0], spriteSize[1]]
+        offset = parseFloats(frameDict['spriteOffset'])
+        sourceSize = parseFloats(frameDict['spriteSourceSize'])
+        rotated = bool(frameDict.get('textureRotated', False))
+        aliases = list(frameDict.get('aliases', []))
+        if 'vertices' in frameDict:
+            polygon = (parseIntegers(frameDict['vertices']),
+                       parseIntegers(frameDict['verticesUV']),
+                       parseIntegers(frameDict['triangles']))
+    return (name, rect, offset, sourceSize, rotated, polygon, aliases)
+
+def pad(data):
+    while len(data) % 4:
+        data += b'\0'
+
+def convert(plist):
+    frames = plist.get('frames')
+    if not isinstance(frames, dict):
+        raise ValueError('no frames')
+    metadata = plist.get('metadata', dict())
+    format = int(metadata.get('format', 0))
+    if format < 0 or format > 3:
+        raise ValueError('format %d is not supported' % format)
+    textureSize = parseFloats(metadata['size']) if 'size' in metadata else [0.0, 0.0]
+
+    strings = StringTable()
+    textureFileName = strings.add(metadata.get('textureFileName', ''))
+    frameList = [readFrame(name, frames[name], format) for name in sorted(frames.keys())]
+    frameIndex = dict((frame[0], index) for index, frame in enumerate(frameList))
+
+    headerSize = struct.calcsize(HEADER_FORMAT)
+    framesOffset = headerSize
+    aliasCount = sum(len(frame[6]) for frame in frameList)
+    aliasesOffset = framesOffset + struct.calcsize(FRAME_FORMAT) * len(frameList)
+    polygonOffset = aliasesOffset + struct.calcsize(ALIAS_FORMAT) * aliasCount
+
+    frameData = bytearray()
+    aliasData = bytearray()
+    polygonData = bytearray()
+    for name, rect, offset, sourceSize, rotated, polygon, aliases in frameList:
+        flags = FLAG_ROTATED if rotated else 0
+        vertexCount = indexCount = vertices = indices = 0
+        if polygon:
+            positions, uvs, triangles = polygon
+            if len(positions) != len(uvs) or len(positions) % 2:
+                raise ValueError('%s: vertices and verticesUV don\'t match' % name)
+            flags |= FLAG_POLYGON
+            vertexCount = len(positions) // 2
+            indexCount = len(triangles)
+            vertices = polygonOffset + len(polygonData)
+            polygonData += struct.pack('<%di' % (vertexCount * 4), *(positions + uvs))
+            indices = polygonOffset + len(polygonData)
+            polygonData += struct.pack('<%dH' % indexCount, *triangles)
+            pad(polygonData)
+        frameData += struct.pack(FRAME_FORMAT, strings.add(name), *(rect + offset + sourceSize +
+                                 [flags, vertexCount, indexCount, vertices, indices]))
+        for alias in aliases:
+            aliasData += struct.pack(ALIAS_FORMAT, strings.add(alias), frameIndex[name])
+
+    stringsOffset = polygonOffset + len(polygonData)
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(frameList), aliasCount,
+                         textureSize[0], textureSize[1], textureFileName,
+                         framesOffset, aliasesOffset, stringsOffset, len(strings.data))
+    return header + frameData + aliasData + polygonData + strings.data
+
+#process file
+def processConvertFile(filename, output):
+    if(not os.path.isfile(filename)):
+        print(filename + ' dose not exist!')
+        return False
+    if not output:
+        output = os.path.splitext(filename)[0] + '.ccsheet'
+    try:
+        data = convert(readPlist(filename))
+    except (KeyError, ValueError) as e:
+        print('Skip plist file: ' + filename + ', ' + str(e))
+        return False
+    with open(output, 'wb') as fp:
+        fp.write(data)
+    print('Write ' + output)
+    return True
+
+# -------------- entrance --------------
+if __name__ == '__main__':
+    argparser = argparse.ArgumentParser(description = 'Converts sprite sheet plist files to .ccsheet files')
+    argparser.add_argument("file", nargs = "+", help = "specify the plist files")
+    argparser.add_argument("-o", "--output", help = "the output file, when converting one file, next to the plist by default")
+    args = argparser.parse_args()
+
+    if args.output and len(args.file) > 1:
+        argparser.error('--output needs a single file')
+    for file in args.file:
+        processConvertFile(file, args.output)